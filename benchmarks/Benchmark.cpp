@@ -0,0 +1,98 @@
+// Copyright (C) 2018 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include "Benchmark.hpp"
+
+static std::atomic<size_t> allocatedMemory(0);
+static std::atomic<size_t> peakMemory(0);
+
+// every block is prefixed with its size, the prefix is big enough to keep the alignment of malloc
+static const size_t HEADER_SIZE = 16;
+
+// returns null if the allocation fails
+static void* allocate(size_t size)
+{
+    uint8_t* block = static_cast<uint8_t*>(malloc(size + HEADER_SIZE));
+    if (!block) return nullptr;
+
+    *reinterpret_cast<size_t*>(block) = size;
+
+    size_t current = allocatedMemory += size;
+    size_t peak = peakMemory;
+    while (current > peak && !peakMemory.compare_exchange_weak(peak, current)) {}
+
+    return block + HEADER_SIZE;
+}
+
+static void deallocate(void* pointer)
+{
+    if (!pointer) return;
+
+    uint8_t* block = static_cast<uint8_t*>(pointer) - HEADER_SIZE;
+    allocatedMemory -= *reinterpret_cast<size_t*>(block);
+    free(block);
+}
+
+void* operator new(size_t size)
+{
+    void* pointer = allocate(size);
+    if (!pointer) throw std::bad_alloc();
+    return pointer;
+}
+
+void* operator new[](size_t size)
+{
+    void* pointer = allocate(size);
+    if (!pointer) throw std::bad_alloc();
+    return pointer;
+}
+
+// the nothrow versions have to be replaced too, because the default ones don't write the size prefix
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+    return allocate(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+    return allocate(size);
+}
+
+void operator delete(void* pointer) noexcept
+{
+    deallocate(pointer);
+}
+
+void operator delete[](void* pointer) noexcept
+{
+    deallocate(pointer);
+}
+
+void operator delete(void* pointer, const std::nothrow_t&) noexcept
+{
+    deallocate(pointer);
+}
+
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept
+{
+    deallocate(pointer);
+}
+
+size_t getAllocatedMemory()
+{
+    return allocatedMemory;
+}
+
+size_t getPeakMemory()
+{
+    return peakMemory;
+}
+
+void resetPeakMemory()
+{
+    peakMemory = allocatedMemory.load();
+}
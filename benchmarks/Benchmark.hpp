@@ -0,0 +1,40 @@
+// Copyright (C) 2018 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+
+// heap memory of the process, counted by the replaced global operator new and delete
+size_t getAllocatedMemory();
+size_t getPeakMemory();
+// starts measuring the peak from the current allocation
+void resetPeakMemory();
+
+class Timer
+{
+public:
+    Timer(): start(std::chrono::steady_clock::now()) {}
+
+    void reset() { start = std::chrono::steady_clock::now(); }
+
+    // in milliseconds
+    double getElapsed() const
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+private:
+    std::chrono::steady_clock::time_point start;
+};
+
+// each benchmark logs its results and returns false if it fails or its results are wrong
+bool runJSONBenchmark();
+bool runLogBenchmark();
+bool runMathBenchmark();
+bool runNetworkBenchmark();
+bool runOBFBenchmark();
+bool runReplicationBenchmark();
+bool runSceneBenchmark();
+bool runXMLBenchmark();
@@ -0,0 +1,231 @@
+// Copyright (C) 2018 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#include <random>
+#include <string>
+#include "utils/JSON.hpp"
+#include "utils/JSONDocument.hpp"
+#include "utils/JSONReader.hpp"
+#include "utils/Log.hpp"
+#include "Benchmark.hpp"
+
+using namespace ouzel;
+
+static const uint32_t FRAME_COUNT = 20000;
+static const uint32_t ITERATIONS = 10;
+
+struct Summary
+{
+    double numberSum = 0.0;
+    uint32_t numberCount = 0;
+    size_t stringSize = 0;
+
+    bool operator==(const Summary& other) const
+    {
+        return numberSum == other.numberSum &&
+            numberCount == other.numberCount &&
+            stringSize == other.stringSize;
+    }
+};
+
+// TexturePacker sheet, every fourth frame is a polygon sprite
+static std::string generateSheet()
+{
+    std::mt19937 random(1);
+    std::uniform_int_distribution<int> position(0, 4000);
+    std::uniform_int_distribution<int> point(0, 64);
+
+    std::string result = "{\n  \"frames\": [\n";
+
+    for (uint32_t i = 0; i < FRAME_COUNT; ++i)
+    {
+        if (i > 0) result += ",\n";
+
+        result += "    {\n      \"filename\": \"sprite_" + std::to_string(i) + ".png\",\n";
+        result += "      \"frame\": {\"x\": " + std::to_string(position(random)) +
+            ", \"y\": " + std::to_string(position(random)) + ", \"w\": 64, \"h\": 64},\n";
+        result += std::string("      \"rotated\": ") + ((i % 3 == 0) ? "true" : "false") + ",\n";
+        result += "      \"trimmed\": true,\n";
+        result += "      \"spriteSourceSize\": {\"x\": 1, \"y\": 2, \"w\": 62, \"h\": 60},\n";
+        result += "      \"sourceSize\": {\"w\": 64, \"h\": 64},\n";
+        result += "      \"pivot\": {\"x\": 0.5, \"y\": 0.25}";
+
+        if (i % 4 == 0)
+        {
+            result += ",\n      \"vertices\": [";
+            for (uint32_t v = 0; v < 6; ++v)
+                result += std::string(v ? ", " : "") + "[" + std::to_string(point(random)) + ", " + std::to_string(point(random)) + "]";
+            result += "],\n      \"triangles\": [[0, 1, 2], [2, 3, 4], [4, 5, 0]]";
+        }
+
+        result += "\n    }";
+    }
+
+    result += "\n  ],\n  \"meta\": {\"app\": \"http://www.codeandweb.com/texturepacker\", \"version\": \"1.0\", "
+        "\"image\": \"sheet.png\", \"format\": \"RGBA8888\", \"size\": {\"w\": 4096, \"h\": 4096}, \"scale\": \"1\"}\n}\n";
+
+    return result;
+}
+
+static void summarize(const json::Value& value, Summary& summary)
+{
+    switch (value.getType())
+    {
+        case json::Value::Type::NUMBER:
+            summary.numberSum += value.asDouble();
+            ++summary.numberCount;
+            break;
+        case json::Value::Type::STRING:
+            summary.stringSize += value.asString().length();
+            break;
+        case json::Value::Type::OBJECT:
+            for (const auto& member : value.asMap())
+            {
+                summary.stringSize += member.first.length();
+                summarize(member.second, summary);
+            }
+            break;
+        case json::Value::Type::ARRAY:
+            for (const json::Value& element : value.asArray())
+                summarize(element, summary);
+            break;
+        default:
+            break;
+    }
+}
+
+static void summarize(const json::Node& node, Summary& summary)
+{
+    switch (node.getType())
+    {
+        case json::Node::Type::NUMBER:
+            summary.numberSum += node.asDouble();
+            ++summary.numberCount;
+            break;
+        case json::Node::Type::STRING:
+            summary.stringSize += node.asString().getLength();
+            break;
+        case json::Node::Type::OBJECT:
+            for (uint32_t i = 0; i < node.getSize(); ++i)
+            {
+                summary.stringSize += node.getMemberName(i).asString().getLength();
+                summarize(node.getMemberValue(i), summary);
+            }
+            break;
+        case json::Node::Type::ARRAY:
+            for (const json::Node& element : node)
+                summarize(element, summary);
+            break;
+        default:
+            break;
+    }
+}
+
+static bool summarize(json::Reader& reader, Summary& summary)
+{
+    for (;;)
+    {
+        switch (reader.next())
+        {
+            case json::Reader::Event::NUMBER:
+                summary.numberSum += reader.getNumber();
+                ++summary.numberCount;
+                break;
+            case json::Reader::Event::KEY:
+            case json::Reader::Event::STRING:
+                summary.stringSize += reader.getString().getLength();
+                break;
+            case json::Reader::Event::END:
+                return true;
+            case json::Reader::Event::ERROR:
+                return false;
+            default:
+                break;
+        }
+    }
+}
+
+bool runJSONBenchmark()
+{
+    std::string sheet = generateSheet();
+    std::vector<uint8_t> data(sheet.begin(), sheet.end());
+    sheet.clear();
+    sheet.shrink_to_fit();
+
+    Summary dataSummary;
+    Summary documentSummary;
+    Summary readerSummary;
+    size_t dataMemory = 0;
+    size_t documentMemory = 0;
+    size_t readerMemory = 0;
+    double dataTime = 0.0;
+    double documentTime = 0.0;
+    double readerTime = 0.0;
+
+    for (uint32_t i = 0; i < ITERATIONS; ++i)
+    {
+        size_t base = getAllocatedMemory();
+        resetPeakMemory();
+        Timer timer;
+
+        json::Data value;
+        if (!value.init(data)) return false;
+
+        dataTime += timer.getElapsed();
+        dataMemory = getPeakMemory() - base;
+
+        if (i == 0) summarize(value, dataSummary);
+    }
+
+    for (uint32_t i = 0; i < ITERATIONS; ++i)
+    {
+        size_t base = getAllocatedMemory();
+        resetPeakMemory();
+        Timer timer;
+
+        json::Document document;
+        if (!document.init(data)) return false;
+
+        documentTime += timer.getElapsed();
+        documentMemory = getPeakMemory() - base;
+
+        if (i == 0) summarize(document.getRoot(), documentSummary);
+    }
+
+    for (uint32_t i = 0; i < ITERATIONS; ++i)
+    {
+        // the reader decodes the strings in place
+        std::vector<uint8_t> buffer = data;
+
+        size_t base = getAllocatedMemory();
+        resetPeakMemory();
+        Timer timer;
+
+        json::Reader reader(buffer.data(), buffer.data() + buffer.size());
+        Summary summary;
+        if (!summarize(reader, summary)) return false;
+
+        readerTime += timer.getElapsed();
+        readerMemory = getPeakMemory() - base;
+
+        if (i == 0) readerSummary = summary;
+    }
+
+    double size = data.size() / 1048576.0;
+
+    Log(Log::Level::INFO) << "JSON sheet of " << FRAME_COUNT << " frames, " << size << " MB";
+    Log(Log::Level::INFO) << "json::Data: " << dataTime / ITERATIONS << " ms, " <<
+        size * 1000.0 * ITERATIONS / dataTime << " MB/s, peak heap " << dataMemory / 1024 << " KB";
+    Log(Log::Level::INFO) << "json::Document: " << documentTime / ITERATIONS << " ms, " <<
+        size * 1000.0 * ITERATIONS / documentTime << " MB/s, peak heap " << documentMemory / 1024 << " KB";
+    Log(Log::Level::INFO) << "json::Reader: " << readerTime / ITERATIONS << " ms, " <<
+        size * 1000.0 * ITERATIONS / readerTime << " MB/s, peak heap " << readerMemory / 1024 << " KB";
+
+    if (!(documentSummary == dataSummary) || !(readerSummary == dataSummary))
+    {
+        Log(Log::Level::ERR) << "The parsers returned different values";
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,74 @@
+// Copyright (C) 2018 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#include <algorithm>
+#include <functional>
+#include <thread>
+#include <vector>
+#include "math/Vector3.hpp"
+#include "utils/Log.hpp"
+#include "Benchmark.hpp"
+
+using namespace ouzel;
+
+static const uint32_t THREAD_COUNT = 4;
+static const uint32_t RECORD_COUNT = 1000;
+static const std::chrono::microseconds INTERVAL(100);
+
+struct ThreadResult
+{
+    double totalTime = 0.0;
+    double maxTime = 0.0;
+};
+
+// every thread logs a record with a few arguments every 100 microseconds, like per-frame logging of a game
+static void logRecords(uint32_t thread, ThreadResult& result)
+{
+    for (uint32_t i = 0; i < RECORD_COUNT; ++i)
+    {
+        Timer timer;
+
+        Log(Log::Level::INFO) << "Frame " << i << " of thread " << thread << " took " << i * 1.5F <<
+            " ms, position " << Vector3(1.0F, 2.0F, 3.0F);
+
+        double elapsed = timer.getElapsed();
+        result.totalTime += elapsed;
+        result.maxTime = std::max(result.maxTime, elapsed);
+
+        std::this_thread::sleep_for(INTERVAL);
+    }
+}
+
+bool runLogBenchmark()
+{
+    Log::flush();
+    uint64_t droppedCount = Log::getDroppedCount();
+
+    std::vector<ThreadResult> results(THREAD_COUNT);
+    std::vector<std::thread> threads;
+
+    for (uint32_t i = 0; i < THREAD_COUNT; ++i)
+        threads.push_back(std::thread(logRecords, i, std::ref(results[i])));
+
+    for (std::thread& thread : threads)
+        thread.join();
+
+    Timer timer;
+    Log::flush();
+    double flushTime = timer.getElapsed();
+
+    double totalTime = 0.0;
+    double maxTime = 0.0;
+
+    for (const ThreadResult& result : results)
+    {
+        totalTime += result.totalTime;
+        maxTime = std::max(maxTime, result.maxTime);
+    }
+
+    Log(Log::Level::INFO) << THREAD_COUNT << " threads, " << RECORD_COUNT << " records each: " <<
+        totalTime * 1000.0 / (THREAD_COUNT * RECORD_COUNT) << " us per call, max " << maxTime * 1000.0 <<
+        " us, flush " << flushTime << " ms, " << Log::getDroppedCount() - droppedCount << " records dropped";
+
+    return true;
+}
@@ -0,0 +1,195 @@
+// Copyright (C) 2018 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include "math/MathBatch.hpp"
+#include "math/Quaternion.hpp"
+#include "utils/Log.hpp"
+#include "Benchmark.hpp"
+
+using namespace ouzel;
+
+// odd, so that the remainder loops of the vectorized versions are run too
+static const size_t COUNT = 10007;
+static const uint32_t ITERATIONS = 500;
+static const float MAX_ERROR = 0.0001F;
+
+static const struct
+{
+    MathISA isa;
+    const char* name;
+} ISAS[] = {
+    {MathISA::SCALAR, "scalar"},
+    {MathISA::SSE, "SSE"},
+    {MathISA::AVX2, "AVX2"},
+    {MathISA::NEON, "NEON"}
+};
+
+struct Data
+{
+    Matrix4 matrix;
+    std::vector<Vector3> points;
+    std::vector<Matrix4> matrices1;
+    std::vector<Matrix4> matrices2;
+    std::vector<Box3> boxes;
+};
+
+struct Results
+{
+    std::vector<Vector3> points;
+    std::vector<Vector3> vectors;
+    std::vector<Matrix4> products;
+    std::vector<Box3> boxes;
+    std::vector<Matrix4> inverses;
+    bool inverted = false;
+};
+
+// rotation, scale and translation
+static Matrix4 getAffineMatrix(std::mt19937& random)
+{
+    std::uniform_real_distribution<float> distribution(-10.0F, 10.0F);
+    std::uniform_real_distribution<float> scale(1.0F, 2.0F);
+
+    Quaternion rotation(distribution(random), distribution(random), distribution(random), distribution(random));
+    rotation.normalize();
+
+    Matrix4 result = rotation.getMatrix();
+    result.scale(Vector3(scale(random), scale(random), scale(random)));
+    result.m[12] = distribution(random);
+    result.m[13] = distribution(random);
+    result.m[14] = distribution(random);
+
+    return result;
+}
+
+static void generate(Data& data)
+{
+    std::mt19937 random(1);
+    std::uniform_real_distribution<float> distribution(-10.0F, 10.0F);
+    std::uniform_real_distribution<float> extent(0.0F, 10.0F);
+
+    data.matrix = getAffineMatrix(random);
+    data.points.resize(COUNT);
+    data.matrices1.resize(COUNT);
+    data.matrices2.resize(COUNT);
+    data.boxes.resize(COUNT);
+
+    for (size_t i = 0; i < COUNT; ++i)
+    {
+        data.points[i] = Vector3(distribution(random), distribution(random), distribution(random));
+        data.matrices1[i] = getAffineMatrix(random);
+        data.matrices2[i] = getAffineMatrix(random);
+
+        Vector3 center(distribution(random), distribution(random), distribution(random));
+        Vector3 halfSize(extent(random), extent(random), extent(random));
+        data.boxes[i] = Box3(center - halfSize, center + halfSize);
+    }
+
+    // empty boxes have to stay empty and singular matrices have to be reported
+    data.boxes[7].reset();
+    data.boxes[COUNT / 2].reset();
+    data.matrices1[5] = Matrix4::ZERO;
+    data.matrices1[5].m[15] = 1.0F;
+}
+
+static float getError(const float* values, const float* expected, size_t count)
+{
+    float result = 0.0F;
+
+    for (size_t i = 0; i < count; ++i)
+        result = std::max(result, std::fabs(values[i] - expected[i]) / (1.0F + std::fabs(expected[i])));
+
+    return result;
+}
+
+template<class F> double measure(F function)
+{
+    Timer timer;
+
+    for (uint32_t i = 0; i < ITERATIONS; ++i)
+        function();
+
+    // in microseconds per call
+    return timer.getElapsed() * 1000.0 / ITERATIONS;
+}
+
+static void run(const Data& data, Results& results, double times[5])
+{
+    results.points.resize(COUNT);
+    results.vectors.resize(COUNT);
+    results.products.resize(COUNT);
+    results.boxes.resize(COUNT);
+    results.inverses.assign(COUNT, Matrix4::IDENTITY);
+
+    times[0] = measure([&data, &results]() {
+        transformPoints(data.matrix, data.points.data(), results.points.data(), COUNT);
+    });
+    times[1] = measure([&data, &results]() {
+        transformVectors(data.matrix, data.points.data(), results.vectors.data(), COUNT);
+    });
+    times[2] = measure([&data, &results]() {
+        multiplyMatrices(data.matrices1.data(), data.matrices2.data(), results.products.data(), COUNT);
+    });
+    times[3] = measure([&data, &results]() {
+        transformBoxes(data.matrices1.data(), data.boxes.data(), results.boxes.data(), COUNT);
+    });
+    times[4] = measure([&data, &results]() {
+        results.inverted = invertAffineMatrices(data.matrices1.data(), results.inverses.data(), COUNT);
+    });
+}
+
+bool runMathBenchmark()
+{
+    Data data;
+    generate(data);
+
+    MathISA originalISA = getMathISA();
+    Results expected;
+    double scalarTimes[5];
+    bool result = true;
+
+    for (const auto& isa : ISAS)
+    {
+        if (!isMathISASupported(isa.isa) || !setMathISA(isa.isa)) continue;
+
+        Results results;
+        double times[5];
+        run(data, results, times);
+
+        if (isa.isa == MathISA::SCALAR)
+        {
+            expected = results;
+            std::copy(times, times + 5, scalarTimes);
+        }
+
+        float error = std::max({
+            getError(&results.points[0].x, &expected.points[0].x, COUNT * 3),
+            getError(&results.vectors[0].x, &expected.vectors[0].x, COUNT * 3),
+            getError(results.products[0].m, expected.products[0].m, COUNT * 16),
+            getError(&results.boxes[0].min.x, &expected.boxes[0].min.x, COUNT * 6),
+            getError(results.inverses[0].m, expected.inverses[0].m, COUNT * 16)
+        });
+
+        Log(Log::Level::INFO) << isa.name << " (us per " << COUNT << " elements): points " << times[0] <<
+            " (" << scalarTimes[0] / times[0] << "x), vectors " << times[1] <<
+            " (" << scalarTimes[1] / times[1] << "x), matrices " << times[2] <<
+            " (" << scalarTimes[2] / times[2] << "x), boxes " << times[3] <<
+            " (" << scalarTimes[3] / times[3] << "x), inverses " << times[4] <<
+            " (" << scalarTimes[4] / times[4] << "x), max error " << error;
+
+        if (error > MAX_ERROR ||
+            results.inverted ||
+            !results.boxes[7].isEmpty() ||
+            !results.boxes[COUNT / 2].isEmpty())
+        {
+            Log(Log::Level::ERR) << "The " << isa.name << " results differ from the scalar ones";
+            result = false;
+        }
+    }
+
+    setMathISA(originalISA);
+
+    return result;
+}
@@ -0,0 +1,145 @@
+// Copyright (C) 2018 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+#include <chrono>
+#include <cstring>
+#include "network/Client.hpp"
+#include "network/Network.hpp"
+#include "utils/LatencyHistogram.hpp"
+#include "utils/Log.hpp"
+#include "Benchmark.hpp"
+
+using namespace ouzel;
+
+static const uint16_t PORT = 47123;
+static const uint32_t CLIENT_COUNT = 1000;
+static const uint32_t ROUNDS = 200;
+static const uint32_t MESSAGE_SIZE = 64;
+// the benchmark fails if the loopback stops making progress for this long
+static const std::chrono::seconds TIMEOUT(10);
+
+// every connection takes a descriptor on both ends
+static uint32_t getMaxClientCount(uint32_t clientCount)
+{
+#ifdef _WIN32
+    return clientCount;
+#else
+    rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) != 0) return clientCount;
+
+    rlim_t required = clientCount * 2 + 64;
+
+    if (limit.rlim_cur < required)
+    {
+        limit.rlim_cur = (limit.rlim_max == RLIM_INFINITY || limit.rlim_max >= required) ? required : limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+        getrlimit(RLIMIT_NOFILE, &limit);
+    }
+
+    if (limit.rlim_cur >= required) return clientCount;
+
+    return (limit.rlim_cur > 64) ? static_cast<uint32_t>((limit.rlim_cur - 64) / 2) : 1;
+#endif
+}
+
+// every client sends a timestamped message per round and waits for the echo before the next round
+static bool runEcho(uint32_t clientCount)
+{
+    network::Network server;
+    network::Network client;
+
+    if (!server.init() || !client.init()) return false;
+
+    server.messageHandler = [](network::Client* connection, const std::vector<uint8_t>& data) {
+        connection->send(data);
+    };
+
+    std::vector<network::Client*> connections;
+    LatencyHistogram latencies;
+    uint64_t received = 0;
+
+    client.connectHandler = [&connections](network::Client* connection) {
+        connections.push_back(connection);
+    };
+
+    client.messageHandler = [&latencies, &received](network::Client*, const std::vector<uint8_t>& data) {
+        std::chrono::steady_clock::rep sendTime;
+        memcpy(&sendTime, data.data(), sizeof(sendTime));
+        latencies.add(std::chrono::steady_clock::now().time_since_epoch() - std::chrono::steady_clock::duration(sendTime));
+        ++received;
+    };
+
+    if (!server.listen("127.0.0.1", PORT)) return false;
+
+    for (uint32_t i = 0; i < clientCount; ++i)
+        if (!client.connect("127.0.0.1", PORT)) return false;
+
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + TIMEOUT;
+
+    while (connections.size() < clientCount)
+    {
+        server.update();
+        client.update();
+
+        if (std::chrono::steady_clock::now() > deadline)
+        {
+            Log(Log::Level::ERR) << "Only " << connections.size() << " of " << clientCount << " clients connected";
+            return false;
+        }
+    }
+
+    uint8_t message[MESSAGE_SIZE] = {};
+    uint64_t sent = 0;
+    Timer timer;
+
+    for (uint32_t round = 0; round < ROUNDS; ++round)
+    {
+        for (network::Client* connection : connections)
+        {
+            std::chrono::steady_clock::rep sendTime = std::chrono::steady_clock::now().time_since_epoch().count();
+            memcpy(message, &sendTime, sizeof(sendTime));
+            connection->send(message, MESSAGE_SIZE);
+            ++sent;
+        }
+
+        deadline = std::chrono::steady_clock::now() + TIMEOUT;
+
+        while (received < sent)
+        {
+            client.update();
+            server.update();
+
+            if (std::chrono::steady_clock::now() > deadline)
+            {
+                Log(Log::Level::ERR) << "Received " << received << " of " << sent << " echoed messages";
+                return false;
+            }
+        }
+    }
+
+    double elapsed = timer.getElapsed();
+
+    Log(Log::Level::INFO) << clientCount << " clients: " << received << " round trips, " <<
+        received * 1000.0 / elapsed << " messages/s, latency mean " << latencies.getMean().count() <<
+        " us, p50 " << latencies.getPercentile(0.5F).count() <<
+        " us, p99 " << latencies.getPercentile(0.99F).count() <<
+        " us, max " << latencies.getMax().count() << " us";
+
+    client.disconnect();
+    server.disconnect();
+
+    return true;
+}
+
+bool runNetworkBenchmark()
+{
+    uint32_t clientCount = getMaxClientCount(CLIENT_COUNT);
+
+    if (clientCount < CLIENT_COUNT)
+        Log(Log::Level::WARN) << "Not enough file descriptors, running with " << clientCount << " clients";
+
+    return runEcho(1) && runEcho(clientCount);
+}
@@ -0,0 +1,242 @@
+// Copyright (C) 2018 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#include <string>
+#include "utils/OBF.hpp"
+#include "utils/OBFView.hpp"
+#include "utils/Log.hpp"
+#include "Benchmark.hpp"
+
+using namespace ouzel;
+
+static const uint32_t ENTITY_COUNT = 20000;
+static const uint32_t BLOB_SIZE = 4 * 1024 * 1024;
+static const uint32_t ITERATIONS = 10;
+
+enum EntityKey
+{
+    KEY_ID,
+    KEY_SCALE,
+    KEY_ANGLE,
+    KEY_NAME,
+    KEY_FLAGS
+};
+
+struct Summary
+{
+    uint64_t integerSum = 0;
+    double floatSum = 0.0;
+    size_t stringSize = 0;
+    size_t blobSize = 0;
+
+    bool operator==(const Summary& other) const
+    {
+        return integerSum == other.integerSum &&
+            floatSum == other.floatSum &&
+            stringSize == other.stringSize &&
+            blobSize == other.blobSize;
+    }
+};
+
+// save file with a large byte array and many small objects,
+// the dictionary keys are written in the order in which Value sorts them
+static void encodeValue(const std::vector<uint8_t>& blob, std::vector<uint8_t>& buffer)
+{
+    obf::Value root(obf::Value::Type::DICTIONARY);
+    obf::Value entities(obf::Value::Type::ARRAY);
+
+    for (uint32_t i = 0; i < ENTITY_COUNT; ++i)
+    {
+        obf::Value entity(obf::Value::Type::OBJECT);
+        entity[KEY_ID] = i;
+        entity[KEY_SCALE] = static_cast<float>(i) * 0.5F;
+        entity[KEY_ANGLE] = static_cast<double>(i) * 0.25;
+        entity[KEY_NAME] = "entity" + std::to_string(i);
+        entity[KEY_FLAGS] = static_cast<uint64_t>(i) << 40;
+        entities.append(entity);
+    }
+
+    root["entities"] = entities;
+    root["replay"] = blob;
+    root["version"] = static_cast<uint32_t>(3);
+
+    root.encode(buffer);
+}
+
+static bool encodeWriter(const std::vector<uint8_t>& blob, std::vector<uint8_t>& buffer)
+{
+    obf::Writer writer(buffer);
+    writer.beginDictionary();
+
+    writer.writeKey(std::string("entities"));
+    writer.beginArray();
+
+    for (uint32_t i = 0; i < ENTITY_COUNT; ++i)
+    {
+        writer.beginObject();
+        writer.writeKey(KEY_ID);
+        writer.writeInt(i);
+        writer.writeKey(KEY_SCALE);
+        writer.writeFloat(static_cast<float>(i) * 0.5F);
+        writer.writeKey(KEY_ANGLE);
+        writer.writeDouble(static_cast<double>(i) * 0.25);
+        writer.writeKey(KEY_NAME);
+        writer.writeString("entity" + std::to_string(i));
+        writer.writeKey(KEY_FLAGS);
+        writer.writeInt(static_cast<uint64_t>(i) << 40);
+        writer.endObject();
+    }
+
+    writer.endArray();
+
+    writer.writeKey(std::string("replay"));
+    writer.writeByteArray(blob);
+    writer.writeKey(std::string("version"));
+    writer.writeInt(3);
+
+    writer.endDictionary();
+
+    return writer.isComplete();
+}
+
+static bool decodeValue(const std::vector<uint8_t>& buffer, Summary& summary)
+{
+    obf::Value root;
+    if (!root.decode(buffer)) return false;
+
+    for (const obf::Value& entity : root["entities"].asVector())
+    {
+        summary.integerSum += entity[KEY_ID].asUInt32() + entity[KEY_FLAGS].asUInt64();
+        summary.floatSum += entity[KEY_SCALE].asFloat() + entity[KEY_ANGLE].asDouble();
+        summary.stringSize += entity[KEY_NAME].asString().length();
+    }
+
+    summary.blobSize = root["replay"].asByteArray().size();
+    summary.integerSum += root["version"].asUInt32();
+
+    return true;
+}
+
+static bool decodeView(const std::vector<uint8_t>& buffer, Summary& summary)
+{
+    obf::View root;
+    if (!root.init(buffer)) return false;
+
+    for (const obf::View& entity : root["entities"])
+    {
+        summary.integerSum += entity[KEY_ID].asUInt32() + entity[KEY_FLAGS].asUInt64();
+        summary.floatSum += entity[KEY_SCALE].asFloat() + entity[KEY_ANGLE].asDouble();
+        summary.stringSize += entity[KEY_NAME].asString().getLength();
+    }
+
+    summary.blobSize = root["replay"].getByteArraySize();
+    summary.integerSum += root["version"].asUInt32();
+
+    return true;
+}
+
+bool runOBFBenchmark()
+{
+    std::vector<uint8_t> blob(BLOB_SIZE);
+    for (uint32_t i = 0; i < BLOB_SIZE; ++i)
+        blob[i] = static_cast<uint8_t>(i * 31);
+
+    std::vector<uint8_t> valueBuffer;
+    std::vector<uint8_t> writerBuffer;
+    Summary valueSummary;
+    Summary viewSummary;
+    size_t valueEncodeMemory = 0;
+    size_t writerMemory = 0;
+    size_t valueDecodeMemory = 0;
+    size_t viewMemory = 0;
+    double valueEncodeTime = 0.0;
+    double writerTime = 0.0;
+    double valueDecodeTime = 0.0;
+    double viewTime = 0.0;
+
+    for (uint32_t i = 0; i < ITERATIONS; ++i)
+    {
+        valueBuffer.clear();
+        valueBuffer.shrink_to_fit();
+
+        size_t base = getAllocatedMemory();
+        resetPeakMemory();
+        Timer timer;
+
+        encodeValue(blob, valueBuffer);
+
+        valueEncodeTime += timer.getElapsed();
+        valueEncodeMemory = getPeakMemory() - base;
+    }
+
+    for (uint32_t i = 0; i < ITERATIONS; ++i)
+    {
+        writerBuffer.clear();
+        writerBuffer.shrink_to_fit();
+
+        size_t base = getAllocatedMemory();
+        resetPeakMemory();
+        Timer timer;
+
+        if (!encodeWriter(blob, writerBuffer)) return false;
+
+        writerTime += timer.getElapsed();
+        writerMemory = getPeakMemory() - base;
+    }
+
+    if (valueBuffer != writerBuffer)
+    {
+        Log(Log::Level::ERR) << "The encoders returned different data";
+        return false;
+    }
+
+    for (uint32_t i = 0; i < ITERATIONS; ++i)
+    {
+        size_t base = getAllocatedMemory();
+        resetPeakMemory();
+        Timer timer;
+
+        Summary summary;
+        if (!decodeValue(valueBuffer, summary)) return false;
+
+        valueDecodeTime += timer.getElapsed();
+        valueDecodeMemory = getPeakMemory() - base;
+
+        if (i == 0) valueSummary = summary;
+    }
+
+    for (uint32_t i = 0; i < ITERATIONS; ++i)
+    {
+        size_t base = getAllocatedMemory();
+        resetPeakMemory();
+        Timer timer;
+
+        Summary summary;
+        if (!decodeView(writerBuffer, summary)) return false;
+
+        viewTime += timer.getElapsed();
+        viewMemory = getPeakMemory() - base;
+
+        if (i == 0) viewSummary = summary;
+    }
+
+    double size = writerBuffer.size() / 1048576.0;
+
+    Log(Log::Level::INFO) << "OBF file with " << ENTITY_COUNT << " objects, " << size << " MB";
+    Log(Log::Level::INFO) << "obf::Value encode: " << valueEncodeTime / ITERATIONS << " ms, " <<
+        size * 1000.0 * ITERATIONS / valueEncodeTime << " MB/s, peak heap " << valueEncodeMemory / 1024 << " KB";
+    Log(Log::Level::INFO) << "obf::Writer: " << writerTime / ITERATIONS << " ms, " <<
+        size * 1000.0 * ITERATIONS / writerTime << " MB/s, peak heap " << writerMemory / 1024 << " KB";
+    Log(Log::Level::INFO) << "obf::Value decode: " << valueDecodeTime / ITERATIONS << " ms, " <<
+        size * 1000.0 * ITERATIONS / valueDecodeTime << " MB/s, peak heap " << valueDecodeMemory / 1024 << " KB";
+    Log(Log::Level::INFO) << "obf::View: " << viewTime / ITERATIONS << " ms, " <<
+        size * 1000.0 * ITERATIONS / viewTime << " MB/s, peak heap " << viewMemory / 1024 << " KB";
+
+    if (!(viewSummary == valueSummary))
+    {
+        Log(Log::Level::ERR) << "The decoders returned different values";
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,171 @@
+// Copyright (C) 2018 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <thread>
+#include "network/Client.hpp"
+#include "network/Network.hpp"
+#include "network/Replicator.hpp"
+#include "scene/Actor.hpp"
+#include "utils/Log.hpp"
+#include "Benchmark.hpp"
+
+using namespace ouzel;
+
+static const uint16_t PORT = 47124;
+static const uint32_t ACTOR_COUNT = 1000;
+static const uint32_t TICK_COUNT = 300;
+// the benchmark fails if the client does not connect for this long
+static const std::chrono::seconds TIMEOUT(10);
+
+// lets the network threads of both ends send and receive
+static void pump(network::Network& server, network::Network& client, uint32_t count)
+{
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        server.update();
+        client.update();
+    }
+}
+
+bool runReplicationBenchmark()
+{
+    network::Network server;
+    network::Network client;
+
+    if (!server.init() || !client.init()) return false;
+
+    network::Replicator sender;
+    network::Replicator receiver;
+    std::vector<std::unique_ptr<scene::Actor>> serverActors;
+    std::vector<std::unique_ptr<scene::Actor>> clientActors;
+
+    for (uint32_t i = 0; i < ACTOR_COUNT; ++i)
+    {
+        std::unique_ptr<scene::Actor> actor(new scene::Actor());
+        actor->setPosition(Vector3(i * 10.0F, i * 3.0F, 0.0F));
+        sender.addActor(i, actor.get());
+        serverActors.push_back(std::move(actor));
+    }
+
+    receiver.createHandler = [&clientActors](uint32_t) {
+        clientActors.emplace_back(new scene::Actor());
+        return clientActors.back().get();
+    };
+
+    bool connected = false;
+
+    server.connectHandler = [&sender](network::Client* connection) {
+        sender.addClient(connection);
+    };
+    server.messageHandler = [&sender](network::Client* connection, const std::vector<uint8_t>& data) {
+        sender.handleMessage(connection, data);
+    };
+    client.connectHandler = [&connected](network::Client*) {
+        connected = true;
+    };
+    client.messageHandler = [&receiver](network::Client* connection, const std::vector<uint8_t>& data) {
+        receiver.handleMessage(connection, data);
+    };
+
+    if (!server.listen("127.0.0.1", PORT) ||
+        !client.connect("127.0.0.1", PORT)) return false;
+
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + TIMEOUT;
+
+    while (!connected)
+    {
+        pump(server, client, 1);
+
+        if (std::chrono::steady_clock::now() > deadline)
+        {
+            Log(Log::Level::ERR) << "The client did not connect";
+            return false;
+        }
+    }
+
+    // wait for the server to register the client
+    pump(server, client, 10);
+
+    std::mt19937 random(1);
+    std::uniform_int_distribution<uint32_t> index(0, ACTOR_COUNT - 1);
+    uint64_t fullSnapshotSize = 0;
+    uint64_t totalSize = 0;
+
+    for (uint32_t tick = 0; tick < TICK_COUNT; ++tick)
+    {
+        // every tick a tenth of the actors move and rotate and one of them fades
+        for (uint32_t i = 0; i < ACTOR_COUNT / 10; ++i)
+        {
+            scene::Actor* actor = serverActors[index(random)].get();
+            actor->setPosition(actor->getPosition() + Vector3(1.5F, -0.75F, 0.0F));
+            actor->setRotation(tick * 0.01F);
+        }
+
+        serverActors[tick % ACTOR_COUNT]->setOpacity(0.5F);
+
+        sender.update();
+
+        if (tick == 0)
+            fullSnapshotSize = sender.getLastTickBytes();
+        else
+            totalSize += sender.getLastTickBytes();
+
+        pump(server, client, 3);
+    }
+
+    // let the receiver catch up with the last ticks
+    for (uint32_t i = 0; i < 50; ++i)
+    {
+        sender.update();
+        pump(server, client, 2);
+    }
+
+    float maxPositionError = 0.0F;
+    float maxRotationError = 0.0F;
+
+    for (uint32_t i = 0; i < ACTOR_COUNT; ++i)
+    {
+        scene::Actor* original = serverActors[i].get();
+        scene::Actor* replica = receiver.getActor(i);
+
+        if (!replica)
+        {
+            Log(Log::Level::ERR) << "Actor " << i << " was not replicated";
+            return false;
+        }
+
+        const Quaternion& a = original->getRotation();
+        const Quaternion& b = replica->getRotation();
+
+        maxPositionError = std::max(maxPositionError, (replica->getPosition() - original->getPosition()).length());
+        maxRotationError = std::max(maxRotationError, 1.0F - std::fabs(a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w));
+
+        if (std::fabs(replica->getOpacity() - original->getOpacity()) > 0.01F)
+        {
+            Log(Log::Level::ERR) << "Opacity of actor " << i << " was not replicated";
+            return false;
+        }
+    }
+
+    Log(Log::Level::INFO) << ACTOR_COUNT << " actors, " << TICK_COUNT << " ticks: full snapshot " <<
+        fullSnapshotSize << " bytes, " << totalSize / (TICK_COUNT - 1) << " bytes/tick, " <<
+        sender.getFullSnapshotCount() << " full snapshots, max position error " << maxPositionError <<
+        ", max rotation error " << maxRotationError;
+
+    client.disconnect();
+    server.disconnect();
+
+    if (maxPositionError > 0.01F || maxRotationError > 0.001F)
+    {
+        Log(Log::Level::ERR) << "The replicated actors did not converge";
+        return false;
+    }
+
+    return true;
+}
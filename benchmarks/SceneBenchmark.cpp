@@ -0,0 +1,121 @@
+// Copyright (C) 2018 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include "scene/Actor.hpp"
+#include "utils/Log.hpp"
+#include "Benchmark.hpp"
+
+using namespace ouzel;
+
+static const uint32_t CHAIN_COUNT = 1000;
+static const uint32_t CHAIN_LENGTH = 100;
+static const uint32_t FRAME_COUNT = 60;
+
+static void move(const std::vector<std::unique_ptr<scene::Actor>>& actors, uint32_t frame, bool rotate3D)
+{
+    for (uint32_t i = 0; i < actors.size(); ++i)
+    {
+        scene::Actor* actor = actors[i].get();
+        float angle = frame * 0.01F + i * 0.001F;
+
+        actor->setPosition(Vector3(1.0F + frame * 0.01F, 0.5F, 0.0F));
+
+        if (rotate3D)
+        {
+            Quaternion rotation;
+            rotation.rotate(angle, Vector3(0.3F, 0.5F, 0.8F));
+            actor->setRotation(rotation);
+        }
+        else
+            actor->setRotation(angle);
+    }
+}
+
+// compares the world transforms of some of the chains with the ones composed by general matrix multiplication
+static float getMaxError(const std::vector<std::unique_ptr<scene::Actor>>& actors)
+{
+    float maxError = 0.0F;
+
+    for (uint32_t chain = 0; chain < CHAIN_COUNT; chain += 97)
+    {
+        Matrix4 transform = Matrix4::IDENTITY;
+
+        for (uint32_t i = 0; i < CHAIN_LENGTH; ++i)
+        {
+            const scene::Actor* actor = actors[chain * CHAIN_LENGTH + i].get();
+
+            Matrix4 localTransform = Matrix4::IDENTITY;
+            localTransform.translate(actor->getPosition());
+            localTransform *= actor->getRotation().getMatrix();
+            localTransform.scale(actor->getScale());
+
+            transform = transform * localTransform;
+
+            const Matrix4& worldTransform = actor->getTransform();
+
+            for (uint32_t e = 0; e < 16; ++e)
+                maxError = std::max(maxError, std::fabs(worldTransform.m[e] - transform.m[e]) / std::max(1.0F, std::fabs(transform.m[e])));
+        }
+    }
+
+    return maxError;
+}
+
+static bool runFrames(bool rotate3D)
+{
+    scene::Actor root;
+    std::vector<std::unique_ptr<scene::Actor>> actors;
+
+    for (uint32_t chain = 0; chain < CHAIN_COUNT; ++chain)
+    {
+        scene::Actor* parent = &root;
+
+        for (uint32_t i = 0; i < CHAIN_LENGTH; ++i)
+        {
+            std::unique_ptr<scene::Actor> actor(new scene::Actor());
+            actor->setScale(Vector3(1.01F, 0.99F, 1.0F));
+            parent->addChild(actor.get());
+            parent = actor.get();
+            actors.push_back(std::move(actor));
+        }
+    }
+
+    // the actors have no components, so nothing is culled against the camera or queued for drawing,
+    // the root is not in a layer so its parent transform is passed on every visit
+    std::vector<scene::Actor*> drawQueue;
+    double moveTime = 0.0;
+    double visitTime = 0.0;
+
+    for (uint32_t frame = 0; frame < FRAME_COUNT; ++frame)
+    {
+        Timer timer;
+        move(actors, frame, rotate3D);
+        moveTime += timer.getElapsed();
+
+        timer.reset();
+        root.visit(drawQueue, Matrix4::IDENTITY, true, nullptr, 0, false);
+        visitTime += timer.getElapsed();
+    }
+
+    float maxError = getMaxError(actors);
+
+    Log(Log::Level::INFO) << actors.size() << " actors with " << (rotate3D ? "3D" : "2D") << " rotations: " <<
+        "moving " << moveTime / FRAME_COUNT << " ms/frame, visiting " << visitTime / FRAME_COUNT <<
+        " ms/frame, max error " << maxError;
+
+    if (maxError > 0.001F)
+    {
+        Log(Log::Level::ERR) << "The world transforms are wrong";
+        return false;
+    }
+
+    return true;
+}
+
+bool runSceneBenchmark()
+{
+    return runFrames(false) && runFrames(true);
+}
@@ -0,0 +1,203 @@
+// Copyright (C) 2018 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#include <random>
+#include <string>
+#include "utils/XML.hpp"
+#include "utils/XMLReader.hpp"
+#include "utils/Log.hpp"
+#include "Benchmark.hpp"
+
+using namespace ouzel;
+
+static const uint32_t VERTEX_COUNT = 20000;
+static const uint32_t TRIANGLE_COUNT = 30000;
+static const uint32_t ITERATIONS = 10;
+
+struct Summary
+{
+    uint32_t elementCount = 0;
+    size_t nameSize = 0;
+    uint32_t textCount = 0;
+    size_t textSize = 0;
+
+    bool operator==(const Summary& other) const
+    {
+        return elementCount == other.elementCount &&
+            nameSize == other.nameSize &&
+            textCount == other.textCount &&
+            textSize == other.textSize;
+    }
+};
+
+static void appendFloats(std::string& result, std::mt19937& random, uint32_t count)
+{
+    std::uniform_real_distribution<float> distribution(-100.0F, 100.0F);
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        if (i > 0) result += ' ';
+        result += std::to_string(distribution(random));
+    }
+}
+
+// Collada file with a single indexed triangle mesh
+static std::string generateCollada()
+{
+    std::mt19937 random(2);
+
+    std::string result = "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n"
+        "<COLLADA xmlns=\"http://www.collada.org/2005/11/COLLADASchema\" version=\"1.4.1\">\n"
+        "  <asset><contributor><author>ouzel &amp; co</author></contributor><up_axis>Y_UP</up_axis></asset>\n"
+        "  <library_geometries>\n"
+        "    <geometry id=\"mesh\" name=\"mesh\"><mesh>\n";
+
+    static const struct
+    {
+        const char* id;
+        uint32_t stride;
+    } SOURCES[] = {{"position", 3}, {"normal", 3}, {"texcoord", 2}};
+
+    for (const auto& source : SOURCES)
+    {
+        result += std::string("      <source id=\"") + source.id + "\"><float_array id=\"" + source.id +
+            "-array\" count=\"" + std::to_string(VERTEX_COUNT * source.stride) + "\">";
+        appendFloats(result, random, VERTEX_COUNT * source.stride);
+        result += "</float_array>\n";
+        result += std::string("        <technique_common><accessor source=\"#") + source.id + "-array\" count=\"" +
+            std::to_string(VERTEX_COUNT) + "\" stride=\"" + std::to_string(source.stride) +
+            "\"><param name=\"X\" type=\"float\"/></accessor></technique_common></source>\n";
+    }
+
+    result += "      <vertices id=\"vertices\"><input semantic=\"POSITION\" source=\"#position\"/></vertices>\n"
+        "      <triangles count=\"" + std::to_string(TRIANGLE_COUNT) + "\">"
+        "<input semantic=\"VERTEX\" source=\"#vertices\" offset=\"0\"/>"
+        "<input semantic=\"NORMAL\" source=\"#normal\" offset=\"1\"/>"
+        "<input semantic=\"TEXCOORD\" source=\"#texcoord\" offset=\"2\" set=\"0\"/>\n        <p>";
+
+    std::uniform_int_distribution<uint32_t> index(0, VERTEX_COUNT - 1);
+
+    for (uint32_t i = 0; i < TRIANGLE_COUNT * 3; ++i)
+    {
+        if (i > 0) result += ' ';
+        std::string value = std::to_string(index(random));
+        result += value + ' ' + value + ' ' + value;
+    }
+
+    result += "</p></triangles>\n"
+        "    </mesh></geometry>\n"
+        "  </library_geometries>\n"
+        "  <!-- generated -->\n"
+        "  <scene><instance_visual_scene url=\"#scene\"/></scene>\n"
+        "</COLLADA>\n";
+
+    return result;
+}
+
+static void summarize(const std::vector<xml::Node>& nodes, Summary& summary)
+{
+    for (const xml::Node& node : nodes)
+    {
+        if (node.getType() == xml::Node::Type::TAG)
+        {
+            ++summary.elementCount;
+            summary.nameSize += node.getValue().length();
+            summarize(node.getChildren(), summary);
+        }
+        else if (node.getType() == xml::Node::Type::TEXT)
+        {
+            ++summary.textCount;
+            summary.textSize += node.getValue().length();
+        }
+    }
+}
+
+static bool summarize(xml::Reader& reader, Summary& summary)
+{
+    std::string text;
+
+    for (;;)
+    {
+        switch (reader.next())
+        {
+            case xml::Reader::Event::START_ELEMENT:
+                ++summary.elementCount;
+                summary.nameSize += reader.getName().getLength();
+                break;
+            case xml::Reader::Event::TEXT:
+                if (!reader.getText(text)) return false;
+                ++summary.textCount;
+                summary.textSize += text.length();
+                break;
+            case xml::Reader::Event::END:
+                return true;
+            case xml::Reader::Event::ERROR:
+                return false;
+            default:
+                break;
+        }
+    }
+}
+
+bool runXMLBenchmark()
+{
+    std::string collada = generateCollada();
+    std::vector<uint8_t> data(collada.begin(), collada.end());
+    collada.clear();
+    collada.shrink_to_fit();
+
+    Summary dataSummary;
+    Summary readerSummary;
+    size_t dataMemory = 0;
+    size_t readerMemory = 0;
+    double dataTime = 0.0;
+    double readerTime = 0.0;
+
+    for (uint32_t i = 0; i < ITERATIONS; ++i)
+    {
+        size_t base = getAllocatedMemory();
+        resetPeakMemory();
+        Timer timer;
+
+        xml::Data document;
+        if (!document.init(data)) return false;
+
+        dataTime += timer.getElapsed();
+        dataMemory = getPeakMemory() - base;
+
+        if (i == 0) summarize(document.getChildren(), dataSummary);
+    }
+
+    for (uint32_t i = 0; i < ITERATIONS; ++i)
+    {
+        size_t base = getAllocatedMemory();
+        resetPeakMemory();
+        Timer timer;
+
+        xml::Reader reader(data.data(), data.data() + data.size());
+        Summary summary;
+        if (!summarize(reader, summary)) return false;
+
+        readerTime += timer.getElapsed();
+        readerMemory = getPeakMemory() - base;
+
+        if (i == 0) readerSummary = summary;
+    }
+
+    double size = data.size() / 1048576.0;
+
+    Log(Log::Level::INFO) << "Collada file with " << VERTEX_COUNT << " vertices and " <<
+        TRIANGLE_COUNT << " triangles, " << size << " MB";
+    Log(Log::Level::INFO) << "xml::Data: " << dataTime / ITERATIONS << " ms, " <<
+        size * 1000.0 * ITERATIONS / dataTime << " MB/s, peak heap " << dataMemory / 1024 << " KB";
+    Log(Log::Level::INFO) << "xml::Reader: " << readerTime / ITERATIONS << " ms, " <<
+        size * 1000.0 * ITERATIONS / readerTime << " MB/s, peak heap " << readerMemory / 1024 << " KB";
+
+    if (!(readerSummary == dataSummary))
+    {
+        Log(Log::Level::ERR) << "The parsers returned different values";
+        return false;
+    }
+
+    return true;
+}
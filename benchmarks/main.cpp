@@ -0,0 +1,84 @@
+// Copyright (C) 2018 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#include <algorithm>
+#include "ouzel.hpp"
+#include "Benchmark.hpp"
+
+std::string DEVELOPER_NAME = "org.ouzel";
+std::string APPLICATION_NAME = "benchmarks";
+
+using namespace ouzel;
+
+struct Benchmark
+{
+    const char* name;
+    bool (*run)();
+};
+
+static const Benchmark BENCHMARKS[] = {
+    {"json", runJSONBenchmark},
+    {"log", runLogBenchmark},
+    {"math", runMathBenchmark},
+    {"network", runNetworkBenchmark},
+    {"obf", runOBFBenchmark},
+    {"replication", runReplicationBenchmark},
+    {"scene", runSceneBenchmark},
+    {"xml", runXMLBenchmark}
+};
+
+void ouzelMain(const std::vector<std::string>& args)
+{
+    std::vector<std::string> selected;
+
+    for (auto arg = args.begin(); arg != args.end(); ++arg)
+    {
+        if (arg == args.begin())
+        {
+            // skip the first parameter
+            continue;
+        }
+
+        if (*arg == "-benchmark")
+        {
+            auto nextArg = ++arg;
+
+            if (nextArg != args.end())
+            {
+                selected.push_back(*nextArg);
+            }
+            else
+            {
+                Log(Log::Level::WARN) << "No benchmark specified";
+                break;
+            }
+        }
+        else
+        {
+            Log(Log::Level::WARN) << "Invalid argument \"" << *arg << "\"";
+        }
+    }
+
+    uint32_t failed = 0;
+
+    // all of the benchmarks are run if none is selected
+    for (const Benchmark& benchmark : BENCHMARKS)
+    {
+        if (!selected.empty() &&
+            std::find(selected.begin(), selected.end(), benchmark.name) == selected.end())
+            continue;
+
+        Log(Log::Level::INFO) << "Running the " << benchmark.name << " benchmark";
+
+        if (!benchmark.run())
+        {
+            Log(Log::Level::ERR) << "The " << benchmark.name << " benchmark failed";
+            ++failed;
+        }
+    }
+
+    if (failed) Log(Log::Level::ERR) << failed << " benchmarks failed";
+
+    Log::flush();
+    engine->exit();
+}
@@ -37,12 +37,14 @@ LOCAL_SRC_FILES :=../../ouzel/animators/Animator.cpp \
     ../../ouzel/assets/LoaderTTF.cpp \
     ../../ouzel/assets/LoaderVorbis.cpp \
     ../../ouzel/assets/LoaderWave.cpp \
+    ../../ouzel/assets/TextureAtlas.cpp \
     ../../ouzel/audio/empty/AudioDeviceEmpty.cpp \
     ../../ouzel/audio/opensl/AudioDeviceSL.cpp \
     ../../ouzel/audio/Audio.cpp \
     ../../ouzel/audio/AudioDevice.cpp \
     ../../ouzel/audio/Listener.cpp \
     ../../ouzel/audio/Mixer.cpp \
+    ../../ouzel/audio/Resampler.cpp \
     ../../ouzel/audio/Sound.cpp \
     ../../ouzel/audio/SoundData.cpp \
     ../../ouzel/audio/SoundDataVorbis.cpp \
@@ -65,6 +67,7 @@ LOCAL_SRC_FILES :=../../ouzel/animators/Animator.cpp \
     ../../ouzel/files/android/FileSystemAndroid.cpp \
     ../../ouzel/files/Archive.cpp \
     ../../ouzel/files/FileSystem.cpp \
+    ../../ouzel/files/MappedFile.cpp \
     ../../ouzel/graphics/empty/BlendStateResourceEmpty.cpp \
     ../../ouzel/graphics/empty/BufferResourceEmpty.cpp \
     ../../ouzel/graphics/empty/MeshBufferResourceEmpty.cpp \
@@ -102,6 +105,7 @@ LOCAL_SRC_FILES :=../../ouzel/animators/Animator.cpp \
     ../../ouzel/gui/EditBox.cpp \
     ../../ouzel/gui/Font.cpp \
     ../../ouzel/gui/Label.cpp \
+    ../../ouzel/gui/ListView.cpp \
     ../../ouzel/gui/Menu.cpp \
     ../../ouzel/gui/RadioButton.cpp \
     ../../ouzel/gui/RadioButtonGroup.cpp \
@@ -109,6 +113,7 @@ LOCAL_SRC_FILES :=../../ouzel/animators/Animator.cpp \
     ../../ouzel/gui/ScrollBar.cpp \
     ../../ouzel/gui/SlideBar.cpp \
     ../../ouzel/gui/Widget.cpp \
+    ../../ouzel/gui/WidgetBatch.cpp \
     ../../ouzel/input/android/GamepadAndroid.cpp \
     ../../ouzel/input/android/InputAndroid.cpp \
     ../../ouzel/input/Cursor.cpp \
@@ -121,6 +126,7 @@ LOCAL_SRC_FILES :=../../ouzel/animators/Animator.cpp \
     ../../ouzel/math/Box3.cpp \
     ../../ouzel/math/Color.cpp \
     ../../ouzel/math/ConvexVolume.cpp \
+    ../../ouzel/math/MathBatch.cpp \
     ../../ouzel/math/MathUtils.cpp \
     ../../ouzel/math/Matrix3.cpp \
     ../../ouzel/math/Matrix4.cpp \
@@ -134,12 +140,15 @@ LOCAL_SRC_FILES :=../../ouzel/animators/Animator.cpp \
     ../../ouzel/math/Vector4.cpp \
     ../../ouzel/network/Client.cpp \
     ../../ouzel/network/Network.cpp \
+    ../../ouzel/network/Replicator.cpp \
     ../../ouzel/scene/Actor.cpp \
     ../../ouzel/scene/ActorContainer.cpp \
     ../../ouzel/scene/Camera.cpp \
     ../../ouzel/scene/Component.cpp \
+    ../../ouzel/scene/DebugRenderer.cpp \
     ../../ouzel/scene/Layer.cpp \
     ../../ouzel/scene/Light.cpp \
+    ../../ouzel/scene/LightGrid.cpp \
     ../../ouzel/scene/ModelData.cpp \
     ../../ouzel/scene/ModelRenderer.cpp \
     ../../ouzel/scene/ParticleSystem.cpp \
@@ -153,10 +162,15 @@ LOCAL_SRC_FILES :=../../ouzel/animators/Animator.cpp \
     ../../ouzel/scene/TextRenderer.cpp \
     ../../ouzel/utils/INI.cpp \
     ../../ouzel/utils/JSON.cpp \
+    ../../ouzel/utils/JSONDocument.cpp \
+    ../../ouzel/utils/JSONReader.cpp \
+    ../../ouzel/utils/LatencyHistogram.cpp \
     ../../ouzel/utils/Log.cpp \
     ../../ouzel/utils/OBF.cpp \
+    ../../ouzel/utils/OBFView.cpp \
     ../../ouzel/utils/Utils.cpp \
-    ../../ouzel/utils/XML.cpp
+    ../../ouzel/utils/XML.cpp \
+    ../../ouzel/utils/XMLReader.cpp
 
 include $(BUILD_STATIC_LIBRARY)
 $(call import-module, android/cpufeatures)
\ No newline at end of file
@@ -6,6 +6,7 @@
 #include "Cache.hpp"
 #include "Loader.hpp"
 #include "core/Engine.hpp"
+#include "graphics/ImageDataSTB.hpp"
 #include "graphics/Renderer.hpp"
 #include "graphics/TextureResource.hpp"
 #include "graphics/ShaderResource.hpp"
@@ -34,6 +35,10 @@ namespace ouzel
             addLoader(&loaderTTF);
             addLoader(&loaderVorbis);
             addLoader(&loaderWave);
+
+            evictionCallback.callback = [this](float) {
+                evict();
+            };
         }
 
         Cache::~Cache()
@@ -153,16 +158,93 @@ namespace ouzel
                 }
             }
 
+            touchAsset(Category::TEXTURE, filename);
+
             return i->second;
         }
 
+        static uint64_t getAssetSize(const std::shared_ptr<graphics::Texture>& texture)
+        {
+            if (!texture) return 0;
+
+            uint64_t size = static_cast<uint64_t>(texture->getSize().width) *
+                static_cast<uint64_t>(texture->getSize().height) *
+                graphics::getPixelSize(texture->getPixelFormat()) *
+                texture->getSampleCount();
+
+            // a full mip chain adds a third of the base level
+            if (texture->getMipmaps() != 1) size += size / 3;
+
+            return size;
+        }
+
         void Cache::setTexture(const std::string& filename, const std::shared_ptr<graphics::Texture>& texture)
         {
             textures[filename] = texture;
+            addAsset(Category::TEXTURE, filename, getAssetSize(texture));
+        }
+
+        bool Cache::getTextureRegion(const std::string& filename, bool mipmaps, TextureAtlas::Region& region) const
+        {
+            // atlas pages have no mip chains, so mipmapped images keep their own texture
+            if (!mipmaps && textureAtlas.getRegion(filename, region))
+            {
+                return true;
+            }
+
+            std::string extension = engine->getFileSystem()->getExtensionPart(filename);
+            std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c){ return std::tolower(c); });
+
+            // images that are already loaded or can't be decoded here keep their own texture
+            if (!mipmaps &&
+                textureAtlas.isEnabled() &&
+                textures.find(filename) == textures.end() &&
+                std::find(loaderImage.extensions.begin(), loaderImage.extensions.end(), extension) != loaderImage.extensions.end())
+            {
+                std::vector<uint8_t> data;
+                if (!engine->getFileSystem()->readFile(filename, data))
+                {
+                    return false;
+                }
+
+                graphics::ImageDataSTB image;
+                if (!image.init(data))
+                {
+                    return false;
+                }
+
+                if (textureAtlas.addImage(filename, image, region))
+                {
+                    return true;
+                }
+
+                std::shared_ptr<graphics::Texture> texture(new graphics::Texture());
+
+                if (!texture->init(image.getData(), image.getSize(), 0, 1, image.getPixelFormat()))
+                {
+                    return false;
+                }
+
+                textures[filename] = texture;
+                addAsset(Category::TEXTURE, filename, getAssetSize(texture));
+            }
+
+            region.texture = getTexture(filename, mipmaps);
+
+            if (!region.texture)
+            {
+                return false;
+            }
+
+            region.rectangle = Rectangle(Vector2(), region.texture->getSize());
+
+            return true;
         }
 
         void Cache::releaseTextures()
         {
+            textureAtlas.clear();
+
             for (auto i = textures.begin(); i != textures.end();)
             {
                 // don't delete white pixel texture
@@ -172,6 +254,7 @@ namespace ouzel
                 }
                 else
                 {
+                    removeAsset(Category::TEXTURE, i->first);
                     i = textures.erase(i);
                 }
             }
@@ -183,6 +266,8 @@ namespace ouzel
 
             if (i != shaders.end())
             {
+                touchAsset(Category::SHADER, shaderName);
+
                 return i->second;
             }
             else
@@ -196,6 +281,7 @@ namespace ouzel
         void Cache::setShader(const std::string& shaderName, const std::shared_ptr<graphics::Shader>& shader)
         {
             shaders[shaderName] = shader;
+            addAsset(Category::SHADER, shaderName, shader ? sizeof(graphics::Shader) : 0);
         }
 
         void Cache::releaseShaders()
@@ -204,12 +290,14 @@ namespace ouzel
             {
                 // don't delete default shaders
                 if (i->first == graphics::SHADER_COLOR ||
-                    i->first == graphics::SHADER_TEXTURE)
+                    i->first == graphics::SHADER_TEXTURE ||
+                    i->first == graphics::SHADER_LIGHTING)
                 {
                     ++i;
                 }
                 else
                 {
+                    removeAsset(Category::SHADER, i->first);
                     i = shaders.erase(i);
                 }
             }
@@ -221,6 +309,8 @@ namespace ouzel
 
             if (i != blendStates.end())
             {
+                touchAsset(Category::BLEND_STATE, blendStateName);
+
                 return i->second;
             }
             else
@@ -234,6 +324,7 @@ namespace ouzel
         void Cache::setBlendState(const std::string& blendStateName, const std::shared_ptr<graphics::BlendState>& blendState)
         {
             blendStates[blendStateName] = blendState;
+            addAsset(Category::BLEND_STATE, blendStateName, blendState ? sizeof(graphics::BlendState) : 0);
         }
 
         void Cache::releaseBlendStates()
@@ -244,17 +335,41 @@ namespace ouzel
                 if (i->first == graphics::BLEND_NO_BLEND ||
                     i->first == graphics::BLEND_ADD ||
                     i->first == graphics::BLEND_MULTIPLY ||
-                    i->first == graphics::BLEND_ALPHA)
+                    i->first == graphics::BLEND_ALPHA ||
+                    i->first == graphics::BLEND_PREMULTIPLIED_ALPHA)
                 {
                     ++i;
                 }
                 else
                 {
+                    removeAsset(Category::BLEND_STATE, i->first);
                     i = blendStates.erase(i);
                 }
             }
         }
 
+        static uint64_t getAssetSize(const scene::SpriteData& newSpriteData)
+        {
+            uint64_t size = newSpriteData.frames.size() * sizeof(scene::SpriteFrame);
+
+            if (!newSpriteData.frames.empty() && newSpriteData.frames.front().getMeshBuffer())
+            {
+                const std::shared_ptr<graphics::MeshBuffer>& meshBuffer = newSpriteData.frames.front().getMeshBuffer();
+                if (meshBuffer->getIndexBuffer()) size += meshBuffer->getIndexBuffer()->getSize();
+                if (meshBuffer->getVertexBuffer()) size += meshBuffer->getVertexBuffer()->getSize();
+            }
+
+            return size;
+        }
+
+        static uint64_t getAssetSize(const scene::ModelData& newModelData)
+        {
+            uint64_t size = 0;
+            if (newModelData.indexBuffer) size += newModelData.indexBuffer->getSize();
+            if (newModelData.vertexBuffer) size += newModelData.vertexBuffer->getSize();
+            return size;
+        }
+
         bool Cache::preloadSpriteData(const std::string& filename, bool mipmaps,
                                             uint32_t spritesX, uint32_t spritesY,
                                             const Vector2& pivot)
@@ -272,22 +387,24 @@ namespace ouzel
             }
             else
             {
-                newSpriteData.texture = engine->getCache()->getTexture(filename, mipmaps);
+                TextureAtlas::Region region;
 
-                if (newSpriteData.texture)
+                if (!getTextureRegion(filename, mipmaps, region))
                 {
                     return false;
                 }
 
-                Size2 spriteSize = Size2(newSpriteData.texture->getSize().width / spritesX,
-                                         newSpriteData.texture->getSize().height / spritesY);
+                newSpriteData.texture = region.texture;
+
+                Size2 spriteSize = Size2(region.rectangle.size.width / spritesX,
+                                         region.rectangle.size.height / spritesY);
 
                 for (uint32_t x = 0; x < spritesX; ++x)
                 {
                     for (uint32_t y = 0; y < spritesY; ++y)
                     {
-                        Rectangle rectangle(spriteSize.width * x,
-                                            spriteSize.height * y,
+                        Rectangle rectangle(region.rectangle.position.x + spriteSize.width * x,
+                                            region.rectangle.position.y + spriteSize.height * y,
                                             spriteSize.width,
                                             spriteSize.height);
 
@@ -295,9 +412,15 @@ namespace ouzel
                         newSpriteData.frames.push_back(frame);
                     }
                 }
+
+                if (!scene::SpriteFrame::createMeshBuffer(newSpriteData.frames))
+                {
+                    return false;
+                }
             }
 
             spriteData[filename] = newSpriteData;
+            addAsset(Category::SPRITE_DATA, filename, getAssetSize(newSpriteData));
 
             return true;
         }
@@ -310,6 +433,8 @@ namespace ouzel
 
             if (i != spriteData.end())
             {
+                touchAsset(Category::SPRITE_DATA, filename);
+
                 return i->second;
             }
             else
@@ -324,19 +449,21 @@ namespace ouzel
                 }
                 else if (spritesX > 0 && spritesY > 0)
                 {
-                    newSpriteData.texture = engine->getCache()->getTexture(filename, mipmaps);
+                    TextureAtlas::Region region;
 
-                    if (newSpriteData.texture)
+                    if (getTextureRegion(filename, mipmaps, region))
                     {
-                        Size2 spriteSize = Size2(newSpriteData.texture->getSize().width / spritesX,
-                                                 newSpriteData.texture->getSize().height / spritesY);
+                        newSpriteData.texture = region.texture;
+
+                        Size2 spriteSize = Size2(region.rectangle.size.width / spritesX,
+                                                 region.rectangle.size.height / spritesY);
 
                         for (uint32_t x = 0; x < spritesX; ++x)
                         {
                             for (uint32_t y = 0; y < spritesY; ++y)
                             {
-                                Rectangle rectangle(spriteSize.width * x,
-                                                    spriteSize.height * y,
+                                Rectangle rectangle(region.rectangle.position.x + spriteSize.width * x,
+                                                    region.rectangle.position.y + spriteSize.height * y,
                                                     spriteSize.width,
                                                     spriteSize.height);
 
@@ -344,10 +471,16 @@ namespace ouzel
                                 newSpriteData.frames.push_back(frame);
                             }
                         }
+
+                        if (!scene::SpriteFrame::createMeshBuffer(newSpriteData.frames))
+                        {
+                            Log(Log::Level::ERR) << "Failed to create mesh buffer for sprite frames of " << filename;
+                        }
                     }
                 }
 
                 i = spriteData.insert(std::make_pair(filename, newSpriteData)).first;
+                addAsset(Category::SPRITE_DATA, filename, getAssetSize(newSpriteData));
 
                 return i->second;
             }
@@ -356,11 +489,13 @@ namespace ouzel
         void Cache::setSpriteData(const std::string& filename, const scene::SpriteData& newSpriteData)
         {
             spriteData[filename] = newSpriteData;
+            addAsset(Category::SPRITE_DATA, filename, getAssetSize(newSpriteData));
         }
 
         void Cache::releaseSpriteData()
         {
             spriteData.clear();
+            removeAssets(Category::SPRITE_DATA);
         }
 
         const scene::ParticleSystemData& Cache::getParticleSystemData(const std::string& filename, bool mipmaps) const
@@ -380,17 +515,21 @@ namespace ouzel
                 }
             }
 
+            touchAsset(Category::PARTICLE_SYSTEM_DATA, filename);
+
             return i->second;
         }
 
         void Cache::setParticleSystemData(const std::string& filename, const scene::ParticleSystemData& newParticleSystemData)
         {
             particleSystemData[filename] = newParticleSystemData;
+            addAsset(Category::PARTICLE_SYSTEM_DATA, filename, sizeof(scene::ParticleSystemData));
         }
 
         void Cache::releaseParticleSystemData()
         {
             particleSystemData.clear();
+            removeAssets(Category::PARTICLE_SYSTEM_DATA);
         }
 
         const std::shared_ptr<Font>& Cache::getFont(const std::string& filename, bool mipmaps) const
@@ -410,17 +549,21 @@ namespace ouzel
                 }
             }
 
+            touchAsset(Category::FONT, filename);
+
             return i->second;
         }
 
         void Cache::setFont(const std::string& filename, const std::shared_ptr<Font>& font)
         {
             fonts[filename] = font;
+            addAsset(Category::FONT, filename, font ? font->getDataSize() : 0);
         }
 
         void Cache::releaseFonts()
         {
             fonts.clear();
+            removeAssets(Category::FONT);
         }
 
         const std::shared_ptr<audio::SoundData>& Cache::getSoundData(const std::string& filename) const
@@ -440,17 +583,21 @@ namespace ouzel
                 }
             }
 
+            touchAsset(Category::SOUND_DATA, filename);
+
             return i->second;
         }
 
         void Cache::setSoundData(const std::string& filename, const std::shared_ptr<audio::SoundData>& newSoundData)
         {
             soundData[filename] = newSoundData;
+            addAsset(Category::SOUND_DATA, filename, newSoundData ? newSoundData->getDataSize() : 0);
         }
 
         void Cache::releaseSoundData()
         {
             soundData.clear();
+            removeAssets(Category::SOUND_DATA);
         }
 
         const std::shared_ptr<graphics::Material>& Cache::getMaterial(const std::string& filename, bool mipmaps) const
@@ -470,17 +617,21 @@ namespace ouzel
                 }
             }
 
+            touchAsset(Category::MATERIAL, filename);
+
             return i->second;
         }
 
         void Cache::setMaterial(const std::string& filename, const std::shared_ptr<graphics::Material>& material)
         {
             materials[filename] = material;
+            addAsset(Category::MATERIAL, filename, material ? sizeof(graphics::Material) : 0);
         }
 
         void Cache::releaseMaterials()
         {
             materials.clear();
+            removeAssets(Category::MATERIAL);
         }
 
         const scene::ModelData& Cache::getModelData(const std::string& filename, bool mipmaps) const
@@ -500,17 +651,216 @@ namespace ouzel
                 }
             }
 
+            touchAsset(Category::MODEL_DATA, filename);
+
             return i->second;
         }
 
         void Cache::setModelData(const std::string& filename, const scene::ModelData& newModelData)
         {
             modelData[filename] = newModelData;
+            addAsset(Category::MODEL_DATA, filename, getAssetSize(newModelData));
         }
 
         void Cache::releaseModelData()
         {
-            particleSystemData.clear();
+            modelData.clear();
+            removeAssets(Category::MODEL_DATA);
+        }
+
+        void Cache::setBudget(Category category, uint64_t budget)
+        {
+            records[static_cast<uint32_t>(category)].budget = budget;
+            evict();
+        }
+
+        void Cache::pin(Category category, const std::string& name)
+        {
+            records[static_cast<uint32_t>(category)].assets[name].pinned = true;
+        }
+
+        void Cache::unpin(Category category, const std::string& name)
+        {
+            CategoryRecords& categoryRecords = records[static_cast<uint32_t>(category)];
+            auto i = categoryRecords.assets.find(name);
+
+            if (i != categoryRecords.assets.end()) i->second.pinned = false;
+        }
+
+        std::vector<Cache::AssetUsage> Cache::getLargestAssets(uint32_t count) const
+        {
+            std::vector<AssetUsage> result;
+
+            for (uint32_t category = 0; category < CATEGORY_COUNT; ++category)
+            {
+                for (const auto& asset : records[category].assets)
+                {
+                    result.push_back({static_cast<Category>(category),
+                                      asset.first,
+                                      asset.second.size,
+                                      isAssetReferenced(static_cast<Category>(category), asset.first),
+                                      asset.second.pinned});
+                }
+            }
+
+            std::sort(result.begin(), result.end(), [](const AssetUsage& a, const AssetUsage& b) {
+                return a.size > b.size;
+            });
+
+            if (result.size() > count) result.resize(count);
+
+            return result;
+        }
+
+        void Cache::evict()
+        {
+            if (evictionScheduled)
+            {
+                evictionCallback.remove();
+                evictionScheduled = false;
+            }
+
+            // sprite data, materials and models hold textures, so they are released first
+            static const Category order[CATEGORY_COUNT] = {
+                Category::SPRITE_DATA,
+                Category::PARTICLE_SYSTEM_DATA,
+                Category::MODEL_DATA,
+                Category::MATERIAL,
+                Category::FONT,
+                Category::SOUND_DATA,
+                Category::TEXTURE,
+                Category::SHADER,
+                Category::BLEND_STATE
+            };
+
+            for (Category category : order)
+            {
+                CategoryRecords& categoryRecords = records[static_cast<uint32_t>(category)];
+
+                if (!categoryRecords.budget || categoryRecords.usage <= categoryRecords.budget) continue;
+
+                std::vector<std::pair<uint64_t, std::string>> candidates;
+
+                for (const auto& asset : categoryRecords.assets)
+                {
+                    if (!asset.second.pinned && !isAssetReferenced(category, asset.first))
+                    {
+                        candidates.push_back(std::make_pair(asset.second.lastUsed, asset.first));
+                    }
+                }
+
+                std::sort(candidates.begin(), candidates.end());
+
+                for (const auto& candidate : candidates)
+                {
+                    if (categoryRecords.usage <= categoryRecords.budget) break;
+
+                    eraseAsset(category, candidate.second);
+                    removeAsset(category, candidate.second);
+                    ++categoryRecords.evictionCount;
+                }
+            }
+        }
+
+        void Cache::addAsset(Category category, const std::string& name, uint64_t size) const
+        {
+            CategoryRecords& categoryRecords = records[static_cast<uint32_t>(category)];
+            AssetRecord& record = categoryRecords.assets[name];
+
+            categoryRecords.usage -= record.size;
+            categoryRecords.usage += size;
+            record.size = size;
+            record.lastUsed = ++accessCounter;
+
+            // evicting right away could invalidate references that the callers of get* still hold
+            if (categoryRecords.budget && categoryRecords.usage > categoryRecords.budget && !evictionScheduled)
+            {
+                engine->scheduleUpdate(&evictionCallback);
+                evictionScheduled = true;
+            }
+        }
+
+        void Cache::touchAsset(Category category, const std::string& name) const
+        {
+            CategoryRecords& categoryRecords = records[static_cast<uint32_t>(category)];
+            auto i = categoryRecords.assets.find(name);
+
+            if (i != categoryRecords.assets.end()) i->second.lastUsed = ++accessCounter;
+        }
+
+        void Cache::removeAsset(Category category, const std::string& name) const
+        {
+            CategoryRecords& categoryRecords = records[static_cast<uint32_t>(category)];
+            auto i = categoryRecords.assets.find(name);
+
+            if (i != categoryRecords.assets.end())
+            {
+                categoryRecords.usage -= i->second.size;
+                categoryRecords.assets.erase(i);
+            }
+        }
+
+        void Cache::removeAssets(Category category) const
+        {
+            CategoryRecords& categoryRecords = records[static_cast<uint32_t>(category)];
+            categoryRecords.usage = 0;
+            categoryRecords.assets.clear();
+        }
+
+        template<class T>
+        static bool isReferenced(const std::map<std::string, std::shared_ptr<T>>& assets, const std::string& name)
+        {
+            auto i = assets.find(name);
+            return i != assets.end() && i->second.use_count() > 1;
+        }
+
+        bool Cache::isAssetReferenced(Category category, const std::string& name) const
+        {
+            switch (category)
+            {
+                case Category::TEXTURE:
+                    // the white pixel texture is used by the renderer itself
+                    return name == graphics::TEXTURE_WHITE_PIXEL || isReferenced(textures, name);
+                case Category::SHADER: return isReferenced(shaders, name);
+                case Category::BLEND_STATE: return isReferenced(blendStates, name);
+                case Category::FONT: return isReferenced(fonts, name);
+                case Category::SOUND_DATA: return isReferenced(soundData, name);
+                case Category::MATERIAL: return isReferenced(materials, name);
+                case Category::SPRITE_DATA:
+                {
+                    // all the frames share one mesh buffer, sprites hold copies of the frames
+                    auto i = spriteData.find(name);
+                    if (i == spriteData.end() || i->second.frames.empty()) return false;
+                    const std::shared_ptr<graphics::MeshBuffer>& meshBuffer = i->second.frames.front().getMeshBuffer();
+                    return meshBuffer && meshBuffer.use_count() > static_cast<long>(i->second.frames.size());
+                }
+                case Category::MODEL_DATA:
+                {
+                    auto i = modelData.find(name);
+                    return i != modelData.end() && i->second.meshBuffer && i->second.meshBuffer.use_count() > 1;
+                }
+                case Category::PARTICLE_SYSTEM_DATA:
+                    // particle systems copy the data
+                    return false;
+            }
+
+            return false;
+        }
+
+        void Cache::eraseAsset(Category category, const std::string& name)
+        {
+            switch (category)
+            {
+                case Category::TEXTURE: textures.erase(name); break;
+                case Category::SHADER: shaders.erase(name); break;
+                case Category::BLEND_STATE: blendStates.erase(name); break;
+                case Category::SPRITE_DATA: spriteData.erase(name); break;
+                case Category::PARTICLE_SYSTEM_DATA: particleSystemData.erase(name); break;
+                case Category::FONT: fonts.erase(name); break;
+                case Category::SOUND_DATA: soundData.erase(name); break;
+                case Category::MATERIAL: materials.erase(name); break;
+                case Category::MODEL_DATA: modelData.erase(name); break;
+            }
         }
     } // namespace assets
 } // namespace ouzel
@@ -6,7 +6,9 @@
 #include <memory>
 #include <string>
 #include <map>
+#include <vector>
 #include "utils/Noncopyable.hpp"
+#include "core/UpdateCallback.hpp"
 #include "assets/LoaderBMF.hpp"
 #include "assets/LoaderCollada.hpp"
 #include "assets/LoaderImage.hpp"
@@ -17,6 +19,7 @@
 #include "assets/LoaderTTF.hpp"
 #include "assets/LoaderVorbis.hpp"
 #include "assets/LoaderWave.hpp"
+#include "assets/TextureAtlas.hpp"
 #include "audio/SoundData.hpp"
 #include "graphics/BlendState.hpp"
 #include "graphics/Material.hpp"
@@ -36,6 +39,30 @@ namespace ouzel
         class Cache: public Noncopyable
         {
         public:
+            enum class Category
+            {
+                TEXTURE,
+                SHADER,
+                BLEND_STATE,
+                SPRITE_DATA,
+                PARTICLE_SYSTEM_DATA,
+                FONT,
+                SOUND_DATA,
+                MATERIAL,
+                MODEL_DATA
+            };
+
+            static const uint32_t CATEGORY_COUNT = 9;
+
+            struct AssetUsage
+            {
+                Category category;
+                std::string name;
+                uint64_t size;
+                bool referenced;
+                bool pinned;
+            };
+
             Cache();
             ~Cache();
 
@@ -52,6 +79,10 @@ namespace ouzel
             void setTexture(const std::string& filename, const std::shared_ptr<graphics::Texture>& texture);
             void releaseTextures();
 
+            // returns the atlas region of a small image or the whole texture of a big one
+            bool getTextureRegion(const std::string& filename, bool mipmaps, TextureAtlas::Region& region) const;
+            TextureAtlas& getTextureAtlas() { return textureAtlas; }
+
             const std::shared_ptr<graphics::Shader>& getShader(const std::string& shaderName) const;
             void setShader(const std::string& shaderName, const std::shared_ptr<graphics::Shader>& shader);
             void releaseShaders();
@@ -89,7 +120,45 @@ namespace ouzel
             void setModelData(const std::string& filename, const scene::ModelData& newModelData);
             void releaseModelData();
 
+            // when the assets of a category exceed its budget, the least recently requested ones
+            // that are neither referenced outside of the cache nor pinned are released, 0 disables the budget
+            uint64_t getBudget(Category category) const { return records[static_cast<uint32_t>(category)].budget; }
+            void setBudget(Category category, uint64_t budget);
+            uint64_t getUsage(Category category) const { return records[static_cast<uint32_t>(category)].usage; }
+            uint32_t getEvictionCount(Category category) const { return records[static_cast<uint32_t>(category)].evictionCount; }
+
+            // pinned assets are never evicted
+            void pin(Category category, const std::string& name);
+            void unpin(Category category, const std::string& name);
+
+            std::vector<AssetUsage> getLargestAssets(uint32_t count) const;
+
+            // releases assets until every category is within its budget, runs automatically after a budget is exceeded
+            void evict();
+
         protected:
+            struct AssetRecord
+            {
+                uint64_t size = 0;
+                uint64_t lastUsed = 0;
+                bool pinned = false;
+            };
+
+            struct CategoryRecords
+            {
+                uint64_t budget = 0;
+                uint64_t usage = 0;
+                uint32_t evictionCount = 0;
+                std::map<std::string, AssetRecord> assets;
+            };
+
+            void addAsset(Category category, const std::string& name, uint64_t size) const;
+            void touchAsset(Category category, const std::string& name) const;
+            void removeAsset(Category category, const std::string& name) const;
+            void removeAssets(Category category) const;
+            bool isAssetReferenced(Category category, const std::string& name) const;
+            void eraseAsset(Category category, const std::string& name);
+
             LoaderBMF loaderBMF;
             LoaderCollada loaderCollada;
             LoaderImage loaderImage;
@@ -101,6 +170,7 @@ namespace ouzel
             LoaderVorbis loaderVorbis;
             LoaderWave loaderWave;
             std::vector<Loader*> loaders;
+            mutable TextureAtlas textureAtlas;
             mutable std::map<std::string, std::shared_ptr<graphics::Texture>> textures;
             mutable std::map<std::string, std::shared_ptr<graphics::Shader>> shaders;
             mutable std::map<std::string, scene::ParticleSystemData> particleSystemData;
@@ -110,6 +180,11 @@ namespace ouzel
             mutable std::map<std::string, std::shared_ptr<audio::SoundData>> soundData;
             mutable std::map<std::string, std::shared_ptr<graphics::Material>> materials;
             mutable std::map<std::string, scene::ModelData> modelData;
+
+            mutable CategoryRecords records[CATEGORY_COUNT];
+            mutable uint64_t accessCounter = 0;
+            mutable UpdateCallback evictionCallback;
+            mutable bool evictionScheduled = false;
         };
     } // namespace assets
 } // namespace ouzel
@@ -1,44 +1,469 @@
 // Copyright (C) 2018 Elviss Strazdins
 // This file is part of the Ouzel engine.
 
+#include <algorithm>
+#include <map>
+#include <string>
+#include <tuple>
+#include <unordered_map>
 #include "LoaderCollada.hpp"
 #include "core/Engine.hpp"
 #include "scene/ModelData.hpp"
 #include "utils/Log.hpp"
-#include "utils/XML.hpp"
+#include "utils/Utils.hpp"
+#include "utils/XMLReader.hpp"
 
 namespace ouzel
 {
     namespace assets
     {
+        static inline bool isWhitespace(char c)
+        {
+            return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+        }
+
+        static inline bool isDigit(char c)
+        {
+            return c >= '0' && c <= '9';
+        }
+
+        // locale independent parsing of a whitespace separated list of numbers
+        static bool parseFloats(const StringView& text, std::vector<float>& result)
+        {
+            const char* current = text.begin();
+            const char* end = text.end();
+
+            for (;;)
+            {
+                while (current != end && isWhitespace(*current)) ++current;
+                if (current == end) break;
+
+                double value;
+                if (!parseDecimal(current, end, value))
+                {
+                    Log(Log::Level::ERR) << "Invalid number";
+                    return false;
+                }
+
+                result.push_back(static_cast<float>(value));
+
+                if (current != end && !isWhitespace(*current))
+                {
+                    Log(Log::Level::ERR) << "Invalid number";
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        static bool parseIndices(const StringView& text, std::vector<uint32_t>& result)
+        {
+            const char* current = text.begin();
+            const char* end = text.end();
+
+            for (;;)
+            {
+                while (current != end && isWhitespace(*current)) ++current;
+                if (current == end) break;
+
+                if (!isDigit(*current))
+                {
+                    Log(Log::Level::ERR) << "Invalid index";
+                    return false;
+                }
+
+                uint32_t value = 0;
+                for (; current != end && isDigit(*current); ++current)
+                {
+                    value = value * 10 + static_cast<uint32_t>(*current - '0');
+                }
+
+                result.push_back(value);
+            }
+
+            return true;
+        }
+
+        // reads the text content of the current element and leaves the reader after its end tag
+        static bool readText(xml::Reader& reader, StringView& result)
+        {
+            result = StringView();
+
+            for (;;)
+            {
+                switch (reader.next())
+                {
+                    case xml::Reader::Event::TEXT:
+                    case xml::Reader::Event::CDATA:
+                        result = reader.getText();
+                        break;
+                    case xml::Reader::Event::END_ELEMENT:
+                        return true;
+                    case xml::Reader::Event::START_ELEMENT:
+                        if (!reader.skipElement()) return false;
+                        break;
+                    default:
+                        return false;
+                }
+            }
+        }
+
+        static std::string getSourceId(const StringView& reference)
+        {
+            if (!reference.isEmpty() && reference.getData()[0] == '#')
+                return std::string(reference.getData() + 1, reference.getLength() - 1);
+            else
+                return reference.str();
+        }
+
+        struct ColladaSource
+        {
+            std::vector<float> data;
+            uint32_t stride = 1;
+        };
+
+        struct ColladaInput
+        {
+            enum class Semantic
+            {
+                NONE,
+                VERTEX,
+                POSITION,
+                NORMAL,
+                TEXCOORD
+            };
+
+            Semantic semantic = Semantic::NONE;
+            std::string source;
+            uint32_t offset = 0;
+        };
+
+        static ColladaInput::Semantic getSemantic(const StringView& semantic)
+        {
+            if (semantic == "VERTEX") return ColladaInput::Semantic::VERTEX;
+            else if (semantic == "POSITION") return ColladaInput::Semantic::POSITION;
+            else if (semantic == "NORMAL") return ColladaInput::Semantic::NORMAL;
+            else if (semantic == "TEXCOORD") return ColladaInput::Semantic::TEXCOORD;
+            else return ColladaInput::Semantic::NONE;
+        }
+
+        struct VertexKeyHash
+        {
+            size_t operator()(const std::tuple<uint32_t, uint32_t, uint32_t>& key) const
+            {
+                uint64_t hash = std::get<0>(key);
+                hash = hash * 0x9E3779B97F4A7C15ULL + std::get<1>(key);
+                hash = hash * 0x9E3779B97F4A7C15ULL + std::get<2>(key);
+                return static_cast<size_t>(hash ^ (hash >> 32));
+            }
+        };
+
+        class ColladaGeometryBuilder
+        {
+        public:
+            bool addPrimitive(const std::vector<ColladaInput>& inputs,
+                              const std::vector<uint32_t>& vertexCounts,
+                              const std::vector<uint32_t>& primitiveIndices,
+                              bool polygons)
+            {
+                const ColladaSource* positionSource = nullptr;
+                const ColladaSource* normalSource = nullptr;
+                const ColladaSource* texCoordSource = nullptr;
+                uint32_t positionOffset = 0;
+                uint32_t normalOffset = 0;
+                uint32_t texCoordOffset = 0;
+                uint32_t inputStride = 0;
+
+                for (const ColladaInput& input : inputs)
+                {
+                    inputStride = std::max(inputStride, input.offset + 1);
+
+                    switch (input.semantic)
+                    {
+                        case ColladaInput::Semantic::VERTEX:
+                        {
+                            auto verticesIterator = vertices.find(input.source);
+                            if (verticesIterator == vertices.end())
+                            {
+                                Log(Log::Level::ERR) << "Invalid vertices reference " << input.source;
+                                return false;
+                            }
+
+                            for (const ColladaInput& vertexInput : verticesIterator->second)
+                            {
+                                if (vertexInput.semantic == ColladaInput::Semantic::POSITION)
+                                {
+                                    positionSource = getSource(vertexInput.source);
+                                    positionOffset = input.offset;
+                                }
+                                else if (vertexInput.semantic == ColladaInput::Semantic::NORMAL)
+                                {
+                                    normalSource = getSource(vertexInput.source);
+                                    normalOffset = input.offset;
+                                }
+                                else if (vertexInput.semantic == ColladaInput::Semantic::TEXCOORD)
+                                {
+                                    texCoordSource = getSource(vertexInput.source);
+                                    texCoordOffset = input.offset;
+                                }
+                            }
+                            break;
+                        }
+                        case ColladaInput::Semantic::NORMAL:
+                            normalSource = getSource(input.source);
+                            normalOffset = input.offset;
+                            break;
+                        case ColladaInput::Semantic::TEXCOORD:
+                            if (!texCoordSource)
+                            {
+                                texCoordSource = getSource(input.source);
+                                texCoordOffset = input.offset;
+                            }
+                            break;
+                        default:
+                            break;
+                    }
+                }
+
+                if (!positionSource || inputStride == 0)
+                {
+                    Log(Log::Level::ERR) << "Primitive has no positions";
+                    return false;
+                }
+
+                uint32_t primitiveVertexCount = static_cast<uint32_t>(primitiveIndices.size() / inputStride);
+                std::vector<uint32_t> polygonIndices;
+
+                vertexMap.reserve(vertexMap.size() + primitiveVertexCount);
+                indices.reserve(indices.size() + primitiveVertexCount);
+
+                uint32_t polygon = 0;
+                uint32_t polygonVertex = 0;
+                uint32_t polygonSize = 3;
+
+                for (uint32_t i = 0; i < primitiveVertexCount; ++i)
+                {
+                    if (polygons && polygonVertex == 0)
+                    {
+                        while (polygon < vertexCounts.size() && vertexCounts[polygon] == 0) ++polygon;
+
+                        if (polygon >= vertexCounts.size())
+                        {
+                            Log(Log::Level::ERR) << "Invalid polygon vertex count";
+                            return false;
+                        }
+
+                        polygonSize = vertexCounts[polygon];
+                    }
+
+                    const uint32_t* vertexIndices = primitiveIndices.data() + i * inputStride;
+
+                    std::tuple<uint32_t, uint32_t, uint32_t> key(vertexIndices[positionOffset],
+                                                                 normalSource ? vertexIndices[normalOffset] : 0,
+                                                                 texCoordSource ? vertexIndices[texCoordOffset] : 0);
+
+                    auto vertexIterator = vertexMap.find(key);
+                    if (vertexIterator != vertexMap.end())
+                    {
+                        polygonIndices.push_back(vertexIterator->second);
+                    }
+                    else
+                    {
+                        graphics::Vertex vertex;
+                        vertex.color = Color::WHITE;
+
+                        if (!getVector(*positionSource, std::get<0>(key), 3, &vertex.position.x) ||
+                            (normalSource && !getVector(*normalSource, std::get<1>(key), 3, &vertex.normal.x)) ||
+                            (texCoordSource && !getVector(*texCoordSource, std::get<2>(key), 2, &vertex.texCoords[0].x)))
+                        {
+                            Log(Log::Level::ERR) << "Vertex index out of range";
+                            return false;
+                        }
+
+                        uint32_t vertexIndex = static_cast<uint32_t>(meshVertices.size());
+                        vertexMap[key] = vertexIndex;
+                        meshVertices.push_back(vertex);
+                        boundingBox.insertPoint(vertex.position);
+                        polygonIndices.push_back(vertexIndex);
+                    }
+
+                    if (++polygonVertex == polygonSize)
+                    {
+                        // triangulate polygons as fans
+                        for (uint32_t v = 2; v < polygonIndices.size(); ++v)
+                        {
+                            indices.push_back(polygonIndices[0]);
+                            indices.push_back(polygonIndices[v - 1]);
+                            indices.push_back(polygonIndices[v]);
+                        }
+
+                        polygonIndices.clear();
+                        polygonVertex = 0;
+                        ++polygon;
+                    }
+                }
+
+                return true;
+            }
+
+            std::map<std::string, ColladaSource> sources;
+            std::map<std::string, std::vector<ColladaInput>> vertices;
+
+            std::vector<uint32_t> indices;
+            std::vector<graphics::Vertex> meshVertices;
+            Box3 boundingBox;
+
+        private:
+            const ColladaSource* getSource(const std::string& id) const
+            {
+                auto sourceIterator = sources.find(id);
+                return (sourceIterator != sources.end()) ? &sourceIterator->second : nullptr;
+            }
+
+            static bool getVector(const ColladaSource& source, uint32_t index, uint32_t components, float* result)
+            {
+                size_t start = static_cast<size_t>(index) * source.stride;
+                if (start + std::min(components, source.stride) > source.data.size()) return false;
+
+                for (uint32_t component = 0; component < components && component < source.stride; ++component)
+                {
+                    result[component] = source.data[start + component];
+                }
+
+                return true;
+            }
+
+            std::unordered_map<std::tuple<uint32_t, uint32_t, uint32_t>, uint32_t, VertexKeyHash> vertexMap;
+        };
+
         LoaderCollada::LoaderCollada():
             Loader(TYPE, {"dae"})
         {
         }
 
-        bool LoaderCollada::loadAsset(const std::string& filename, const std::vector<uint8_t>& data, bool mipmaps)
+        bool LoaderCollada::loadAsset(const std::string& filename, const std::vector<uint8_t>& data, bool)
         {
-            xml::Data colladaData;
-
-            if (!colladaData.init(data)) return false;
+            xml::Reader reader(data.data(), data.data() + data.size());
 
-            if (colladaData.getChildren().empty())
+            if (reader.next() != xml::Reader::Event::START_ELEMENT ||
+                reader.getName() != "COLLADA")
             {
-                Log(Log::Level::ERR) << "Invalid collada Collada file";
+                Log(Log::Level::ERR) << "Invalid Collada file";
                 return false;
             }
 
-            xml::Node rootNode = colladaData.getChildren().front();
+            ColladaGeometryBuilder builder;
+
+            // the document is consumed incrementally, only the geometry library is read
+            std::string currentSource;
+            std::string currentVertices;
+            bool inPrimitive = false;
+            bool polygons = false;
+            std::vector<ColladaInput> inputs;
+            std::vector<uint32_t> vertexCounts;
+            std::vector<uint32_t> primitiveIndices;
+            StringView text;
 
-            if (rootNode.getValue() != "COLLADA")
+            for (;;)
             {
-                Log(Log::Level::ERR) << "Invalid collada Collada file";
-                return false;
+                xml::Reader::Event event = reader.next();
+
+                if (event == xml::Reader::Event::ERROR) return false;
+                if (event == xml::Reader::Event::END) break;
+
+                if (event == xml::Reader::Event::END_ELEMENT)
+                {
+                    const StringView& name = reader.getName();
+
+                    if (name == "source") currentSource.clear();
+                    else if (name == "vertices") currentVertices.clear();
+                    else if (name == "triangles" || name == "polylist")
+                    {
+                        if (!builder.addPrimitive(inputs, vertexCounts, primitiveIndices, polygons)) return false;
+                        inPrimitive = false;
+                    }
+                }
+                else if (event == xml::Reader::Event::START_ELEMENT)
+                {
+                    const StringView& name = reader.getName();
+
+                    if (reader.getDepth() == 2 && name != "library_geometries")
+                    {
+                        if (!reader.skipElement()) return false;
+                    }
+                    else if (name == "source")
+                    {
+                        currentSource = reader.getAttribute("id").str();
+                    }
+                    else if (name == "float_array" && !currentSource.empty())
+                    {
+                        std::vector<float>& sourceData = builder.sources[currentSource].data;
+
+                        if (!readText(reader, text) ||
+                            !parseFloats(text, sourceData))
+                        {
+                            Log(Log::Level::ERR) << "Failed to parse source " << currentSource;
+                            return false;
+                        }
+                    }
+                    else if (name == "accessor" && !currentSource.empty())
+                    {
+                        std::vector<uint32_t> stride;
+                        if (parseIndices(reader.getAttribute("stride"), stride) && !stride.empty() && stride.front() > 0)
+                            builder.sources[currentSource].stride = stride.front();
+                    }
+                    else if (name == "vertices")
+                    {
+                        currentVertices = reader.getAttribute("id").str();
+                        builder.vertices[currentVertices].clear();
+                    }
+                    else if (name == "triangles" || name == "polylist")
+                    {
+                        inPrimitive = true;
+                        polygons = (name == "polylist");
+                        inputs.clear();
+                        vertexCounts.clear();
+                        primitiveIndices.clear();
+                    }
+                    else if (name == "input")
+                    {
+                        ColladaInput input;
+                        input.semantic = getSemantic(reader.getAttribute("semantic"));
+                        input.source = getSourceId(reader.getAttribute("source"));
+
+                        std::vector<uint32_t> offset;
+                        if (parseIndices(reader.getAttribute("offset"), offset) && !offset.empty())
+                            input.offset = offset.front();
+
+                        if (inPrimitive) inputs.push_back(input);
+                        else if (!currentVertices.empty()) builder.vertices[currentVertices].push_back(input);
+                    }
+                    else if (name == "vcount" && inPrimitive)
+                    {
+                        if (!readText(reader, text) ||
+                            !parseIndices(text, vertexCounts))
+                        {
+                            Log(Log::Level::ERR) << "Failed to parse polygon vertex counts";
+                            return false;
+                        }
+                    }
+                    else if (name == "p" && inPrimitive)
+                    {
+                        if (!readText(reader, text) ||
+                            !parseIndices(text, primitiveIndices))
+                        {
+                            Log(Log::Level::ERR) << "Failed to parse primitive indices";
+                            return false;
+                        }
+                    }
+                }
             }
 
             scene::ModelData modelData;
 
-            // TODO: load the model
+            if (!builder.meshVertices.empty())
+                modelData.init(builder.boundingBox, builder.indices, builder.meshVertices, nullptr);
 
             engine->getCache()->setModelData(filename, modelData);
 
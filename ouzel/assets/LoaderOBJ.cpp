@@ -1,440 +1,813 @@
 // Copyright (C) 2018 Elviss Strazdins
 // This file is part of the Ouzel engine.
 
-#include <cstdlib>
-#include <iterator>
-#include <map>
+#include <algorithm>
+#include <cstring>
 #include <string>
-#include <tuple>
+#include <thread>
 #include "LoaderOBJ.hpp"
 #include "Cache.hpp"
 #include "core/Engine.hpp"
+#include "files/MappedFile.hpp"
 #include "graphics/Material.hpp"
+#include "scene/ModelData.hpp"
 #include "utils/Log.hpp"
+#include "utils/Utils.hpp"
 
 namespace ouzel
 {
     namespace assets
     {
-        static bool isWhitespace(uint8_t c)
+        // files smaller than this are parsed on the calling thread
+        static const size_t MIN_CHUNK_SIZE = 256 * 1024;
+        // files smaller than this are not worth caching
+        static const size_t MIN_CACHE_SIZE = 1024 * 1024;
+
+        static const uint8_t CACHE_MAGIC[4] = {'O', 'B', 'J', 'C'};
+        static const uint32_t CACHE_VERSION = 1;
+
+        static const uint32_t NO_INDEX = 0xFFFFFFFF;
+
+        static inline bool isWhitespace(uint8_t c)
         {
             return c == ' ' || c == '\t';
         }
 
-        static bool isNewline(uint8_t c)
+        static inline bool isNewline(uint8_t c)
         {
             return c == '\r' || c == '\n';
         }
 
-        static bool isControlChar(uint8_t c)
+        static inline bool isDigit(uint8_t c)
         {
-            return c <= 0x1F;
+            return c >= '0' && c <= '9';
         }
 
-        static bool skipWhitespaces(const std::vector<uint8_t>& str,
-                                    std::vector<uint8_t>::const_iterator& iterator)
+        static inline void skipWhitespaces(const uint8_t*& current, const uint8_t* end)
         {
-            if (iterator == str.end()) return false;
+            while (current != end && isWhitespace(*current)) ++current;
+        }
 
-            for (;;)
+        static inline void skipLine(const uint8_t*& current, const uint8_t* end)
+        {
+            while (current != end && *current != '\n') ++current;
+            if (current != end) ++current;
+        }
+
+        static inline bool isKeyword(const uint8_t* start, const uint8_t* end, const char* keyword)
+        {
+            size_t length = strlen(keyword);
+            return static_cast<size_t>(end - start) == length && std::equal(start, end, keyword);
+        }
+
+        // the rest of the line without trailing whitespaces
+        static bool parseString(const uint8_t*& current, const uint8_t* end, std::string& result)
+        {
+            skipWhitespaces(current, end);
+
+            const uint8_t* start = current;
+            while (current != end && !isNewline(*current)) ++current;
+
+            const uint8_t* last = current;
+            while (last != start && isWhitespace(*(last - 1))) --last;
+
+            result.assign(start, last);
+
+            return !result.empty();
+        }
+
+        static inline bool parseFloat(const uint8_t*& current, const uint8_t* end, float& result)
+        {
+            skipWhitespaces(current, end);
+
+            double value;
+            if (!parseDecimal(current, end, value)) return false;
+
+            result = static_cast<float>(value);
+
+            return true;
+        }
+
+        static bool parseInt32(const uint8_t*& current, const uint8_t* end, int32_t& result)
+        {
+            bool negative = false;
+            if (current != end && *current == '-')
             {
-                if (iterator == str.end()) break;
+                negative = true;
+                ++current;
+            }
 
-                if (isWhitespace(*iterator))
-                    ++iterator;
-                else
-                    break;
+            if (current == end || !isDigit(*current)) return false;
+
+            int32_t value = 0;
+            for (; current != end && isDigit(*current); ++current)
+            {
+                value = value * 10 + (*current - '0');
             }
 
+            result = negative ? -value : value;
+
             return true;
         }
 
-        static void skipLine(const std::vector<uint8_t>& str,
-                             std::vector<uint8_t>::const_iterator& iterator)
+        struct ObjCorner
         {
-            for (;;)
+            uint32_t position;
+            uint32_t texCoord;
+            uint32_t normal;
+        };
+
+        // corner whose indices are relative to the start of the chunk (negative indices in the file)
+        struct ObjFixup
+        {
+            uint32_t corner;
+            uint32_t mask; // bit 0 - position, bit 1 - texture coordinates, bit 2 - normal
+        };
+
+        struct ObjStatement
+        {
+            enum class Type
             {
-                if (iterator == str.end()) break;
+                OBJECT,
+                MATERIAL,
+                MATERIAL_LIBRARY
+            };
 
-                if (isNewline(*iterator))
-                {
-                    ++iterator;
-                    break;
-                }
+            Type type;
+            uint32_t corner; // number of corners in the chunk before the statement
+            std::string value;
+        };
 
-                ++iterator;
+        // result of parsing a line-aligned part of the file
+        struct ObjChunk
+        {
+            const uint8_t* begin = nullptr;
+            const uint8_t* end = nullptr;
+
+            std::vector<Vector3> positions;
+            std::vector<Vector2> texCoords;
+            std::vector<Vector3> normals;
+            std::vector<ObjCorner> corners; // three per triangle
+            std::vector<ObjFixup> fixups;
+            std::vector<ObjStatement> statements;
+
+            // workers can not log, so the first error is reported by the calling thread
+            const char* error = nullptr;
+        };
+
+        static inline bool resolveIndex(int32_t index, size_t count, uint32_t& result, uint32_t& mask, uint32_t bit)
+        {
+            if (index > 0)
+                result = static_cast<uint32_t>(index - 1);
+            else if (index < 0)
+            {
+                // may wrap around if it points to a previous chunk, the chunk offset is added when merging
+                result = static_cast<uint32_t>(count) + static_cast<uint32_t>(index);
+                mask |= bit;
             }
+            else
+                return false;
+
+            return true;
         }
 
-        static bool parseString(const std::vector<uint8_t>& str,
-                                std::vector<uint8_t>::const_iterator& iterator,
-                                std::string& result)
+        static bool parseFace(const uint8_t*& current, const uint8_t* end, ObjChunk& chunk,
+                              std::vector<ObjCorner>& face, std::vector<uint32_t>& faceMasks)
         {
-            result.clear();
+            face.clear();
+            faceMasks.clear();
 
             for (;;)
             {
-                if (iterator == str.end() || isControlChar(*iterator) || isWhitespace(*iterator)) break;
+                skipWhitespaces(current, end);
+                if (current == end || isNewline(*current) || *current == '#') break;
+
+                ObjCorner corner = {NO_INDEX, NO_INDEX, NO_INDEX};
+                uint32_t mask = 0;
+                int32_t index;
 
-                result.push_back(static_cast<char>(*iterator));
+                if (!parseInt32(current, end, index) ||
+                    !resolveIndex(index, chunk.positions.size(), corner.position, mask, 1))
+                    return false;
 
-                ++iterator;
+                if (current != end && *current == '/')
+                {
+                    ++current;
+
+                    if (current != end && *current != '/')
+                    {
+                        if (!parseInt32(current, end, index) ||
+                            !resolveIndex(index, chunk.texCoords.size(), corner.texCoord, mask, 2))
+                            return false;
+                    }
+
+                    if (current != end && *current == '/')
+                    {
+                        ++current;
+
+                        if (!parseInt32(current, end, index) ||
+                            !resolveIndex(index, chunk.normals.size(), corner.normal, mask, 4))
+                            return false;
+                    }
+                }
+
+                if (current != end && !isWhitespace(*current) && !isNewline(*current)) return false;
+
+                face.push_back(corner);
+                faceMasks.push_back(mask);
             }
 
-            return !result.empty();
+            if (face.size() < 3) return false;
+
+            // polygons are triangulated as a fan around the first corner
+            for (uint32_t i = 2; i < face.size(); ++i)
+            {
+                const uint32_t triangle[] = {0, i - 1, i};
+
+                for (uint32_t c : triangle)
+                {
+                    if (faceMasks[c]) chunk.fixups.push_back({static_cast<uint32_t>(chunk.corners.size()), faceMasks[c]});
+                    chunk.corners.push_back(face[c]);
+                }
+            }
+
+            return true;
         }
 
-        static bool parseInt32(const std::vector<uint8_t>& str,
-                               std::vector<uint8_t>::const_iterator& iterator,
-                               int32_t& result)
+        static void parseChunk(ObjChunk& chunk)
         {
-            std::string value;
-            uint32_t length = 1;
+            std::vector<ObjCorner> face;
+            std::vector<uint32_t> faceMasks;
 
-            if (iterator != str.end() && *iterator == '-')
-            {
-                value.push_back(static_cast<char>(*iterator));
-                ++length;
-                ++iterator;
-            }
+            const uint8_t* current = chunk.begin;
+            const uint8_t* end = chunk.end;
 
-            for (;;)
+            while (current != end)
             {
-                if (iterator == str.end() || *iterator < '0' || *iterator > '9') break;
+                skipWhitespaces(current, end);
+                if (current == end) break;
 
-                value.push_back(static_cast<char>(*iterator));
+                if (isNewline(*current))
+                {
+                    // skip empty lines
+                    ++current;
+                    continue;
+                }
 
-                ++iterator;
-            }
+                if (*current == '#')
+                {
+                    // skip the comment
+                    skipLine(current, end);
+                    continue;
+                }
 
-            if (value.length() < length) return false;
+                const uint8_t* keyword = current;
+                while (current != end && !isWhitespace(*current) && !isNewline(*current)) ++current;
+                const uint8_t* keywordEnd = current;
 
-            result = std::stoi(value);
+                if (isKeyword(keyword, keywordEnd, "v"))
+                {
+                    Vector3 position;
 
-            return true;
+                    if (!parseFloat(current, end, position.x) ||
+                        !parseFloat(current, end, position.y) ||
+                        !parseFloat(current, end, position.z))
+                    {
+                        chunk.error = "Failed to parse position";
+                        return;
+                    }
+
+                    chunk.positions.push_back(position);
+                }
+                else if (isKeyword(keyword, keywordEnd, "vt"))
+                {
+                    Vector2 texCoord;
+
+                    if (!parseFloat(current, end, texCoord.x) ||
+                        !parseFloat(current, end, texCoord.y))
+                    {
+                        chunk.error = "Failed to parse texture coordinates";
+                        return;
+                    }
+
+                    chunk.texCoords.push_back(texCoord);
+                }
+                else if (isKeyword(keyword, keywordEnd, "vn"))
+                {
+                    Vector3 normal;
+
+                    if (!parseFloat(current, end, normal.x) ||
+                        !parseFloat(current, end, normal.y) ||
+                        !parseFloat(current, end, normal.z))
+                    {
+                        chunk.error = "Failed to parse normal";
+                        return;
+                    }
+
+                    chunk.normals.push_back(normal);
+                }
+                else if (isKeyword(keyword, keywordEnd, "f"))
+                {
+                    if (!parseFace(current, end, chunk, face, faceMasks))
+                    {
+                        chunk.error = "Failed to parse face";
+                        return;
+                    }
+                }
+                else if (isKeyword(keyword, keywordEnd, "o") ||
+                         isKeyword(keyword, keywordEnd, "usemtl") ||
+                         isKeyword(keyword, keywordEnd, "mtllib"))
+                {
+                    ObjStatement statement;
+                    statement.corner = static_cast<uint32_t>(chunk.corners.size());
+
+                    if (*keyword == 'o')
+                        statement.type = ObjStatement::Type::OBJECT;
+                    else if (*keyword == 'u')
+                        statement.type = ObjStatement::Type::MATERIAL;
+                    else
+                        statement.type = ObjStatement::Type::MATERIAL_LIBRARY;
+
+                    if (!parseString(current, end, statement.value))
+                    {
+                        chunk.error = (statement.type == ObjStatement::Type::OBJECT) ? "Failed to parse object name" :
+                            (statement.type == ObjStatement::Type::MATERIAL) ? "Failed to parse material name" :
+                            "Failed to parse material library";
+                        return;
+                    }
+
+                    chunk.statements.push_back(std::move(statement));
+                }
+
+                // unknown commands and the rest of the line are skipped
+                skipLine(current, end);
+            }
         }
 
-        static bool parseFloat(const std::vector<uint8_t>& str,
-                               std::vector<uint8_t>::const_iterator& iterator,
-                               float& result)
+        // open-addressing hash table from position/texture coordinate/normal index triplets to vertex indices
+        class ObjVertexTable
         {
-            std::string value;
-            uint32_t length = 1;
+        public:
+            ObjVertexTable()
+            {
+                clear();
+            }
 
-            if (iterator != str.end() && *iterator == '-')
+            void clear()
             {
-                value.push_back(static_cast<char>(*iterator));
-                ++length;
-                ++iterator;
+                count = 0;
+                slots.assign(1024, Slot());
             }
 
-            for (;;)
+            // returns the index of an existing vertex or stores and returns the new index
+            uint32_t insert(const ObjCorner& key, uint32_t newIndex)
             {
-                if (iterator == str.end() || *iterator < '0' || *iterator > '9') break;
+                if ((count + 1) * 2 > slots.size()) grow();
+
+                size_t mask = slots.size() - 1;
+
+                for (size_t i = hash(key) & mask;; i = (i + 1) & mask)
+                {
+                    Slot& slot = slots[i];
+
+                    if (slot.index == NO_INDEX)
+                    {
+                        slot.key = key;
+                        slot.index = newIndex;
+                        ++count;
+                        return newIndex;
+                    }
+
+                    if (slot.key.position == key.position &&
+                        slot.key.texCoord == key.texCoord &&
+                        slot.key.normal == key.normal)
+                        return slot.index;
+                }
+            }
 
-                value.push_back(static_cast<char>(*iterator));
+        private:
+            struct Slot
+            {
+                ObjCorner key = {NO_INDEX, NO_INDEX, NO_INDEX};
+                uint32_t index = NO_INDEX;
+            };
 
-                ++iterator;
+            static inline size_t hash(const ObjCorner& key)
+            {
+                uint32_t result = key.position * 0x9E3779B1U ^ key.texCoord * 0x85EBCA77U ^ key.normal * 0xC2B2AE3DU;
+                return result ^ (result >> 15);
             }
 
-            if (iterator != str.end() && *iterator == '.')
+            void grow()
             {
-                value.push_back(static_cast<char>(*iterator));
-                ++length;
-                ++iterator;
+                std::vector<Slot> oldSlots(slots.size() * 2);
+                oldSlots.swap(slots);
 
-                for (;;)
-                {
-                    if (iterator == str.end() || *iterator < '0' || *iterator > '9') break;
+                size_t mask = slots.size() - 1;
 
-                    value.push_back(static_cast<char>(*iterator));
+                for (const Slot& oldSlot : oldSlots)
+                {
+                    if (oldSlot.index == NO_INDEX) continue;
 
-                    ++iterator;
+                    size_t i = hash(oldSlot.key) & mask;
+                    while (slots[i].index != NO_INDEX) i = (i + 1) & mask;
+                    slots[i] = oldSlot;
                 }
             }
 
-            if (value.length() < length) return false;
+            std::vector<Slot> slots;
+            size_t count = 0;
+        };
 
-            result = std::stof(value);
+        struct ObjObject
+        {
+            std::string name;
+            std::string material;
+            Box3 boundingBox;
+            std::vector<graphics::Vertex> vertices;
+            std::vector<uint32_t> indices;
+        };
 
-            return true;
+        static std::string getCachePath(uint64_t hash)
+        {
+            std::string directory = engine->getFileSystem()->getTempDirectory();
+            if (directory.empty()) return std::string();
+
+            return directory + FileSystem::DIRECTORY_SEPARATOR + "ouzel-obj-" + hexToString(hash, 16) + ".bin";
         }
 
-        static bool parseToken(const std::vector<uint8_t>& str,
-                               std::vector<uint8_t>::const_iterator& iterator,
-                               char token)
+        // the cache stores everything in the native byte order and alignment so that it can be used in place
+        // header: magic, version, vertex size, padding, source size (64 bit), source hash (64 bit),
+        // library count, object count
+        // library: length, bytes
+        // object: name length, bytes, material length, bytes, bounding box min and max,
+        // vertex count, index count, vertices, indices
+        // strings are padded to four bytes
+        static void writeCacheData(std::vector<uint8_t>& buffer, const void* data, size_t size)
         {
-            if (iterator == str.end() || *iterator != static_cast<uint8_t>(token)) return false;
+            const uint8_t* bytes = static_cast<const uint8_t*>(data);
+            buffer.insert(buffer.end(), bytes, bytes + size);
+        }
 
-            ++iterator;
+        static void writeCacheString(std::vector<uint8_t>& buffer, const std::string& str)
+        {
+            uint32_t length = static_cast<uint32_t>(str.length());
+            writeCacheData(buffer, &length, sizeof(length));
+            writeCacheData(buffer, str.data(), str.length());
+            buffer.resize((buffer.size() + 3) & ~static_cast<size_t>(3), 0);
+        }
 
-            return true;
+        static bool writeCache(const std::string& path, uint64_t dataSize, uint64_t dataHash,
+                               const std::vector<std::string>& libraries,
+                               const std::vector<ObjObject>& objects)
+        {
+            std::vector<uint8_t> buffer;
+
+            size_t totalSize = 40;
+            for (const ObjObject& object : objects)
+                totalSize += 64 + object.name.length() + object.material.length() +
+                    object.vertices.size() * sizeof(graphics::Vertex) + object.indices.size() * sizeof(uint32_t);
+            buffer.reserve(totalSize);
+
+            uint32_t vertexSize = sizeof(graphics::Vertex);
+            uint32_t padding = 0;
+            uint32_t libraryCount = static_cast<uint32_t>(libraries.size());
+            uint32_t objectCount = static_cast<uint32_t>(objects.size());
+
+            writeCacheData(buffer, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+            writeCacheData(buffer, &CACHE_VERSION, sizeof(CACHE_VERSION));
+            writeCacheData(buffer, &vertexSize, sizeof(vertexSize));
+            writeCacheData(buffer, &padding, sizeof(padding));
+            writeCacheData(buffer, &dataSize, sizeof(dataSize));
+            writeCacheData(buffer, &dataHash, sizeof(dataHash));
+            writeCacheData(buffer, &libraryCount, sizeof(libraryCount));
+            writeCacheData(buffer, &objectCount, sizeof(objectCount));
+
+            for (const std::string& library : libraries)
+                writeCacheString(buffer, library);
+
+            for (const ObjObject& object : objects)
+            {
+                uint32_t vertexCount = static_cast<uint32_t>(object.vertices.size());
+                uint32_t indexCount = static_cast<uint32_t>(object.indices.size());
+
+                writeCacheString(buffer, object.name);
+                writeCacheString(buffer, object.material);
+                writeCacheData(buffer, &object.boundingBox.min, sizeof(Vector3));
+                writeCacheData(buffer, &object.boundingBox.max, sizeof(Vector3));
+                writeCacheData(buffer, &vertexCount, sizeof(vertexCount));
+                writeCacheData(buffer, &indexCount, sizeof(indexCount));
+                writeCacheData(buffer, object.vertices.data(), object.vertices.size() * sizeof(graphics::Vertex));
+                writeCacheData(buffer, object.indices.data(), object.indices.size() * sizeof(uint32_t));
+            }
+
+            return engine->getFileSystem()->writeFile(path, buffer);
         }
 
+        class ObjCacheReader
+        {
+        public:
+            ObjCacheReader(const uint8_t* initCurrent, const uint8_t* initEnd):
+                current(initCurrent), end(initEnd)
+            {
+            }
+
+            bool read(void* result, size_t size)
+            {
+                if (static_cast<size_t>(end - current) < size) return false;
+                memcpy(result, current, size);
+                current += size;
+                return true;
+            }
+
+            // returns a pointer into the cache, the data is not copied
+            const uint8_t* get(size_t size)
+            {
+                if (static_cast<size_t>(end - current) < size) return nullptr;
+                const uint8_t* result = current;
+                current += size;
+                return result;
+            }
+
+            bool readString(std::string& result)
+            {
+                uint32_t length;
+                if (!read(&length, sizeof(length))) return false;
+
+                const uint8_t* str = get((length + 3) & ~3U);
+                if (!str) return false;
+
+                result.assign(reinterpret_cast<const char*>(str), length);
+                return true;
+            }
+
+        private:
+            const uint8_t* current;
+            const uint8_t* end;
+        };
+
         LoaderOBJ::LoaderOBJ():
             Loader(TYPE, {"obj"})
         {
         }
 
+        bool LoaderOBJ::loadCache(const std::string& filename, const std::string& path,
+                                  uint64_t dataSize, uint64_t dataHash, bool mipmaps)
+        {
+            MappedFile file;
+            if (!file.init(path)) return false;
+
+            ObjCacheReader reader(file.getData(), file.getData() + file.getSize());
+
+            uint8_t magic[4];
+            uint32_t version;
+            uint32_t vertexSize;
+            uint32_t padding;
+            uint64_t cachedDataSize;
+            uint64_t cachedDataHash;
+            uint32_t libraryCount;
+            uint32_t objectCount;
+
+            if (!reader.read(magic, sizeof(magic)) ||
+                !reader.read(&version, sizeof(version)) ||
+                !reader.read(&vertexSize, sizeof(vertexSize)) ||
+                !reader.read(&padding, sizeof(padding)) ||
+                !reader.read(&cachedDataSize, sizeof(cachedDataSize)) ||
+                !reader.read(&cachedDataHash, sizeof(cachedDataHash)) ||
+                !reader.read(&libraryCount, sizeof(libraryCount)) ||
+                !reader.read(&objectCount, sizeof(objectCount)))
+                return false;
+
+            if (memcmp(magic, CACHE_MAGIC, sizeof(magic)) != 0 ||
+                version != CACHE_VERSION ||
+                vertexSize != sizeof(graphics::Vertex) ||
+                cachedDataSize != dataSize ||
+                cachedDataHash != dataHash)
+                return false;
+
+            std::vector<std::string> libraries(libraryCount);
+            for (std::string& library : libraries)
+                if (!reader.readString(library)) return false;
+
+            struct CachedObject
+            {
+                std::string name;
+                std::string material;
+                Box3 boundingBox;
+                const graphics::Vertex* vertices;
+                uint32_t vertexCount;
+                const uint32_t* indices;
+                uint32_t indexCount;
+            };
+
+            // validate the whole file before anything is added to the cache
+            std::vector<CachedObject> objects(objectCount);
+            for (CachedObject& object : objects)
+            {
+                if (!reader.readString(object.name) ||
+                    !reader.readString(object.material) ||
+                    !reader.read(&object.boundingBox.min, sizeof(Vector3)) ||
+                    !reader.read(&object.boundingBox.max, sizeof(Vector3)) ||
+                    !reader.read(&object.vertexCount, sizeof(object.vertexCount)) ||
+                    !reader.read(&object.indexCount, sizeof(object.indexCount)))
+                    return false;
+
+                const uint8_t* vertexData = reader.get(static_cast<size_t>(object.vertexCount) * sizeof(graphics::Vertex));
+                const uint8_t* indexData = reader.get(static_cast<size_t>(object.indexCount) * sizeof(uint32_t));
+                if (!vertexData || !indexData) return false;
+
+                object.vertices = reinterpret_cast<const graphics::Vertex*>(vertexData);
+                object.indices = reinterpret_cast<const uint32_t*>(indexData);
+
+                for (uint32_t i = 0; i < object.indexCount; ++i)
+                    if (object.indices[i] >= object.vertexCount) return false;
+            }
+
+            for (const std::string& library : libraries)
+                cache->loadAsset(library, mipmaps);
+
+            for (const CachedObject& object : objects)
+            {
+                std::shared_ptr<graphics::Material> material;
+                if (!object.material.empty()) material = cache->getMaterial(object.material);
+
+                scene::ModelData modelData;
+                modelData.init(object.boundingBox,
+                               object.indices, object.indexCount,
+                               object.vertices, object.vertexCount,
+                               material);
+                cache->setModelData(object.name.empty() ? filename : object.name, modelData);
+            }
+
+            return true;
+        }
+
         bool LoaderOBJ::loadAsset(const std::string& filename, const std::vector<uint8_t>& data, bool mipmaps)
         {
-            std::string name = filename;
-            std::shared_ptr<graphics::Material> material;
-            std::vector<Vector3> positions;
-            std::vector<Vector2> texCoords;
-            std::vector<Vector3> normals;
-            std::vector<graphics::Vertex> vertices;
-            std::map<std::tuple<uint32_t, uint32_t, uint32_t>, uint32_t> vertexMap;
-            std::vector<uint32_t> indices;
-            Box3 boundingBox;
+            uint64_t dataHash = 0;
+            std::string cachePath;
 
-            uint32_t objectCount = 0;
+            if (data.size() >= MIN_CACHE_SIZE)
+            {
+                dataHash = fnv1aHash64(data.data(), data.size());
+                cachePath = getCachePath(dataHash);
 
-            std::vector<uint8_t>::const_iterator iterator = data.begin();
+                if (!cachePath.empty() && loadCache(filename, cachePath, data.size(), dataHash, mipmaps))
+                    return true;
+            }
 
-            std::string keyword;
-            std::string value;
+            // split the file into line-aligned chunks that are parsed in parallel
+            uint32_t threadCount = std::max(std::thread::hardware_concurrency(), 1U);
+            size_t chunkCount = std::max(std::min(static_cast<size_t>(threadCount), data.size() / MIN_CHUNK_SIZE), static_cast<size_t>(1));
 
-            for (;;)
+            std::vector<ObjChunk> chunks(chunkCount);
+
+            const uint8_t* chunkBegin = data.data();
+            const uint8_t* dataEnd = data.data() + data.size();
+
+            for (size_t i = 0; i < chunkCount; ++i)
             {
-                if (iterator == data.end()) break;
+                const uint8_t* chunkEnd = (i + 1 == chunkCount) ? dataEnd :
+                    std::max(chunkBegin, data.data() + data.size() * (i + 1) / chunkCount);
 
-                if (isNewline(*iterator))
-                {
-                    // skip empty lines
-                    ++iterator;
-                }
-                else if (*iterator == '#')
-                {
-                    // skip the comment
-                    skipLine(data, iterator);
-                }
-                else
-                {
-                    if (!skipWhitespaces(data, iterator) ||
-                        !parseString(data, iterator, keyword))
-                    {
-                        Log(Log::Level::ERR) << "Failed to parse keyword";
-                        return false;
-                    }
+                while (chunkEnd != dataEnd && *chunkEnd != '\n') ++chunkEnd;
+                if (chunkEnd != dataEnd) ++chunkEnd;
 
-                    if (keyword == "mtllib")
-                    {
-                        if (!skipWhitespaces(data, iterator) ||
-                            !parseString(data, iterator, value))
-                        {
-                            Log(Log::Level::ERR) << "Failed to parse material library";
-                            return false;
-                        }
+                chunks[i].begin = chunkBegin;
+                chunks[i].end = chunkEnd;
+                chunkBegin = chunkEnd;
+            }
 
-                        skipLine(data, iterator);
+            std::vector<std::thread> threads;
+            for (size_t i = 1; i < chunkCount; ++i)
+                threads.push_back(std::thread(parseChunk, std::ref(chunks[i])));
 
-                        cache->loadAsset(value, mipmaps);
-                    }
-                    else if (keyword == "usemtl")
-                    {
-                        if (!skipWhitespaces(data, iterator) ||
-                            !parseString(data, iterator, value))
-                        {
-                            Log(Log::Level::ERR) << "Failed to parse material name";
-                            return false;
-                        }
+            parseChunk(chunks[0]);
 
-                        skipLine(data, iterator);
+            for (std::thread& thread : threads)
+                thread.join();
 
-                        material = cache->getMaterial(value);
-                    }
-                    else if (keyword == "o")
-                    {
-                        if (objectCount)
-                        {
-                            scene::ModelData modelData;
-                            modelData.init(boundingBox, indices, vertices, material);
-                            engine->getCache()->setModelData(name, modelData);
-                        }
+            std::vector<Vector3> positions;
+            std::vector<Vector2> texCoords;
+            std::vector<Vector3> normals;
 
-                        if (!skipWhitespaces(data, iterator) ||
-                            !parseString(data, iterator, name))
-                        {
-                            Log(Log::Level::ERR) << "Failed to parse object name";
-                            return false;
-                        }
+            size_t positionCount = 0;
+            size_t texCoordCount = 0;
+            size_t normalCount = 0;
 
-                        skipLine(data, iterator);
+            for (ObjChunk& chunk : chunks)
+            {
+                if (chunk.error)
+                {
+                    Log(Log::Level::ERR) << chunk.error;
+                    return false;
+                }
 
-                        material.reset();
-                        positions.clear();
-                        texCoords.clear();
-                        normals.clear();
-                        vertices.clear();
-                        indices.clear();
-                        boundingBox.reset();
-                        ++objectCount;
-                    }
-                    else if (keyword == "v")
-                    {
-                        Vector3 position;
-
-                        if (!skipWhitespaces(data, iterator) ||
-                            !parseFloat(data, iterator, position.x) ||
-                            !skipWhitespaces(data, iterator) ||
-                            !parseFloat(data, iterator, position.y) ||
-                            !skipWhitespaces(data, iterator) ||
-                            !parseFloat(data, iterator, position.z))
-                        {
-                            Log(Log::Level::ERR) << "Failed to parse position";
-                            return false;
-                        }
+                for (const ObjFixup& fixup : chunk.fixups)
+                {
+                    ObjCorner& corner = chunk.corners[fixup.corner];
+                    if (fixup.mask & 1) corner.position += static_cast<uint32_t>(positionCount);
+                    if (fixup.mask & 2) corner.texCoord += static_cast<uint32_t>(texCoordCount);
+                    if (fixup.mask & 4) corner.normal += static_cast<uint32_t>(normalCount);
+                }
 
-                        skipLine(data, iterator);
+                positionCount += chunk.positions.size();
+                texCoordCount += chunk.texCoords.size();
+                normalCount += chunk.normals.size();
+            }
 
-                        positions.push_back(position);
-                    }
-                    else if (keyword == "vt")
-                    {
-                        Vector3 texCoord;
+            positions.reserve(positionCount);
+            texCoords.reserve(texCoordCount);
+            normals.reserve(normalCount);
 
-                        if (!skipWhitespaces(data, iterator) ||
-                            !parseFloat(data, iterator, texCoord.x) ||
-                            !skipWhitespaces(data, iterator) ||
-                            !parseFloat(data, iterator, texCoord.y))
-                        {
-                            Log(Log::Level::ERR) << "Failed to parse texture coordinates";
-                            return false;
-                        }
+            for (ObjChunk& chunk : chunks)
+            {
+                positions.insert(positions.end(), chunk.positions.begin(), chunk.positions.end());
+                texCoords.insert(texCoords.end(), chunk.texCoords.begin(), chunk.texCoords.end());
+                normals.insert(normals.end(), chunk.normals.begin(), chunk.normals.end());
+                std::vector<Vector3>().swap(chunk.positions);
+                std::vector<Vector2>().swap(chunk.texCoords);
+                std::vector<Vector3>().swap(chunk.normals);
+            }
 
-                        skipLine(data, iterator);
+            // walk the faces and statements in the file order
+            std::vector<std::string> libraries;
+            std::vector<ObjObject> objects;
+            ObjObject object;
+            ObjVertexTable vertexTable;
 
-                        texCoords.push_back(texCoord);
-                    }
-                    else if (keyword == "vn")
+            for (const ObjChunk& chunk : chunks)
+            {
+                auto statement = chunk.statements.begin();
+
+                for (uint32_t c = 0;; ++c)
+                {
+                    for (; statement != chunk.statements.end() && statement->corner == c; ++statement)
                     {
-                        Vector3 normal;
-
-                        if (!skipWhitespaces(data, iterator) ||
-                            !parseFloat(data, iterator, normal.x) ||
-                            !skipWhitespaces(data, iterator) ||
-                            !parseFloat(data, iterator, normal.y) ||
-                            !skipWhitespaces(data, iterator) ||
-                            !parseFloat(data, iterator, normal.z))
+                        switch (statement->type)
                         {
-                            Log(Log::Level::ERR) << "Failed to parse normal";
-                            return false;
+                            case ObjStatement::Type::OBJECT:
+                                if (!object.indices.empty()) objects.push_back(std::move(object));
+                                object = ObjObject();
+                                object.name = statement->value;
+                                vertexTable.clear();
+                                break;
+                            case ObjStatement::Type::MATERIAL:
+                                object.material = statement->value;
+                                break;
+                            case ObjStatement::Type::MATERIAL_LIBRARY:
+                                libraries.push_back(statement->value);
+                                break;
                         }
-
-                        skipLine(data, iterator);
-
-                        normals.push_back(normal);
                     }
-                    else if (keyword == "f")
-                    {
-                        std::vector<uint32_t> vertexIndices;
 
-                        std::tuple<uint32_t, uint32_t, uint32_t> i = std::make_tuple(0, 0, 0);
-                        int32_t positionIndex = 0, texCoordIndex = 0, normalIndex = 0;
+                    if (c == chunk.corners.size()) break;
 
-                        for (;;)
-                        {
-                            if (iterator == data.end() || isNewline(*iterator)) break;
-
-                            if (!skipWhitespaces(data, iterator))
-                            {
-                                Log(Log::Level::ERR) << "Failed to parse face";
-                                return false;
-                            }
-
-                            if (!parseInt32(data, iterator, positionIndex) ||
-                                !parseToken(data, iterator, '/') ||
-                                !parseInt32(data, iterator, texCoordIndex) ||
-                                !parseToken(data, iterator, '/') ||
-                                !parseInt32(data, iterator, normalIndex))
-                            {
-                                Log(Log::Level::ERR) << "Failed to parse face";
-                                return false;
-                            }
-
-                            if (positionIndex < 0)
-                                std::get<0>(i) = static_cast<uint32_t>(static_cast<long>(positions.size()) + positionIndex);
-                            else if (positionIndex > 0)
-                                std::get<0>(i) = static_cast<uint32_t>(positionIndex - 1);
-                            else
-                            {
-                                Log(Log::Level::ERR) << "Failed to parse face";
-                                return false;
-                            }
-
-                            if (texCoordIndex < 0)
-                                std::get<1>(i) = static_cast<uint32_t>(static_cast<long>(texCoords.size()) + texCoordIndex);
-                            else if (texCoordIndex > 0)
-                                std::get<1>(i) = static_cast<uint32_t>(texCoordIndex - 1);
-                            else
-                            {
-                                Log(Log::Level::ERR) << "Failed to parse face";
-                                return false;
-                            }
-
-                            if (normalIndex < 0)
-                                std::get<2>(i) = static_cast<uint32_t>(static_cast<long>(normals.size()) + normalIndex);
-                            else if (normalIndex > 0)
-                                std::get<2>(i) = static_cast<uint32_t>(normalIndex - 1);
-                            else
-                            {
-                                Log(Log::Level::ERR) << "Failed to parse face";
-                                return false;
-                            }
-
-                            auto vertexIterator = vertexMap.find(i);
-                            if (vertexIterator != vertexMap.end())
-                            {
-                                vertexIndices.push_back(vertexIterator->second);
-                            }
-                            else
-                            {
-                                graphics::Vertex vertex;
-                                vertex.position = positions[std::get<0>(i)];
-                                vertex.texCoords[0] = texCoords[std::get<1>(i)];
-                                vertex.color = Color::WHITE;
-                                vertex.normal = normals[std::get<2>(i)];
-                                vertexIndices.push_back(static_cast<uint32_t>(vertices.size()));
-                                vertices.push_back(vertex);
-                                boundingBox.insertPoint(vertex.position);
-                            }
-                        }
+                    const ObjCorner& corner = chunk.corners[c];
 
-                        if (vertexIndices.size() < 3)
-                        {
-                            Log(Log::Level::ERR) << "Invalid face count";
-                            return false;
-                        }
-                        else if (vertexIndices.size() == 3)
-                        {
-                            for (uint32_t vertexIndex : vertexIndices)
-                            {
-                                indices.push_back(vertexIndex);
-                            }
-                        }
-                        else
-                        {
-                            // TODO: implement
-                            Log(Log::Level::ERR) << "Non-triangle faces are not supported";
-                            return false;
-                        }
+                    if (corner.position >= positions.size() ||
+                        (corner.texCoord != NO_INDEX && corner.texCoord >= texCoords.size()) ||
+                        (corner.normal != NO_INDEX && corner.normal >= normals.size()))
+                    {
+                        Log(Log::Level::ERR) << "Invalid vertex index";
+                        return false;
                     }
-                    else
+
+                    uint32_t newIndex = static_cast<uint32_t>(object.vertices.size());
+                    uint32_t index = vertexTable.insert(corner, newIndex);
+
+                    if (index == newIndex)
                     {
-                        // skip all unknown commands
-                        skipLine(data, iterator);
+                        graphics::Vertex vertex;
+                        vertex.position = positions[corner.position];
+                        if (corner.texCoord != NO_INDEX) vertex.texCoords[0] = texCoords[corner.texCoord];
+                        vertex.color = Color::WHITE;
+                        if (corner.normal != NO_INDEX) vertex.normal = normals[corner.normal];
+                        object.vertices.push_back(vertex);
+                        object.boundingBox.insertPoint(vertex.position);
                     }
 
-                    if (!objectCount) ++objectCount; // if we got at least one attribute, we have an object
+                    object.indices.push_back(index);
                 }
             }
 
-            if (objectCount)
+            if (!object.indices.empty()) objects.push_back(std::move(object));
+
+            if (!cachePath.empty() &&
+                !writeCache(cachePath, data.size(), dataHash, libraries, objects))
+                Log(Log::Level::WARN) << "Failed to write model cache " << cachePath;
+
+            for (const std::string& library : libraries)
+                cache->loadAsset(library, mipmaps);
+
+            for (const ObjObject& result : objects)
             {
+                std::shared_ptr<graphics::Material> material;
+                if (!result.material.empty()) material = cache->getMaterial(result.material);
+
                 scene::ModelData modelData;
-                modelData.init(boundingBox, indices, vertices, material);
-                engine->getCache()->setModelData(name, modelData);
+                modelData.init(result.boundingBox, result.indices, result.vertices, material);
+                cache->setModelData(result.name.empty() ? filename : result.name, modelData);
             }
 
             return true;
@@ -16,6 +16,11 @@ namespace ouzel
 
             LoaderOBJ();
             virtual bool loadAsset(const std::string& filename, const std::vector<uint8_t>& data, bool mipmaps = true) override;
+
+        private:
+            // loads the models from a binary cache written by a previous load of the same data
+            bool loadCache(const std::string& filename, const std::string& path,
+                           uint64_t dataSize, uint64_t dataHash, bool mipmaps);
         };
     } // namespace assets
 } // namespace ouzel
@@ -6,7 +6,7 @@
 #include "core/Engine.hpp"
 #include "files/FileSystem.hpp"
 #include "scene/ParticleSystemData.hpp"
-#include "utils/JSON.hpp"
+#include "utils/JSONDocument.hpp"
 #include "utils/Log.hpp"
 
 namespace ouzel
@@ -22,7 +22,7 @@ namespace ouzel
         {
             scene::ParticleSystemData particleSystemData;
 
-            json::Data document;
+            json::Document document;
 
             if (!document.init(data))
             {
@@ -35,7 +35,7 @@ namespace ouzel
                 return false;
             }
 
-            particleSystemData.name = document["configName"].asString();
+            particleSystemData.name = document["configName"].asString().str();
 
             if (document.hasMember("blendFuncSource")) particleSystemData.blendFuncSource = document["blendFuncSource"].asUInt32();
             if (document.hasMember("blendFuncDestination")) particleSystemData.blendFuncDestination = document["blendFuncDestination"].asUInt32();
@@ -114,7 +114,7 @@ namespace ouzel
             if (document.hasMember("finishColorVarianceBlue")) particleSystemData.finishColorBlueVariance = document["finishColorVarianceBlue"].asFloat();
             if (document.hasMember("finishColorVarianceAlpha")) particleSystemData.finishColorAlphaVariance = document["finishColorVarianceAlpha"].asFloat();
 
-            if (document.hasMember("textureFileName")) particleSystemData.texture = engine->getCache()->getTexture(document["textureFileName"].asString(), mipmaps);
+            if (document.hasMember("textureFileName")) particleSystemData.texture = engine->getCache()->getTexture(document["textureFileName"].asString().str(), mipmaps);
 
             particleSystemData.emissionRate = static_cast<float>(particleSystemData.maxParticles) / particleSystemData.particleLifespan;
 
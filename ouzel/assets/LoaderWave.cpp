@@ -3,7 +3,10 @@
 
 #include "LoaderWave.hpp"
 #include "Cache.hpp"
+#include "audio/Audio.hpp"
+#include "audio/AudioDevice.hpp"
 #include "audio/SoundDataWave.hpp"
+#include "core/Engine.hpp"
 
 namespace ouzel
 {
@@ -16,12 +19,20 @@ namespace ouzel
 
         bool LoaderWave::loadAsset(const std::string& filename, const std::vector<uint8_t>& data, bool)
         {
-            std::shared_ptr<audio::SoundData> soundData = std::make_shared<audio::SoundDataWave>();
+            std::shared_ptr<audio::SoundDataWave> soundData = std::make_shared<audio::SoundDataWave>();
             if (!soundData->init(data))
             {
                 return false;
             }
 
+            audio::Audio* audio = engine->getAudio();
+
+            if (audio->isResampleOnLoad() &&
+                !soundData->resample(audio->getDevice()->getSampleRate(), audio->getResamplerQuality()))
+            {
+                return false;
+            }
+
             cache->setSoundData(filename, soundData);
 
             return true;
@@ -0,0 +1,294 @@
+// Copyright (C) 2018 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#include <algorithm>
+#include <cstring>
+#include "TextureAtlas.hpp"
+#include "core/Engine.hpp"
+#include "utils/Log.hpp"
+
+namespace ouzel
+{
+    namespace assets
+    {
+        TextureAtlas::TextureAtlas():
+            updateCallback(-UpdateCallback::PRIORITY_MAX)
+        {
+            // run after all other update callbacks, so that images added during the update are visible in the same frame
+            updateCallback.callback = [this](float) {
+                upload();
+            };
+        }
+
+        bool TextureAtlas::addImage(const std::string& name, const graphics::ImageData& image, Region& region)
+        {
+            if (!enabled ||
+                image.getPixelFormat() != graphics::PixelFormat::RGBA8_UNORM)
+            {
+                return false;
+            }
+
+            uint32_t imageWidth = static_cast<uint32_t>(image.getSize().width);
+            uint32_t imageHeight = static_cast<uint32_t>(image.getSize().height);
+
+            if (imageWidth == 0 || imageHeight == 0 ||
+                imageWidth > maxImageSize || imageHeight > maxImageSize)
+            {
+                return false;
+            }
+
+            uint32_t width = imageWidth + padding * 2;
+            uint32_t height = imageHeight + padding * 2;
+
+            if (width > pageSize || height > pageSize)
+            {
+                return false;
+            }
+
+            uint32_t pageIndex = 0;
+            uint32_t nodeIndex = 0;
+            uint32_t x = 0;
+            uint32_t y = 0;
+
+            for (; pageIndex < pages.size(); ++pageIndex)
+            {
+                if (findPosition(pages[pageIndex], width, height, nodeIndex, x, y)) break;
+            }
+
+            if (pageIndex == pages.size())
+            {
+                Page page;
+                page.size = pageSize;
+                page.data.resize(static_cast<size_t>(pageSize) * pageSize * 4);
+                page.skyline.push_back({0, 0, pageSize});
+
+                // pages don't have mip chains, the padding keeps the linear filter from sampling neighbouring images
+                page.texture = std::make_shared<graphics::Texture>();
+                if (!page.texture->init(Size2(static_cast<float>(pageSize), static_cast<float>(pageSize)),
+                                        graphics::Texture::DYNAMIC, 1, 1,
+                                        graphics::PixelFormat::RGBA8_UNORM))
+                {
+                    Log(Log::Level::ERR) << "Failed to create texture atlas page";
+                    return false;
+                }
+
+                pages.push_back(std::move(page));
+
+                if (!findPosition(pages.back(), width, height, nodeIndex, x, y))
+                {
+                    return false;
+                }
+            }
+
+            Page& page = pages[pageIndex];
+            addSkylineNode(page, nodeIndex, x, y, width, height);
+            copyImage(page, image, x, y);
+
+            page.usedArea += static_cast<uint64_t>(width) * height;
+            ++page.imageCount;
+            page.dirty = true;
+
+            region.texture = page.texture;
+            region.rectangle = Rectangle(static_cast<float>(x + padding),
+                                         static_cast<float>(y + padding),
+                                         static_cast<float>(imageWidth),
+                                         static_cast<float>(imageHeight));
+
+            regions[name] = region;
+
+            if (!uploadScheduled)
+            {
+                engine->scheduleUpdate(&updateCallback);
+                uploadScheduled = true;
+            }
+
+            return true;
+        }
+
+        bool TextureAtlas::getRegion(const std::string& name, Region& region) const
+        {
+            auto i = regions.find(name);
+
+            if (i == regions.end())
+            {
+                return false;
+            }
+
+            region = i->second;
+
+            return true;
+        }
+
+        void TextureAtlas::clear()
+        {
+            upload();
+
+            pages.clear();
+            regions.clear();
+        }
+
+        uint32_t TextureAtlas::getPageImageCount(uint32_t page) const
+        {
+            if (page >= pages.size()) return 0;
+
+            return pages[page].imageCount;
+        }
+
+        float TextureAtlas::getPageOccupancy(uint32_t page) const
+        {
+            if (page >= pages.size()) return 0.0f;
+
+            return static_cast<float>(pages[page].usedArea) /
+                (static_cast<float>(pages[page].size) * static_cast<float>(pages[page].size));
+        }
+
+        void TextureAtlas::upload()
+        {
+            if (uploadScheduled)
+            {
+                updateCallback.remove();
+                uploadScheduled = false;
+            }
+
+            for (uint32_t pageIndex = 0; pageIndex < pages.size(); ++pageIndex)
+            {
+                Page& page = pages[pageIndex];
+
+                if (page.dirty)
+                {
+                    page.texture->setData(page.data, Size2(static_cast<float>(page.size), static_cast<float>(page.size)));
+                    page.dirty = false;
+
+                    Log(Log::Level::ALL) << "Texture atlas page " << pageIndex << ": " <<
+                        page.imageCount << " images, " <<
+                        static_cast<uint32_t>(getPageOccupancy(pageIndex) * 100.0f) << "% occupied";
+                }
+            }
+
+            if (!regions.empty())
+            {
+                // every image on a page can be drawn without switching the texture
+                Log(Log::Level::ALL) << "Texture atlas: " << regions.size() << " images in " <<
+                    pages.size() << " textures";
+            }
+        }
+
+        // skyline bottom-left: picks the position with the lowest top edge, then the narrowest node
+        bool TextureAtlas::findPosition(const Page& page, uint32_t width, uint32_t height,
+                                        uint32_t& bestNode, uint32_t& bestX, uint32_t& bestY)
+        {
+            uint32_t bestTop = UINT32_MAX;
+            uint32_t bestWidth = UINT32_MAX;
+
+            for (uint32_t nodeIndex = 0; nodeIndex < page.skyline.size(); ++nodeIndex)
+            {
+                const SkylineNode& node = page.skyline[nodeIndex];
+
+                if (node.x + width > page.size) break;
+
+                // the rectangle rests on the highest node it spans
+                uint32_t y = 0;
+                uint32_t widthLeft = width;
+                bool fits = true;
+
+                for (uint32_t i = nodeIndex; widthLeft > 0; ++i)
+                {
+                    y = std::max(y, page.skyline[i].y);
+
+                    if (y + height > page.size)
+                    {
+                        fits = false;
+                        break;
+                    }
+
+                    widthLeft = (page.skyline[i].width < widthLeft) ? widthLeft - page.skyline[i].width : 0;
+                }
+
+                if (!fits) continue;
+
+                if (y + height < bestTop ||
+                    (y + height == bestTop && node.width < bestWidth))
+                {
+                    bestNode = nodeIndex;
+                    bestX = node.x;
+                    bestY = y;
+                    bestTop = y + height;
+                    bestWidth = node.width;
+                }
+            }
+
+            return bestTop != UINT32_MAX;
+        }
+
+        void TextureAtlas::addSkylineNode(Page& page, uint32_t nodeIndex, uint32_t x, uint32_t y, uint32_t width, uint32_t height)
+        {
+            SkylineNode newNode = {x, y + height, width};
+            page.skyline.insert(page.skyline.begin() + nodeIndex, newNode);
+
+            // shrink or remove the nodes that are now covered by the new one
+            for (uint32_t i = nodeIndex + 1; i < page.skyline.size();)
+            {
+                SkylineNode& node = page.skyline[i];
+                const SkylineNode& previous = page.skyline[i - 1];
+
+                if (node.x >= previous.x + previous.width) break;
+
+                uint32_t shrink = previous.x + previous.width - node.x;
+
+                if (shrink < node.width)
+                {
+                    node.x += shrink;
+                    node.width -= shrink;
+                    break;
+                }
+
+                page.skyline.erase(page.skyline.begin() + i);
+            }
+
+            // merge neighbours with the same height
+            for (uint32_t i = 0; i + 1 < page.skyline.size();)
+            {
+                if (page.skyline[i].y == page.skyline[i + 1].y)
+                {
+                    page.skyline[i].width += page.skyline[i + 1].width;
+                    page.skyline.erase(page.skyline.begin() + i + 1);
+                }
+                else
+                {
+                    ++i;
+                }
+            }
+        }
+
+        void TextureAtlas::copyImage(Page& page, const graphics::ImageData& image, uint32_t x, uint32_t y) const
+        {
+            const uint32_t pixelSize = 4;
+            uint32_t imageWidth = static_cast<uint32_t>(image.getSize().width);
+            uint32_t imageHeight = static_cast<uint32_t>(image.getSize().height);
+            size_t pagePitch = static_cast<size_t>(page.size) * pixelSize;
+            size_t imagePitch = static_cast<size_t>(imageWidth) * pixelSize;
+            const uint8_t* imageData = image.getData().data();
+
+            // every row of the padded rectangle gets the nearest image row with its edge pixels extruded
+            for (uint32_t row = 0; row < imageHeight + padding * 2; ++row)
+            {
+                uint32_t sourceRow = (row < padding) ? 0 : std::min(row - padding, imageHeight - 1);
+                const uint8_t* source = imageData + sourceRow * imagePitch;
+                uint8_t* destination = page.data.data() + (y + row) * pagePitch + static_cast<size_t>(x) * pixelSize;
+
+                for (uint32_t column = 0; column < padding; ++column)
+                {
+                    std::memcpy(destination + column * pixelSize, source, pixelSize);
+                }
+
+                std::memcpy(destination + padding * pixelSize, source, imagePitch);
+
+                for (uint32_t column = 0; column < padding; ++column)
+                {
+                    std::memcpy(destination + (padding + imageWidth + column) * pixelSize,
+                                source + imagePitch - pixelSize, pixelSize);
+                }
+            }
+        }
+    } // namespace assets
+} // namespace ouzel
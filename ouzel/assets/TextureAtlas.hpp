@@ -0,0 +1,101 @@
+// Copyright (C) 2018 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "utils/Noncopyable.hpp"
+#include "core/UpdateCallback.hpp"
+#include "graphics/ImageData.hpp"
+#include "graphics/Texture.hpp"
+#include "math/Rectangle.hpp"
+
+namespace ouzel
+{
+    namespace assets
+    {
+        // packs small images into shared texture pages, so that sprites from different files use the same texture
+        class TextureAtlas: public Noncopyable
+        {
+        public:
+            struct Region
+            {
+                std::shared_ptr<graphics::Texture> texture;
+                // position and size of the image in the texture in pixels
+                Rectangle rectangle;
+            };
+
+            TextureAtlas();
+
+            bool isEnabled() const { return enabled; }
+            void setEnabled(bool newEnabled) { enabled = newEnabled; }
+
+            // only affects pages that are created afterwards
+            uint32_t getPageSize() const { return pageSize; }
+            void setPageSize(uint32_t newPageSize) { pageSize = newPageSize; }
+
+            // images with a bigger width or height are not packed
+            uint32_t getMaxImageSize() const { return maxImageSize; }
+            void setMaxImageSize(uint32_t newMaxImageSize) { maxImageSize = newMaxImageSize; }
+
+            // number of pixels around each image that are filled with its edge pixels
+            uint32_t getPadding() const { return padding; }
+            void setPadding(uint32_t newPadding) { padding = newPadding; }
+
+            // returns false if the image can not be packed and should get its own texture
+            bool addImage(const std::string& name, const graphics::ImageData& image, Region& region);
+            bool getRegion(const std::string& name, Region& region) const;
+
+            // pages stay alive as long as sprites reference their textures
+            void clear();
+
+            uint32_t getImageCount() const { return static_cast<uint32_t>(regions.size()); }
+            uint32_t getPageCount() const { return static_cast<uint32_t>(pages.size()); }
+            uint32_t getPageImageCount(uint32_t page) const;
+            // ratio of the page area covered by images, including padding
+            float getPageOccupancy(uint32_t page) const;
+
+            // uploads the modified pages, called automatically before the scene is drawn
+            void upload();
+
+        private:
+            struct SkylineNode
+            {
+                uint32_t x;
+                uint32_t y;
+                uint32_t width;
+            };
+
+            struct Page
+            {
+                std::shared_ptr<graphics::Texture> texture;
+                uint32_t size = 0;
+                std::vector<uint8_t> data;
+                std::vector<SkylineNode> skyline;
+                uint64_t usedArea = 0;
+                uint32_t imageCount = 0;
+                bool dirty = false;
+            };
+
+            static bool findPosition(const Page& page, uint32_t width, uint32_t height,
+                                     uint32_t& bestNode, uint32_t& bestX, uint32_t& bestY);
+            static void addSkylineNode(Page& page, uint32_t nodeIndex, uint32_t x, uint32_t y, uint32_t width, uint32_t height);
+            void copyImage(Page& page, const graphics::ImageData& image, uint32_t x, uint32_t y) const;
+
+            bool enabled = true;
+            uint32_t pageSize = 2048;
+            uint32_t maxImageSize = 512;
+            uint32_t padding = 2;
+
+            std::vector<Page> pages;
+            std::map<std::string, Region> regions;
+
+            UpdateCallback updateCallback;
+            bool uploadScheduled = false;
+        };
+    } // namespace assets
+} // namespace ouzel
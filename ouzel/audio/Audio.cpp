@@ -18,7 +18,6 @@
 #include "openal/AudioDeviceAL.hpp"
 #include "opensl/AudioDeviceSL.hpp"
 #include "xaudio2/AudioDeviceXA2.hpp"
-#include "math/MathUtils.hpp"
 #include "utils/Log.hpp"
 
 namespace ouzel
@@ -170,50 +169,5 @@ namespace ouzel
                 }
             }
         }
-
-        void Audio::resampleLerp(const std::vector<float>& src, uint32_t srcFrames,
-                                 std::vector<float>& dst, uint32_t dstFrames,
-                                 uint32_t channels)
-        {
-            if (dstFrames > 0) // do resampling only if destination is not empty
-            {
-                if (srcFrames == 0) // source is empty
-                {
-                    dst.resize(dstFrames * channels);
-
-                    std::fill(dst.begin(), dst.end(), 0.0f);
-                }
-                else
-                {
-                    float srcIncrement = static_cast<float>(srcFrames - 1) / static_cast<float>(dstFrames - 1);
-                    float srcPosition = 0.0f;
-
-                    dst.resize(dstFrames * channels);
-
-                    for (uint32_t frame = 0; frame < dstFrames - 1; ++frame)
-                    {
-                        uint32_t srcCurrentFrame = static_cast<uint32_t>(srcPosition);
-                        float frac = srcPosition - srcCurrentFrame;
-
-                        srcPosition += srcIncrement;
-                        uint32_t srcNextFrame = srcCurrentFrame + 1;
-
-                        for (uint32_t channel = 0; channel < channels; ++channel)
-                        {
-                            uint32_t srcCurrentPosition = srcCurrentFrame * channels + channel;
-                            uint32_t srcNextPosition = srcNextFrame * channels + channel;
-
-                            dst[frame * channels + channel] = ouzel::lerp(src[srcCurrentPosition], src[srcNextPosition], frac);
-                        }
-                    }
-
-                    // fill the last frame of the destination with the last frame of the source
-                    for (uint32_t channel = 0; channel < channels; ++channel)
-                    {
-                        dst[(dstFrames - 1) * channels + channel] = src[(srcFrames - 1) * channels + channel];
-                    }
-                }
-            }
-        }
     } // namespace audio
 } // namespace ouzel
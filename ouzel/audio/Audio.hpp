@@ -8,6 +8,7 @@
 #include <memory>
 #include <set>
 #include <vector>
+#include "audio/Resampler.hpp"
 #include "utils/Noncopyable.hpp"
 #include "math/Quaternion.hpp"
 #include "math/Vector3.hpp"
@@ -79,9 +80,12 @@ namespace ouzel
             void addListener(Listener* listener);
             void removeListener(Listener* listener);
 
-            static void resampleLerp(const std::vector<float>& src, uint32_t srcFrames,
-                                     std::vector<float>& dst, uint32_t dstFrames,
-                                     uint32_t channels);
+            Resampler::Quality getResamplerQuality() const { return resamplerQuality; }
+            void setResamplerQuality(Resampler::Quality newQuality) { resamplerQuality = newQuality; }
+
+            // if set, sound data is converted to the device sample rate when loaded
+            bool isResampleOnLoad() const { return resampleOnLoad; }
+            void setResampleOnLoad(bool newResampleOnLoad) { resampleOnLoad = newResampleOnLoad; }
 
         protected:
             Audio(Driver driver);
@@ -89,6 +93,9 @@ namespace ouzel
 
             std::unique_ptr<AudioDevice> device;
 
+            Resampler::Quality resamplerQuality = Resampler::Quality::SINC;
+            bool resampleOnLoad = false;
+
             std::vector<Listener*> listeners;
         };
     } // namespace audio
@@ -27,6 +27,9 @@ namespace ouzel
             inline uint16_t getAPIMajorVersion() const { return apiMajorVersion; }
             inline uint16_t getAPIMinorVersion() const { return apiMinorVersion; }
 
+            inline uint32_t getSampleRate() const { return sampleRate; }
+            inline uint16_t getChannels() const { return channels; }
+
             void executeOnAudioThread(const std::function<void(void)>& func);
 
             struct RenderCommand
@@ -0,0 +1,310 @@
+// Copyright (C) 2018 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#include <algorithm>
+#include <cmath>
+#include "core/Setup.h"
+#if OUZEL_SUPPORTS_SSE
+#include <xmmintrin.h>
+#elif OUZEL_SUPPORTS_NEON || OUZEL_SUPPORTS_NEON64
+#include <arm_neon.h>
+#endif
+#include "Resampler.hpp"
+#include "math/MathUtils.hpp"
+#include "utils/Utils.hpp"
+
+namespace ouzel
+{
+    namespace audio
+    {
+        // count must be a multiple of 4
+        static inline float dotProduct(const float* a, const float* b, uint32_t count)
+        {
+#if OUZEL_SUPPORTS_SSE
+            __m128 sum = _mm_setzero_ps();
+            for (uint32_t i = 0; i < count; i += 4)
+            {
+                sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+            }
+            sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+            sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+            return _mm_cvtss_f32(sum);
+#elif OUZEL_SUPPORTS_NEON || OUZEL_SUPPORTS_NEON64
+    #if OUZEL_SUPPORTS_NEON_CHECK
+            if (anrdoidNEONChecker.isNEONAvailable())
+            {
+    #endif
+            float32x4_t sum = vdupq_n_f32(0.0f);
+            for (uint32_t i = 0; i < count; i += 4)
+            {
+                sum = vmlaq_f32(sum, vld1q_f32(a + i), vld1q_f32(b + i));
+            }
+            float32x2_t pair = vadd_f32(vget_low_f32(sum), vget_high_f32(sum));
+            return vget_lane_f32(vpadd_f32(pair, pair), 0);
+    #if OUZEL_SUPPORTS_NEON_CHECK
+            }
+    #endif
+#endif
+
+#if (!OUZEL_SUPPORTS_NEON && !OUZEL_SUPPORTS_NEON64 && !OUZEL_SUPPORTS_SSE) || OUZEL_SUPPORTS_NEON_CHECK
+            float sum = 0.0f;
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                sum += a[i] * b[i];
+            }
+            return sum;
+#endif
+        }
+
+        // windowed sinc sampled at SINC_TABLE_RESOLUTION points per source frame, it is computed once and
+        // interpolated when the filter is rebuilt, so ratio changes on the audio thread don't call any trigonometric functions
+        static const uint32_t SINC_TABLE_RESOLUTION = 512;
+        static const uint32_t SINC_TABLE_SIZE = Resampler::SINC_HALF_TAPS * SINC_TABLE_RESOLUTION + 2;
+
+        struct SincTable
+        {
+            SincTable()
+            {
+                for (uint32_t i = 0; i < SINC_TABLE_SIZE; ++i)
+                {
+                    float x = static_cast<float>(i) / static_cast<float>(SINC_TABLE_RESOLUTION);
+                    float t = x / static_cast<float>(Resampler::SINC_HALF_TAPS);
+
+                    sinc[i] = (x < EPSILON) ? 1.0f : sinf(PI * x) / (PI * x);
+                    // Blackman window
+                    window[i] = (t < 1.0f) ? 0.42f + 0.5f * cosf(PI * t) + 0.08f * cosf(TAU * t) : 0.0f;
+                }
+            }
+
+            float sinc[SINC_TABLE_SIZE];
+            float window[SINC_TABLE_SIZE];
+        };
+
+        static const SincTable& getSincTable()
+        {
+            static const SincTable sincTable;
+            return sincTable;
+        }
+
+        // both functions are even
+        static inline float sampleTable(const float* table, float x)
+        {
+            float position = fabsf(x) * static_cast<float>(SINC_TABLE_RESOLUTION);
+            uint32_t index = static_cast<uint32_t>(position);
+
+            if (index >= SINC_TABLE_SIZE - 1) return table[SINC_TABLE_SIZE - 1];
+
+            return table[index] + (position - static_cast<float>(index)) * (table[index + 1] - table[index]);
+        }
+
+        Resampler::Resampler(Quality initQuality):
+            quality(initQuality)
+        {
+            if (quality == Quality::SINC) updateFilter();
+            reset();
+        }
+
+        void Resampler::reset()
+        {
+            // keep halfTaps - 1 silent frames before the first source frame so that the kernel never reads before the buffer
+            bufferFrames = getHalfTaps() - 1;
+            position = static_cast<double>(bufferFrames);
+            idle = true;
+
+            for (std::vector<float>& buffer : buffers)
+            {
+                if (buffer.size() < bufferFrames) buffer.resize(bufferFrames);
+                std::fill(buffer.begin(), buffer.begin() + bufferFrames, 0.0f);
+            }
+        }
+
+        void Resampler::setQuality(Quality newQuality)
+        {
+            if (quality != newQuality)
+            {
+                quality = newQuality;
+                if (quality == Quality::SINC) updateFilter();
+                reset();
+            }
+        }
+
+        void Resampler::setChannels(uint16_t newChannels)
+        {
+            if (channels != newChannels)
+            {
+                channels = newChannels;
+                buffers.resize(channels);
+                reset();
+            }
+        }
+
+        void Resampler::setRatio(float newRatio)
+        {
+            if (newRatio > 0.0f && static_cast<float>(ratio) != newRatio)
+            {
+                ratio = newRatio;
+                if (quality == Quality::SINC) updateFilter();
+            }
+        }
+
+        void Resampler::updateFilter()
+        {
+            // lower the cutoff frequency when downsampling to avoid aliasing
+            float cutoff = (ratio > 1.0) ? static_cast<float>(1.0 / ratio) : 1.0f;
+
+            if (!filter.empty() && fabsf(cutoff - filterCutoff) < 0.01f) return;
+
+            filterCutoff = cutoff;
+            filter.resize((SINC_PHASES + 1) * SINC_TAPS);
+
+            const SincTable& sincTable = getSincTable();
+
+            for (uint32_t phase = 0; phase <= SINC_PHASES; ++phase)
+            {
+                float* coefficients = filter.data() + phase * SINC_TAPS;
+                float offset = static_cast<float>(phase) / static_cast<float>(SINC_PHASES);
+                float sum = 0.0f;
+
+                for (uint32_t tap = 0; tap < SINC_TAPS; ++tap)
+                {
+                    // distance of the tap from the interpolated position in source frames
+                    float x = static_cast<float>(tap) - static_cast<float>(SINC_HALF_TAPS - 1) - offset;
+
+                    coefficients[tap] = cutoff * sampleTable(sincTable.sinc, cutoff * x) * sampleTable(sincTable.window, x);
+                    sum += coefficients[tap];
+                }
+
+                // normalize the phase to unity gain
+                for (uint32_t tap = 0; tap < SINC_TAPS; ++tap)
+                {
+                    coefficients[tap] /= sum;
+                }
+            }
+        }
+
+        uint32_t Resampler::getNeededFrames(uint32_t dstFrames) const
+        {
+            if (dstFrames == 0) return 0;
+
+            double lastPosition = position + (dstFrames - 1) * ratio;
+            uint32_t requiredFrames = static_cast<uint32_t>(lastPosition) + getHalfTaps() + 1;
+
+            return (requiredFrames > bufferFrames) ? requiredFrames - bufferFrames : 0;
+        }
+
+        void Resampler::process(const float* src, uint32_t srcFrames, float* dst, uint32_t dstFrames)
+        {
+            if (channels == 0) return;
+
+            uint32_t halfTaps = getHalfTaps();
+
+            // source frames are padded with silence if the caller did not provide enough of them
+            uint32_t newFrames = std::max(srcFrames, getNeededFrames(dstFrames));
+
+            for (uint16_t channel = 0; channel < channels; ++channel)
+            {
+                std::vector<float>& buffer = buffers[channel];
+                if (buffer.size() < bufferFrames + newFrames) buffer.resize(bufferFrames + newFrames);
+
+                float* bufferData = buffer.data() + bufferFrames;
+
+                for (uint32_t frame = 0; frame < srcFrames; ++frame)
+                {
+                    bufferData[frame] = src[frame * channels + channel];
+                }
+
+                std::fill(bufferData + srcFrames, bufferData + newFrames, 0.0f);
+            }
+
+            bufferFrames += newFrames;
+            if (srcFrames > 0) idle = false;
+
+            for (uint32_t frame = 0; frame < dstFrames; ++frame)
+            {
+                uint32_t srcFrame = static_cast<uint32_t>(position);
+                float offset = static_cast<float>(position - srcFrame);
+                float* dstFrame = dst + frame * channels;
+
+                if (offset == 0.0f && ratio == 1.0)
+                {
+                    for (uint16_t channel = 0; channel < channels; ++channel)
+                    {
+                        dstFrame[channel] = buffers[channel][srcFrame];
+                    }
+                }
+                else if (quality == Quality::LINEAR)
+                {
+                    for (uint16_t channel = 0; channel < channels; ++channel)
+                    {
+                        const float* bufferData = buffers[channel].data();
+                        dstFrame[channel] = ouzel::lerp(bufferData[srcFrame], bufferData[srcFrame + 1], offset);
+                    }
+                }
+                else
+                {
+                    float phasePosition = offset * SINC_PHASES;
+                    uint32_t phase = std::min(static_cast<uint32_t>(phasePosition), SINC_PHASES - 1);
+                    float phaseOffset = phasePosition - phase;
+
+                    const float* coefficients = filter.data() + phase * SINC_TAPS;
+                    const float* nextCoefficients = coefficients + SINC_TAPS;
+
+                    float kernel[SINC_TAPS];
+                    for (uint32_t tap = 0; tap < SINC_TAPS; ++tap)
+                    {
+                        kernel[tap] = coefficients[tap] + phaseOffset * (nextCoefficients[tap] - coefficients[tap]);
+                    }
+
+                    uint32_t first = srcFrame + 1 - SINC_HALF_TAPS;
+
+                    for (uint16_t channel = 0; channel < channels; ++channel)
+                    {
+                        dstFrame[channel] = dotProduct(buffers[channel].data() + first, kernel, SINC_TAPS);
+                    }
+                }
+
+                position += ratio;
+            }
+
+            // drop the frames that the kernel will not reach anymore
+            uint32_t positionFrame = static_cast<uint32_t>(position);
+
+            if (positionFrame + 1 > halfTaps)
+            {
+                uint32_t discardFrames = std::min(positionFrame + 1 - halfTaps, bufferFrames);
+
+                for (std::vector<float>& buffer : buffers)
+                {
+                    std::copy(buffer.begin() + discardFrames, buffer.begin() + bufferFrames, buffer.begin());
+                }
+
+                bufferFrames -= discardFrames;
+                position -= discardFrames;
+            }
+        }
+
+        void Resampler::resample(const std::vector<float>& src, uint16_t channels,
+                                 uint32_t srcSampleRate, uint32_t dstSampleRate,
+                                 std::vector<float>& dst, Quality quality)
+        {
+            if (channels == 0 || srcSampleRate == 0 || dstSampleRate == 0)
+            {
+                dst.clear();
+                return;
+            }
+
+            uint32_t srcFrames = static_cast<uint32_t>(src.size() / channels);
+            uint32_t dstFrames = static_cast<uint32_t>(static_cast<uint64_t>(srcFrames) * dstSampleRate / srcSampleRate);
+
+            Resampler resampler(quality);
+            resampler.setChannels(channels);
+            resampler.ratio = static_cast<double>(srcSampleRate) / static_cast<double>(dstSampleRate);
+            if (quality == Quality::SINC) resampler.updateFilter();
+
+            dst.resize(dstFrames * channels);
+
+            uint32_t neededFrames = std::min(resampler.getNeededFrames(dstFrames), srcFrames);
+            resampler.process(src.data(), neededFrames, dst.data(), dstFrames);
+        }
+    } // namespace audio
+} // namespace ouzel
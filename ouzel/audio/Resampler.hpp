@@ -0,0 +1,71 @@
+// Copyright (C) 2018 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace ouzel
+{
+    namespace audio
+    {
+        class Resampler
+        {
+        public:
+            enum class Quality
+            {
+                LINEAR,
+                SINC
+            };
+
+            static const uint32_t SINC_HALF_TAPS = 8;
+            static const uint32_t SINC_TAPS = SINC_HALF_TAPS * 2;
+            static const uint32_t SINC_PHASES = 256;
+
+            Resampler(Quality initQuality = Quality::SINC);
+
+            void reset();
+
+            Quality getQuality() const { return quality; }
+            void setQuality(Quality newQuality);
+
+            uint16_t getChannels() const { return channels; }
+            void setChannels(uint16_t newChannels);
+
+            // number of source frames consumed per destination frame
+            float getRatio() const { return static_cast<float>(ratio); }
+            void setRatio(float newRatio);
+
+            // true if no source frames have been pushed since the last reset
+            bool isIdle() const { return idle; }
+
+            // number of source frames that have to be passed to process to produce dstFrames
+            uint32_t getNeededFrames(uint32_t dstFrames) const;
+
+            // appends srcFrames interleaved frames to the history and produces dstFrames interleaved frames
+            void process(const float* src, uint32_t srcFrames, float* dst, uint32_t dstFrames);
+
+            // resamples a whole interleaved buffer in one go
+            static void resample(const std::vector<float>& src, uint16_t channels,
+                                 uint32_t srcSampleRate, uint32_t dstSampleRate,
+                                 std::vector<float>& dst, Quality quality = Quality::SINC);
+
+        private:
+            uint32_t getHalfTaps() const { return (quality == Quality::SINC) ? SINC_HALF_TAPS : 1; }
+            void updateFilter();
+
+            Quality quality;
+            uint16_t channels = 0;
+            double ratio = 1.0;
+            double position = 0.0;
+            bool idle = true;
+
+            uint32_t bufferFrames = 0;
+            std::vector<std::vector<float>> buffers; // planar history, one buffer per channel
+
+            float filterCutoff = 0.0f;
+            std::vector<float> filter; // (SINC_PHASES + 1) * SINC_TAPS coefficients
+        };
+    } // namespace audio
+} // namespace ouzel
@@ -30,6 +30,7 @@ namespace ouzel
             {
                 stream = soundData->createStream();
                 stream->setEventListener(this);
+                stream->setResamplerQuality(engine->getAudio()->getResamplerQuality());
             }
 
             return true;
@@ -216,6 +217,7 @@ namespace ouzel
                     if (stream->getShouldReset())
                     {
                         stream->reset();
+                        stream->resetResampler();
                         stream->setShouldReset(false);
                     }
 
@@ -3,6 +3,7 @@
 
 #include "SoundData.hpp"
 #include "Audio.hpp"
+#include "Stream.hpp"
 #include "core/Engine.hpp"
 
 namespace ouzel
@@ -35,22 +36,35 @@ namespace ouzel
 
         bool SoundData::getData(Stream* stream, uint32_t frames, uint32_t neededChannels, uint32_t neededSampleRate, float pitch, std::vector<float>& result)
         {
-            uint32_t neededFrames = static_cast<uint32_t>(frames * pitch * sampleRate / neededSampleRate);
+            Resampler& resampler = stream->resampler;
+            std::vector<float>& resampledData = stream->resampledData;
 
-            if (!readData(stream, neededFrames, tempData))
-            {
-                return false;
-            }
+            float ratio = pitch * static_cast<float>(sampleRate) / static_cast<float>(neededSampleRate);
 
-            if (pitch != 1.0f)
+            if (ratio == 1.0f && resampler.isIdle())
             {
-                uint32_t srcFrames = static_cast<uint32_t>(tempData.size()) / channels;
-
-                Audio::resampleLerp(tempData, srcFrames, resampledData, frames, channels);
+                // the data is already in the needed sample rate, skip the resampler
+                if (!readData(stream, frames, resampledData))
+                {
+                    return false;
+                }
             }
             else
             {
-                resampledData = tempData;
+                std::vector<float>& tempData = stream->tempData;
+
+                resampler.setChannels(channels);
+                resampler.setRatio(ratio);
+
+                uint32_t neededFrames = resampler.getNeededFrames(frames);
+
+                if (!readData(stream, neededFrames, tempData))
+                {
+                    return false;
+                }
+
+                resampledData.resize(frames * channels);
+                resampler.process(tempData.data(), neededFrames, resampledData.data(), frames);
             }
 
             if (neededChannels != channels)
@@ -233,7 +247,7 @@ namespace ouzel
             }
             else
             {
-                result = resampledData;
+                result.swap(resampledData);
             }
 
             return true;
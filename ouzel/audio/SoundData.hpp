@@ -32,14 +32,14 @@ namespace ouzel
             uint16_t getChannels() const { return channels; }
             uint32_t getSampleRate() const { return sampleRate; }
 
+            // bytes of sample or encoded data kept in memory
+            virtual uint32_t getDataSize() const { return 0; }
+
         protected:
             virtual bool readData(Stream* stream, uint32_t frames, std::vector<float>& result) = 0;
 
             uint16_t channels = 0;
             uint32_t sampleRate = 0;
-
-            std::vector<float> tempData;
-            std::vector<float> resampledData;
         };
     } // namespace audio
 } // namespace ouzel
@@ -21,6 +21,8 @@ namespace ouzel
 
             virtual std::shared_ptr<Stream> createStream() override;
 
+            virtual uint32_t getDataSize() const override { return static_cast<uint32_t>(data.size()); }
+
         protected:
             virtual bool readData(Stream* stream, uint32_t frames, std::vector<float>& result) override;
 
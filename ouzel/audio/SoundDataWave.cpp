@@ -217,6 +217,25 @@ namespace ouzel
             return std::make_shared<StreamWave>();
         }
 
+        bool SoundDataWave::resample(uint32_t newSampleRate, Resampler::Quality quality)
+        {
+            if (channels == 0 || sampleRate == 0 || newSampleRate == 0)
+            {
+                Log(Log::Level::ERR) << "Failed to resample sound data, invalid sample rate";
+                return false;
+            }
+
+            if (sampleRate != newSampleRate)
+            {
+                std::vector<float> resampledData;
+                Resampler::resample(data, channels, sampleRate, newSampleRate, resampledData, quality);
+                data.swap(resampledData);
+                sampleRate = newSampleRate;
+            }
+
+            return true;
+        }
+
         bool SoundDataWave::readData(Stream* stream, uint32_t frames, std::vector<float>& result)
         {
             StreamWave* streamWave = static_cast<StreamWave*>(stream);
@@ -6,6 +6,7 @@
 #include <cstdint>
 #include <string>
 #include <vector>
+#include "audio/Resampler.hpp"
 #include "audio/SoundData.hpp"
 
 namespace ouzel
@@ -21,6 +22,11 @@ namespace ouzel
 
             virtual std::shared_ptr<Stream> createStream() override;
 
+            virtual uint32_t getDataSize() const override { return static_cast<uint32_t>(data.size() * sizeof(float)); }
+
+            // converts the sound data to the given sample rate so that it does not have to be resampled during playback
+            bool resample(uint32_t newSampleRate, Resampler::Quality quality = Resampler::Quality::SINC);
+
         protected:
             virtual bool readData(Stream* stream, uint32_t frames, std::vector<float>& result) override;
 
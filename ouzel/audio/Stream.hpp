@@ -6,14 +6,19 @@
 #include <cstdint>
 #include <atomic>
 #include <mutex>
+#include <vector>
+#include "audio/Resampler.hpp"
 #include "utils/Noncopyable.hpp"
 
 namespace ouzel
 {
     namespace audio
     {
+        class SoundData;
+
         class Stream: public Noncopyable
         {
+            friend SoundData;
         public:
             class EventListener
             {
@@ -39,7 +44,16 @@ namespace ouzel
 
             void setEventListener(EventListener* newEventListener);
 
+            Resampler::Quality getResamplerQuality() const { return resampler.getQuality(); }
+            void setResamplerQuality(Resampler::Quality newQuality) { resampler.setQuality(newQuality); }
+            void resetResampler() { resampler.reset(); }
+
         private:
+            // accessed only from the audio thread
+            Resampler resampler;
+            std::vector<float> tempData;
+            std::vector<float> resampledData;
+
             std::atomic<bool> playing;
             std::atomic<bool> repeating;
             std::atomic<bool> shouldReset;
@@ -127,6 +127,8 @@ namespace ouzel
         bool highDpi = true; // should high DPI resolution be used
         audio::Audio::Driver audioDriver = audio::Audio::Driver::DEFAULT;
         bool debugAudio = false;
+        audio::Resampler::Quality resamplerQuality = audio::Resampler::Quality::SINC;
+        bool resampleAudioOnLoad = false;
 
         defaultSettings.init("settings.ini");
         userSettings.init(fileSystem->getStorageDirectory() + FileSystem::DIRECTORY_SEPARATOR + "settings.ini");
@@ -221,6 +223,9 @@ namespace ouzel
         std::string debugRendererValue = userEngineSection.getValue("debugRenderer", defaultEngineSection.getValue("debugRenderer"));
         if (!debugRendererValue.empty()) debugRenderer = (debugRendererValue == "true" || debugRendererValue == "1" || debugRendererValue == "yes");
 
+        std::string headlessValue = userEngineSection.getValue("headless", defaultEngineSection.getValue("headless"));
+        if (!headlessValue.empty()) headless = (headlessValue == "true" || headlessValue == "1" || headlessValue == "yes");
+
         std::string highDpiValue = userEngineSection.getValue("highDpi", defaultEngineSection.getValue("highDpi"));
         if (!highDpiValue.empty()) highDpi = (highDpiValue == "true" || highDpiValue == "1" || highDpiValue == "yes");
 
@@ -270,6 +275,28 @@ namespace ouzel
         std::string debugAudioValue = userEngineSection.getValue("debugAudio", defaultEngineSection.getValue("debugAudio"));
         if (!debugAudioValue.empty()) debugAudio = (debugAudioValue == "true" || debugAudioValue == "1" || debugAudioValue == "yes");
 
+        std::string audioResamplerValue = userEngineSection.getValue("audioResampler", defaultEngineSection.getValue("audioResampler"));
+
+        if (!audioResamplerValue.empty())
+        {
+            if (audioResamplerValue == "linear")
+            {
+                resamplerQuality = audio::Resampler::Quality::LINEAR;
+            }
+            else if (audioResamplerValue == "sinc")
+            {
+                resamplerQuality = audio::Resampler::Quality::SINC;
+            }
+            else
+            {
+                ouzel::Log(ouzel::Log::Level::WARN) << "Invalid audio resampler specified";
+                return false;
+            }
+        }
+
+        std::string resampleAudioOnLoadValue = userEngineSection.getValue("resampleAudioOnLoad", defaultEngineSection.getValue("resampleAudioOnLoad"));
+        if (!resampleAudioOnLoadValue.empty()) resampleAudioOnLoad = (resampleAudioOnLoadValue == "true" || resampleAudioOnLoadValue == "1" || resampleAudioOnLoadValue == "yes");
+
         if (graphicsDriver == graphics::Renderer::Driver::DEFAULT)
         {
             auto availableDrivers = graphics::Renderer::getAvailableRenderDrivers();
@@ -358,6 +385,9 @@ namespace ouzel
             return false;
         }
 
+        audio->setResamplerQuality(resamplerQuality);
+        audio->setResampleOnLoad(resampleAudioOnLoad);
+
 #if OUZEL_PLATFORM_MACOS
         input.reset(new input::InputMacOS());
 #elif OUZEL_PLATFORM_IOS
@@ -487,7 +517,10 @@ namespace ouzel
             previousUpdateTime = currentTime;
             float delta = std::chrono::duration_cast<std::chrono::microseconds>(diff).count() / 1000000.0f;
 
+            // every input event published before the latch is in the event queue already
+            input->latchState();
             eventDispatcher.dispatchEvents();
+            network.update();
             timer.update(delta);
 
             for (UpdateCallback* updateCallback : updateCallbackDeleteSet)
@@ -538,7 +571,7 @@ namespace ouzel
             if (renderer->getDevice()->getRefillQueue())
             {
                 sceneManager.draw();
-                renderer->getDevice()->flushCommands();
+                renderer->getDevice()->flushCommands(input->getLatchedInputTime());
             }
 
             audio->update();
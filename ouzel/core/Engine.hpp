@@ -64,6 +64,8 @@ namespace ouzel
 
         inline bool isPaused() const { return paused; }
         inline bool isActive() const { return active; }
+        // rendering offscreen without a window, only supported on Linux with OpenGL
+        inline bool isHeadless() const { return headless; }
 
         void scheduleUpdate(UpdateCallback* callback);
         void unscheduleUpdate(UpdateCallback* callback);
@@ -119,6 +121,7 @@ namespace ouzel
         std::atomic<bool> paused;
 
         std::atomic<bool> screenSaverEnabled;
+        bool headless = false;
         std::vector<std::string> args;
     };
 
@@ -1,6 +1,7 @@
 // Copyright (C) 2018 Elviss Strazdins
 // This file is part of the Ouzel engine.
 
+#include <chrono>
 #include <cstdlib>
 #include <unistd.h>
 #include <pthread.h>
@@ -49,6 +50,23 @@ namespace ouzel
             executeAll();
         }*/
 
+        if (headless)
+        {
+            // there are no X events, just wait for the functions scheduled from the other threads
+            while (active)
+            {
+                executeAll();
+
+                std::unique_lock<std::mutex> lock(executeMutex);
+                if (executeQueue.empty() && active)
+                    executeCondition.wait_for(lock, std::chrono::milliseconds(10));
+            }
+
+            exit();
+
+            return EXIT_SUCCESS;
+        }
+
         XEvent event;
 
         WindowResourceLinux* windowLinux = static_cast<WindowResourceLinux*>(window.getResource());
@@ -63,6 +81,9 @@ namespace ouzel
             {
                 XNextEvent(windowLinux->getDisplay(), &event);
 
+                // input latency is measured from the moment the event leaves the X queue
+                std::chrono::steady_clock::time_point timestamp = std::chrono::steady_clock::now();
+
                 switch (event.type)
                 {
                     case ClientMessage:
@@ -89,12 +110,14 @@ namespace ouzel
                         if (event.type == KeyPress)
                         {
                             input->keyPress(input::InputLinux::convertKeyCode(keySym),
-                                            input::InputLinux::getModifiers(event.xkey.state));
+                                            input::InputLinux::getModifiers(event.xkey.state),
+                                            timestamp);
                         }
                         else
                         {
                             input->keyRelease(input::InputLinux::convertKeyCode(keySym),
-                                              input::InputLinux::getModifiers(event.xkey.state));
+                                              input::InputLinux::getModifiers(event.xkey.state),
+                                              timestamp);
                         }
                         break;
                     }
@@ -126,13 +149,15 @@ namespace ouzel
                         {
                             input->mouseButtonPress(button,
                                                     window.convertWindowToNormalizedLocation(pos),
-                                                    input::InputLinux::getModifiers(event.xbutton.state));
+                                                    input::InputLinux::getModifiers(event.xbutton.state),
+                                                    timestamp);
                         }
                         else
                         {
                             input->mouseButtonRelease(button,
                                                       window.convertWindowToNormalizedLocation(pos),
-                                                      input::InputLinux::getModifiers(event.xbutton.state));
+                                                      input::InputLinux::getModifiers(event.xbutton.state),
+                                                      timestamp);
                         }
                         break;
                     }
@@ -142,7 +167,8 @@ namespace ouzel
                                     static_cast<float>(event.xmotion.y));
 
                         input->mouseMove(window.convertWindowToNormalizedLocation(pos),
-                                         input::InputLinux::getModifiers(event.xmotion.state));
+                                         input::InputLinux::getModifiers(event.xmotion.state),
+                                         timestamp);
 
                         break;
                     }
@@ -160,7 +186,7 @@ namespace ouzel
                     case GenericEvent:
                     {
                         XGenericEventCookie* cookie = &event.xcookie;
-                        inputLinux->handleXInput2Event(cookie);
+                        inputLinux->handleXInput2Event(cookie, timestamp);
                         break;
                     }
                 }
@@ -177,6 +203,7 @@ namespace ouzel
         std::lock_guard<std::mutex> lock(executeMutex);
 
         executeQueue.push(func);
+        executeCondition.notify_one();
     }
 
     bool EngineLinux::openURL(const std::string& url)
@@ -193,7 +220,8 @@ namespace ouzel
         executeOnMainThread([this, newScreenSaverEnabled]() {
             WindowResourceLinux* windowLinux = static_cast<WindowResourceLinux*>(window.getResource());
 
-            XScreenSaverSuspend(windowLinux->getDisplay(), !newScreenSaverEnabled);
+            if (windowLinux->getDisplay())
+                XScreenSaverSuspend(windowLinux->getDisplay(), !newScreenSaverEnabled);
         });
     }
 
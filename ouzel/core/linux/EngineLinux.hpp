@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <condition_variable>
 #include "core/Engine.hpp"
 
 namespace ouzel
@@ -29,6 +30,7 @@ namespace ouzel
 
         std::queue<std::function<void(void)>> executeQueue;
         std::mutex executeMutex;
+        std::condition_variable executeCondition;
 
         int argc = 0;
         char** argv = nullptr;
@@ -60,6 +60,17 @@ namespace ouzel
             return false;
         }
 
+        // rendering offscreen, there is no X server to connect to
+        if (engine->isHeadless())
+        {
+            if (size.width <= 0.0f) size.width = 1280.0f;
+            if (size.height <= 0.0f) size.height = 720.0f;
+
+            resolution = size;
+
+            return true;
+        }
+
         // open a connection to the X server
         display = XOpenDisplay(nullptr);
 
@@ -174,6 +185,12 @@ namespace ouzel
     {
         WindowResource::close();
 
+        if (!display)
+        {
+            engine->exit();
+            return;
+        }
+
         XEvent event;
         event.type = ClientMessage;
         event.xclient.window = window;
@@ -194,12 +211,15 @@ namespace ouzel
     {
         WindowResource::setSize(newSize);
 
-        XWindowChanges changes;
-        changes.width = static_cast<int>(size.width);
-        changes.height = static_cast<int>(size.height);
-        XConfigureWindow(display, window, CWWidth | CWHeight, &changes);
+        if (display)
+        {
+            XWindowChanges changes;
+            changes.width = static_cast<int>(size.width);
+            changes.height = static_cast<int>(size.height);
+            XConfigureWindow(display, window, CWWidth | CWHeight, &changes);
+        }
 
-        if (!resizable)
+        if (display && !resizable)
         {
             XSizeHints sizeHints;
             sizeHints.flags = PMinSize | PMaxSize;
@@ -231,7 +251,7 @@ namespace ouzel
 
     void WindowResourceLinux::setTitle(const std::string& newTitle)
     {
-        if (title != newTitle)
+        if (display && title != newTitle)
         {
             XStoreName(display, window, newTitle.c_str());
         }
@@ -241,7 +261,7 @@ namespace ouzel
 
     bool WindowResourceLinux::toggleFullscreen()
     {
-        if (!state || !stateFullscreen)
+        if (!display || !state || !stateFullscreen)
         {
             return false;
         }
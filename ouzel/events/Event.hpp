@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <chrono>
 #include <cstdint>
 #include <vector>
 #include <string>
@@ -26,10 +27,12 @@ namespace ouzel
         MIDDLE_MOUSE_DOWN   = 0x0080,
     };
 
+    // the timestamps of the input events are taken when the event is received from the OS
     struct KeyboardEvent
     {
         uint32_t modifiers = 0;
         input::KeyboardKey key = input::KeyboardKey::NONE;
+        std::chrono::steady_clock::time_point timestamp;
     };
 
     struct MouseEvent
@@ -39,6 +42,7 @@ namespace ouzel
         Vector2 difference;
         Vector2 position;
         Vector2 scroll;
+        std::chrono::steady_clock::time_point timestamp;
     };
 
     struct TouchEvent
@@ -47,6 +51,7 @@ namespace ouzel
         Vector2 difference;
         Vector2 position;
         float force = 1.0f;
+        std::chrono::steady_clock::time_point timestamp;
     };
 
     struct GamepadEvent
@@ -57,6 +62,7 @@ namespace ouzel
         bool previousPressed = false;
         float value = 0.0f;
         float previousValue = 0.0f;
+        std::chrono::steady_clock::time_point timestamp;
     };
 
     class Window;
@@ -0,0 +1,99 @@
+// Copyright (C) 2018 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#include "core/Setup.h"
+#if OUZEL_PLATFORM_WINDOWS
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#include "MappedFile.hpp"
+
+namespace ouzel
+{
+    MappedFile::~MappedFile()
+    {
+        close();
+    }
+
+    bool MappedFile::init(const std::string& path)
+    {
+        close();
+
+#if OUZEL_PLATFORM_WINDOWS
+        HANDLE fileHandle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (fileHandle == INVALID_HANDLE_VALUE) return false;
+
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(fileHandle, &fileSize) || fileSize.QuadPart == 0)
+        {
+            CloseHandle(fileHandle);
+            return false;
+        }
+
+        HANDLE mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mappingHandle)
+        {
+            CloseHandle(fileHandle);
+            return false;
+        }
+
+        void* view = MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+        if (!view)
+        {
+            CloseHandle(mappingHandle);
+            CloseHandle(fileHandle);
+            return false;
+        }
+
+        file = fileHandle;
+        mapping = mappingHandle;
+        data = static_cast<const uint8_t*>(view);
+        size = static_cast<size_t>(fileSize.QuadPart);
+#else
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd == -1) return false;
+
+        struct stat buf;
+        if (fstat(fd, &buf) != 0 || buf.st_size <= 0)
+        {
+            ::close(fd);
+            return false;
+        }
+
+        void* view = mmap(nullptr, static_cast<size_t>(buf.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+
+        // the mapping stays valid after the descriptor is closed
+        ::close(fd);
+
+        if (view == MAP_FAILED) return false;
+
+        data = static_cast<const uint8_t*>(view);
+        size = static_cast<size_t>(buf.st_size);
+#endif
+
+        return true;
+    }
+
+    void MappedFile::close()
+    {
+        if (!data) return;
+
+#if OUZEL_PLATFORM_WINDOWS
+        UnmapViewOfFile(data);
+        CloseHandle(mapping);
+        CloseHandle(file);
+        mapping = nullptr;
+        file = nullptr;
+#else
+        munmap(const_cast<uint8_t*>(data), size);
+#endif
+
+        data = nullptr;
+        size = 0;
+    }
+}
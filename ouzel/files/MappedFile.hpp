@@ -0,0 +1,36 @@
+// Copyright (C) 2018 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include "core/Setup.h"
+#include "utils/Noncopyable.hpp"
+
+namespace ouzel
+{
+    // read-only memory mapping of a whole file, the mapping is released when the object is destroyed
+    class MappedFile: public Noncopyable
+    {
+    public:
+        MappedFile() {}
+        ~MappedFile();
+
+        // returns false if the file does not exist, is empty or could not be mapped
+        bool init(const std::string& path);
+        void close();
+
+        bool isOpen() const { return data != nullptr; }
+        const uint8_t* getData() const { return data; }
+        size_t getSize() const { return size; }
+
+    private:
+        const uint8_t* data = nullptr;
+        size_t size = 0;
+#if OUZEL_PLATFORM_WINDOWS
+        void* file = nullptr;
+        void* mapping = nullptr;
+#endif
+    };
+}
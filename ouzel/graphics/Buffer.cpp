@@ -11,6 +11,30 @@ namespace ouzel
 {
     namespace graphics
     {
+        // owns the update until it is executed on the render thread, so the data is moved instead of copied
+        class BufferUpdateCommand
+        {
+        public:
+            BufferUpdateCommand(BufferResource* initResource, bool initSubData, uint32_t initOffset, std::vector<uint8_t>&& initData):
+                resource(initResource), subData(initSubData), offset(initOffset), data(std::move(initData))
+            {
+            }
+
+            void operator()()
+            {
+                if (subData)
+                    resource->setSubData(offset, data);
+                else
+                    resource->setData(data);
+            }
+
+        private:
+            BufferResource* resource;
+            bool subData;
+            uint32_t offset;
+            std::vector<uint8_t> data;
+        };
+
         Buffer::Buffer()
         {
             resource = engine->getRenderer()->getDevice()->createBuffer();
@@ -25,6 +49,7 @@ namespace ouzel
         {
             usage = newUsage;
             flags = newFlags;
+            size = newSize;
 
             engine->getRenderer()->executeOnRenderThread(std::bind(static_cast<bool(BufferResource::*)(Usage, uint32_t, uint32_t)>(&BufferResource::init),
                                                                          resource,
@@ -47,6 +72,7 @@ namespace ouzel
         {
             usage = newUsage;
             flags = newFlags;
+            size = static_cast<uint32_t>(newData.size());
 
             engine->getRenderer()->executeOnRenderThread(std::bind(static_cast<bool(BufferResource::*)(Buffer::Usage, const std::vector<uint8_t>&, uint32_t)>(&BufferResource::init),
                                                                          resource,
@@ -65,9 +91,26 @@ namespace ouzel
 
         bool Buffer::setData(const std::vector<uint8_t>& newData)
         {
-            engine->getRenderer()->executeOnRenderThread(std::bind(&BufferResource::setData,
-                                                                         resource,
-                                                                         newData));
+            return setData(std::vector<uint8_t>(newData));
+        }
+
+        bool Buffer::setData(std::vector<uint8_t>&& newData)
+        {
+            size = static_cast<uint32_t>(newData.size());
+            engine->getRenderer()->executeOnRenderThread(BufferUpdateCommand(resource, false, 0, std::move(newData)));
+
+            return true;
+        }
+
+        bool Buffer::setSubData(uint32_t offset, const void* newData, uint32_t newSize)
+        {
+            return setSubData(offset, std::vector<uint8_t>(static_cast<const uint8_t*>(newData),
+                                                           static_cast<const uint8_t*>(newData) + newSize));
+        }
+
+        bool Buffer::setSubData(uint32_t offset, std::vector<uint8_t>&& newData)
+        {
+            engine->getRenderer()->executeOnRenderThread(BufferUpdateCommand(resource, true, offset, std::move(newData)));
 
             return true;
         }
@@ -37,17 +37,24 @@ namespace ouzel
 
             bool setData(const void* newData, uint32_t newSize);
             bool setData(const std::vector<uint8_t>& newData);
+            bool setData(std::vector<uint8_t>&& newData);
+
+            // updates a part of the buffer, the range has to be inside the data that was set before
+            bool setSubData(uint32_t offset, const void* newData, uint32_t newSize);
+            bool setSubData(uint32_t offset, std::vector<uint8_t>&& newData);
 
             BufferResource* getResource() const { return resource; }
 
             uint32_t getFlags() const { return flags; }
             Usage getUsage() const { return usage; }
+            uint32_t getSize() const { return size; }
 
         private:
             BufferResource* resource = nullptr;
 
             Buffer::Usage usage;
             uint32_t flags = 0;
+            uint32_t size = 0;
         };
     } // namespace graphics
 } // namespace ouzel
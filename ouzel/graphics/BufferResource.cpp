@@ -1,7 +1,9 @@
 // Copyright (C) 2018 Elviss Strazdins
 // This file is part of the Ouzel engine.
 
+#include <algorithm>
 #include "BufferResource.hpp"
+#include "utils/Log.hpp"
 
 namespace ouzel
 {
@@ -33,14 +35,32 @@ namespace ouzel
             return true;
         }
 
-        bool BufferResource::setData(const std::vector<uint8_t>& newData)
+        bool BufferResource::setData(std::vector<uint8_t>& newData)
         {
             if (!(flags & Buffer::DYNAMIC))
             {
                 return false;
             }
 
-            data = newData;
+            data.swap(newData);
+
+            return true;
+        }
+
+        bool BufferResource::setSubData(uint32_t offset, const std::vector<uint8_t>& newData)
+        {
+            if (!(flags & Buffer::DYNAMIC))
+            {
+                return false;
+            }
+
+            if (offset > data.size() || newData.size() > data.size() - offset)
+            {
+                Log(Log::Level::ERR) << "Buffer range out of bounds";
+                return false;
+            }
+
+            std::copy(newData.begin(), newData.end(), data.begin() + offset);
 
             return true;
         }
@@ -23,7 +23,9 @@ namespace ouzel
             virtual bool init(Buffer::Usage newUsage, uint32_t newFlags = 0, uint32_t newSize = 0);
             virtual bool init(Buffer::Usage newUsage, const std::vector<uint8_t>& newData, uint32_t newFlags = 0);
 
-            virtual bool setData(const std::vector<uint8_t>& newData);
+            // takes over the contents of newData
+            virtual bool setData(std::vector<uint8_t>& newData);
+            virtual bool setSubData(uint32_t offset, const std::vector<uint8_t>& newData);
 
             uint32_t getFlags() const { return flags; }
             Buffer::Usage getUsage() const { return usage; }
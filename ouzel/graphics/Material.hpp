@@ -26,6 +26,8 @@ namespace ouzel
             graphics::Renderer::CullMode cullMode = graphics::Renderer::CullMode::BACK;
             Color diffuseColor = Color::WHITE;
             float opacity = 1.0f;
+            // lit by the lights of the layer, drawn with the lighting shader where it is available
+            bool lighting = false;
         };
     } // namespace graphics
 } // namespace ouzel
@@ -3,16 +3,30 @@
 
 #include <algorithm>
 #include "RenderDevice.hpp"
+#include "TextureResource.hpp"
 #include "utils/Log.hpp"
 
 namespace ouzel
 {
     namespace graphics
     {
+        // bytes of texture levels uploaded per frame when streaming evicted textures back in
+        static const uint64_t TEXTURE_STREAMING_RATE = 4 * 1024 * 1024;
+
         RenderDevice::RenderDevice(Renderer::Driver aDriver):
             driver(aDriver),
             projectionTransform(Matrix4::IDENTITY),
             renderTargetProjectionTransform(Matrix4::IDENTITY),
+            bufferUploadSize(0),
+            bufferStallCount(0),
+            textureMemoryBudget(0),
+            textureMemoryUsage(0),
+            textureEvictionCount(0),
+            textureReloadCount(0),
+            gpuTimingEnabled(false),
+            skippedTimingFrameCount(0),
+            passTimingFrame(0),
+            gpuFrameTime(0.0f),
             refillQueue(true),
             currentFPS(0.0f),
             accumulatedFPS(0.0f)
@@ -71,6 +85,7 @@ namespace ouzel
             }
 
             std::vector<DrawCommand> drawCommands;
+            std::chrono::steady_clock::time_point inputTime;
             {
 #if OUZEL_MULTITHREADED
                 std::unique_lock<std::mutex> lock(drawQueueMutex);
@@ -79,6 +94,7 @@ namespace ouzel
 
                 drawCommands = drawQueue;
                 drawQueue.clear();
+                inputTime = queuedInputTime;
 
                 queueFinished = false;
             }
@@ -94,13 +110,24 @@ namespace ouzel
 
             executeAll();
 
+            bufferUploadSize = currentBufferUploadSize;
+            bufferStallCount = currentBufferStallCount;
+            currentBufferUploadSize = 0;
+            currentBufferStallCount = 0;
+
             ++currentFrame;
 
+            updateTextureResidency(drawCommands);
+
             if (!draw(drawCommands))
             {
                 return false;
             }
 
+            // draw returns after the buffers have been swapped
+            if (inputTime != std::chrono::steady_clock::time_point())
+                inputToSwapLatency.add(std::chrono::steady_clock::now() - inputTime);
+
             return true;
         }
 
@@ -147,6 +174,103 @@ namespace ouzel
                 resourceDeleteSet.push_back(std::move(*resourceIterator));
                 resources.erase(resourceIterator);
             }
+
+            auto textureIterator = std::find(textureResources.begin(), textureResources.end(), resource);
+
+            if (textureIterator != textureResources.end())
+            {
+                textureResources.erase(textureIterator);
+            }
+        }
+
+        void RenderDevice::updateTextureResidency(const std::vector<DrawCommand>& drawCommands)
+        {
+            std::vector<TextureResource*> textures;
+            {
+                std::lock_guard<std::mutex> lock(resourceMutex);
+                textures = textureResources;
+            }
+
+            for (const DrawCommand& drawCommand : drawCommands)
+            {
+                for (TextureResource* texture : drawCommand.textures)
+                {
+                    if (!texture) continue;
+
+                    texture->setLastUsedFrame(currentFrame);
+
+                    // evicted textures get their smallest level back before they are drawn
+                    if (texture->isEvicted() && texture->uploadLevel()) ++textureReloadCount;
+                }
+
+                if (drawCommand.renderTarget) drawCommand.renderTarget->setLastUsedFrame(currentFrame);
+            }
+
+            uint64_t usage = 0;
+            for (TextureResource* texture : textures)
+            {
+                usage += texture->getMemorySize();
+            }
+
+            uint64_t budget = textureMemoryBudget;
+
+            if (budget && usage > budget)
+            {
+                std::vector<TextureResource*> candidates;
+
+                for (TextureResource* texture : textures)
+                {
+                    if (texture->isEvictable() &&
+                        !texture->isEvicted() &&
+                        texture->getLastUsedFrame() != currentFrame)
+                    {
+                        candidates.push_back(texture);
+                    }
+                }
+
+                std::sort(candidates.begin(), candidates.end(), [](const TextureResource* a, const TextureResource* b) {
+                    return a->getLastUsedFrame() < b->getLastUsedFrame();
+                });
+
+                for (TextureResource* texture : candidates)
+                {
+                    if (usage <= budget) break;
+
+                    uint64_t memorySize = texture->getMemorySize();
+
+                    if (texture->evict())
+                    {
+                        usage -= memorySize;
+                        ++textureEvictionCount;
+                    }
+                }
+            }
+
+            // stream the more detailed levels of the textures drawn in this frame while the budget allows it
+            uint64_t streamed = 0;
+
+            for (TextureResource* texture : textures)
+            {
+                if (streamed >= TEXTURE_STREAMING_RATE) break;
+
+                if (texture->getLastUsedFrame() != currentFrame) continue;
+
+                while (texture->getResidentLevel() > 0 &&
+                       !texture->isEvicted() &&
+                       streamed < TEXTURE_STREAMING_RATE)
+                {
+                    uint64_t levelSize = texture->getLevelMemorySize(texture->getResidentLevel() - 1);
+
+                    if (budget && usage + levelSize > budget) break;
+                    if (!texture->uploadLevel()) break;
+
+                    usage += levelSize;
+                    streamed += levelSize;
+                    ++textureReloadCount;
+                }
+            }
+
+            textureMemoryUsage = usage;
         }
 
         bool RenderDevice::addDrawCommand(const DrawCommand& drawCommand)
@@ -158,11 +282,24 @@ namespace ouzel
             return true;
         }
 
-        void RenderDevice::flushCommands()
+        void RenderDevice::flushCommands(std::chrono::steady_clock::time_point inputTime)
         {
+            std::chrono::steady_clock::time_point currentTime = std::chrono::steady_clock::now();
+
             std::lock_guard<std::mutex> lock(drawQueueMutex);
             refillQueue = false;
 
+            if (inputTime > lastSubmittedInputTime)
+            {
+                inputToSubmitLatency.add(currentTime - inputTime);
+                lastSubmittedInputTime = inputTime;
+                queuedInputTime = inputTime;
+            }
+            else
+            {
+                queuedInputTime = std::chrono::steady_clock::time_point();
+            }
+
             queueFinished = true;
             drawCallCount = static_cast<uint32_t>(drawQueue.size());
 
@@ -171,16 +308,38 @@ namespace ouzel
 #endif
         }
 
+        std::vector<RenderDevice::PassTiming> RenderDevice::getPassTimings() const
+        {
+            std::lock_guard<std::mutex> lock(passTimingMutex);
+
+            return passTimings;
+        }
+
+        void RenderDevice::setPassTimings(uint32_t frame, std::vector<PassTiming>& timings)
+        {
+            // the frames can become available out of order
+            if (frame <= passTimingFrame) return;
+
+            float frameTime = 0.0f;
+            for (const PassTiming& timing : timings) frameTime += timing.time;
+
+            std::lock_guard<std::mutex> lock(passTimingMutex);
+
+            passTimings.swap(timings);
+            passTimingFrame = frame;
+            gpuFrameTime = frameTime;
+        }
+
         bool RenderDevice::generateScreenshot(const std::string&)
         {
             return true;
         }
 
-        void RenderDevice::executeOnRenderThread(const std::function<void(void)>& func)
+        void RenderDevice::executeOnRenderThread(std::function<void(void)> func)
         {
             std::lock_guard<std::mutex> lock(executeMutex);
 
-            executeQueue.push(func);
+            executeQueue.push(std::move(func));
         }
 
         void RenderDevice::executeAll()
@@ -11,6 +11,7 @@
 #include "graphics/MeshBuffer.hpp"
 #include "graphics/Shader.hpp"
 #include "graphics/Texture.hpp"
+#include "utils/LatencyHistogram.hpp"
 
 namespace ouzel
 {
@@ -77,10 +78,24 @@ namespace ouzel
                 bool scissorTest;
                 Rectangle scissorRectangle;
                 Renderer::CullMode cullMode;
+                // submitter of the command, only used for GPU timing
+                const scene::Camera* camera;
+                const scene::Layer* layer;
+            };
+
+            // GPU time of the draw commands between two changes of the render target or the submitter
+            struct PassTiming
+            {
+                // only identify the pass, they may have been deleted by the time the timing is read
+                const scene::Camera* camera;
+                const scene::Layer* layer;
+                TextureResource* renderTarget;
+                float time; // milliseconds
             };
 
             bool addDrawCommand(const DrawCommand& drawCommand);
-            void flushCommands();
+            // inputTime is the timestamp of the newest input that the frame has read
+            void flushCommands(std::chrono::steady_clock::time_point inputTime = std::chrono::steady_clock::time_point());
 
             Vector2 convertScreenToNormalizedLocation(const Vector2& position)
             {
@@ -96,6 +111,45 @@ namespace ouzel
 
             inline uint32_t getDrawCallCount() const { return drawCallCount; }
 
+            // buffer bytes uploaded and uploads that had to wait for the GPU during the last frame
+            inline uint32_t getBufferUploadSize() const { return bufferUploadSize; }
+            inline uint32_t getBufferStallCount() const { return bufferStallCount; }
+
+            // called by the buffer resources on the render thread
+            void addBufferUpload(uint32_t uploadSize, bool stall)
+            {
+                currentBufferUploadSize += uploadSize;
+                if (stall) ++currentBufferStallCount;
+            }
+
+            inline uint32_t getCurrentFrame() const { return currentFrame; }
+
+            // time from the newest input of a frame to the submission of its draw commands and to the buffer swap,
+            // only the frames that read new input are counted
+            inline const LatencyHistogram& getInputToSubmitLatency() const { return inputToSubmitLatency; }
+            inline const LatencyHistogram& getInputToSwapLatency() const { return inputToSwapLatency; }
+
+            // least recently drawn textures are evicted when their memory exceeds the budget, 0 disables the budget
+            inline uint64_t getTextureMemoryBudget() const { return textureMemoryBudget; }
+            inline void setTextureMemoryBudget(uint64_t newBudget) { textureMemoryBudget = newBudget; }
+
+            inline uint64_t getTextureMemoryUsage() const { return textureMemoryUsage; }
+            // totals since the start, evicted textures and levels that were uploaded again
+            inline uint32_t getTextureEvictionCount() const { return textureEvictionCount; }
+            inline uint32_t getTextureReloadCount() const { return textureReloadCount; }
+
+            // the passes are measured with timer queries that are read back a few frames later without
+            // waiting for the GPU, frames are not timed while all the queries are still pending
+            inline bool isGPUTimingSupported() const { return gpuTimingSupported; }
+            inline bool isGPUTimingEnabled() const { return gpuTimingEnabled; }
+            inline void setGPUTimingEnabled(bool enabled) { gpuTimingEnabled = enabled; }
+
+            // passes of the newest frame that has been read back
+            std::vector<PassTiming> getPassTimings() const;
+            inline uint32_t getPassTimingFrame() const { return passTimingFrame; }
+            inline float getGPUFrameTime() const { return gpuFrameTime; }
+            inline uint32_t getSkippedTimingFrameCount() const { return skippedTimingFrameCount; }
+
             inline uint16_t getAPIMajorVersion() const { return apiMajorVersion; }
             inline uint16_t getAPIMinorVersion() const { return apiMinorVersion; }
 
@@ -112,7 +166,7 @@ namespace ouzel
             inline float getFPS() const { return currentFPS; }
             inline float getAccumulatedFPS() const { return accumulatedFPS; }
 
-            void executeOnRenderThread(const std::function<void(void)>& func);
+            void executeOnRenderThread(std::function<void(void)> func);
 
         protected:
             RenderDevice(Renderer::Driver aDriver);
@@ -127,6 +181,7 @@ namespace ouzel
                               bool newDebugRenderer);
 
             void executeAll();
+            void updateTextureResidency(const std::vector<DrawCommand>& drawCommands);
             virtual void setSize(const Size2& newSize);
 
             virtual BlendStateResource* createBlendState() = 0;
@@ -139,6 +194,19 @@ namespace ouzel
             virtual bool draw(const std::vector<DrawCommand>& drawCommands) = 0;
             virtual bool generateScreenshot(const std::string& filename);
 
+            // frames whose timer queries can be in flight at the same time
+            static const uint32_t TIMER_FRAME_COUNT = 4;
+
+            static bool isNewPass(const DrawCommand& previousCommand, const DrawCommand& drawCommand)
+            {
+                return previousCommand.renderTarget != drawCommand.renderTarget ||
+                    previousCommand.camera != drawCommand.camera ||
+                    previousCommand.layer != drawCommand.layer;
+            }
+
+            // called by the devices on the render thread when the queries of a frame are available
+            void setPassTimings(uint32_t frame, std::vector<PassTiming>& timings);
+
             Renderer::Driver driver;
 
             Window* window = nullptr;
@@ -160,6 +228,7 @@ namespace ouzel
             bool multisamplingSupported = true;
             bool anisotropicFilteringSupported = true;
             bool renderTargetsSupported = true;
+            bool gpuTimingSupported = false;
 
             Matrix4 projectionTransform;
             Matrix4 renderTargetProjectionTransform;
@@ -173,15 +242,39 @@ namespace ouzel
             std::mutex resourceMutex;
             std::vector<std::unique_ptr<RenderResource>> resources;
             std::vector<std::unique_ptr<RenderResource>> resourceDeleteSet;
+            std::vector<TextureResource*> textureResources;
 
             uint32_t drawCallCount = 0;
 
+            uint32_t currentBufferUploadSize = 0;
+            uint32_t currentBufferStallCount = 0;
+            std::atomic<uint32_t> bufferUploadSize;
+            std::atomic<uint32_t> bufferStallCount;
+
+            std::atomic<uint64_t> textureMemoryBudget;
+            std::atomic<uint64_t> textureMemoryUsage;
+            std::atomic<uint32_t> textureEvictionCount;
+            std::atomic<uint32_t> textureReloadCount;
+
+            std::atomic<bool> gpuTimingEnabled;
+            std::atomic<uint32_t> skippedTimingFrameCount;
+            std::atomic<uint32_t> passTimingFrame;
+            std::atomic<float> gpuFrameTime;
+            mutable std::mutex passTimingMutex;
+            std::vector<PassTiming> passTimings;
+
             std::vector<DrawCommand> drawQueue;
             std::mutex drawQueueMutex;
             std::condition_variable queueCondition;
             bool queueFinished = false;
             std::atomic<bool> refillQueue;
 
+            LatencyHistogram inputToSubmitLatency;
+            LatencyHistogram inputToSwapLatency;
+            std::chrono::steady_clock::time_point lastSubmittedInputTime;
+            // input time of the queued frame, zero if the frame didn't read new input
+            std::chrono::steady_clock::time_point queuedInputTime;
+
             std::atomic<float> currentFPS;
             std::chrono::steady_clock::time_point previousFrameTime;
 
@@ -28,6 +28,7 @@
 #include "graphics/opengl/android/RenderDeviceOGLAndroid.hpp"
 #elif OUZEL_PLATFORM_LINUX
 #include "graphics/opengl/linux/RenderDeviceOGLLinux.hpp"
+#include "graphics/opengl/linux/RenderDeviceOGLLinuxEGL.hpp"
 #elif OUZEL_PLATFORM_WINDOWS
 #include "graphics/opengl/windows/RenderDeviceOGLWin.hpp"
 #elif OUZEL_PLATFORM_RASPBIAN
@@ -98,7 +99,10 @@ namespace ouzel
 #elif OUZEL_PLATFORM_ANDROID
                     device.reset(new RenderDeviceOGLAndroid());
 #elif OUZEL_PLATFORM_LINUX
-                    device.reset(new RenderDeviceOGLLinux());
+                    if (engine->isHeadless())
+                        device.reset(new RenderDeviceOGLLinuxEGL());
+                    else
+                        device.reset(new RenderDeviceOGLLinux());
 #elif OUZEL_PLATFORM_WINDOWS
                     device.reset(new RenderDeviceOGLWin());
 #elif OUZEL_PLATFORM_RASPBIAN
@@ -195,10 +199,11 @@ namespace ouzel
 
             std::shared_ptr<BlendState> alphaBlendState = std::make_shared<BlendState>();
 
+            // the alpha is composited over the destination, so the render targets hold premultiplied colors
             alphaBlendState->init(true,
                                   BlendState::Factor::SRC_ALPHA, BlendState::Factor::INV_SRC_ALPHA,
                                   BlendState::Operation::ADD,
-                                  BlendState::Factor::ONE, BlendState::Factor::ONE,
+                                  BlendState::Factor::ONE, BlendState::Factor::INV_SRC_ALPHA,
                                   BlendState::Operation::ADD);
 
             engine->getCache()->setBlendState(BLEND_ALPHA, alphaBlendState);
@@ -213,6 +218,16 @@ namespace ouzel
 
             engine->getCache()->setBlendState(BLEND_SCREEN, screenBlendState);
 
+            std::shared_ptr<BlendState> premultipliedAlphaBlendState = std::make_shared<BlendState>();
+
+            premultipliedAlphaBlendState->init(true,
+                                               BlendState::Factor::ONE, BlendState::Factor::INV_SRC_ALPHA,
+                                               BlendState::Operation::ADD,
+                                               BlendState::Factor::ONE, BlendState::Factor::INV_SRC_ALPHA,
+                                               BlendState::Operation::ADD);
+
+            engine->getCache()->setBlendState(BLEND_PREMULTIPLIED_ALPHA, premultipliedAlphaBlendState);
+
             std::shared_ptr<Texture> whitePixelTexture = std::make_shared<Texture>();
             whitePixelTexture->init({255, 255, 255, 255}, Size2(1.0f, 1.0f), 0, 1);
             engine->getCache()->setTexture(TEXTURE_WHITE_PIXEL, whitePixelTexture);
@@ -220,9 +235,9 @@ namespace ouzel
             return true;
         }
 
-        void Renderer::executeOnRenderThread(const std::function<void(void)>& func)
+        void Renderer::executeOnRenderThread(std::function<void(void)> func)
         {
-            device->executeOnRenderThread(func);
+            device->executeOnRenderThread(std::move(func));
         }
 
         void Renderer::setClearColorBuffer(bool clear)
@@ -327,7 +342,9 @@ namespace ouzel
                 wireframe,
                 scissorTest,
                 scissorRectangle,
-                cullMode
+                cullMode,
+                passCamera,
+                passLayer
             };
 
             return device->addDrawCommand(drawCommand);
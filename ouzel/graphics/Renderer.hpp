@@ -24,16 +24,24 @@ namespace ouzel
     class Engine;
     class Window;
 
+    namespace scene
+    {
+        class Camera;
+        class Layer;
+    }
+
     namespace graphics
     {
         const std::string SHADER_TEXTURE = "shaderTexture";
         const std::string SHADER_COLOR = "shaderColor";
+        const std::string SHADER_LIGHTING = "shaderLighting";
 
         const std::string BLEND_NO_BLEND = "blendNoBlend";
         const std::string BLEND_ADD = "blendAdd";
         const std::string BLEND_MULTIPLY = "blendMultiply";
         const std::string BLEND_ALPHA = "blendAlpha";
         const std::string BLEND_SCREEN = "blendScreen";
+        const std::string BLEND_PREMULTIPLIED_ALPHA = "blendPremultipliedAlpha";
 
         const std::string TEXTURE_WHITE_PIXEL = "textureWhitePixel";
 
@@ -78,7 +86,7 @@ namespace ouzel
 
             inline RenderDevice* getDevice() const { return device.get(); }
 
-            void executeOnRenderThread(const std::function<void(void)>& func);
+            void executeOnRenderThread(std::function<void(void)> func);
 
             void setClearColorBuffer(bool clear);
             bool getClearColorBuffer() const { return clearColorBuffer; }
@@ -114,6 +122,13 @@ namespace ouzel
                                 const Rectangle& scissorRectangle,
                                 CullMode cullMode);
 
+            // camera and layer that the following draw commands are submitted by, for GPU timing of the passes
+            void setPassTag(const scene::Camera* camera, const scene::Layer* layer)
+            {
+                passCamera = camera;
+                passLayer = layer;
+            }
+
         protected:
             Renderer(Driver driver);
             bool init(Window* newWindow,
@@ -134,6 +149,9 @@ namespace ouzel
             float clearDepth = 1.0;
             bool clearColorBuffer = true;
             bool clearDepthBuffer = false;
+
+            const scene::Camera* passCamera = nullptr;
+            const scene::Layer* passLayer = nullptr;
         };
     } // namespace graphics
 } // namespace ouzel
@@ -72,6 +72,7 @@ namespace ouzel
                                    PixelFormat newPixelFormat)
         {
             levels = newLevels;
+            residentLevel = 0;
             size = newSize;
             flags = newFlags;
             mipmaps = static_cast<uint32_t>(newLevels.size());
@@ -132,9 +133,34 @@ namespace ouzel
             return true;
         }
 
+        uint64_t TextureResource::getMemorySize() const
+        {
+            uint64_t result = 0;
+
+            for (uint32_t level = residentLevel; level < levels.size(); ++level)
+            {
+                result += getLevelMemorySize(level);
+            }
+
+            if (flags & Texture::RENDER_TARGET)
+            {
+                result *= sampleCount;
+            }
+
+            return result;
+        }
+
+        uint64_t TextureResource::getLevelMemorySize(uint32_t level) const
+        {
+            if (level >= levels.size()) return 0;
+
+            return static_cast<uint64_t>(levels[level].pitch) * static_cast<uint64_t>(levels[level].size.height);
+        }
+
         bool TextureResource::calculateSizes(const Size2& newSize)
         {
             levels.clear();
+            residentLevel = 0;
             size = newSize;
 
             uint32_t newWidth = static_cast<uint32_t>(newSize.width);
@@ -77,6 +77,26 @@ namespace ouzel
             uint32_t getFrameBufferClearedFrame() const { return frameBufferClearedFrame; }
             void setFrameBufferClearedFrame(uint32_t clearedFrame) { frameBufferClearedFrame = clearedFrame; }
 
+            // GPU memory used by the resident levels in bytes
+            uint64_t getMemorySize() const;
+            uint64_t getLevelMemorySize(uint32_t level) const;
+
+            uint32_t getLastUsedFrame() const { return lastUsedFrame; }
+            void setLastUsedFrame(uint32_t frame) { lastUsedFrame = frame; }
+
+            // most detailed level that is uploaded, equals the level count if the texture is evicted
+            uint32_t getResidentLevel() const { return residentLevel; }
+            uint32_t getLevelCount() const { return static_cast<uint32_t>(levels.size()); }
+            bool isEvicted() const { return !levels.empty() && residentLevel >= levels.size(); }
+
+            // render targets and dynamic textures can't be restored from their levels, so they are never evicted
+            bool isEvictable() const { return !(flags & (Texture::RENDER_TARGET | Texture::DYNAMIC)) && !levels.empty(); }
+
+            // frees the GPU storage, but keeps the levels, so that the texture can be reloaded
+            virtual bool evict() { return false; }
+            // uploads the next more detailed level, the first upload after eviction recreates the texture
+            virtual bool uploadLevel() { return false; }
+
         protected:
             TextureResource();
 
@@ -99,6 +119,8 @@ namespace ouzel
             uint32_t maxAnisotropy = 0;
 
             uint32_t frameBufferClearedFrame = 0;
+            uint32_t lastUsedFrame = 0;
+            uint32_t residentLevel = 0;
         };
     } // namespace graphics
 } // namespace ouzel
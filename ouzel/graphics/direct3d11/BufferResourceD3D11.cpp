@@ -56,18 +56,38 @@ namespace ouzel
             return true;
         }
 
-        bool BufferResourceD3D11::setData(const std::vector<uint8_t>& newData)
+        bool BufferResourceD3D11::setData(std::vector<uint8_t>& newData)
         {
             if (!BufferResource::setData(newData))
             {
                 return false;
             }
 
+            return uploadData();
+        }
+
+        bool BufferResourceD3D11::setSubData(uint32_t offset, const std::vector<uint8_t>& newData)
+        {
+            if (!BufferResource::setSubData(offset, newData))
+            {
+                return false;
+            }
+
+            // dynamic buffers can only be mapped as a whole without waiting for the GPU,
+            // so the whole shadow copy is uploaded
+            return uploadData();
+        }
+
+        bool BufferResourceD3D11::uploadData()
+        {
             if (!data.empty())
             {
                 if (!buffer || data.size() > bufferSize)
                 {
-                    createBuffer();
+                    if (!createBuffer())
+                    {
+                        return false;
+                    }
                 }
                 else
                 {
@@ -76,6 +96,7 @@ namespace ouzel
                     mappedSubresource.RowPitch = 0;
                     mappedSubresource.DepthPitch = 0;
 
+                    // discarding gives a new storage, so the map does not wait for the GPU
                     HRESULT hr = renderDeviceD3D11->getContext()->Map(buffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedSubresource);
                     if (FAILED(hr))
                     {
@@ -87,6 +108,8 @@ namespace ouzel
 
                     renderDeviceD3D11->getContext()->Unmap(buffer, 0);
                 }
+
+                renderDeviceD3D11->addBufferUpload(static_cast<uint32_t>(data.size()), false);
             }
 
             return true;
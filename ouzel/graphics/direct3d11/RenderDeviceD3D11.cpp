@@ -44,6 +44,19 @@ namespace ouzel
             resourceDeleteSet.clear();
             resources.clear();
 
+            for (TimerFrame& timerFrame : timerFrames)
+            {
+                if (timerFrame.disjointQuery)
+                {
+                    timerFrame.disjointQuery->Release();
+                }
+
+                for (ID3D11Query* query : timerFrame.queries)
+                {
+                    query->Release();
+                }
+            }
+
             for (ID3D11DepthStencilState* depthStencilState : depthStencilStates)
             {
                 if (depthStencilState)
@@ -157,6 +170,9 @@ namespace ouzel
                 npotTexturesSupported = false;
             }
 
+            // disabled if the queries can't be created
+            gpuTimingSupported = true;
+
             IDXGIDevice* dxgiDevice;
             IDXGIFactory* factory;
 
@@ -431,6 +447,15 @@ namespace ouzel
             viewport.MinDepth = 0.0f;
             viewport.MaxDepth = 1.0f;
 
+            TimerFrame* timerFrame = nullptr;
+            const DrawCommand* previousCommand = nullptr;
+
+            if (gpuTimingSupported)
+            {
+                readTimerQueries();
+                if (gpuTimingEnabled) timerFrame = beginTimerFrame();
+            }
+
             if (drawCommands.empty())
             {
                 frameBufferClearedFrame = currentFrame;
@@ -456,6 +481,22 @@ namespace ouzel
             }
             else for (const DrawCommand& drawCommand : drawCommands)
             {
+                // a timestamp at the start of every pass
+                if (timerFrame && (!previousCommand || isNewPass(*previousCommand, drawCommand)))
+                {
+                    if (writeTimestamp(*timerFrame, static_cast<uint32_t>(timerFrame->passes.size())))
+                    {
+                        timerFrame->passes.push_back({drawCommand.camera, drawCommand.layer, drawCommand.renderTarget, 0.0f});
+                    }
+                    else
+                    {
+                        endTimerFrame(*timerFrame);
+                        timerFrame = nullptr;
+                    }
+                }
+
+                previousCommand = &drawCommand;
+
                 // render target
                 ID3D11RenderTargetView* newRenderTargetView = nullptr;
                 ID3D11DepthStencilView* newDepthStencilView = nullptr;
@@ -727,11 +768,125 @@ namespace ouzel
                 context->DrawIndexed(indexCount, drawCommand.startIndex, 0);
             }
 
+            if (timerFrame) endTimerFrame(*timerFrame);
+
             swapChain->Present(swapInterval, 0);
 
             return true;
         }
 
+        RenderDeviceD3D11::TimerFrame* RenderDeviceD3D11::beginTimerFrame()
+        {
+            TimerFrame& timerFrame = timerFrames[currentFrame % TIMER_FRAME_COUNT];
+
+            // never wait for the GPU, just skip timing this frame
+            if (timerFrame.pending)
+            {
+                ++skippedTimingFrameCount;
+                return nullptr;
+            }
+
+            if (!timerFrame.disjointQuery)
+            {
+                D3D11_QUERY_DESC queryDesc;
+                queryDesc.Query = D3D11_QUERY_TIMESTAMP_DISJOINT;
+                queryDesc.MiscFlags = 0;
+
+                HRESULT hr = device->CreateQuery(&queryDesc, &timerFrame.disjointQuery);
+                if (FAILED(hr))
+                {
+                    Log(Log::Level::ERR) << "Failed to create Direct3D 11 query, error: " << hr;
+                    gpuTimingSupported = false;
+                    return nullptr;
+                }
+            }
+
+            timerFrame.frame = currentFrame;
+            timerFrame.passes.clear();
+
+            // the frequency of the timestamps is only valid between the begin and the end of the disjoint query
+            context->Begin(timerFrame.disjointQuery);
+
+            return &timerFrame;
+        }
+
+        bool RenderDeviceD3D11::writeTimestamp(TimerFrame& timerFrame, uint32_t index)
+        {
+            if (timerFrame.queries.size() <= index)
+            {
+                D3D11_QUERY_DESC queryDesc;
+                queryDesc.Query = D3D11_QUERY_TIMESTAMP;
+                queryDesc.MiscFlags = 0;
+
+                ID3D11Query* query;
+                HRESULT hr = device->CreateQuery(&queryDesc, &query);
+                if (FAILED(hr))
+                {
+                    Log(Log::Level::ERR) << "Failed to create Direct3D 11 query, error: " << hr;
+                    gpuTimingSupported = false;
+                    return false;
+                }
+
+                timerFrame.queries.push_back(query);
+            }
+
+            context->End(timerFrame.queries[index]);
+
+            return true;
+        }
+
+        void RenderDeviceD3D11::endTimerFrame(TimerFrame& timerFrame)
+        {
+            // and one at the end of the last pass
+            if (!timerFrame.passes.empty() &&
+                writeTimestamp(timerFrame, static_cast<uint32_t>(timerFrame.passes.size())))
+            {
+                timerFrame.pending = true;
+            }
+
+            context->End(timerFrame.disjointQuery);
+        }
+
+        void RenderDeviceD3D11::readTimerQueries()
+        {
+            for (TimerFrame& timerFrame : timerFrames)
+            {
+                if (!timerFrame.pending) continue;
+
+                D3D11_QUERY_DATA_TIMESTAMP_DISJOINT disjointData;
+                if (context->GetData(timerFrame.disjointQuery, &disjointData, sizeof(disjointData), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK)
+                {
+                    continue;
+                }
+
+                // the queries of a frame finish in order, so the last one tells if all are available
+                UINT64 endTime;
+                if (context->GetData(timerFrame.queries[timerFrame.passes.size()], &endTime, sizeof(endTime), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK)
+                {
+                    continue;
+                }
+
+                timerFrame.pending = false;
+
+                // the timestamps can't be compared if the GPU changed its frequency in the meantime
+                if (disjointData.Disjoint || !disjointData.Frequency) continue;
+
+                UINT64 startTime = 0;
+                context->GetData(timerFrame.queries[0], &startTime, sizeof(startTime), D3D11_ASYNC_GETDATA_DONOTFLUSH);
+
+                for (size_t i = 0; i < timerFrame.passes.size(); ++i)
+                {
+                    endTime = 0;
+                    context->GetData(timerFrame.queries[i + 1], &endTime, sizeof(endTime), D3D11_ASYNC_GETDATA_DONOTFLUSH);
+
+                    timerFrame.passes[i].time = static_cast<float>(endTime - startTime) * 1000.0f / static_cast<float>(disjointData.Frequency);
+                    startTime = endTime;
+                }
+
+                setPassTimings(timerFrame.frame, timerFrame.passes);
+            }
+        }
+
         IDXGIOutput* RenderDeviceD3D11::getOutput() const
         {
             WindowResourceWin* windowWin = static_cast<WindowResourceWin*>(window->getResource());
@@ -916,6 +1071,7 @@ namespace ouzel
 
             TextureResource* texture = new TextureResourceD3D11(this);
             resources.push_back(std::unique_ptr<RenderResource>(texture));
+            textureResources.push_back(texture);
             return texture;
         }
 
@@ -75,6 +75,21 @@ namespace ouzel
 
             IDXGIOutput* getOutput() const;
 
+            struct TimerFrame
+            {
+                ID3D11Query* disjointQuery = nullptr;
+                // a timestamp at the start of every pass and one at the end of the last pass
+                std::vector<ID3D11Query*> queries;
+                std::vector<PassTiming> passes;
+                uint32_t frame = 0;
+                bool pending = false;
+            };
+
+            TimerFrame* beginTimerFrame();
+            bool writeTimestamp(TimerFrame& timerFrame, uint32_t index);
+            void endTimerFrame(TimerFrame& timerFrame);
+            void readTimerQueries();
+
             ID3D11Device* device = nullptr;
             ID3D11DeviceContext* context = nullptr;
             IDXGISwapChain* swapChain = nullptr;
@@ -93,6 +108,8 @@ namespace ouzel
             UINT swapInterval = 0;
             FLOAT frameBufferClearColor[4];
 
+            TimerFrame timerFrames[TIMER_FRAME_COUNT];
+
             std::atomic<bool> running;
             std::thread renderThread;
         };
@@ -83,6 +83,7 @@ namespace ouzel
 
             TextureResource* texture(new TextureResourceEmpty());
             resources.push_back(std::unique_ptr<RenderResource>(texture));
+            textureResources.push_back(texture);
             return texture;
         }
 
@@ -34,7 +34,8 @@ namespace ouzel
             virtual bool init(Buffer::Usage newUsage, uint32_t newFlags = 0, uint32_t newSize = 0) override;
             virtual bool init(Buffer::Usage newUsage, const std::vector<uint8_t>& newData, uint32_t newFlags = 0) override;
 
-            virtual bool setData(const std::vector<uint8_t>& newData) override;
+            virtual bool setData(std::vector<uint8_t>& newData) override;
+            virtual bool setSubData(uint32_t offset, const std::vector<uint8_t>& newData) override;
 
             MTLBufferPtr getBuffer() const { return buffer; }
 
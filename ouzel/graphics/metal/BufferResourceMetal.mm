@@ -62,7 +62,7 @@ namespace ouzel
             return true;
         }
 
-        bool BufferResourceMetal::setData(const std::vector<uint8_t>& newData)
+        bool BufferResourceMetal::setData(std::vector<uint8_t>& newData)
         {
             if (!BufferResource::setData(newData))
             {
@@ -80,6 +80,29 @@ namespace ouzel
             if (!data.empty())
             {
                 std::copy(data.begin(), data.end(), static_cast<uint8_t*>([buffer contents]));
+                renderDeviceMetal->addBufferUpload(static_cast<uint32_t>(data.size()), false);
+            }
+
+            return true;
+        }
+
+        bool BufferResourceMetal::setSubData(uint32_t offset, const std::vector<uint8_t>& newData)
+        {
+            if (!BufferResource::setSubData(offset, newData))
+            {
+                return false;
+            }
+
+            if (!buffer)
+            {
+                Log(Log::Level::ERR) << "Buffer not initialized";
+                return false;
+            }
+
+            if (!newData.empty())
+            {
+                std::copy(newData.begin(), newData.end(), static_cast<uint8_t*>([buffer contents]) + offset);
+                renderDeviceMetal->addBufferUpload(static_cast<uint32_t>(newData.size()), false);
             }
 
             return true;
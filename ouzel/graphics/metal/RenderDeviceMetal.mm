@@ -820,6 +820,7 @@ namespace ouzel
 
             TextureResource* texture = new TextureResourceMetal(this);
             resources.push_back(std::unique_ptr<RenderResource>(texture));
+            textureResources.push_back(texture);
             return texture;
         }
 
@@ -5,6 +5,7 @@
 
 #if OUZEL_COMPILE_OPENGL
 
+#include <algorithm>
 #include "BufferResourceOGL.hpp"
 #include "RenderDeviceOGL.hpp"
 #include "utils/Log.hpp"
@@ -93,6 +94,9 @@ namespace ouzel
                     Log(Log::Level::ERR) << "Failed to create buffer";
                     return false;
                 }
+
+                orphanedFrame = renderDeviceOGL->getCurrentFrame();
+                renderDeviceOGL->addBufferUpload(static_cast<uint32_t>(data.size()), false);
             }
 
             return true;
@@ -129,7 +133,7 @@ namespace ouzel
             return true;
         }
 
-        bool BufferResourceOGL::setData(const std::vector<uint8_t>& newData)
+        bool BufferResourceOGL::setData(std::vector<uint8_t>& newData)
         {
             if (!BufferResource::setData(newData))
             {
@@ -142,40 +146,120 @@ namespace ouzel
                 return false;
             }
 
-            if (!data.empty())
+            if (data.empty()) return true;
+
+            return uploadData(0, static_cast<uint32_t>(data.size()));
+        }
+
+        bool BufferResourceOGL::setSubData(uint32_t offset, const std::vector<uint8_t>& newData)
+        {
+            if (!BufferResource::setSubData(offset, newData))
             {
-                renderDeviceOGL->bindVertexArray(0);
+                return false;
+            }
 
-                if (!renderDeviceOGL->bindBuffer(bufferType, bufferId))
+            if (!bufferId)
+            {
+                Log(Log::Level::ERR) << "Buffer not initialized";
+                return false;
+            }
+
+            if (newData.empty()) return true;
+
+            return uploadData(offset, static_cast<uint32_t>(newData.size()));
+        }
+
+        bool BufferResourceOGL::uploadData(uint32_t offset, uint32_t size)
+        {
+            renderDeviceOGL->bindVertexArray(0);
+
+            if (!renderDeviceOGL->bindBuffer(bufferType, bufferId))
+            {
+                return false;
+            }
+
+            if (static_cast<GLsizeiptr>(data.size()) > bufferSize)
+            {
+                bufferSize = static_cast<GLsizeiptr>(data.size());
+
+                glBufferDataProc(bufferType, bufferSize, data.data(),
+                                 (flags & Texture::DYNAMIC) ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW);
+
+                if (RenderDeviceOGL::checkOpenGLError())
                 {
+                    Log(Log::Level::ERR) << "Failed to create buffer";
                     return false;
                 }
 
-                if (static_cast<GLsizeiptr>(data.size()) > bufferSize)
-                {
-                    bufferSize = static_cast<GLsizeiptr>(data.size());
+                orphanedFrame = renderDeviceOGL->getCurrentFrame();
+                renderDeviceOGL->addBufferUpload(static_cast<uint32_t>(data.size()), false);
+
+                return true;
+            }
+
+            // the storage was already replaced in this frame, so no draw call is reading it
+            bool orphaned = (orphanedFrame == renderDeviceOGL->getCurrentFrame());
+
+            // writing into storage that the GPU might still be reading would wait for the GPU,
+            // so big updates of dynamic buffers upload the whole shadow copy into new storage instead
+            if (!orphaned && (flags & Texture::DYNAMIC) && size * 2 >= data.size())
+            {
+                return orphanBuffer();
+            }
+
+            glBufferSubDataProc(bufferType, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(size), data.data() + offset);
+
+            if (RenderDeviceOGL::checkOpenGLError())
+            {
+                Log(Log::Level::ERR) << "Failed to upload buffer";
+                return false;
+            }
+
+            renderDeviceOGL->addBufferUpload(size, !orphaned);
+
+            return true;
+        }
+
+        bool BufferResourceOGL::orphanBuffer()
+        {
+            if (glMapBufferRangeProc && glUnmapBufferProc)
+            {
+                // invalidating the whole buffer lets the driver hand out new storage without waiting for the GPU
+                void* mappedData = glMapBufferRangeProc(bufferType, 0, static_cast<GLsizeiptr>(data.size()),
+                                                        GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
 
-                    glBufferDataProc(bufferType, bufferSize, data.data(),
-                                     (flags & Texture::DYNAMIC) ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW);
+                if (mappedData)
+                {
+                    std::copy(data.begin(), data.end(), static_cast<uint8_t*>(mappedData));
 
-                    if (RenderDeviceOGL::checkOpenGLError())
+                    if (glUnmapBufferProc(bufferType) == GL_TRUE)
                     {
-                        Log(Log::Level::ERR) << "Failed to create buffer";
-                        return false;
+                        orphanedFrame = renderDeviceOGL->getCurrentFrame();
+                        renderDeviceOGL->addBufferUpload(static_cast<uint32_t>(data.size()), false);
+                        return true;
                     }
+
+                    // the contents were lost, upload them again below
                 }
                 else
                 {
-                    glBufferSubDataProc(bufferType, 0, static_cast<GLsizeiptr>(data.size()), data.data());
-
-                    if (RenderDeviceOGL::checkOpenGLError())
-                    {
-                        Log(Log::Level::ERR) << "Failed to upload buffer";
-                        return false;
-                    }
+                    RenderDeviceOGL::checkOpenGLError(false); // clear the error
                 }
             }
 
+            // respecifying the storage has the same effect when mapping is not available
+            glBufferDataProc(bufferType, bufferSize, nullptr, GL_DYNAMIC_DRAW);
+            glBufferSubDataProc(bufferType, 0, static_cast<GLsizeiptr>(data.size()), data.data());
+
+            if (RenderDeviceOGL::checkOpenGLError())
+            {
+                Log(Log::Level::ERR) << "Failed to upload buffer";
+                return false;
+            }
+
+            orphanedFrame = renderDeviceOGL->getCurrentFrame();
+            renderDeviceOGL->addBufferUpload(static_cast<uint32_t>(data.size()), false);
+
             return true;
         }
 
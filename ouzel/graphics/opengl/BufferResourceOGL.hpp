@@ -40,13 +40,16 @@ namespace ouzel
 
             virtual bool reload() override;
 
-            virtual bool setData(const std::vector<uint8_t>& newData) override;
+            virtual bool setData(std::vector<uint8_t>& newData) override;
+            virtual bool setSubData(uint32_t offset, const std::vector<uint8_t>& newData) override;
 
             GLuint getBufferId() const { return bufferId; }
             GLuint getBufferType() const { return bufferType; }
 
         protected:
             bool createBuffer();
+            bool uploadData(uint32_t offset, uint32_t size);
+            bool orphanBuffer();
 
             RenderDeviceOGL* renderDeviceOGL;
 
@@ -54,6 +57,9 @@ namespace ouzel
             GLsizeiptr bufferSize = 0;
 
             GLuint bufferType = 0;
+
+            // frame in which the storage was last replaced, the GPU can not be using it until that frame is drawn
+            uint32_t orphanedFrame = 0xFFFFFFFF;
         };
     } // namespace graphics
 } // namespace ouzel
@@ -9,6 +9,7 @@
 #include <dlfcn.h>
 #endif
 
+#include <algorithm>
 #include <sstream>
 
 #if OUZEL_SUPPORTS_OPENGLES
@@ -55,6 +56,8 @@
 #include "ColorVSGLES3.h"
 #include "TexturePSGLES3.h"
 #include "TextureVSGLES3.h"
+#include "LightingPSGLES3.h"
+#include "LightingVSGLES3.h"
 #else
 #include "ColorPSGL2.h"
 #include "ColorVSGL2.h"
@@ -64,10 +67,14 @@
 #include "ColorVSGL3.h"
 #include "TexturePSGL3.h"
 #include "TextureVSGL3.h"
+#include "LightingPSGL3.h"
+#include "LightingVSGL3.h"
 #include "ColorPSGL4.h"
 #include "ColorVSGL4.h"
 #include "TexturePSGL4.h"
 #include "TextureVSGL4.h"
+#include "LightingPSGL4.h"
+#include "LightingVSGL4.h"
 #endif
 
 PFNGLBLENDFUNCSEPARATEPROC glBlendFuncSeparateProc;
@@ -127,6 +134,9 @@ PFNGLLINKPROGRAMPROC glLinkProgramProc;
 PFNGLGETPROGRAMIVPROC glGetProgramivProc;
 PFNGLGETPROGRAMINFOLOGPROC glGetProgramInfoLogProc;
 PFNGLGETUNIFORMLOCATIONPROC glGetUniformLocationProc;
+PFNGLGETPROGRAMBINARYPROC glGetProgramBinaryProc;
+PFNGLPROGRAMBINARYPROC glProgramBinaryProc;
+PFNGLPROGRAMPARAMETERIPROC glProgramParameteriProc;
 
 PFNGLBINDBUFFERPROC glBindBufferProc;
 PFNGLDELETEBUFFERSPROC glDeleteBuffersProc;
@@ -143,6 +153,20 @@ PFNGLVERTEXATTRIBPOINTERPROC glVertexAttribPointerProc;
 
 PFNGLGETSTRINGIPROC glGetStringiProc;
 
+#if OUZEL_SUPPORTS_OPENGLES
+PFNGLGENQUERIESEXTPROC glGenQueriesProc;
+PFNGLDELETEQUERIESEXTPROC glDeleteQueriesProc;
+PFNGLQUERYCOUNTEREXTPROC glQueryCounterProc;
+PFNGLGETQUERYOBJECTUIVEXTPROC glGetQueryObjectuivProc;
+PFNGLGETQUERYOBJECTUI64VEXTPROC glGetQueryObjectui64vProc;
+#else
+PFNGLGENQUERIESPROC glGenQueriesProc;
+PFNGLDELETEQUERIESPROC glDeleteQueriesProc;
+PFNGLQUERYCOUNTERPROC glQueryCounterProc;
+PFNGLGETQUERYOBJECTUIVPROC glGetQueryObjectuivProc;
+PFNGLGETQUERYOBJECTUI64VPROC glGetQueryObjectui64vProc;
+#endif
+
 #if OUZEL_SUPPORTS_OPENGLES
 PFNGLMAPBUFFEROESPROC glMapBufferProc;
 PFNGLUNMAPBUFFEROESPROC glUnmapBufferProc;
@@ -176,6 +200,12 @@ namespace ouzel
         {
             resourceDeleteSet.clear();
             resources.clear();
+
+            for (TimerFrame& timerFrame : timerFrames)
+            {
+                if (!timerFrame.queries.empty())
+                    glDeleteQueriesProc(static_cast<GLsizei>(timerFrame.queries.size()), timerFrame.queries.data());
+            }
         }
 
         bool RenderDeviceOGL::init(Window* newWindow,
@@ -202,8 +232,9 @@ namespace ouzel
             frameBufferWidth = static_cast<GLsizei>(size.width);
             frameBufferHeight = static_cast<GLsizei>(size.height);
 
-            //const GLubyte* deviceVendor = glGetString(GL_VENDOR);
+            const GLubyte* deviceVendor = glGetString(GL_VENDOR);
             const GLubyte* deviceName = glGetString(GL_RENDERER);
+            const GLubyte* deviceVersion = glGetString(GL_VERSION);
 
             if (checkOpenGLError() || !deviceName)
             {
@@ -214,6 +245,13 @@ namespace ouzel
                 Log(Log::Level::INFO) << "Using " << reinterpret_cast<const char*>(deviceName) << " for rendering";
             }
 
+            driverDescription.clear();
+            if (deviceVendor) driverDescription += reinterpret_cast<const char*>(deviceVendor);
+            driverDescription += '\n';
+            if (deviceName) driverDescription += reinterpret_cast<const char*>(deviceName);
+            driverDescription += '\n';
+            if (deviceVersion) driverDescription += reinterpret_cast<const char*>(deviceVersion);
+
             glBlendFuncSeparateProc = reinterpret_cast<PFNGLBLENDFUNCSEPARATEPROC >(getProcAddress("glBlendFuncSeparate"));
             glBlendEquationSeparateProc = reinterpret_cast<PFNGLBLENDEQUATIONSEPARATEPROC>(getProcAddress("glBlendEquationSeparate"));
 
@@ -543,6 +581,75 @@ namespace ouzel
                 }
             }
 
+            // EAGL drivers do not report any program binary formats
+#if !OUZEL_OPENGL_INTERFACE_EAGL
+            glGetProgramBinaryProc = nullptr;
+            glProgramBinaryProc = nullptr;
+            glProgramParameteriProc = nullptr;
+
+    #if OUZEL_SUPPORTS_OPENGLES
+            bool programBinaryCore = (apiMajorVersion >= 3);
+    #else
+            bool programBinaryCore = (apiMajorVersion > 4 || (apiMajorVersion == 4 && apiMinorVersion >= 1));
+    #endif
+
+            if (programBinaryCore ||
+                std::find(extensions.begin(), extensions.end(), "GL_ARB_get_program_binary") != extensions.end())
+            {
+                glGetProgramBinaryProc = reinterpret_cast<PFNGLGETPROGRAMBINARYPROC>(getProcAddress("glGetProgramBinary"));
+                glProgramBinaryProc = reinterpret_cast<PFNGLPROGRAMBINARYPROC>(getProcAddress("glProgramBinary"));
+                glProgramParameteriProc = reinterpret_cast<PFNGLPROGRAMPARAMETERIPROC>(getProcAddress("glProgramParameteri"));
+            }
+    #if OUZEL_SUPPORTS_OPENGLES
+            else if (std::find(extensions.begin(), extensions.end(), "GL_OES_get_program_binary") != extensions.end())
+            {
+                glGetProgramBinaryProc = reinterpret_cast<PFNGLGETPROGRAMBINARYPROC>(getProcAddress("glGetProgramBinaryOES"));
+                glProgramBinaryProc = reinterpret_cast<PFNGLPROGRAMBINARYPROC>(getProcAddress("glProgramBinaryOES"));
+            }
+    #endif
+
+            programBinarySupported = false;
+
+            if (glGetProgramBinaryProc && glProgramBinaryProc)
+            {
+                GLint binaryFormatCount = 0;
+                glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &binaryFormatCount);
+
+                if (!checkOpenGLError(false) && binaryFormatCount > 0)
+                {
+                    programCacheDirectory = engine->getFileSystem()->getStorageDirectory();
+                    programBinarySupported = !programCacheDirectory.empty();
+                }
+            }
+#endif
+
+            // timestamp queries for the GPU timing of the passes
+#if !OUZEL_OPENGL_INTERFACE_EAGL
+    #if OUZEL_SUPPORTS_OPENGLES
+            if (std::find(extensions.begin(), extensions.end(), "GL_EXT_disjoint_timer_query") != extensions.end())
+            {
+                glGenQueriesProc = reinterpret_cast<PFNGLGENQUERIESEXTPROC>(getProcAddress("glGenQueriesEXT"));
+                glDeleteQueriesProc = reinterpret_cast<PFNGLDELETEQUERIESEXTPROC>(getProcAddress("glDeleteQueriesEXT"));
+                glQueryCounterProc = reinterpret_cast<PFNGLQUERYCOUNTEREXTPROC>(getProcAddress("glQueryCounterEXT"));
+                glGetQueryObjectuivProc = reinterpret_cast<PFNGLGETQUERYOBJECTUIVEXTPROC>(getProcAddress("glGetQueryObjectuivEXT"));
+                glGetQueryObjectui64vProc = reinterpret_cast<PFNGLGETQUERYOBJECTUI64VEXTPROC>(getProcAddress("glGetQueryObjectui64vEXT"));
+            }
+    #else
+            if (apiMajorVersion > 3 || (apiMajorVersion == 3 && apiMinorVersion >= 3) ||
+                std::find(extensions.begin(), extensions.end(), "GL_ARB_timer_query") != extensions.end())
+            {
+                glGenQueriesProc = reinterpret_cast<PFNGLGENQUERIESPROC>(getProcAddress("glGenQueries"));
+                glDeleteQueriesProc = reinterpret_cast<PFNGLDELETEQUERIESPROC>(getProcAddress("glDeleteQueries"));
+                glQueryCounterProc = reinterpret_cast<PFNGLQUERYCOUNTERPROC>(getProcAddress("glQueryCounter"));
+                glGetQueryObjectuivProc = reinterpret_cast<PFNGLGETQUERYOBJECTUIVPROC>(getProcAddress("glGetQueryObjectuiv"));
+                glGetQueryObjectui64vProc = reinterpret_cast<PFNGLGETQUERYOBJECTUI64VPROC>(getProcAddress("glGetQueryObjectui64v"));
+            }
+    #endif
+
+            gpuTimingSupported = glGenQueriesProc && glDeleteQueriesProc && glQueryCounterProc &&
+                glGetQueryObjectuivProc && glGetQueryObjectui64vProc;
+#endif
+
             std::shared_ptr<Shader> textureShader = std::make_shared<Shader>();
 
             switch (apiMajorVersion)
@@ -642,6 +749,44 @@ namespace ouzel
 
             engine->getCache()->setShader(SHADER_COLOR, colorShader);
 
+            // the lighting shader needs texelFetch, so it is not available on OpenGL 2 and OpenGL ES 2
+            std::shared_ptr<Shader> lightingShader;
+            const std::set<Vertex::Attribute::Usage> lightingAttributes = {Vertex::Attribute::Usage::POSITION, Vertex::Attribute::Usage::COLOR, Vertex::Attribute::Usage::TEXTURE_COORDINATES0};
+            const std::vector<Shader::ConstantInfo> lightingPixelConstants = {{"color", DataType::FLOAT_VECTOR4},
+                                                                              {"ambientColor", DataType::FLOAT_VECTOR4},
+                                                                              {"lightGrid", DataType::FLOAT_VECTOR4}};
+            const std::vector<Shader::ConstantInfo> lightingVertexConstants = {{"modelViewProj", DataType::FLOAT_MATRIX4},
+                                                                               {"modelMatrix", DataType::FLOAT_MATRIX4}};
+
+            switch (apiMajorVersion)
+            {
+#if OUZEL_SUPPORTS_OPENGLES
+                case 3:
+                    lightingShader = std::make_shared<Shader>();
+                    lightingShader->init(std::vector<uint8_t>(std::begin(LightingPSGLES3_glsl), std::end(LightingPSGLES3_glsl)),
+                                         std::vector<uint8_t>(std::begin(LightingVSGLES3_glsl), std::end(LightingVSGLES3_glsl)),
+                                         lightingAttributes, lightingPixelConstants, lightingVertexConstants);
+                    break;
+#else
+                case 3:
+                    lightingShader = std::make_shared<Shader>();
+                    lightingShader->init(std::vector<uint8_t>(std::begin(LightingPSGL3_glsl), std::end(LightingPSGL3_glsl)),
+                                         std::vector<uint8_t>(std::begin(LightingVSGL3_glsl), std::end(LightingVSGL3_glsl)),
+                                         lightingAttributes, lightingPixelConstants, lightingVertexConstants);
+                    break;
+                case 4:
+                    lightingShader = std::make_shared<Shader>();
+                    lightingShader->init(std::vector<uint8_t>(std::begin(LightingPSGL4_glsl), std::end(LightingPSGL4_glsl)),
+                                         std::vector<uint8_t>(std::begin(LightingVSGL4_glsl), std::end(LightingVSGL4_glsl)),
+                                         lightingAttributes, lightingPixelConstants, lightingVertexConstants);
+                    break;
+#endif
+                default:
+                    break;
+            }
+
+            if (lightingShader) engine->getCache()->setShader(SHADER_LIGHTING, lightingShader);
+
             glDisable(GL_DITHER);
             glDepthFunc(GL_LEQUAL);
 
@@ -785,6 +930,15 @@ namespace ouzel
 
         bool RenderDeviceOGL::draw(const std::vector<DrawCommand>& drawCommands)
         {
+            TimerFrame* timerFrame = nullptr;
+            const DrawCommand* previousCommand = nullptr;
+
+            if (gpuTimingSupported)
+            {
+                readTimerQueries();
+                if (gpuTimingEnabled) timerFrame = beginTimerFrame();
+            }
+
             if (drawCommands.empty())
             {
                 frameBufferClearedFrame = currentFrame;
@@ -824,6 +978,15 @@ namespace ouzel
             }
             else for (const DrawCommand& drawCommand : drawCommands)
             {
+                // a timestamp at the start of every pass
+                if (timerFrame && (!previousCommand || isNewPass(*previousCommand, drawCommand)))
+                {
+                    writeTimestamp(*timerFrame, static_cast<uint32_t>(timerFrame->passes.size()));
+                    timerFrame->passes.push_back({drawCommand.camera, drawCommand.layer, drawCommand.renderTarget, 0.0f});
+                }
+
+                previousCommand = &drawCommand;
+
 #if !OUZEL_SUPPORTS_OPENGLES
                 setPolygonFillMode(drawCommand.wireframe ? GL_LINE : GL_FILL);
 #else
@@ -1108,6 +1271,13 @@ namespace ouzel
                 }
             }
 
+            // and one at the end of the last pass
+            if (timerFrame && !timerFrame->passes.empty())
+            {
+                writeTimestamp(*timerFrame, static_cast<uint32_t>(timerFrame->passes.size()));
+                timerFrame->pending = true;
+            }
+
             if (!swapBuffers())
             {
                 return false;
@@ -1116,6 +1286,76 @@ namespace ouzel
             return true;
         }
 
+        RenderDeviceOGL::TimerFrame* RenderDeviceOGL::beginTimerFrame()
+        {
+            TimerFrame& timerFrame = timerFrames[currentFrame % TIMER_FRAME_COUNT];
+
+            // never wait for the GPU, just skip timing this frame
+            if (timerFrame.pending)
+            {
+                ++skippedTimingFrameCount;
+                return nullptr;
+            }
+
+            timerFrame.frame = currentFrame;
+            timerFrame.passes.clear();
+
+            return &timerFrame;
+        }
+
+        void RenderDeviceOGL::writeTimestamp(TimerFrame& timerFrame, uint32_t index)
+        {
+            if (timerFrame.queries.size() <= index)
+            {
+                GLuint queryId = 0;
+                glGenQueriesProc(1, &queryId);
+                timerFrame.queries.push_back(queryId);
+            }
+
+#if OUZEL_SUPPORTS_OPENGLES
+            glQueryCounterProc(timerFrame.queries[index], GL_TIMESTAMP_EXT);
+#else
+            glQueryCounterProc(timerFrame.queries[index], GL_TIMESTAMP);
+#endif
+        }
+
+        void RenderDeviceOGL::readTimerQueries()
+        {
+            for (TimerFrame& timerFrame : timerFrames)
+            {
+                if (!timerFrame.pending) continue;
+
+                // the queries of a frame finish in order, so the last one tells if all are available
+                GLuint available = GL_FALSE;
+                glGetQueryObjectuivProc(timerFrame.queries[timerFrame.passes.size()], GL_QUERY_RESULT_AVAILABLE, &available);
+
+                if (!available) continue;
+
+                timerFrame.pending = false;
+
+#if OUZEL_SUPPORTS_OPENGLES
+                // the timestamps can't be compared if the GPU changed its frequency or was reset in the meantime
+                GLint disjoint = 0;
+                glGetIntegerv(GL_GPU_DISJOINT_EXT, &disjoint);
+                if (disjoint) continue;
+#endif
+
+                GLuint64 startTime = 0;
+                glGetQueryObjectui64vProc(timerFrame.queries[0], GL_QUERY_RESULT, &startTime);
+
+                for (size_t i = 0; i < timerFrame.passes.size(); ++i)
+                {
+                    GLuint64 endTime = 0;
+                    glGetQueryObjectui64vProc(timerFrame.queries[i + 1], GL_QUERY_RESULT, &endTime);
+
+                    timerFrame.passes[i].time = static_cast<float>(endTime - startTime) / 1000000.0f;
+                    startTime = endTime;
+                }
+
+                setPassTimings(timerFrame.frame, timerFrame.passes);
+            }
+        }
+
         bool RenderDeviceOGL::lockContext()
         {
             return true;
@@ -1178,6 +1418,7 @@ namespace ouzel
 
             TextureResource* texture = new TextureResourceOGL(this);
             resources.push_back(std::unique_ptr<RenderResource>(texture));
+            textureResources.push_back(texture);
             return texture;
         }
 
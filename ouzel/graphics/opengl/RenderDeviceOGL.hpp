@@ -83,6 +83,9 @@ extern PFNGLLINKPROGRAMPROC glLinkProgramProc;
 extern PFNGLGETPROGRAMIVPROC glGetProgramivProc;
 extern PFNGLGETPROGRAMINFOLOGPROC glGetProgramInfoLogProc;
 extern PFNGLGETUNIFORMLOCATIONPROC glGetUniformLocationProc;
+extern PFNGLGETPROGRAMBINARYPROC glGetProgramBinaryProc;
+extern PFNGLPROGRAMBINARYPROC glProgramBinaryProc;
+extern PFNGLPROGRAMPARAMETERIPROC glProgramParameteriProc;
 
 extern PFNGLBINDBUFFERPROC glBindBufferProc;
 extern PFNGLDELETEBUFFERSPROC glDeleteBuffersProc;
@@ -99,6 +102,20 @@ extern PFNGLVERTEXATTRIBPOINTERPROC glVertexAttribPointerProc;
 
 extern PFNGLGETSTRINGIPROC glGetStringiProc;
 
+#if OUZEL_SUPPORTS_OPENGLES
+extern PFNGLGENQUERIESEXTPROC glGenQueriesProc;
+extern PFNGLDELETEQUERIESEXTPROC glDeleteQueriesProc;
+extern PFNGLQUERYCOUNTEREXTPROC glQueryCounterProc;
+extern PFNGLGETQUERYOBJECTUIVEXTPROC glGetQueryObjectuivProc;
+extern PFNGLGETQUERYOBJECTUI64VEXTPROC glGetQueryObjectui64vProc;
+#else
+extern PFNGLGENQUERIESPROC glGenQueriesProc;
+extern PFNGLDELETEQUERIESPROC glDeleteQueriesProc;
+extern PFNGLQUERYCOUNTERPROC glQueryCounterProc;
+extern PFNGLGETQUERYOBJECTUIVPROC glGetQueryObjectuivProc;
+extern PFNGLGETQUERYOBJECTUI64VPROC glGetQueryObjectui64vProc;
+#endif
+
 #if OUZEL_SUPPORTS_OPENGLES
 extern PFNGLMAPBUFFEROESPROC glMapBufferProc;
 extern PFNGLUNMAPBUFFEROESPROC glUnmapBufferProc;
@@ -160,6 +177,11 @@ namespace ouzel
             }
 
             bool isTextureBaseLevelSupported() const { return textureBaseLevelSupported; }
+            bool isProgramBinarySupported() const { return programBinarySupported; }
+
+            // vendor, renderer and version, program binaries are only valid for the same driver
+            const std::string& getDriverDescription() const { return driverDescription; }
+            const std::string& getProgramCacheDirectory() const { return programCacheDirectory; }
             bool isTextureMaxLevelSupported() const { return textureMaxLevelSupported; }
 
             inline bool bindTexture(GLuint textureId, uint32_t layer)
@@ -643,7 +665,22 @@ namespace ouzel
             virtual MeshBufferResource* createMeshBuffer() override;
             virtual BufferResource* createBuffer() override;
 
-            void* getProcAddress(const std::string& name) const;
+            virtual void* getProcAddress(const std::string& name) const;
+
+            struct TimerFrame
+            {
+                // a timestamp at the start of every pass and one at the end of the last pass
+                std::vector<GLuint> queries;
+                std::vector<PassTiming> passes;
+                uint32_t frame = 0;
+                bool pending = false;
+            };
+
+            TimerFrame* beginTimerFrame();
+            void writeTimestamp(TimerFrame& timerFrame, uint32_t index);
+            void readTimerQueries();
+
+            TimerFrame timerFrames[TIMER_FRAME_COUNT];
 
             GLuint frameBufferId = 0;
             GLsizei frameBufferWidth = 0;
@@ -653,6 +690,10 @@ namespace ouzel
             GLfloat frameBufferClearColor[4];
             bool textureBaseLevelSupported = true;
             bool textureMaxLevelSupported = true;
+            bool programBinarySupported = false;
+
+            std::string driverDescription;
+            std::string programCacheDirectory;
 
             struct StateCache
             {
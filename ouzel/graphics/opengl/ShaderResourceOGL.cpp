@@ -5,14 +5,43 @@
 
 #if OUZEL_COMPILE_OPENGL
 
+#include <chrono>
 #include "ShaderResourceOGL.hpp"
 #include "RenderDeviceOGL.hpp"
+#include "core/Engine.hpp"
+#include "files/FileSystem.hpp"
 #include "utils/Log.hpp"
+#include "utils/OBFView.hpp"
+#include "utils/Utils.hpp"
 
 namespace ouzel
 {
     namespace graphics
     {
+        static const uint32_t PROGRAM_CACHE_VERSION = 1;
+
+        enum ProgramCacheKey
+        {
+            PROGRAM_CACHE_KEY_VERSION,
+            PROGRAM_CACHE_KEY_BINARY_FORMAT,
+            PROGRAM_CACHE_KEY_BINARY,
+            PROGRAM_CACHE_KEY_ATTRIBUTES,
+            PROGRAM_CACHE_KEY_TEXTURE_LOCATIONS,
+            PROGRAM_CACHE_KEY_PIXEL_SHADER_LOCATIONS,
+            PROGRAM_CACHE_KEY_VERTEX_SHADER_LOCATIONS
+        };
+
+        static void hashString(uint64_t& hash, const std::string& str)
+        {
+            // the terminator keeps consecutive strings apart
+            hash = fnv1aHash64(str.c_str(), str.length() + 1, hash);
+        }
+
+        static float getElapsedMilliseconds(std::chrono::steady_clock::time_point startTime)
+        {
+            return std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+        }
+
         ShaderResourceOGL::ShaderResourceOGL(RenderDeviceOGL* initRenderDeviceOGL):
             renderDeviceOGL(initRenderDeviceOGL)
         {
@@ -107,6 +136,31 @@ namespace ouzel
         }
 
         bool ShaderResourceOGL::compileShader()
+        {
+            std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+            std::string cachePath;
+            if (renderDeviceOGL->isProgramBinarySupported()) cachePath = getProgramCachePath();
+
+            if (!cachePath.empty() && loadProgramBinary(cachePath))
+            {
+                Log(Log::Level::INFO) << "Shader program loaded from cache in " << getElapsedMilliseconds(startTime) << " ms";
+                return true;
+            }
+
+            if (!linkProgram())
+            {
+                return false;
+            }
+
+            if (!cachePath.empty()) saveProgramBinary(cachePath);
+
+            Log(Log::Level::INFO) << "Shader program compiled in " << getElapsedMilliseconds(startTime) << " ms";
+
+            return true;
+        }
+
+        bool ShaderResourceOGL::linkProgram()
         {
             pixelShaderId = glCreateShaderProc(GL_FRAGMENT_SHADER);
 
@@ -204,6 +258,10 @@ namespace ouzel
                 }
             }
 
+            // without the hint some drivers do not keep the binary around
+            if (renderDeviceOGL->isProgramBinarySupported() && glProgramParameteriProc)
+                glProgramParameteriProc(programId, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+
             glLinkProgramProc(programId);
 
             glGetProgramivProc(programId, GL_LINK_STATUS, &status);
@@ -232,15 +290,8 @@ namespace ouzel
                 return false;
             }
 
-            renderDeviceOGL->useProgram(programId);
-
-            GLint texture0Location = glGetUniformLocationProc(programId, "texture0");
-            if (texture0Location != -1) glUniform1iProc(texture0Location, 0);
-
-            GLint texture1Location = glGetUniformLocationProc(programId, "texture1");
-            if (texture1Location != -1) glUniform1iProc(texture1Location, 1);
-
-            if (RenderDeviceOGL::checkOpenGLError())
+            if (!setTextureLocations(glGetUniformLocationProc(programId, "texture0"),
+                                     glGetUniformLocationProc(programId, "texture1")))
             {
                 return false;
             }
@@ -285,6 +336,181 @@ namespace ouzel
 
             return true;
         }
+
+        bool ShaderResourceOGL::setTextureLocations(GLint texture0Location, GLint texture1Location)
+        {
+            renderDeviceOGL->useProgram(programId);
+
+            if (texture0Location != -1) glUniform1iProc(texture0Location, 0);
+            if (texture1Location != -1) glUniform1iProc(texture1Location, 1);
+
+            if (RenderDeviceOGL::checkOpenGLError())
+            {
+                return false;
+            }
+
+            return true;
+        }
+
+        std::string ShaderResourceOGL::getProgramCachePath() const
+        {
+            uint64_t hash = FNV1A_OFFSET_64;
+
+            hashString(hash, renderDeviceOGL->getDriverDescription());
+            hash = fnv1aHash64(pixelShaderData.data(), pixelShaderData.size(), hash);
+            hash = fnv1aHash64(vertexShaderData.data(), vertexShaderData.size(), hash);
+
+            for (Vertex::Attribute::Usage usage : vertexAttributes)
+            {
+                uint32_t value = static_cast<uint32_t>(usage);
+                hash = fnv1aHash64(&value, sizeof(value), hash);
+            }
+
+            for (const Shader::ConstantInfo& info : pixelShaderConstantInfo)
+                hashString(hash, info.name);
+
+            for (const Shader::ConstantInfo& info : vertexShaderConstantInfo)
+                hashString(hash, info.name);
+
+            return renderDeviceOGL->getProgramCacheDirectory() + FileSystem::DIRECTORY_SEPARATOR +
+                "program-" + hexToString(hash, 16) + ".bin";
+        }
+
+        bool ShaderResourceOGL::loadProgramBinary(const std::string& path)
+        {
+            // any failure falls back to compiling the program
+            FileSystem* fileSystem = engine->getFileSystem();
+            if (!fileSystem->fileExists(path)) return false;
+
+            std::vector<uint8_t> data;
+            if (!fileSystem->readFile(path, data, false)) return false;
+
+            obf::View cache;
+            if (!cache.init(data)) return false;
+
+            if (cache[PROGRAM_CACHE_KEY_VERSION].asUInt32() != PROGRAM_CACHE_VERSION) return false;
+
+            obf::View binary = cache[PROGRAM_CACHE_KEY_BINARY];
+            obf::View attributes = cache[PROGRAM_CACHE_KEY_ATTRIBUTES];
+            obf::View textureLocations = cache[PROGRAM_CACHE_KEY_TEXTURE_LOCATIONS];
+            obf::View pixelLocations = cache[PROGRAM_CACHE_KEY_PIXEL_SHADER_LOCATIONS];
+            obf::View vertexLocations = cache[PROGRAM_CACHE_KEY_VERTEX_SHADER_LOCATIONS];
+
+            if (!binary.getByteArrayData() ||
+                attributes.getSize() != vertexAttributes.size() ||
+                textureLocations.getSize() != 2 ||
+                pixelLocations.getSize() != pixelShaderConstantInfo.size() ||
+                vertexLocations.getSize() != vertexShaderConstantInfo.size())
+                return false;
+
+            // attribute locations are part of the binary, so they have to be bound in the same order
+            uint32_t attributeIndex = 0;
+            for (Vertex::Attribute::Usage usage : vertexAttributes)
+            {
+                if (attributes[attributeIndex++].asUInt32() != static_cast<uint32_t>(usage)) return false;
+            }
+
+            programId = glCreateProgramProc();
+
+            glProgramBinaryProc(programId,
+                                static_cast<GLenum>(cache[PROGRAM_CACHE_KEY_BINARY_FORMAT].asUInt32()),
+                                binary.getByteArrayData(),
+                                static_cast<GLsizei>(binary.getByteArraySize()));
+
+            GLint status = GL_FALSE;
+            glGetProgramivProc(programId, GL_LINK_STATUS, &status);
+
+            // the driver rejects binaries of other driver versions
+            if (RenderDeviceOGL::checkOpenGLError(false) || status == GL_FALSE)
+            {
+                renderDeviceOGL->deleteProgram(programId);
+                programId = 0;
+                return false;
+            }
+
+            if (!setTextureLocations(textureLocations[0U].asInt32(), textureLocations[1U].asInt32()))
+            {
+                renderDeviceOGL->deleteProgram(programId);
+                programId = 0;
+                return false;
+            }
+
+            pixelShaderConstantLocations.clear();
+            pixelShaderConstantLocations.reserve(pixelShaderConstantInfo.size());
+
+            for (uint32_t i = 0; i < pixelShaderConstantInfo.size(); ++i)
+                pixelShaderConstantLocations.push_back({pixelLocations[i].asInt32(), pixelShaderConstantInfo[i].dataType});
+
+            vertexShaderConstantLocations.clear();
+            vertexShaderConstantLocations.reserve(vertexShaderConstantInfo.size());
+
+            for (uint32_t i = 0; i < vertexShaderConstantInfo.size(); ++i)
+                vertexShaderConstantLocations.push_back({vertexLocations[i].asInt32(), vertexShaderConstantInfo[i].dataType});
+
+            return true;
+        }
+
+        void ShaderResourceOGL::saveProgramBinary(const std::string& path)
+        {
+            GLint binaryLength = 0;
+            glGetProgramivProc(programId, GL_PROGRAM_BINARY_LENGTH, &binaryLength);
+
+            if (RenderDeviceOGL::checkOpenGLError(false) || binaryLength <= 0) return;
+
+            std::vector<uint8_t> binary(static_cast<size_t>(binaryLength));
+            GLsizei length = 0;
+            GLenum binaryFormat = 0;
+            glGetProgramBinaryProc(programId, binaryLength, &length, &binaryFormat, binary.data());
+
+            if (RenderDeviceOGL::checkOpenGLError(false) || length <= 0) return;
+
+            binary.resize(static_cast<size_t>(length));
+
+            std::vector<uint8_t> data;
+            obf::Writer writer(data);
+
+            writer.beginObject();
+
+            writer.writeKey(PROGRAM_CACHE_KEY_VERSION);
+            writer.writeInt(PROGRAM_CACHE_VERSION);
+
+            writer.writeKey(PROGRAM_CACHE_KEY_BINARY_FORMAT);
+            writer.writeInt(binaryFormat);
+
+            writer.writeKey(PROGRAM_CACHE_KEY_BINARY);
+            writer.writeByteArray(binary);
+
+            writer.writeKey(PROGRAM_CACHE_KEY_ATTRIBUTES);
+            writer.beginArray();
+            for (Vertex::Attribute::Usage usage : vertexAttributes)
+                writer.writeInt(static_cast<uint32_t>(usage));
+            writer.endArray();
+
+            writer.writeKey(PROGRAM_CACHE_KEY_TEXTURE_LOCATIONS);
+            writer.beginArray();
+            writer.writeInt(static_cast<uint64_t>(static_cast<int64_t>(glGetUniformLocationProc(programId, "texture0"))));
+            writer.writeInt(static_cast<uint64_t>(static_cast<int64_t>(glGetUniformLocationProc(programId, "texture1"))));
+            writer.endArray();
+
+            writer.writeKey(PROGRAM_CACHE_KEY_PIXEL_SHADER_LOCATIONS);
+            writer.beginArray();
+            for (const Location& location : pixelShaderConstantLocations)
+                writer.writeInt(static_cast<uint64_t>(static_cast<int64_t>(location.location)));
+            writer.endArray();
+
+            writer.writeKey(PROGRAM_CACHE_KEY_VERTEX_SHADER_LOCATIONS);
+            writer.beginArray();
+            for (const Location& location : vertexShaderConstantLocations)
+                writer.writeInt(static_cast<uint64_t>(static_cast<int64_t>(location.location)));
+            writer.endArray();
+
+            writer.endObject();
+
+            if (!engine->getFileSystem()->writeFile(path, data))
+            {
+                Log(Log::Level::WARN) << "Failed to write program cache " << path;
+            }
+        }
     } // namespace graphics
 } // namespace ouzel
 
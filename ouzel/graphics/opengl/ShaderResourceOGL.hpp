@@ -58,6 +58,13 @@ namespace ouzel
 
         protected:
             bool compileShader();
+            bool linkProgram();
+            bool setTextureLocations(GLint texture0Location, GLint texture1Location);
+
+            // program binaries are cached per source and driver, so that programs do not have to be compiled on every start
+            std::string getProgramCachePath() const;
+            bool loadProgramBinary(const std::string& path);
+            void saveProgramBinary(const std::string& path);
             void printShaderMessage(GLuint shaderId);
             void printProgramMessage();
 
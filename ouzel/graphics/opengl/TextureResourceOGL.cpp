@@ -408,6 +408,7 @@ namespace ouzel
 
         bool TextureResourceOGL::reload()
         {
+            residentLevel = 0;
             textureId = 0;
             frameBufferId = 0;
             depthBufferId = 0;
@@ -638,6 +639,9 @@ namespace ouzel
 
             if (!textureId)
             {
+                // the parameters are set when the texture is reloaded
+                if (isEvicted()) return true;
+
                 Log(Log::Level::ERR) << "Texture not initialized";
                 return false;
             }
@@ -685,6 +689,9 @@ namespace ouzel
 
             if (!textureId)
             {
+                // the parameters are set when the texture is reloaded
+                if (isEvicted()) return true;
+
                 Log(Log::Level::ERR) << "Texture not initialized";
                 return false;
             }
@@ -722,6 +729,9 @@ namespace ouzel
 
             if (!textureId)
             {
+                // the parameters are set when the texture is reloaded
+                if (isEvicted()) return true;
+
                 Log(Log::Level::ERR) << "Texture not initialized";
                 return false;
             }
@@ -759,6 +769,9 @@ namespace ouzel
 
             if (!textureId)
             {
+                // the parameters are set when the texture is reloaded
+                if (isEvicted()) return true;
+
                 Log(Log::Level::ERR) << "Texture not initialized";
                 return false;
             }
@@ -834,6 +847,68 @@ namespace ouzel
             return true;
         }
 
+        bool TextureResourceOGL::evict()
+        {
+            if (!isEvictable() || !textureId)
+            {
+                return false;
+            }
+
+            renderDeviceOGL->deleteTexture(textureId);
+            textureId = 0;
+            residentLevel = static_cast<uint32_t>(levels.size());
+
+            return true;
+        }
+
+        bool TextureResourceOGL::uploadLevel()
+        {
+            if (residentLevel == 0 || levels.empty())
+            {
+                return false;
+            }
+
+            if (!textureId)
+            {
+                if (!createTexture())
+                {
+                    return false;
+                }
+
+                if (renderDeviceOGL->isTextureMaxLevelSupported()) glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLsizei>(levels.size()) - 1);
+
+                if (!setTextureParameters())
+                {
+                    return false;
+                }
+            }
+
+            renderDeviceOGL->bindTexture(textureId, 0);
+
+            // without the base level parameter the texture is complete only with all the levels
+            uint32_t firstLevel = renderDeviceOGL->isTextureBaseLevelSupported() ? residentLevel - 1 : 0;
+
+            for (uint32_t level = firstLevel; level < residentLevel; ++level)
+            {
+                glTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(level), oglInternalPixelFormat,
+                             static_cast<GLsizei>(levels[level].size.width),
+                             static_cast<GLsizei>(levels[level].size.height), 0,
+                             oglPixelFormat, oglPixelType, levels[level].data.data());
+            }
+
+            if (renderDeviceOGL->isTextureBaseLevelSupported()) glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, static_cast<GLint>(firstLevel));
+
+            if (RenderDeviceOGL::checkOpenGLError())
+            {
+                Log(Log::Level::ERR) << "Failed to upload texture data";
+                return false;
+            }
+
+            residentLevel = firstLevel;
+
+            return true;
+        }
+
         bool TextureResourceOGL::createTexture()
         {
             if (depthBufferId)
@@ -60,6 +60,9 @@ namespace ouzel
             virtual bool setClearDepthBuffer(bool clear) override;
             virtual bool setClearColor(Color color) override;
 
+            virtual bool evict() override;
+            virtual bool uploadLevel() override;
+
             GLuint getTextureId() const { return textureId; }
 
             GLuint getFrameBufferId() const { return frameBufferId; }
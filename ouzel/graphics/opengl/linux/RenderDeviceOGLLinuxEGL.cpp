@@ -0,0 +1,336 @@
+// Copyright (C) 2018 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#include "core/Setup.h"
+
+#if OUZEL_PLATFORM_LINUX && OUZEL_COMPILE_OPENGL
+
+#include <cstring>
+#include "RenderDeviceOGLLinuxEGL.hpp"
+#include "EGL/eglext.h"
+#include "core/Engine.hpp"
+#include "utils/Log.hpp"
+
+#ifndef EGL_PLATFORM_SURFACELESS_MESA
+#define EGL_PLATFORM_SURFACELESS_MESA 0x31DD
+#endif
+
+namespace ouzel
+{
+    namespace graphics
+    {
+        static bool hasExtension(const char* extensions, const char* name)
+        {
+            if (!extensions) return false;
+
+            size_t length = strlen(name);
+
+            for (const char* i = strstr(extensions, name); i; i = strstr(i + length, name))
+            {
+                if ((i == extensions || i[-1] == ' ') && (i[length] == ' ' || i[length] == '\0'))
+                    return true;
+            }
+
+            return false;
+        }
+
+        RenderDeviceOGLLinuxEGL::RenderDeviceOGLLinuxEGL():
+            running(false)
+        {
+        }
+
+        RenderDeviceOGLLinuxEGL::~RenderDeviceOGLLinuxEGL()
+        {
+            running = false;
+            flushCommands();
+            if (renderThread.joinable()) renderThread.join();
+
+            if (context)
+            {
+                // the render thread released the context, the frame buffer has to be deleted in this one
+                if (eglMakeCurrent(display, surface, surface, context))
+                {
+                    if (colorRenderBufferId) glDeleteRenderbuffersProc(1, &colorRenderBufferId);
+                    if (depthRenderBufferId) glDeleteRenderbuffersProc(1, &depthRenderBufferId);
+                    if (frameBufferId) glDeleteFramebuffersProc(1, &frameBufferId);
+                }
+
+                if (!eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT))
+                {
+                    Log(Log::Level::ERR) << "Failed to unset EGL context";
+                }
+
+                if (!eglDestroyContext(display, context))
+                {
+                    Log(Log::Level::ERR) << "Failed to destroy EGL context";
+                }
+            }
+
+            if (surface)
+            {
+                if (!eglDestroySurface(display, surface))
+                {
+                    Log(Log::Level::ERR) << "Failed to destroy EGL surface";
+                }
+            }
+
+            if (display)
+            {
+                if (!eglTerminate(display))
+                {
+                    Log(Log::Level::ERR) << "Failed to terminate EGL";
+                }
+            }
+        }
+
+        bool RenderDeviceOGLLinuxEGL::init(Window* newWindow,
+                                           const Size2& newSize,
+                                           uint32_t newSampleCount,
+                                           Texture::Filter newTextureFilter,
+                                           uint32_t newMaxAnisotropy,
+                                           bool newVerticalSync,
+                                           bool newDepth,
+                                           bool newDebugRenderer)
+        {
+            // client extensions are only reported if EGL_EXT_client_extensions is supported
+            const char* clientExtensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+
+            if (hasExtension(clientExtensions, "EGL_MESA_platform_surfaceless"))
+            {
+                PFNEGLGETPLATFORMDISPLAYEXTPROC eglGetPlatformDisplayProc = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(eglGetProcAddress("eglGetPlatformDisplayEXT"));
+
+                if (eglGetPlatformDisplayProc)
+                    display = eglGetPlatformDisplayProc(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+            }
+
+            if (display == EGL_NO_DISPLAY)
+                display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+
+            if (display == EGL_NO_DISPLAY)
+            {
+                Log(Log::Level::ERR) << "Failed to get EGL display";
+                return false;
+            }
+
+            EGLint majorVersion;
+            EGLint minorVersion;
+            if (!eglInitialize(display, &majorVersion, &minorVersion))
+            {
+                Log(Log::Level::ERR) << "Failed to initialize EGL, error: " << eglGetError();
+                display = EGL_NO_DISPLAY;
+                return false;
+            }
+
+            Log(Log::Level::INFO) << "EGL " << majorVersion << "." << minorVersion << " initialized, vendor: " <<
+                eglQueryString(display, EGL_VENDOR);
+
+            if (!eglBindAPI(EGL_OPENGL_API))
+            {
+                Log(Log::Level::ERR) << "Failed to bind OpenGL API, error: " << eglGetError();
+                return false;
+            }
+
+            // the depth buffer is attached to the frame buffer object
+            const EGLint attributeList[] =
+            {
+                EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+                EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+                EGL_RED_SIZE, 8,
+                EGL_GREEN_SIZE, 8,
+                EGL_BLUE_SIZE, 8,
+                EGL_ALPHA_SIZE, 8,
+                EGL_NONE
+            };
+            EGLConfig config;
+            EGLint numConfig;
+            if (!eglChooseConfig(display, attributeList, &config, 1, &numConfig) || numConfig == 0)
+            {
+                Log(Log::Level::ERR) << "Failed to choose EGL config, error: " << eglGetError();
+                return false;
+            }
+
+            std::vector<EGLint> contextAttributes = {
+                EGL_CONTEXT_MAJOR_VERSION_KHR, 3,
+                EGL_CONTEXT_MINOR_VERSION_KHR, 2,
+                EGL_CONTEXT_OPENGL_PROFILE_MASK_KHR, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT_KHR
+            };
+
+            if (newDebugRenderer)
+            {
+                contextAttributes.push_back(EGL_CONTEXT_FLAGS_KHR);
+                contextAttributes.push_back(EGL_CONTEXT_OPENGL_DEBUG_BIT_KHR);
+            }
+
+            contextAttributes.push_back(EGL_NONE);
+
+            context = eglCreateContext(display, config, EGL_NO_CONTEXT, contextAttributes.data());
+
+            if (context)
+            {
+                apiMajorVersion = 3;
+                apiMinorVersion = 2;
+                Log(Log::Level::INFO) << "EGL OpenGL 3.2 context created";
+            }
+            else
+            {
+                context = eglCreateContext(display, config, EGL_NO_CONTEXT, nullptr);
+
+                if (context)
+                {
+                    apiMajorVersion = 2;
+                    apiMinorVersion = 0;
+                    Log(Log::Level::INFO) << "EGL OpenGL 2 context created";
+                }
+                else
+                {
+                    Log(Log::Level::ERR) << "Failed to create EGL context, error: " << eglGetError();
+                    return false;
+                }
+            }
+
+            // without surfaceless contexts a dummy pbuffer is made current, nothing is drawn into it
+            if (!hasExtension(eglQueryString(display, EGL_EXTENSIONS), "EGL_KHR_surfaceless_context"))
+            {
+                const EGLint surfaceAttributes[] =
+                {
+                    EGL_WIDTH, 1,
+                    EGL_HEIGHT, 1,
+                    EGL_NONE
+                };
+
+                surface = eglCreatePbufferSurface(display, config, surfaceAttributes);
+
+                if (surface == EGL_NO_SURFACE)
+                {
+                    Log(Log::Level::ERR) << "Failed to create EGL pbuffer surface, error: " << eglGetError();
+                    return false;
+                }
+            }
+
+            if (!eglMakeCurrent(display, surface, surface, context))
+            {
+                Log(Log::Level::ERR) << "Failed to set current EGL context, error: " << eglGetError();
+                return false;
+            }
+
+            if (newSampleCount > 1)
+            {
+                Log(Log::Level::WARN) << "Multisampling is not supported by the headless render device";
+                newSampleCount = 1;
+            }
+
+            if (!RenderDeviceOGL::init(newWindow,
+                                       newSize,
+                                       newSampleCount,
+                                       newTextureFilter,
+                                       newMaxAnisotropy,
+                                       newVerticalSync,
+                                       newDepth,
+                                       newDebugRenderer))
+            {
+                return false;
+            }
+
+            if (!createFrameBuffer())
+            {
+                return false;
+            }
+
+            if (!eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT))
+            {
+                Log(Log::Level::ERR) << "Failed to unset EGL context";
+            }
+
+            running = true;
+            renderThread = std::thread(&RenderDeviceOGLLinuxEGL::main, this);
+
+            return true;
+        }
+
+        void RenderDeviceOGLLinuxEGL::setSize(const Size2& newSize)
+        {
+            RenderDeviceOGL::setSize(newSize);
+
+            createFrameBuffer();
+        }
+
+        bool RenderDeviceOGLLinuxEGL::lockContext()
+        {
+            if (!eglMakeCurrent(display, surface, surface, context))
+            {
+                Log(Log::Level::ERR) << "Failed to set current EGL context, error: " << eglGetError();
+                return false;
+            }
+
+            return true;
+        }
+
+        bool RenderDeviceOGLLinuxEGL::swapBuffers()
+        {
+            // nothing is presented, just make sure the frame gets rendered
+            glFlush();
+
+            return true;
+        }
+
+        void* RenderDeviceOGLLinuxEGL::getProcAddress(const std::string& name) const
+        {
+            return reinterpret_cast<void*>(eglGetProcAddress(name.c_str()));
+        }
+
+        bool RenderDeviceOGLLinuxEGL::createFrameBuffer()
+        {
+            if (!glGenFramebuffersProc || !glGenRenderbuffersProc)
+            {
+                Log(Log::Level::ERR) << "Frame buffer objects are not supported";
+                return false;
+            }
+
+            if (!frameBufferId) glGenFramebuffersProc(1, &frameBufferId);
+
+            if (!colorRenderBufferId) glGenRenderbuffersProc(1, &colorRenderBufferId);
+            glBindRenderbufferProc(GL_RENDERBUFFER, colorRenderBufferId);
+            glRenderbufferStorageProc(GL_RENDERBUFFER, GL_RGBA8, frameBufferWidth, frameBufferHeight);
+
+            if (depth)
+            {
+                if (!depthRenderBufferId) glGenRenderbuffersProc(1, &depthRenderBufferId);
+                glBindRenderbufferProc(GL_RENDERBUFFER, depthRenderBufferId);
+                glRenderbufferStorageProc(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, frameBufferWidth, frameBufferHeight);
+            }
+
+            bindFrameBuffer(frameBufferId);
+            glFramebufferRenderbufferProc(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorRenderBufferId);
+
+            if (depth)
+            {
+                glFramebufferRenderbufferProc(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depthRenderBufferId);
+            }
+
+            if (glCheckFramebufferStatusProc(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+            {
+                Log(Log::Level::ERR) << "Failed to create framebuffer object " << glCheckFramebufferStatusProc(GL_FRAMEBUFFER);
+                return false;
+            }
+
+            return true;
+        }
+
+        void RenderDeviceOGLLinuxEGL::main()
+        {
+            engine->setCurrentThreadName("Render");
+
+            while (running)
+            {
+                process();
+            }
+
+            if (!eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT))
+            {
+                Log(Log::Level::ERR) << "Failed to unset EGL context, error: " << eglGetError();
+            }
+        }
+    } // namespace graphics
+} // namespace ouzel
+
+#endif
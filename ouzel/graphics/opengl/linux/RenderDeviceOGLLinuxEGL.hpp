@@ -0,0 +1,60 @@
+// Copyright (C) 2018 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#pragma once
+
+#include "core/Setup.h"
+
+#if OUZEL_PLATFORM_LINUX && OUZEL_COMPILE_OPENGL
+
+#include <thread>
+#include <atomic>
+#include "EGL/egl.h"
+#include "graphics/opengl/RenderDeviceOGL.hpp"
+
+namespace ouzel
+{
+    namespace graphics
+    {
+        // headless device that renders to a frame buffer object without a window or an X server,
+        // uses the surfaceless Mesa platform if it is available (e.g. llvmpipe on build machines)
+        class RenderDeviceOGLLinuxEGL: public RenderDeviceOGL
+        {
+            friend Renderer;
+        public:
+            virtual ~RenderDeviceOGLLinuxEGL();
+
+        private:
+            RenderDeviceOGLLinuxEGL();
+
+            virtual bool init(Window* newWindow,
+                              const Size2& newSize,
+                              uint32_t newSampleCount,
+                              Texture::Filter newTextureFilter,
+                              uint32_t newMaxAnisotropy,
+                              bool newVerticalSync,
+                              bool newDepth,
+                              bool newDebugRenderer) override;
+
+            virtual void setSize(const Size2& newSize) override;
+            virtual bool lockContext() override;
+            virtual bool swapBuffers() override;
+            virtual void* getProcAddress(const std::string& name) const override;
+
+            bool createFrameBuffer();
+            void main();
+
+            EGLDisplay display = EGL_NO_DISPLAY;
+            EGLSurface surface = EGL_NO_SURFACE;
+            EGLContext context = EGL_NO_CONTEXT;
+
+            GLuint colorRenderBufferId = 0;
+            GLuint depthRenderBufferId = 0;
+
+            std::atomic<bool> running;
+            std::thread renderThread;
+        };
+    } // namespace graphics
+} // namespace ouzel
+
+#endif
@@ -24,6 +24,12 @@ namespace ouzel
                                  std::vector<graphics::Vertex>& vertices,
                                  std::shared_ptr<graphics::Texture>& texture) override;
 
+        virtual uint32_t getDataSize() const override
+        {
+            return static_cast<uint32_t>(chars.size() * sizeof(CharDescriptor) +
+                                         kern.size() * (sizeof(std::pair<uint32_t, uint32_t>) + sizeof(int16_t)));
+        }
+
     protected:
         int16_t getKerningPair(uint32_t, uint32_t);
         float getStringWidth(const std::string& text);
@@ -28,5 +28,8 @@ namespace ouzel
                                  std::vector<uint16_t>& indices,
                                  std::vector<graphics::Vertex>& vertices,
                                  std::shared_ptr<graphics::Texture>& texture) = 0;
+
+        // bytes of font data kept in memory, excluding the textures
+        virtual uint32_t getDataSize() const { return 0; }
     };
 }
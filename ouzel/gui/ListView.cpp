@@ -0,0 +1,213 @@
+// Copyright (C) 2018 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#include <algorithm>
+#include <cmath>
+#include "ListView.hpp"
+#include "scene/Camera.hpp"
+#include "math/MathUtils.hpp"
+#include "math/Vector4.hpp"
+#include "utils/Log.hpp"
+
+namespace ouzel
+{
+    namespace gui
+    {
+        ListView::ListView(const Size2& initSize, const Size2& initItemSize,
+                           const std::function<std::unique_ptr<Widget>()>& initCreateItem,
+                           const std::function<void(Widget*, uint32_t)>& initBindItem,
+                           uint32_t initColumns, uint32_t initMarginRows):
+            size(initSize),
+            itemSize(initItemSize),
+            columns(std::max(initColumns, 1U)),
+            marginRows(initMarginRows),
+            createItem(initCreateItem),
+            bindItem(initBindItem)
+        {
+        }
+
+        void ListView::setSize(const Size2& newSize)
+        {
+            size = newSize;
+
+            updateItems(false);
+        }
+
+        void ListView::setItemCount(uint32_t newItemCount)
+        {
+            itemCount = newItemCount;
+
+            updateItems(true);
+        }
+
+        void ListView::refreshItem(uint32_t index)
+        {
+            if (Widget* widget = getItemWidget(index))
+            {
+                if (bindItem) bindItem(widget, index);
+            }
+        }
+
+        void ListView::refresh()
+        {
+            updateItems(true);
+        }
+
+        float ListView::getMaxScrollPosition() const
+        {
+            uint32_t rowCount = (itemCount + columns - 1) / columns;
+
+            return std::max(0.0f, rowCount * itemSize.height - size.height);
+        }
+
+        void ListView::setScrollPosition(float newScrollPosition)
+        {
+            scrollPosition = clamp(newScrollPosition, 0.0f, getMaxScrollPosition());
+
+            updateItems(false);
+        }
+
+        void ListView::scrollToItem(uint32_t index)
+        {
+            float top = (index / columns) * itemSize.height;
+
+            // scroll just enough for the whole row to be visible
+            if (top < scrollPosition)
+            {
+                setScrollPosition(top);
+            }
+            else if (top + itemSize.height > scrollPosition + size.height)
+            {
+                setScrollPosition(top + itemSize.height - size.height);
+            }
+        }
+
+        Widget* ListView::getItemWidget(uint32_t index) const
+        {
+            if (index < firstVisibleItem || index - firstVisibleItem >= visibleItems.size()) return nullptr;
+
+            return visibleItems[index - firstVisibleItem];
+        }
+
+        bool ListView::getClipRectangle(const scene::Camera* camera, Rectangle& rectangle) const
+        {
+            const Matrix4 modelViewProj = camera->getRenderViewProjection() * getTransform();
+            const Rectangle& renderViewport = camera->getRenderViewport();
+
+            float minX = 1.0f, minY = 1.0f, maxX = -1.0f, maxY = -1.0f;
+
+            for (uint32_t corner = 0; corner < 4; ++corner)
+            {
+                Vector4 clip;
+                modelViewProj.transformVector(Vector4((corner & 1) ? size.width : 0.0f,
+                                                      (corner & 2) ? size.height : 0.0f,
+                                                      0.0f, 1.0f), clip);
+
+                // the area crosses the camera plane, nothing sensible to clip to
+                if (clip.w <= 0.0f) return false;
+
+                minX = std::min(minX, clip.x / clip.w);
+                minY = std::min(minY, clip.y / clip.w);
+                maxX = std::max(maxX, clip.x / clip.w);
+                maxY = std::max(maxY, clip.y / clip.w);
+            }
+
+            minX = clamp(minX, -1.0f, 1.0f);
+            minY = clamp(minY, -1.0f, 1.0f);
+            maxX = clamp(maxX, -1.0f, 1.0f);
+            maxY = clamp(maxY, -1.0f, 1.0f);
+
+            // render target pixels with the origin in the top left corner
+            rectangle.position.x = renderViewport.position.x + (minX * 0.5f + 0.5f) * renderViewport.size.width;
+            rectangle.position.y = renderViewport.position.y + (0.5f - maxY * 0.5f) * renderViewport.size.height;
+            rectangle.size.width = std::max(0.0f, (maxX - minX) * 0.5f * renderViewport.size.width);
+            rectangle.size.height = std::max(0.0f, (maxY - minY) * 0.5f * renderViewport.size.height);
+
+            return true;
+        }
+
+        void ListView::updateItems(bool rebind)
+        {
+            scrollPosition = clamp(scrollPosition, 0.0f, getMaxScrollPosition());
+
+            uint32_t firstItem = 0;
+            uint32_t endItem = 0;
+
+            if (itemCount > 0 && itemSize.height > 0.0f && size.height > 0.0f)
+            {
+                uint32_t rowCount = (itemCount + columns - 1) / columns;
+                uint32_t firstRow = static_cast<uint32_t>(scrollPosition / itemSize.height);
+                uint32_t lastRow = static_cast<uint32_t>((scrollPosition + size.height) / itemSize.height);
+
+                firstRow = (firstRow > marginRows) ? firstRow - marginRows : 0;
+                lastRow = std::min(lastRow + marginRows, rowCount - 1);
+
+                firstItem = firstRow * columns;
+                endItem = std::min(itemCount, (lastRow + 1) * columns);
+            }
+
+            std::vector<Widget*> newVisibleItems(endItem - firstItem, nullptr);
+
+            // recycle the widgets of the items that scrolled out
+            for (size_t i = 0; i < visibleItems.size(); ++i)
+            {
+                Widget* widget = visibleItems[i];
+                if (!widget) continue;
+
+                uint32_t index = firstVisibleItem + static_cast<uint32_t>(i);
+
+                if (index >= firstItem && index < endItem)
+                {
+                    newVisibleItems[index - firstItem] = widget;
+                    if (rebind && bindItem) bindItem(widget, index);
+                }
+                else
+                {
+                    removeChild(widget);
+                    freeItems.push_back(widget);
+                }
+            }
+
+            for (size_t i = 0; i < newVisibleItems.size(); ++i)
+            {
+                uint32_t index = firstItem + static_cast<uint32_t>(i);
+                Widget*& widget = newVisibleItems[i];
+
+                if (!widget)
+                {
+                    if (!freeItems.empty())
+                    {
+                        widget = freeItems.back();
+                        freeItems.pop_back();
+                    }
+                    else
+                    {
+                        std::unique_ptr<Widget> item = createItem ? createItem() : nullptr;
+
+                        if (!item)
+                        {
+                            Log(Log::Level::ERR) << "Failed to create list item";
+                            continue;
+                        }
+
+                        item->setClipWidget(this);
+                        widget = item.get();
+                        items.push_back(std::move(item));
+                    }
+
+                    addChild(widget);
+                    if (bindItem) bindItem(widget, index);
+                }
+
+                uint32_t row = index / columns;
+                uint32_t column = index % columns;
+
+                widget->setPosition(Vector2((column + 0.5f) * itemSize.width,
+                                            size.height - (row + 0.5f) * itemSize.height + scrollPosition));
+            }
+
+            visibleItems.swap(newVisibleItems);
+            firstVisibleItem = firstItem;
+        }
+    } // namespace gui
+} // namespace ouzel
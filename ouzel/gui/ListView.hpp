@@ -0,0 +1,79 @@
+// Copyright (C) 2018 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "gui/Widget.hpp"
+#include "math/Size2.hpp"
+
+namespace ouzel
+{
+    namespace gui
+    {
+        // scrollable list (or grid with more than one column) of equally sized items that only keeps widgets
+        // for the rows in the visible area and a margin around it, the widgets of the rows that scroll out
+        // are bound to the items that scroll in, so the cost does not depend on the number of items
+        // the area spans from (0, 0) to the size in the local space of the list, the first row is at the top
+        class ListView: public Widget
+        {
+        public:
+            ListView(const Size2& initSize, const Size2& initItemSize,
+                     const std::function<std::unique_ptr<Widget>()>& initCreateItem,
+                     const std::function<void(Widget*, uint32_t)>& initBindItem,
+                     uint32_t initColumns = 1, uint32_t initMarginRows = 1);
+
+            const Size2& getSize() const { return size; }
+            void setSize(const Size2& newSize);
+
+            const Size2& getItemSize() const { return itemSize; }
+            uint32_t getColumns() const { return columns; }
+
+            uint32_t getItemCount() const { return itemCount; }
+            // binds all the visible widgets again
+            void setItemCount(uint32_t newItemCount);
+
+            // binds the widget of the item again if it is visible
+            void refreshItem(uint32_t index);
+            void refresh();
+
+            // distance the content is scrolled up by, from 0 to getMaxScrollPosition()
+            float getScrollPosition() const { return scrollPosition; }
+            float getMaxScrollPosition() const;
+            void setScrollPosition(float newScrollPosition);
+            void scrollBy(float delta) { setScrollPosition(scrollPosition + delta); }
+            void scrollToItem(uint32_t index);
+
+            // the widget of the item or nullptr if the item is not in the visible rows
+            Widget* getItemWidget(uint32_t index) const;
+            uint32_t getFirstVisibleItem() const { return firstVisibleItem; }
+            uint32_t getVisibleItemCount() const { return static_cast<uint32_t>(visibleItems.size()); }
+            // number of widgets created so far, visible and recycled
+            uint32_t getCreatedItemCount() const { return static_cast<uint32_t>(items.size()); }
+
+            virtual bool getClipRectangle(const scene::Camera* camera, Rectangle& rectangle) const override;
+
+        protected:
+            void updateItems(bool rebind);
+
+            Size2 size;
+            Size2 itemSize;
+            uint32_t columns;
+            uint32_t marginRows;
+            uint32_t itemCount = 0;
+            float scrollPosition = 0.0f;
+
+            std::function<std::unique_ptr<Widget>()> createItem;
+            std::function<void(Widget*, uint32_t)> bindItem;
+
+            std::vector<std::unique_ptr<Widget>> items;
+            std::vector<Widget*> freeItems;
+            // widgets of the items from firstVisibleItem on
+            std::vector<Widget*> visibleItems;
+            uint32_t firstVisibleItem = 0;
+        };
+    } // namespace gui
+} // namespace ouzel
@@ -6,6 +6,7 @@
 #include "core/Engine.hpp"
 #include "events/EventDispatcher.hpp"
 #include "input/Input.hpp"
+#include "scene/Layer.hpp"
 #include "utils/Log.hpp"
 
 namespace ouzel
@@ -51,6 +52,38 @@ namespace ouzel
             }
         }
 
+        void Menu::draw(scene::Camera* camera, bool wireframe)
+        {
+            Widget::draw(camera, wireframe);
+
+            if (batch)
+            {
+                if (!wireframe) batch->update(widgets);
+                batch->draw(camera, getTransform(), wireframe);
+            }
+        }
+
+        void Menu::setBatched(bool newBatched)
+        {
+            if (newBatched == isBatched()) return;
+
+            if (newBatched)
+            {
+                batch.reset(new WidgetBatch());
+
+                // the menu itself usually has nothing to draw, so it must not be culled
+                cullDisabledBeforeBatch = cullDisabled;
+                cullDisabled = true;
+            }
+            else
+            {
+                batch.reset();
+                cullDisabled = cullDisabledBeforeBatch;
+            }
+
+            if (layer) layer->invalidateCache();
+        }
+
         void Menu::addChildWidget(Widget* widget)
         {
             addChild(widget);
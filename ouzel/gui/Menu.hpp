@@ -3,7 +3,9 @@
 
 #pragma once
 
+#include <memory>
 #include "gui/Widget.hpp"
+#include "gui/WidgetBatch.hpp"
 #include "events/EventHandler.hpp"
 
 namespace ouzel
@@ -17,6 +19,14 @@ namespace ouzel
 
             virtual void setEnabled(bool newEnabled) override;
 
+            virtual void draw(scene::Camera* camera, bool wireframe) override;
+
+            // draws the sprites and texts of all the widgets of the menu from one retained buffer,
+            // the widgets should share a texture atlas and not overlap
+            void setBatched(bool newBatched);
+            bool isBatched() const { return batch != nullptr; }
+            const WidgetBatch* getBatch() const { return batch.get(); }
+
             void addWidget(Widget* widget)
             {
                 addChildWidget(widget);
@@ -49,6 +59,9 @@ namespace ouzel
             std::vector<Widget*> widgets;
             Widget* selectedWidget = nullptr;
 
+            std::unique_ptr<WidgetBatch> batch;
+            bool cullDisabledBeforeBatch = false;
+
             EventHandler eventHandler;
         };
     } // namespace gui
@@ -3,6 +3,8 @@
 
 #include "Widget.hpp"
 #include "Menu.hpp"
+#include "WidgetBatch.hpp"
+#include "scene/Camera.hpp"
 
 namespace ouzel
 {
@@ -12,6 +14,43 @@ namespace ouzel
         {
         }
 
+        void Widget::draw(scene::Camera* camera, bool wireframe)
+        {
+            bool batched = menu && menu->isBatched();
+            Rectangle scissorRectangle;
+            bool scissorTest = clipWidget && clipWidget->getClipRectangle(camera, scissorRectangle);
+
+            if (!batched && !scissorTest)
+            {
+                Actor::draw(camera, wireframe);
+                return;
+            }
+
+            for (scene::Component* component : components)
+            {
+                if (component->isHidden()) continue;
+
+                // the sprites and texts of the widgets of a batched menu are drawn by the menu
+                if (batched && WidgetBatch::isBatchable(component)) continue;
+
+                component->draw(getTransform(),
+                                opacity,
+                                camera->getRenderViewProjection(),
+                                camera->getDrawTarget(),
+                                camera->getRenderViewport(),
+                                camera->getDepthWrite(),
+                                camera->getDepthTest(),
+                                wireframe,
+                                scissorTest,
+                                scissorRectangle);
+            }
+        }
+
+        bool Widget::getClipRectangle(const scene::Camera*, Rectangle&) const
+        {
+            return false;
+        }
+
         void Widget::setEnabled(bool newEnabled)
         {
             enabled = newEnabled;
@@ -4,6 +4,7 @@
 #pragma once
 
 #include "scene/Actor.hpp"
+#include "math/Rectangle.hpp"
 
 namespace ouzel
 {
@@ -17,6 +18,8 @@ namespace ouzel
         public:
             Widget();
 
+            virtual void draw(scene::Camera* camera, bool wireframe) override;
+
             Menu* getMenu() const { return menu; }
 
             virtual void setEnabled(bool newEnabled);
@@ -24,10 +27,18 @@ namespace ouzel
 
             bool isSelected() const { return selected; }
 
+            // the drawing of the widget is clipped to the area of the clip widget
+            Widget* getClipWidget() const { return clipWidget; }
+            void setClipWidget(Widget* newClipWidget) { clipWidget = newClipWidget; }
+
+            // area of the widget in render target pixels that the widgets it clips are drawn in
+            virtual bool getClipRectangle(const scene::Camera* camera, Rectangle& rectangle) const;
+
         protected:
             virtual void setSelected(bool newSelected);
 
             Menu* menu = nullptr;
+            Widget* clipWidget = nullptr;
             bool enabled = true;
             bool selected = false;
         };
@@ -0,0 +1,359 @@
+// Copyright (C) 2018 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#include <algorithm>
+#include "WidgetBatch.hpp"
+#include "Widget.hpp"
+#include "core/Engine.hpp"
+#include "assets/Cache.hpp"
+#include "graphics/Material.hpp"
+#include "scene/Camera.hpp"
+#include "scene/Sprite.hpp"
+#include "scene/TextRenderer.hpp"
+#include "utils/Log.hpp"
+#include "utils/Utils.hpp"
+
+namespace ouzel
+{
+    namespace gui
+    {
+        WidgetBatch::WidgetBatch()
+        {
+            whitePixelTexture = engine->getCache()->getTexture(graphics::TEXTURE_WHITE_PIXEL);
+
+            indexBuffer = std::make_shared<graphics::Buffer>();
+            indexBuffer->init(graphics::Buffer::Usage::INDEX, graphics::Buffer::DYNAMIC);
+
+            vertexBuffer = std::make_shared<graphics::Buffer>();
+            vertexBuffer->init(graphics::Buffer::Usage::VERTEX, graphics::Buffer::DYNAMIC);
+
+            meshBuffer = std::make_shared<graphics::MeshBuffer>();
+            meshBuffer->init(sizeof(uint32_t), indexBuffer, vertexBuffer);
+        }
+
+        bool WidgetBatch::isBatchable(const scene::Component* component)
+        {
+            if (component->getType() == scene::Component::SPRITE)
+            {
+                const scene::Sprite* sprite = static_cast<const scene::Sprite*>(component);
+                const std::shared_ptr<graphics::Material>& material = sprite->getMaterial();
+
+                // lit sprites and sprites with more than one texture need their own draw
+                if (!material || material->lighting || !material->shader || !material->textures[0]) return false;
+
+                for (uint32_t layer = 1; layer < graphics::Texture::LAYERS; ++layer)
+                {
+                    if (material->textures[layer]) return false;
+                }
+
+                return sprite->getCurrentFrame() < sprite->getFrames().size();
+            }
+            else if (component->getType() == scene::Component::TEXT_RENDERER)
+            {
+                const scene::TextRenderer* textRenderer = static_cast<const scene::TextRenderer*>(component);
+
+                return textRenderer->getTexture() && textRenderer->getShader();
+            }
+
+            return false;
+        }
+
+        void WidgetBatch::update(const std::vector<Widget*>& widgets)
+        {
+            bool widgetsChanged = (widgets.size() != entries.size());
+
+            for (size_t i = 0; i < widgets.size() && !widgetsChanged; ++i)
+            {
+                if (entries[i].widget != widgets[i]) widgetsChanged = true;
+            }
+
+            if (widgetsChanged)
+            {
+                entries.resize(widgets.size());
+
+                for (size_t i = 0; i < widgets.size(); ++i)
+                {
+                    entries[i].widget = widgets[i];
+                    build(entries[i]);
+                }
+
+                layout();
+                return;
+            }
+
+            bool needsLayout = false;
+
+            for (Entry& entry : entries)
+            {
+                if (!hasChanged(entry)) continue;
+
+                std::vector<Part> oldParts = std::move(entry.parts);
+                build(entry);
+
+                // the geometry of the widget still fits in its old ranges
+                if (!needsLayout && !patch(entry, oldParts)) needsLayout = true;
+            }
+
+            if (needsLayout) layout();
+        }
+
+        void WidgetBatch::draw(scene::Camera* camera, const Matrix4& transform, bool wireframe)
+        {
+            if (groups.empty()) return;
+
+            Matrix4 modelViewProj = camera->getRenderViewProjection() * transform;
+
+            // colors are baked into the vertices
+            std::vector<std::vector<float>> pixelShaderConstants(1);
+            pixelShaderConstants[0] = {1.0f, 1.0f, 1.0f, 1.0f};
+
+            std::vector<std::vector<float>> vertexShaderConstants(1);
+            vertexShaderConstants[0] = {std::begin(modelViewProj.m), std::end(modelViewProj.m)};
+
+            for (const Group& group : groups)
+            {
+                if (group.indexCount == 0) continue;
+
+                engine->getRenderer()->addDrawCommand({wireframe ? whitePixelTexture : group.key.texture},
+                                                      group.key.shader,
+                                                      pixelShaderConstants,
+                                                      vertexShaderConstants,
+                                                      group.key.blendState,
+                                                      meshBuffer,
+                                                      group.indexCount,
+                                                      graphics::Renderer::DrawMode::TRIANGLE_LIST,
+                                                      group.startIndex,
+                                                      camera->getDrawTarget(),
+                                                      camera->getRenderViewport(),
+                                                      camera->getDepthWrite(),
+                                                      camera->getDepthTest(),
+                                                      wireframe,
+                                                      false,
+                                                      Rectangle(),
+                                                      group.key.cullMode);
+            }
+        }
+
+        void WidgetBatch::addGeometry(Entry& entry, const Key& key,
+                                      const std::vector<uint16_t>& geometryIndices,
+                                      const std::vector<graphics::Vertex>& geometryVertices,
+                                      const Matrix4& transform, const float color[4])
+        {
+            auto i = std::find_if(entry.parts.begin(), entry.parts.end(),
+                                  [&key](const Part& part) { return part.key == key; });
+
+            if (i == entry.parts.end())
+            {
+                entry.parts.push_back(Part());
+                i = entry.parts.end() - 1;
+                i->key = key;
+            }
+
+            uint32_t baseVertex = static_cast<uint32_t>(i->vertices.size());
+
+            for (uint16_t index : geometryIndices)
+            {
+                i->indices.push_back(baseVertex + index);
+            }
+
+            for (graphics::Vertex vertex : geometryVertices)
+            {
+                transform.transformPoint(vertex.position);
+                vertex.color = Color(static_cast<uint8_t>(vertex.color.r * color[0]),
+                                     static_cast<uint8_t>(vertex.color.g * color[1]),
+                                     static_cast<uint8_t>(vertex.color.b * color[2]),
+                                     static_cast<uint8_t>(vertex.color.a * color[3]));
+                i->vertices.push_back(vertex);
+            }
+        }
+
+        bool WidgetBatch::hasChanged(const Entry& entry)
+        {
+            const Widget* widget = entry.widget;
+
+            if (widget->isWorldHidden() != entry.hidden) return true;
+            if (entry.hidden) return false;
+            if (widget->getOpacity() != entry.opacity) return true;
+
+            const Matrix4& transform = widget->getLocalTransform();
+            if (!std::equal(std::begin(transform.m), std::end(transform.m), std::begin(entry.transform.m))) return true;
+
+            const std::vector<scene::Component*>& components = widget->getComponents();
+            if (components.size() != entry.components.size()) return true;
+
+            for (size_t i = 0; i < components.size(); ++i)
+            {
+                if (components[i] != entry.components[i].first ||
+                    components[i]->getChangeCount() != entry.components[i].second)
+                {
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        void WidgetBatch::build(Entry& entry)
+        {
+            const Widget* widget = entry.widget;
+
+            entry.hidden = widget->isWorldHidden();
+            entry.opacity = widget->getOpacity();
+            entry.transform = widget->getLocalTransform();
+            entry.components.clear();
+            entry.parts.clear();
+
+            for (const scene::Component* component : widget->getComponents())
+            {
+                entry.components.push_back(std::make_pair(component, component->getChangeCount()));
+            }
+
+            if (entry.hidden) return;
+
+            for (const scene::Component* component : widget->getComponents())
+            {
+                if (component->isHidden() || !isBatchable(component)) continue;
+
+                if (component->getType() == scene::Component::SPRITE)
+                {
+                    const scene::Sprite* sprite = static_cast<const scene::Sprite*>(component);
+                    const std::shared_ptr<graphics::Material>& material = sprite->getMaterial();
+                    const scene::SpriteFrame& frame = sprite->getFrames()[sprite->getCurrentFrame()];
+
+                    Key key = {material->textures[0], material->shader, material->blendState, material->cullMode};
+                    float color[4] = {material->diffuseColor.normR(), material->diffuseColor.normG(), material->diffuseColor.normB(),
+                        material->diffuseColor.normA() * entry.opacity * material->opacity};
+
+                    addGeometry(entry, key, frame.getIndices(), frame.getVertices(),
+                                entry.transform * sprite->getOffsetMatrix(), color);
+                }
+                else
+                {
+                    const scene::TextRenderer* textRenderer = static_cast<const scene::TextRenderer*>(component);
+                    const Color& textColor = textRenderer->getColor();
+
+                    Key key = {textRenderer->getTexture(), textRenderer->getShader(), textRenderer->getBlendState(),
+                        graphics::Renderer::CullMode::NONE};
+                    float color[4] = {textColor.normR(), textColor.normG(), textColor.normB(), textColor.normA() * entry.opacity};
+
+                    addGeometry(entry, key, textRenderer->getIndices(), textRenderer->getVertices(),
+                                entry.transform, color);
+                }
+            }
+        }
+
+        void WidgetBatch::layout()
+        {
+            groups.clear();
+            indices.clear();
+            vertices.clear();
+
+            // groups in the order of their first use
+            for (Entry& entry : entries)
+            {
+                for (Part& part : entry.parts)
+                {
+                    auto i = std::find_if(groups.begin(), groups.end(),
+                                          [&part](const Group& group) { return group.key == part.key; });
+
+                    part.group = static_cast<uint32_t>(i - groups.begin());
+
+                    if (i == groups.end())
+                    {
+                        Group group;
+                        group.key = part.key;
+                        group.startIndex = 0;
+                        group.indexCount = 0;
+                        groups.push_back(group);
+                    }
+                }
+            }
+
+            for (uint32_t groupIndex = 0; groupIndex < groups.size(); ++groupIndex)
+            {
+                Group& group = groups[groupIndex];
+                group.startIndex = static_cast<uint32_t>(indices.size());
+
+                for (Entry& entry : entries)
+                {
+                    for (Part& part : entry.parts)
+                    {
+                        if (part.group != groupIndex) continue;
+
+                        part.startVertex = static_cast<uint32_t>(vertices.size());
+                        part.startIndex = static_cast<uint32_t>(indices.size());
+
+                        for (uint32_t index : part.indices)
+                        {
+                            indices.push_back(part.startVertex + index);
+                        }
+
+                        vertices.insert(vertices.end(), part.vertices.begin(), part.vertices.end());
+                    }
+                }
+
+                group.indexCount = static_cast<uint32_t>(indices.size()) - group.startIndex;
+            }
+
+            ++layoutCount;
+
+            if (indices.empty()) return;
+
+            if (!indexBuffer->setData(indices.data(), static_cast<uint32_t>(getVectorSize(indices))) ||
+                !vertexBuffer->setData(vertices.data(), static_cast<uint32_t>(getVectorSize(vertices))))
+            {
+                Log(Log::Level::ERR) << "Failed to upload widget batch";
+                groups.clear();
+            }
+        }
+
+        bool WidgetBatch::patch(Entry& entry, const std::vector<Part>& oldParts)
+        {
+            if (entry.parts.size() != oldParts.size()) return false;
+
+            for (size_t i = 0; i < oldParts.size(); ++i)
+            {
+                const Part& oldPart = oldParts[i];
+                const Part& part = entry.parts[i];
+
+                if (!(part.key == oldPart.key) ||
+                    part.vertices.size() != oldPart.vertices.size() ||
+                    part.indices.size() != oldPart.indices.size())
+                {
+                    return false;
+                }
+            }
+
+            for (size_t i = 0; i < oldParts.size(); ++i)
+            {
+                Part& part = entry.parts[i];
+                part.group = oldParts[i].group;
+                part.startVertex = oldParts[i].startVertex;
+                part.startIndex = oldParts[i].startIndex;
+
+                if (part.vertices.empty()) continue;
+
+                for (size_t index = 0; index < part.indices.size(); ++index)
+                {
+                    indices[part.startIndex + index] = part.startVertex + part.indices[index];
+                }
+
+                std::copy(part.vertices.begin(), part.vertices.end(), vertices.begin() + part.startVertex);
+
+                if (!indexBuffer->setSubData(static_cast<uint32_t>(part.startIndex * sizeof(uint32_t)),
+                                             indices.data() + part.startIndex,
+                                             static_cast<uint32_t>(part.indices.size() * sizeof(uint32_t))) ||
+                    !vertexBuffer->setSubData(static_cast<uint32_t>(part.startVertex * sizeof(graphics::Vertex)),
+                                              vertices.data() + part.startVertex,
+                                              static_cast<uint32_t>(part.vertices.size() * sizeof(graphics::Vertex))))
+                {
+                    return false;
+                }
+            }
+
+            ++patchCount;
+
+            return true;
+        }
+    } // namespace gui
+} // namespace ouzel
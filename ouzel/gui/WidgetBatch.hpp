@@ -0,0 +1,124 @@
+// Copyright (C) 2018 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "utils/Noncopyable.hpp"
+#include "graphics/BlendState.hpp"
+#include "graphics/Buffer.hpp"
+#include "graphics/MeshBuffer.hpp"
+#include "graphics/Renderer.hpp"
+#include "graphics/Shader.hpp"
+#include "graphics/Texture.hpp"
+#include "graphics/Vertex.hpp"
+#include "math/Matrix4.hpp"
+
+namespace ouzel
+{
+    namespace scene
+    {
+        class Camera;
+        class Component;
+    }
+
+    namespace gui
+    {
+        class Widget;
+
+        // retained geometry of the sprites and texts of a widget tree in the local space of its root,
+        // drawn with one command per texture (one command if the widgets share an atlas)
+        // only the widgets whose components, transform or opacity changed are rebuilt and their ranges
+        // patched in the buffers, everything is laid out again only if the amount of geometry changes
+        // the widgets are drawn texture by texture, so overlapping widgets with different textures
+        // can be drawn out of order, and material changes have to go through Sprite::setMaterial
+        class WidgetBatch: public Noncopyable
+        {
+        public:
+            WidgetBatch();
+
+            static bool isBatchable(const scene::Component* component);
+
+            // rebuilds the changed widgets, the widgets have to be the children of the actor the batch is drawn with
+            void update(const std::vector<Widget*>& widgets);
+            void draw(scene::Camera* camera, const Matrix4& transform, bool wireframe);
+
+            uint32_t getDrawCount() const { return static_cast<uint32_t>(groups.size()); }
+            uint32_t getVertexCount() const { return static_cast<uint32_t>(vertices.size()); }
+            // number of widget patches and full layouts since the batch was created
+            uint64_t getPatchCount() const { return patchCount; }
+            uint64_t getLayoutCount() const { return layoutCount; }
+
+        private:
+            struct Key
+            {
+                std::shared_ptr<graphics::Texture> texture;
+                std::shared_ptr<graphics::Shader> shader;
+                std::shared_ptr<graphics::BlendState> blendState;
+                graphics::Renderer::CullMode cullMode;
+
+                bool operator==(const Key& other) const
+                {
+                    return texture == other.texture &&
+                        shader == other.shader &&
+                        blendState == other.blendState &&
+                        cullMode == other.cullMode;
+                }
+            };
+
+            struct Group
+            {
+                Key key;
+                uint32_t startIndex;
+                uint32_t indexCount;
+            };
+
+            // geometry of a widget that goes into one group
+            struct Part
+            {
+                Key key;
+                std::vector<uint32_t> indices;
+                std::vector<graphics::Vertex> vertices;
+                uint32_t group;
+                uint32_t startVertex;
+                uint32_t startIndex;
+            };
+
+            struct Entry
+            {
+                Widget* widget;
+                std::vector<std::pair<const scene::Component*, uint32_t>> components;
+                Matrix4 transform;
+                float opacity;
+                bool hidden;
+                std::vector<Part> parts;
+            };
+
+            static void addGeometry(Entry& entry, const Key& key,
+                                    const std::vector<uint16_t>& geometryIndices,
+                                    const std::vector<graphics::Vertex>& geometryVertices,
+                                    const Matrix4& transform, const float color[4]);
+
+            static bool hasChanged(const Entry& entry);
+            static void build(Entry& entry);
+            void layout();
+            bool patch(Entry& entry, const std::vector<Part>& oldParts);
+
+            std::vector<Entry> entries;
+            std::vector<Group> groups;
+            std::vector<uint32_t> indices;
+            std::vector<graphics::Vertex> vertices;
+
+            std::shared_ptr<graphics::Buffer> indexBuffer;
+            std::shared_ptr<graphics::Buffer> vertexBuffer;
+            std::shared_ptr<graphics::MeshBuffer> meshBuffer;
+            std::shared_ptr<graphics::Texture> whitePixelTexture;
+
+            uint64_t patchCount = 0;
+            uint64_t layoutCount = 0;
+        };
+    } // namespace gui
+} // namespace ouzel
@@ -5,6 +5,7 @@
 #include "Gamepad.hpp"
 #include "core/Engine.hpp"
 #include "events/EventDispatcher.hpp"
+#include "input/Input.hpp"
 
 namespace ouzel
 {
@@ -42,7 +43,8 @@ namespace ouzel
             return buttonStates[static_cast<uint32_t>(button)];
         }
 
-        void Gamepad::handleButtonValueChange(GamepadButton button, bool pressed, float value)
+        void Gamepad::handleButtonValueChange(GamepadButton button, bool pressed, float value,
+                                              std::chrono::steady_clock::time_point timestamp)
         {
             Event event;
             event.type = Event::Type::GAMEPAD_BUTTON_CHANGE;
@@ -53,11 +55,14 @@ namespace ouzel
             event.gamepadEvent.pressed = pressed;
             event.gamepadEvent.value = value;
             event.gamepadEvent.previousValue = buttonStates[static_cast<uint32_t>(button)].value;
+            event.gamepadEvent.timestamp = timestamp;
 
             engine->getEventDispatcher()->postEvent(event);
 
             buttonStates[static_cast<uint32_t>(button)].pressed = pressed;
             buttonStates[static_cast<uint32_t>(button)].value = value;
+
+            engine->getInput()->publishState(timestamp);
         }
 
         void Gamepad::setVibration(Motor, float)
@@ -48,7 +48,8 @@ namespace ouzel
         protected:
             Gamepad();
 
-            void handleButtonValueChange(GamepadButton button, bool pressed, float value);
+            void handleButtonValueChange(GamepadButton button, bool pressed, float value,
+                                         std::chrono::steady_clock::time_point timestamp = std::chrono::steady_clock::now());
 
             ButtonState buttonStates[static_cast<uint32_t>(GamepadButton::BUTTON_COUNT)];
             std::string name;
@@ -13,10 +13,23 @@ namespace ouzel
 {
     namespace input
     {
-        Input::Input()
+        Input::Input():
+            publishedState(1)
         {
             std::fill(std::begin(keyboardKeyStates), std::end(keyboardKeyStates), false);
             std::fill(std::begin(mouseButtonStates), std::end(mouseButtonStates), false);
+
+            for (InputState& state : states)
+            {
+                std::fill(std::begin(state.keyboardKeyStates), std::end(state.keyboardKeyStates), false);
+                std::fill(std::begin(state.mouseButtonStates), std::end(state.mouseButtonStates), false);
+
+                for (uint32_t i = 0; i < InputState::MAX_GAMEPADS; ++i)
+                {
+                    std::fill(std::begin(state.gamepadButtonStates[i]), std::end(state.gamepadButtonStates[i]), false);
+                    std::fill(std::begin(state.gamepadButtonValues[i]), std::end(state.gamepadButtonValues[i]), 0.0f);
+                }
+            }
         }
 
         Input::~Input()
@@ -119,12 +132,13 @@ namespace ouzel
         {
         }
 
-        void Input::keyPress(KeyboardKey key, uint32_t modifiers)
+        void Input::keyPress(KeyboardKey key, uint32_t modifiers, std::chrono::steady_clock::time_point timestamp)
         {
             Event event;
 
             event.keyboardEvent.key = key;
             event.keyboardEvent.modifiers = modifiers;
+            event.keyboardEvent.timestamp = timestamp;
 
             if (!keyboardKeyStates[static_cast<uint32_t>(key)])
             {
@@ -138,9 +152,11 @@ namespace ouzel
                 event.type = Event::Type::KEY_REPEAT;
                 engine->getEventDispatcher()->postEvent(event);
             }
+
+            publishState(timestamp);
         }
 
-        void Input::keyRelease(KeyboardKey key, uint32_t modifiers)
+        void Input::keyRelease(KeyboardKey key, uint32_t modifiers, std::chrono::steady_clock::time_point timestamp)
         {
             keyboardKeyStates[static_cast<uint32_t>(key)] = false;
 
@@ -149,11 +165,15 @@ namespace ouzel
 
             event.keyboardEvent.key = key;
             event.keyboardEvent.modifiers = modifiers;
+            event.keyboardEvent.timestamp = timestamp;
 
             engine->getEventDispatcher()->postEvent(event);
+
+            publishState(timestamp);
         }
 
-        void Input::mouseButtonPress(MouseButton button, const Vector2& position, uint32_t modifiers)
+        void Input::mouseButtonPress(MouseButton button, const Vector2& position, uint32_t modifiers,
+                                     std::chrono::steady_clock::time_point timestamp)
         {
             mouseButtonStates[static_cast<uint32_t>(button)] = true;
 
@@ -163,11 +183,15 @@ namespace ouzel
             event.mouseEvent.button = button;
             event.mouseEvent.position = position;
             event.mouseEvent.modifiers = modifiers;
+            event.mouseEvent.timestamp = timestamp;
 
             engine->getEventDispatcher()->postEvent(event);
+
+            publishState(timestamp);
         }
 
-        void Input::mouseButtonRelease(MouseButton button, const Vector2& position, uint32_t modifiers)
+        void Input::mouseButtonRelease(MouseButton button, const Vector2& position, uint32_t modifiers,
+                                       std::chrono::steady_clock::time_point timestamp)
         {
             mouseButtonStates[static_cast<uint32_t>(button)] = false;
 
@@ -177,11 +201,14 @@ namespace ouzel
             event.mouseEvent.button = button;
             event.mouseEvent.position = position;
             event.mouseEvent.modifiers = modifiers;
+            event.mouseEvent.timestamp = timestamp;
 
             engine->getEventDispatcher()->postEvent(event);
+
+            publishState(timestamp);
         }
 
-        void Input::mouseMove(const Vector2& position, uint32_t modifiers)
+        void Input::mouseMove(const Vector2& position, uint32_t modifiers, std::chrono::steady_clock::time_point timestamp)
         {
             Event event;
             event.type = Event::Type::MOUSE_MOVE;
@@ -189,23 +216,28 @@ namespace ouzel
             event.mouseEvent.difference = position - cursorPosition;
             event.mouseEvent.position = position;
             event.mouseEvent.modifiers = modifiers;
+            event.mouseEvent.timestamp = timestamp;
 
             cursorPosition = position;
 
             engine->getEventDispatcher()->postEvent(event);
+
+            publishState(timestamp);
         }
 
-        void Input::mouseRelativeMove(const Vector2& relativePosition, uint32_t modifiers)
+        void Input::mouseRelativeMove(const Vector2& relativePosition, uint32_t modifiers,
+                                      std::chrono::steady_clock::time_point timestamp)
         {
             Vector2 newPosition = cursorPosition + relativePosition;
 
             newPosition.x = clamp(newPosition.x, 0.0f, 1.0f);
             newPosition.y = clamp(newPosition.y, 0.0f, 1.0f);
 
-            mouseMove(newPosition, modifiers);
+            mouseMove(newPosition, modifiers, timestamp);
         }
 
-        void Input::mouseScroll(const Vector2& scroll, const Vector2& position, uint32_t modifiers)
+        void Input::mouseScroll(const Vector2& scroll, const Vector2& position, uint32_t modifiers,
+                                std::chrono::steady_clock::time_point timestamp)
         {
             Event event;
             event.type = Event::Type::MOUSE_SCROLL;
@@ -213,11 +245,15 @@ namespace ouzel
             event.mouseEvent.position = position;
             event.mouseEvent.scroll = scroll;
             event.mouseEvent.modifiers = modifiers;
+            event.mouseEvent.timestamp = timestamp;
 
             engine->getEventDispatcher()->postEvent(event);
+
+            publishState(timestamp);
         }
 
-        void Input::touchBegin(uint64_t touchId, const Vector2& position, float force)
+        void Input::touchBegin(uint64_t touchId, const Vector2& position, float force,
+                               std::chrono::steady_clock::time_point timestamp)
         {
             Event event;
             event.type = Event::Type::TOUCH_BEGIN;
@@ -225,13 +261,17 @@ namespace ouzel
             event.touchEvent.touchId = touchId;
             event.touchEvent.position = position;
             event.touchEvent.force = force;
+            event.touchEvent.timestamp = timestamp;
 
             touchPositions[touchId] = position;
 
             engine->getEventDispatcher()->postEvent(event);
+
+            publishState(timestamp);
         }
 
-        void Input::touchEnd(uint64_t touchId, const Vector2& position, float force)
+        void Input::touchEnd(uint64_t touchId, const Vector2& position, float force,
+                             std::chrono::steady_clock::time_point timestamp)
         {
             Event event;
             event.type = Event::Type::TOUCH_END;
@@ -239,6 +279,7 @@ namespace ouzel
             event.touchEvent.touchId = touchId;
             event.touchEvent.position = position;
             event.touchEvent.force = force;
+            event.touchEvent.timestamp = timestamp;
 
             auto i = touchPositions.find(touchId);
 
@@ -248,9 +289,12 @@ namespace ouzel
             }
 
             engine->getEventDispatcher()->postEvent(event);
+
+            publishState(timestamp);
         }
 
-        void Input::touchMove(uint64_t touchId, const Vector2& position, float force)
+        void Input::touchMove(uint64_t touchId, const Vector2& position, float force,
+                              std::chrono::steady_clock::time_point timestamp)
         {
             Event event;
             event.type = Event::Type::TOUCH_MOVE;
@@ -259,13 +303,17 @@ namespace ouzel
             event.touchEvent.difference = position - touchPositions[touchId];
             event.touchEvent.position = position;
             event.touchEvent.force = force;
+            event.touchEvent.timestamp = timestamp;
 
             touchPositions[touchId] = position;
 
             engine->getEventDispatcher()->postEvent(event);
+
+            publishState(timestamp);
         }
 
-        void Input::touchCancel(uint64_t touchId, const Vector2& position, float force)
+        void Input::touchCancel(uint64_t touchId, const Vector2& position, float force,
+                                std::chrono::steady_clock::time_point timestamp)
         {
             Event event;
             event.type = Event::Type::TOUCH_CANCEL;
@@ -273,6 +321,7 @@ namespace ouzel
             event.touchEvent.touchId = touchId;
             event.touchEvent.position = position;
             event.touchEvent.force = force;
+            event.touchEvent.timestamp = timestamp;
 
             auto i = touchPositions.find(touchId);
 
@@ -282,6 +331,49 @@ namespace ouzel
             }
 
             engine->getEventDispatcher()->postEvent(event);
+
+            publishState(timestamp);
+        }
+
+        InputState Input::getState()
+        {
+            return latchState();
+        }
+
+        void Input::publishState(std::chrono::steady_clock::time_point timestamp)
+        {
+            InputState& state = states[writeState];
+
+            state.timestamp = timestamp;
+            state.eventCount = ++eventCount;
+            std::copy(std::begin(keyboardKeyStates), std::end(keyboardKeyStates), std::begin(state.keyboardKeyStates));
+            std::copy(std::begin(mouseButtonStates), std::end(mouseButtonStates), std::begin(state.mouseButtonStates));
+            state.cursorPosition = cursorPosition;
+
+            state.gamepadCount = static_cast<uint32_t>(std::min(gamepads.size(), static_cast<size_t>(InputState::MAX_GAMEPADS)));
+
+            for (uint32_t i = 0; i < state.gamepadCount; ++i)
+            {
+                for (uint32_t button = 0; button < static_cast<uint32_t>(GamepadButton::BUTTON_COUNT); ++button)
+                {
+                    const Gamepad::ButtonState& buttonState = gamepads[i]->getButtonState(static_cast<GamepadButton>(button));
+                    state.gamepadButtonStates[i][button] = buttonState.pressed;
+                    state.gamepadButtonValues[i][button] = buttonState.value;
+                }
+            }
+
+            writeState = publishedState.exchange(writeState | STATE_NEW, std::memory_order_acq_rel) & ~STATE_NEW;
+        }
+
+        const InputState& Input::latchState()
+        {
+            if (publishedState.load(std::memory_order_relaxed) & STATE_NEW)
+                readState = publishedState.exchange(readState, std::memory_order_acq_rel) & ~STATE_NEW;
+
+            const InputState& state = states[readState];
+            if (state.timestamp > latchedInputTime) latchedInputTime = state.timestamp;
+
+            return state;
         }
 
         bool Input::showVirtualKeyboard()
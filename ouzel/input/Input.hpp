@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include <atomic>
+#include <chrono>
 #include <memory>
 #include <mutex>
 #include <vector>
@@ -217,11 +219,29 @@ namespace ouzel
 
         class Gamepad;
 
+        // state of the devices after the latest input event
+        struct InputState
+        {
+            static const uint32_t MAX_GAMEPADS = 4;
+
+            std::chrono::steady_clock::time_point timestamp;
+            uint64_t eventCount = 0;
+
+            bool keyboardKeyStates[static_cast<uint32_t>(KeyboardKey::KEY_COUNT)];
+            bool mouseButtonStates[static_cast<uint32_t>(MouseButton::BUTTON_COUNT)];
+            Vector2 cursorPosition;
+
+            uint32_t gamepadCount = 0;
+            bool gamepadButtonStates[MAX_GAMEPADS][static_cast<uint32_t>(GamepadButton::BUTTON_COUNT)];
+            float gamepadButtonValues[MAX_GAMEPADS][static_cast<uint32_t>(GamepadButton::BUTTON_COUNT)];
+        };
+
         class Input: public Noncopyable
         {
             friend Engine;
             friend Cursor;
             friend CursorResource;
+            friend Gamepad;
         public:
             virtual ~Input();
 
@@ -251,19 +271,37 @@ namespace ouzel
             bool isKeyboardKeyDown(KeyboardKey key) const { return keyboardKeyStates[static_cast<uint32_t>(key)]; }
             bool isMouseButtonDown(MouseButton button) const { return mouseButtonStates[static_cast<uint32_t>(button)]; }
 
-            virtual void keyPress(KeyboardKey key, uint32_t modifiers);
-            virtual void keyRelease(KeyboardKey key, uint32_t modifiers);
+            // the timestamps should be taken when the event is received from the OS
+            virtual void keyPress(KeyboardKey key, uint32_t modifiers,
+                                  std::chrono::steady_clock::time_point timestamp = std::chrono::steady_clock::now());
+            virtual void keyRelease(KeyboardKey key, uint32_t modifiers,
+                                    std::chrono::steady_clock::time_point timestamp = std::chrono::steady_clock::now());
 
-            virtual void mouseButtonPress(MouseButton button, const Vector2& position, uint32_t modifiers);
-            virtual void mouseButtonRelease(MouseButton button, const Vector2& position, uint32_t modifiers);
-            virtual void mouseMove(const Vector2& position, uint32_t modifiers);
-            virtual void mouseRelativeMove(const Vector2& relativePosition, uint32_t modifiers);
-            virtual void mouseScroll(const Vector2& scroll, const Vector2& position, uint32_t modifiers);
+            virtual void mouseButtonPress(MouseButton button, const Vector2& position, uint32_t modifiers,
+                                          std::chrono::steady_clock::time_point timestamp = std::chrono::steady_clock::now());
+            virtual void mouseButtonRelease(MouseButton button, const Vector2& position, uint32_t modifiers,
+                                            std::chrono::steady_clock::time_point timestamp = std::chrono::steady_clock::now());
+            virtual void mouseMove(const Vector2& position, uint32_t modifiers,
+                                   std::chrono::steady_clock::time_point timestamp = std::chrono::steady_clock::now());
+            virtual void mouseRelativeMove(const Vector2& relativePosition, uint32_t modifiers,
+                                           std::chrono::steady_clock::time_point timestamp = std::chrono::steady_clock::now());
+            virtual void mouseScroll(const Vector2& scroll, const Vector2& position, uint32_t modifiers,
+                                     std::chrono::steady_clock::time_point timestamp = std::chrono::steady_clock::now());
 
-            virtual void touchBegin(uint64_t touchId, const Vector2& position, float force = 1.0f);
-            virtual void touchEnd(uint64_t touchId, const Vector2& position, float force = 1.0f);
-            virtual void touchMove(uint64_t touchId, const Vector2& position, float force = 1.0f);
-            virtual void touchCancel(uint64_t touchId, const Vector2& position, float force = 1.0f);
+            virtual void touchBegin(uint64_t touchId, const Vector2& position, float force = 1.0f,
+                                    std::chrono::steady_clock::time_point timestamp = std::chrono::steady_clock::now());
+            virtual void touchEnd(uint64_t touchId, const Vector2& position, float force = 1.0f,
+                                  std::chrono::steady_clock::time_point timestamp = std::chrono::steady_clock::now());
+            virtual void touchMove(uint64_t touchId, const Vector2& position, float force = 1.0f,
+                                   std::chrono::steady_clock::time_point timestamp = std::chrono::steady_clock::now());
+            virtual void touchCancel(uint64_t touchId, const Vector2& position, float force = 1.0f,
+                                     std::chrono::steady_clock::time_point timestamp = std::chrono::steady_clock::now());
+
+            // latest published state without waiting for the events to be dispatched, meant to be read by the
+            // update thread (and only by it) as late in the frame as possible
+            InputState getState();
+            // timestamp of the newest input that the update thread has read, from the events or from getState
+            std::chrono::steady_clock::time_point getLatchedInputTime() const { return latchedInputTime; }
 
             virtual bool showVirtualKeyboard();
             virtual bool hideVirtualKeyboard();
@@ -273,6 +311,11 @@ namespace ouzel
             virtual bool init();
 
             void setCurrentCursor(Cursor* cursor);
+
+            // called on the thread that receives the input events after the event has been posted
+            void publishState(std::chrono::steady_clock::time_point timestamp);
+            // takes the latest published state, called by the update thread
+            const InputState& latchState();
             virtual void activateCursorResource(CursorResource* resource);
             virtual CursorResource* createCursorResource();
             void deleteCursorResource(CursorResource* resource);
@@ -284,6 +327,15 @@ namespace ouzel
             std::unordered_map<uint64_t, Vector2> touchPositions;
             std::vector<std::unique_ptr<Gamepad>> gamepads;
 
+            // triple buffer of the states, the published index has STATE_NEW set until it is taken by the reader
+            static const uint32_t STATE_NEW = 0x04;
+            InputState states[3];
+            std::atomic<uint32_t> publishedState;
+            uint32_t writeState = 0;
+            uint32_t readState = 2;
+            uint64_t eventCount = 0;
+            std::chrono::steady_clock::time_point latchedInputTime;
+
             std::mutex resourceMutex;
             std::vector<std::unique_ptr<CursorResource>> resources;
             std::vector<std::unique_ptr<CursorResource>> resourceDeleteSet;
@@ -241,6 +241,9 @@ namespace ouzel
             ::Window window = windowLinux->getNativeWindow();
             Display* display = windowLinux->getDisplay();
 
+            // headless, there is no X server to get the input from
+            if (!display) return true;
+
             char data[1] = {0};
 
             Pixmap pixmap = XCreateBitmapFromData(display, DefaultRootWindow(display), data, 1, 1);
@@ -294,7 +297,7 @@ namespace ouzel
             {
                 WindowResourceLinux* windowLinux = static_cast<WindowResourceLinux*>(engine->getWindow()->getResource());
                 Display* display = windowLinux->getDisplay();
-                if (emptyCursor != None) XFreeCursor(display, emptyCursor);
+                if (display && emptyCursor != None) XFreeCursor(display, emptyCursor);
             }
         }
 
@@ -308,6 +311,8 @@ namespace ouzel
                 Display* display = windowLinux->getDisplay();
                 ::Window window = windowLinux->getNativeWindow();
 
+                if (!display) return;
+
                 CursorResourceLinux* cursorLinux = static_cast<CursorResourceLinux*>(resource);
 
                 if (cursorLinux)
@@ -361,6 +366,8 @@ namespace ouzel
                     Display* display = windowLinux->getDisplay();
                     ::Window window = windowLinux->getNativeWindow();
 
+                    if (!display) return;
+
                     if (visible)
                     {
                         if (currentCursor)
@@ -394,6 +401,8 @@ namespace ouzel
                 Display* display = windowLinux->getDisplay();
                 ::Window window = windowLinux->getNativeWindow();
 
+                if (!display) return;
+
                 if (locked)
                 {
                     if (XGrabPointer(display, window, False,
@@ -428,6 +437,8 @@ namespace ouzel
                 Display* display = windowLinux->getDisplay();
                 ::Window window = windowLinux->getNativeWindow();
 
+                if (!display) return;
+
                 XWindowAttributes attributes;
                 XGetWindowAttributes(display, window, &attributes);
 
@@ -440,7 +451,7 @@ namespace ouzel
             });
         }
 
-        void InputLinux::handleXInput2Event(XGenericEventCookie* cookie)
+        void InputLinux::handleXInput2Event(XGenericEventCookie* cookie, std::chrono::steady_clock::time_point timestamp)
         {
             if (cookie->extension == xInputOpCode)
             {
@@ -451,7 +462,8 @@ namespace ouzel
                         XIDeviceEvent* xievent = reinterpret_cast<XIDeviceEvent*>(cookie->data);
                         touchBegin(xievent->detail,
                                    engine->getWindow()->convertWindowToNormalizedLocation(Vector2(static_cast<float>(xievent->event_x),
-                                                                                                  static_cast<float>(xievent->event_y))));
+                                                                                                  static_cast<float>(xievent->event_y))),
+                                   1.0f, timestamp);
                         break;
                     }
                     case XI_TouchEnd:
@@ -459,7 +471,8 @@ namespace ouzel
                         XIDeviceEvent* xievent = reinterpret_cast<XIDeviceEvent*>(cookie->data);
                         touchEnd(xievent->detail,
                                  engine->getWindow()->convertWindowToNormalizedLocation(Vector2(static_cast<float>(xievent->event_x),
-                                                                                                static_cast<float>(xievent->event_y))));
+                                                                                                static_cast<float>(xievent->event_y))),
+                                 1.0f, timestamp);
                         break;
                     }
                     case XI_TouchUpdate:
@@ -467,7 +480,8 @@ namespace ouzel
                         XIDeviceEvent* xievent = reinterpret_cast<XIDeviceEvent*>(cookie->data);
                         touchMove(xievent->detail,
                                   engine->getWindow()->convertWindowToNormalizedLocation(Vector2(static_cast<float>(xievent->event_x),
-                                                                                                 static_cast<float>(xievent->event_y))));
+                                                                                                 static_cast<float>(xievent->event_y))),
+                                  1.0f, timestamp);
                         break;
                     }
                 }
@@ -30,7 +30,7 @@ namespace ouzel
 
             virtual void setCursorPosition(const Vector2& position) override;
 
-            void handleXInput2Event(XGenericEventCookie* cookie);
+            void handleXInput2Event(XGenericEventCookie* cookie, std::chrono::steady_clock::time_point timestamp);
 
         protected:
             InputLinux();
@@ -1,6 +1,7 @@
 // Copyright (C) 2018 Elviss Strazdins
 // This file is part of the Ouzel engine.
 
+#include <cstring>
 #include <vector>
 #include "Language.hpp"
 #include "core/Engine.hpp"
@@ -19,19 +20,13 @@ namespace ouzel
         uint32_t translationOffset;
     };
 
-    bool Language::init(const std::string& filename)
-    {
-        std::vector<uint8_t> data;
-
-        if (!engine->getFileSystem()->readFile(filename, data))
-        {
-            return false;
-        }
-
-        return init(data);
-    }
+    // header: magic, version, slot count (power of two), string count, size of the string data,
+    // followed by the slots and the null-terminated strings
+    static const uint8_t TABLE_MAGIC[4] = {'O', 'L', 'N', 'G'};
+    static const uint32_t TABLE_VERSION = 1;
+    static const uint32_t TABLE_HEADER_SIZE = sizeof(TABLE_MAGIC) + 4 * sizeof(uint32_t);
 
-    bool Language::init(const std::vector<uint8_t>& data)
+    static bool parseMO(const std::vector<uint8_t>& data, std::vector<TranslationInfo>& translations)
     {
         const unsigned long MAGIC_BIG = 0xde120495;
         const unsigned long MAGIC_LITTLE = 0x950412de;
@@ -74,7 +69,7 @@ namespace ouzel
         uint32_t stringCount = decodeUInt32(data.data() + offset);
         offset += sizeof(stringCount);
 
-        std::vector<TranslationInfo> translations(stringCount);
+        translations.resize(stringCount);
 
         uint32_t stringsOffset = decodeUInt32(data.data() + offset);
         offset += sizeof(stringsOffset);
@@ -121,27 +116,237 @@ namespace ouzel
             {
                 return false;
             }
+        }
+
+        return true;
+    }
+
+    bool Language::init(const std::string& filename)
+    {
+        std::string path = engine->getFileSystem()->getPath(filename);
+
+        // precompiled tables are used directly from the mapped file
+        if (!path.empty() && file.init(path))
+        {
+            if (file.getSize() >= sizeof(TABLE_MAGIC) &&
+                memcmp(file.getData(), TABLE_MAGIC, sizeof(TABLE_MAGIC)) == 0)
+            {
+                return initTable(file.getData(), file.getSize());
+            }
+
+            file.close();
+        }
+
+        std::vector<uint8_t> data;
+
+        if (!engine->getFileSystem()->readFile(filename, data))
+        {
+            return false;
+        }
+
+        return init(data);
+    }
+
+    bool Language::init(const std::vector<uint8_t>& data)
+    {
+        file.close();
+
+        if (data.size() >= sizeof(TABLE_MAGIC) &&
+            memcmp(data.data(), TABLE_MAGIC, sizeof(TABLE_MAGIC)) == 0)
+        {
+            tableBuffer = data;
+        }
+        else if (!compile(data, tableBuffer))
+        {
+            return false;
+        }
+
+        return initTable(tableBuffer.data(), tableBuffer.size());
+    }
+
+    bool Language::compile(const std::vector<uint8_t>& data, std::vector<uint8_t>& table)
+    {
+        std::vector<TranslationInfo> translations;
+
+        if (!parseMO(data, translations))
+        {
+            return false;
+        }
+
+        // at most half of the slots are used, so that the probe sequences stay short
+        uint32_t slotCount = 2;
+        while (slotCount < translations.size() * 2) slotCount <<= 1;
+
+        std::vector<Slot> tableSlots(slotCount);
+        for (Slot& slot : tableSlots) slot.keyOffset = EMPTY_SLOT;
+
+        std::vector<char> tableStrings;
+        uint32_t tableStringCount = 0;
+
+        for (const TranslationInfo& translation : translations)
+        {
+            const char* key = reinterpret_cast<const char*>(data.data() + translation.stringOffset);
+            uint32_t keyHash = hash(key, translation.stringLength);
+
+            uint32_t index = keyHash & (slotCount - 1);
+            while (tableSlots[index].keyOffset != EMPTY_SLOT &&
+                   (tableSlots[index].hash != keyHash ||
+                    tableSlots[index].keyLength != translation.stringLength ||
+                    memcmp(&tableStrings[tableSlots[index].keyOffset], key, translation.stringLength) != 0))
+                index = (index + 1) & (slotCount - 1);
+
+            Slot& slot = tableSlots[index];
+
+            // the last translation of a duplicate string is used
+            if (slot.keyOffset == EMPTY_SLOT)
+            {
+                slot.hash = keyHash;
+                slot.keyOffset = static_cast<uint32_t>(tableStrings.size());
+                slot.keyLength = translation.stringLength;
+                tableStrings.insert(tableStrings.end(), key, key + translation.stringLength);
+                tableStrings.push_back('\0');
+                ++tableStringCount;
+            }
+
+            const char* value = reinterpret_cast<const char*>(data.data() + translation.translationOffset);
+            slot.valueOffset = static_cast<uint32_t>(tableStrings.size());
+            slot.valueLength = translation.translationLength;
+            tableStrings.insert(tableStrings.end(), value, value + translation.translationLength);
+            tableStrings.push_back('\0');
+        }
+
+        uint32_t stringsSize = static_cast<uint32_t>(tableStrings.size());
+
+        table.resize(TABLE_HEADER_SIZE + slotCount * sizeof(Slot) + stringsSize);
+        uint8_t* dst = table.data();
+
+        memcpy(dst, TABLE_MAGIC, sizeof(TABLE_MAGIC));
+        dst += sizeof(TABLE_MAGIC);
+        memcpy(dst, &TABLE_VERSION, sizeof(TABLE_VERSION));
+        dst += sizeof(TABLE_VERSION);
+        memcpy(dst, &slotCount, sizeof(slotCount));
+        dst += sizeof(slotCount);
+        memcpy(dst, &tableStringCount, sizeof(tableStringCount));
+        dst += sizeof(tableStringCount);
+        memcpy(dst, &stringsSize, sizeof(stringsSize));
+        dst += sizeof(stringsSize);
+        memcpy(dst, tableSlots.data(), slotCount * sizeof(Slot));
+        dst += slotCount * sizeof(Slot);
+        if (stringsSize) memcpy(dst, tableStrings.data(), stringsSize);
+
+        return true;
+    }
+
+    uint32_t Language::hash(const char* str, size_t length)
+    {
+        // the hashes are stored in the slots of the compiled tables, so this has to stay 32-bit FNV-1a
+        return fnv1aHash32(str, length);
+    }
+
+    bool Language::initTable(const uint8_t* tableData, size_t tableSize)
+    {
+        slots = nullptr;
+        strings = nullptr;
+        slotMask = 0;
+        stringCount = 0;
+
+        uint32_t header[4];
+
+        if (tableSize < TABLE_HEADER_SIZE)
+        {
+            Log(Log::Level::ERR) << "Invalid language table";
+            return false;
+        }
 
-            std::string str(reinterpret_cast<const char*>(data.data() + translations[i].stringOffset), translations[i].stringLength);
-            std::string translation(reinterpret_cast<const char*>(data.data() + translations[i].translationOffset), translations[i].translationLength);
+        memcpy(header, tableData + sizeof(TABLE_MAGIC), sizeof(header));
 
-            strings[str] = translation;
+        uint32_t version = header[0];
+        uint32_t slotCount = header[1];
+        uint32_t stringsSize = header[3];
+
+        if (version != TABLE_VERSION)
+        {
+            Log(Log::Level::ERR) << "Unsupported language table version " << version;
+            return false;
         }
 
+        if (slotCount == 0 || (slotCount & (slotCount - 1)) != 0 ||
+            slotCount > (tableSize - TABLE_HEADER_SIZE) / sizeof(Slot) ||
+            tableSize - TABLE_HEADER_SIZE - slotCount * sizeof(Slot) != stringsSize)
+        {
+            Log(Log::Level::ERR) << "Invalid language table";
+            return false;
+        }
+
+        const Slot* tableSlots = reinterpret_cast<const Slot*>(tableData + TABLE_HEADER_SIZE);
+        const char* tableStrings = reinterpret_cast<const char*>(tableSlots + slotCount);
+
+        // the lookups trust the table, so all of the strings are checked once here
+        uint32_t usedSlotCount = 0;
+
+        for (uint32_t i = 0; i < slotCount; ++i)
+        {
+            const Slot& slot = tableSlots[i];
+            if (slot.keyOffset == EMPTY_SLOT) continue;
+
+            ++usedSlotCount;
+
+            if (slot.keyOffset >= stringsSize || stringsSize - slot.keyOffset <= slot.keyLength ||
+                tableStrings[slot.keyOffset + slot.keyLength] != '\0' ||
+                slot.valueOffset >= stringsSize || stringsSize - slot.valueOffset <= slot.valueLength ||
+                tableStrings[slot.valueOffset + slot.valueLength] != '\0')
+            {
+                Log(Log::Level::ERR) << "Invalid language table";
+                return false;
+            }
+        }
+
+        // the probing stops at an empty slot
+        if (usedSlotCount == slotCount)
+        {
+            Log(Log::Level::ERR) << "Invalid language table";
+            return false;
+        }
+
+        slots = tableSlots;
+        strings = tableStrings;
+        slotMask = slotCount - 1;
+        stringCount = header[2];
+
         return true;
     }
 
-    std::string Language::getString(const std::string& str)
+    std::string Language::getString(const std::string& str) const
     {
-        auto i = strings.find(str);
+        StringView key(str.data(), static_cast<uint32_t>(str.length()));
+        StringView translation;
 
-        if (i != strings.end())
+        if (getTranslation(key, hash(str.data(), str.length()), translation))
         {
-            return i->second;
+            return translation.str();
         }
         else
         {
             return str;
         }
     }
+
+    bool Language::getTranslation(const StringView& str, uint32_t strHash, StringView& translation) const
+    {
+        if (!slots) return false;
+
+        for (uint32_t index = strHash & slotMask;; index = (index + 1) & slotMask)
+        {
+            const Slot& slot = slots[index];
+
+            if (slot.keyOffset == EMPTY_SLOT) return false;
+
+            if (slot.hash == strHash && slot.keyLength == str.getLength() &&
+                memcmp(strings + slot.keyOffset, str.getData(), str.getLength()) == 0)
+            {
+                translation = StringView(strings + slot.valueOffset, slot.valueLength);
+                return true;
+            }
+        }
+    }
 }
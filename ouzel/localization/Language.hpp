@@ -4,21 +4,53 @@
 #pragma once
 
 #include <cstdint>
-#include <map>
 #include <string>
 #include <vector>
+#include "files/MappedFile.hpp"
+#include "utils/StringView.hpp"
+#include "utils/Noncopyable.hpp"
 
 namespace ouzel
 {
-    class Language
+    // translations are kept in an open addressing hash table that is used in place,
+    // precompiled tables are mapped into memory instead of being parsed
+    class Language: public Noncopyable
     {
     public:
+        // accepts both .mo files and tables made by compile
         bool init(const std::string& filename);
         bool init(const std::vector<uint8_t>& data);
 
-        std::string getString(const std::string& str);
+        // converts an .mo file into a table in the native byte order
+        static bool compile(const std::vector<uint8_t>& data, std::vector<uint8_t>& table);
+        static uint32_t hash(const char* str, size_t length);
 
-    protected:
-        std::map<std::string, std::string> strings;
+        std::string getString(const std::string& str) const;
+        // the translation points into the table and is null-terminated
+        bool getTranslation(const StringView& str, uint32_t strHash, StringView& translation) const;
+
+        uint32_t getStringCount() const { return stringCount; }
+
+    private:
+        struct Slot
+        {
+            uint32_t hash;
+            uint32_t keyOffset; // EMPTY_SLOT for unused slots
+            uint32_t keyLength;
+            uint32_t valueOffset;
+            uint32_t valueLength;
+        };
+
+        static const uint32_t EMPTY_SLOT = 0xFFFFFFFF;
+
+        bool initTable(const uint8_t* tableData, size_t tableSize);
+
+        MappedFile file;
+        std::vector<uint8_t> tableBuffer;
+
+        const Slot* slots = nullptr;
+        const char* strings = nullptr;
+        uint32_t slotMask = 0;
+        uint32_t stringCount = 0;
     };
 }
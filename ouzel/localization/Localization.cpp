@@ -1,8 +1,12 @@
 // Copyright (C) 2018 Elviss Strazdins
 // This file is part of the Ouzel engine.
 
+#include <vector>
 #include "Localization.hpp"
 #include "Language.hpp"
+#include "core/Engine.hpp"
+#include "files/FileSystem.hpp"
+#include "utils/Log.hpp"
 
 namespace ouzel
 {
@@ -41,4 +45,55 @@ namespace ouzel
             return str;
         }
     }
+
+    Localization::Key Localization::getKey(const std::string& str)
+    {
+        auto i = keys.find(str);
+
+        if (i == keys.end())
+        {
+            i = keys.insert(std::make_pair(str, Language::hash(str.data(), str.length()))).first;
+        }
+
+        Key key;
+        key.str = &i->first;
+        key.hash = i->second;
+
+        return key;
+    }
+
+    StringView Localization::getString(const Key& key) const
+    {
+        if (!key.str) return StringView();
+
+        StringView str(key.str->data(), static_cast<uint32_t>(key.str->length()));
+        StringView translation;
+
+        if (currentLanguage && currentLanguage->getTranslation(str, key.hash, translation))
+        {
+            return translation;
+        }
+
+        return str;
+    }
+
+    bool Localization::compileLanguage(const std::string& filename, const std::string& outputFilename)
+    {
+        std::vector<uint8_t> data;
+
+        if (!engine->getFileSystem()->readFile(filename, data))
+        {
+            return false;
+        }
+
+        std::vector<uint8_t> table;
+
+        if (!Language::compile(data, table))
+        {
+            Log(Log::Level::ERR) << "Failed to compile language " << filename;
+            return false;
+        }
+
+        return engine->getFileSystem()->writeFile(outputFilename, table);
+    }
 }
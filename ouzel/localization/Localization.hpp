@@ -3,9 +3,12 @@
 
 #pragma once
 
+#include <cstdint>
 #include <memory>
 #include <map>
 #include <string>
+#include <unordered_map>
+#include "utils/StringView.hpp"
 
 namespace ouzel
 {
@@ -14,12 +17,28 @@ namespace ouzel
     class Localization
     {
     public:
+        // interned string with a precomputed hash, valid for the lifetime of the Localization
+        struct Key
+        {
+            const std::string* str = nullptr;
+            uint32_t hash = 0;
+        };
+
         void addLanguage(const std::string& name, const std::string& filename);
         void setLanguage(const std::string& language);
         std::string getString(const std::string& str);
 
+        Key getKey(const std::string& str);
+        // returns the key string if there is no translation, the result is null-terminated and stays valid until
+        // the language is replaced
+        StringView getString(const Key& key) const;
+
+        // writes the table that Language maps into memory, so that the .mo file doesn't have to be parsed at runtime
+        bool compileLanguage(const std::string& filename, const std::string& outputFilename);
+
     protected:
         std::map<std::string, std::shared_ptr<Language>> languages;
         std::shared_ptr<Language> currentLanguage;
+        std::unordered_map<std::string, uint32_t> keys;
     };
 }
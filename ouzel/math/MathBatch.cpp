@@ -0,0 +1,739 @@
+// Copyright (C) 2018 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include "MathBatch.hpp"
+#include "MathUtils.hpp"
+#include "utils/Utils.hpp"
+#if OUZEL_SUPPORTS_SSE
+#include <xmmintrin.h>
+    #if defined(__GNUC__)
+    #include <immintrin.h>
+    #include <cpuid.h>
+    #define OUZEL_SUPPORTS_AVX2 1
+    #define OUZEL_TARGET_AVX2 __attribute__((target("avx2,fma")))
+    #endif
+#elif OUZEL_SUPPORTS_NEON || OUZEL_SUPPORTS_NEON64
+#include <arm_neon.h>
+#endif
+
+namespace ouzel
+{
+    namespace
+    {
+        struct Kernels
+        {
+            MathISA isa;
+            void (*transformPoints)(const Matrix4&, const Vector3*, Vector3*, size_t);
+            void (*transformVectors)(const Matrix4&, const Vector3*, Vector3*, size_t);
+            void (*multiplyMatrices)(const Matrix4*, const Matrix4*, Matrix4*, size_t);
+            void (*transformBoxes)(const Matrix4*, const Box3*, Box3*, size_t);
+            bool (*invertAffineMatrices)(const Matrix4*, Matrix4*, size_t);
+        };
+
+        // scalar
+
+        template<bool POINT>
+        void transformScalar(const Matrix4& matrix, const Vector3* src, Vector3* dst, size_t count)
+        {
+            const float* m = matrix.m;
+            const float w = POINT ? 1.0f : 0.0f;
+
+            for (size_t i = 0; i < count; ++i)
+            {
+                float x = src[i].x;
+                float y = src[i].y;
+                float z = src[i].z;
+
+                dst[i].x = m[0] * x + m[4] * y + m[8] * z + m[12] * w;
+                dst[i].y = m[1] * x + m[5] * y + m[9] * z + m[13] * w;
+                dst[i].z = m[2] * x + m[6] * y + m[10] * z + m[14] * w;
+            }
+        }
+
+        void multiplyMatricesScalar(const Matrix4* matrices1, const Matrix4* matrices2, Matrix4* dst, size_t count)
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                const float* a = matrices1[i].m;
+                const float* b = matrices2[i].m;
+                float product[16];
+
+                for (size_t column = 0; column < 16; column += 4)
+                {
+                    product[column + 0] = a[0] * b[column] + a[4] * b[column + 1] + a[8] * b[column + 2] + a[12] * b[column + 3];
+                    product[column + 1] = a[1] * b[column] + a[5] * b[column + 1] + a[9] * b[column + 2] + a[13] * b[column + 3];
+                    product[column + 2] = a[2] * b[column] + a[6] * b[column + 1] + a[10] * b[column + 2] + a[14] * b[column + 3];
+                    product[column + 3] = a[3] * b[column] + a[7] * b[column + 1] + a[11] * b[column + 2] + a[15] * b[column + 3];
+                }
+
+                std::copy(std::begin(product), std::end(product), dst[i].m);
+            }
+        }
+
+        void transformBoxScalar(const Matrix4& matrix, const Box3& box, Box3& dst)
+        {
+            if (box.isEmpty())
+            {
+                dst.reset();
+                return;
+            }
+
+            // transform the center and sum up the absolute contributions of the extents
+            const float* m = matrix.m;
+            float centerX = (box.min.x + box.max.x) * 0.5f;
+            float centerY = (box.min.y + box.max.y) * 0.5f;
+            float centerZ = (box.min.z + box.max.z) * 0.5f;
+            float extentX = (box.max.x - box.min.x) * 0.5f;
+            float extentY = (box.max.y - box.min.y) * 0.5f;
+            float extentZ = (box.max.z - box.min.z) * 0.5f;
+
+            Vector3 center(m[0] * centerX + m[4] * centerY + m[8] * centerZ + m[12],
+                           m[1] * centerX + m[5] * centerY + m[9] * centerZ + m[13],
+                           m[2] * centerX + m[6] * centerY + m[10] * centerZ + m[14]);
+            Vector3 extent(fabsf(m[0]) * extentX + fabsf(m[4]) * extentY + fabsf(m[8]) * extentZ,
+                           fabsf(m[1]) * extentX + fabsf(m[5]) * extentY + fabsf(m[9]) * extentZ,
+                           fabsf(m[2]) * extentX + fabsf(m[6]) * extentY + fabsf(m[10]) * extentZ);
+
+            dst.min = center - extent;
+            dst.max = center + extent;
+        }
+
+        void transformBoxesScalar(const Matrix4* matrices, const Box3* boxes, Box3* dst, size_t count)
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                transformBoxScalar(matrices[i], boxes[i], dst[i]);
+            }
+        }
+
+        bool invertAffineMatrixScalar(const Matrix4& matrix, Matrix4& dst)
+        {
+            // the rows of the inverse 3x3 part are the cross products of the columns divided by the determinant
+            const float* m = matrix.m;
+            float r00 = m[5] * m[10] - m[6] * m[9];
+            float r01 = m[6] * m[8] - m[4] * m[10];
+            float r02 = m[4] * m[9] - m[5] * m[8];
+            float r10 = m[9] * m[2] - m[10] * m[1];
+            float r11 = m[10] * m[0] - m[8] * m[2];
+            float r12 = m[8] * m[1] - m[9] * m[0];
+            float r20 = m[1] * m[6] - m[2] * m[5];
+            float r21 = m[2] * m[4] - m[0] * m[6];
+            float r22 = m[0] * m[5] - m[1] * m[4];
+
+            float det = m[0] * r00 + m[1] * r01 + m[2] * r02;
+
+            if (fabsf(det) < TOLERANCE)
+            {
+                return false;
+            }
+
+            float invDet = 1.0f / det;
+            float translationX = m[12];
+            float translationY = m[13];
+            float translationZ = m[14];
+
+            float* d = dst.m;
+            d[0] = r00 * invDet;
+            d[1] = r10 * invDet;
+            d[2] = r20 * invDet;
+            d[3] = 0.0f;
+            d[4] = r01 * invDet;
+            d[5] = r11 * invDet;
+            d[6] = r21 * invDet;
+            d[7] = 0.0f;
+            d[8] = r02 * invDet;
+            d[9] = r12 * invDet;
+            d[10] = r22 * invDet;
+            d[11] = 0.0f;
+            d[12] = -(d[0] * translationX + d[4] * translationY + d[8] * translationZ);
+            d[13] = -(d[1] * translationX + d[5] * translationY + d[9] * translationZ);
+            d[14] = -(d[2] * translationX + d[6] * translationY + d[10] * translationZ);
+            d[15] = 1.0f;
+
+            return true;
+        }
+
+        bool invertAffineMatricesScalar(const Matrix4* matrices, Matrix4* dst, size_t count)
+        {
+            bool result = true;
+
+            for (size_t i = 0; i < count; ++i)
+            {
+                if (!invertAffineMatrixScalar(matrices[i], dst[i])) result = false;
+            }
+
+            return result;
+        }
+
+        const Kernels scalarKernels = {
+            MathISA::SCALAR,
+            transformScalar<true>,
+            transformScalar<false>,
+            multiplyMatricesScalar,
+            transformBoxesScalar,
+            invertAffineMatricesScalar
+        };
+
+#if OUZEL_SUPPORTS_SSE
+        // SSE
+
+        // the last vector of an array is loaded by element, so that the read doesn't go past the end of the array
+        inline __m128 loadVector3(const Vector3& vector, bool last)
+        {
+            return last ? _mm_setr_ps(vector.x, vector.y, vector.z, 0.0f) : _mm_loadu_ps(&vector.x);
+        }
+
+        inline void storeVector3(Vector3& vector, __m128 value)
+        {
+            _mm_storel_pi(reinterpret_cast<__m64*>(&vector.x), value);
+            _mm_store_ss(&vector.z, _mm_movehl_ps(value, value));
+        }
+
+        inline __m128 splat(__m128 value, int index)
+        {
+            switch (index)
+            {
+                case 0: return _mm_shuffle_ps(value, value, _MM_SHUFFLE(0, 0, 0, 0));
+                case 1: return _mm_shuffle_ps(value, value, _MM_SHUFFLE(1, 1, 1, 1));
+                case 2: return _mm_shuffle_ps(value, value, _MM_SHUFFLE(2, 2, 2, 2));
+                default: return _mm_shuffle_ps(value, value, _MM_SHUFFLE(3, 3, 3, 3));
+            }
+        }
+
+        inline __m128 transformSSE(__m128 c0, __m128 c1, __m128 c2, __m128 c3, __m128 value)
+        {
+            return _mm_add_ps(_mm_add_ps(_mm_mul_ps(c0, splat(value, 0)), _mm_mul_ps(c1, splat(value, 1))),
+                              _mm_add_ps(_mm_mul_ps(c2, splat(value, 2)), c3));
+        }
+
+        template<bool POINT>
+        void transformSSE(const Matrix4& matrix, const Vector3* src, Vector3* dst, size_t count)
+        {
+            __m128 c3 = POINT ? matrix.col[3] : _mm_setzero_ps();
+
+            for (size_t i = 0; i < count; ++i)
+            {
+                storeVector3(dst[i], transformSSE(matrix.col[0], matrix.col[1], matrix.col[2], c3,
+                                                  loadVector3(src[i], i + 1 == count)));
+            }
+        }
+
+        void multiplyMatricesSSE(const Matrix4* matrices1, const Matrix4* matrices2, Matrix4* dst, size_t count)
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                const Matrix4& a = matrices1[i];
+                const Matrix4& b = matrices2[i];
+                __m128 product[4];
+
+                for (size_t column = 0; column < 4; ++column)
+                {
+                    __m128 c = b.col[column];
+                    product[column] = _mm_add_ps(_mm_add_ps(_mm_mul_ps(a.col[0], splat(c, 0)), _mm_mul_ps(a.col[1], splat(c, 1))),
+                                                 _mm_add_ps(_mm_mul_ps(a.col[2], splat(c, 2)), _mm_mul_ps(a.col[3], splat(c, 3))));
+                }
+
+                dst[i].col[0] = product[0];
+                dst[i].col[1] = product[1];
+                dst[i].col[2] = product[2];
+                dst[i].col[3] = product[3];
+            }
+        }
+
+        inline void transformBoxSSE(const Matrix4& matrix, const Box3& box, Box3& dst)
+        {
+            if (box.isEmpty())
+            {
+                dst.reset();
+                return;
+            }
+
+            const __m128 half = _mm_set1_ps(0.5f);
+            const __m128 signMask = _mm_set1_ps(-0.0f);
+
+            // both reads stay inside of the box: min.x min.y min.z max.x and min.z max.x max.y max.z
+            __m128 min = _mm_loadu_ps(&box.min.x);
+            __m128 max = _mm_loadu_ps(&box.min.z);
+            max = _mm_shuffle_ps(max, max, _MM_SHUFFLE(3, 3, 2, 1));
+
+            __m128 center = _mm_mul_ps(_mm_add_ps(min, max), half);
+            __m128 extent = _mm_mul_ps(_mm_sub_ps(max, min), half);
+
+            __m128 newCenter = transformSSE(matrix.col[0], matrix.col[1], matrix.col[2], matrix.col[3], center);
+            __m128 newExtent = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_andnot_ps(signMask, matrix.col[0]), splat(extent, 0)),
+                                                     _mm_mul_ps(_mm_andnot_ps(signMask, matrix.col[1]), splat(extent, 1))),
+                                          _mm_mul_ps(_mm_andnot_ps(signMask, matrix.col[2]), splat(extent, 2)));
+
+            storeVector3(dst.min, _mm_sub_ps(newCenter, newExtent));
+            storeVector3(dst.max, _mm_add_ps(newCenter, newExtent));
+        }
+
+        void transformBoxesSSE(const Matrix4* matrices, const Box3* boxes, Box3* dst, size_t count)
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                transformBoxSSE(matrices[i], boxes[i], dst[i]);
+            }
+        }
+
+        inline __m128 crossSSE(__m128 u, __m128 v)
+        {
+            return _mm_sub_ps(_mm_mul_ps(_mm_shuffle_ps(u, u, _MM_SHUFFLE(3, 0, 2, 1)), _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 1, 0, 2))),
+                              _mm_mul_ps(_mm_shuffle_ps(u, u, _MM_SHUFFLE(3, 1, 0, 2)), _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 0, 2, 1))));
+        }
+
+        inline bool invertAffineMatrixSSE(const Matrix4& matrix, Matrix4& dst)
+        {
+            __m128 translation = matrix.col[3];
+            __m128 row0 = crossSSE(matrix.col[1], matrix.col[2]);
+            __m128 row1 = crossSSE(matrix.col[2], matrix.col[0]);
+            __m128 row2 = crossSSE(matrix.col[0], matrix.col[1]);
+            __m128 row3 = _mm_setzero_ps();
+
+            __m128 dot = _mm_mul_ps(matrix.col[0], row0);
+            float det = _mm_cvtss_f32(_mm_add_ps(_mm_add_ps(dot, splat(dot, 1)), splat(dot, 2)));
+
+            if (fabsf(det) < TOLERANCE)
+            {
+                return false;
+            }
+
+            __m128 invDet = _mm_set1_ps(1.0f / det);
+            row0 = _mm_mul_ps(row0, invDet);
+            row1 = _mm_mul_ps(row1, invDet);
+            row2 = _mm_mul_ps(row2, invDet);
+
+            // the rows become the columns of the inverse
+            _MM_TRANSPOSE4_PS(row0, row1, row2, row3);
+
+            dst.col[0] = row0;
+            dst.col[1] = row1;
+            dst.col[2] = row2;
+            dst.col[3] = _mm_sub_ps(_mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f),
+                                    transformSSE(row0, row1, row2, _mm_setzero_ps(), translation));
+
+            return true;
+        }
+
+        bool invertAffineMatricesSSE(const Matrix4* matrices, Matrix4* dst, size_t count)
+        {
+            bool result = true;
+
+            for (size_t i = 0; i < count; ++i)
+            {
+                if (!invertAffineMatrixSSE(matrices[i], dst[i])) result = false;
+            }
+
+            return result;
+        }
+
+        const Kernels sseKernels = {
+            MathISA::SSE,
+            transformSSE<true>,
+            transformSSE<false>,
+            multiplyMatricesSSE,
+            transformBoxesSSE,
+            invertAffineMatricesSSE
+        };
+#endif
+
+#if OUZEL_SUPPORTS_AVX2
+        // AVX2, two vectors, matrices or boxes per register, one in each 128-bit lane
+
+        bool isAVX2Available()
+        {
+            unsigned int eax, ebx, ecx, edx;
+            if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) return false;
+
+            // FMA, OSXSAVE and AVX
+            if ((ecx & (1 << 12)) == 0 || (ecx & (1 << 27)) == 0 || (ecx & (1 << 28)) == 0) return false;
+
+            // the OS has to save the YMM registers
+            unsigned int xcr0Low, xcr0High;
+            __asm__ volatile("xgetbv" : "=a"(xcr0Low), "=d"(xcr0High) : "c"(0));
+            if ((xcr0Low & 0x06) != 0x06) return false;
+
+            if (__get_cpuid_max(0, nullptr) < 7) return false;
+            __cpuid_count(7, 0, eax, ebx, ecx, edx);
+
+            return (ebx & (1 << 5)) != 0;
+        }
+
+        OUZEL_TARGET_AVX2 inline __m256 loadPair(const float* low, const float* high)
+        {
+            return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(low)), _mm_loadu_ps(high), 1);
+        }
+
+        template<bool POINT>
+        OUZEL_TARGET_AVX2 void transformAVX2(const Matrix4& matrix, const Vector3* src, Vector3* dst, size_t count)
+        {
+            __m256 c0 = _mm256_broadcast_ps(&matrix.col[0]);
+            __m256 c1 = _mm256_broadcast_ps(&matrix.col[1]);
+            __m256 c2 = _mm256_broadcast_ps(&matrix.col[2]);
+            __m256 c3 = POINT ? _mm256_broadcast_ps(&matrix.col[3]) : _mm256_setzero_ps();
+
+            size_t i = 0;
+
+            // the second vector of a pair is read as four floats, so a pair can't end with the last vector
+            for (; i + 2 < count; i += 2)
+            {
+                __m256 value = loadPair(&src[i].x, &src[i + 1].x);
+                __m256 result = _mm256_fmadd_ps(c0, _mm256_permute_ps(value, 0x00),
+                                                _mm256_fmadd_ps(c1, _mm256_permute_ps(value, 0x55),
+                                                                _mm256_fmadd_ps(c2, _mm256_permute_ps(value, 0xAA), c3)));
+
+                storeVector3(dst[i], _mm256_castps256_ps128(result));
+                storeVector3(dst[i + 1], _mm256_extractf128_ps(result, 1));
+            }
+
+            for (; i < count; ++i)
+            {
+                storeVector3(dst[i], transformSSE(matrix.col[0], matrix.col[1], matrix.col[2], _mm256_castps256_ps128(c3),
+                                                  loadVector3(src[i], i + 1 == count)));
+            }
+        }
+
+        OUZEL_TARGET_AVX2 void multiplyMatricesAVX2(const Matrix4* matrices1, const Matrix4* matrices2, Matrix4* dst, size_t count)
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                __m256 a0 = _mm256_broadcast_ps(&matrices1[i].col[0]);
+                __m256 a1 = _mm256_broadcast_ps(&matrices1[i].col[1]);
+                __m256 a2 = _mm256_broadcast_ps(&matrices1[i].col[2]);
+                __m256 a3 = _mm256_broadcast_ps(&matrices1[i].col[3]);
+                __m256 b01 = _mm256_loadu_ps(matrices2[i].m);
+                __m256 b23 = _mm256_loadu_ps(matrices2[i].m + 8);
+
+                __m256 product01 = _mm256_fmadd_ps(a0, _mm256_permute_ps(b01, 0x00),
+                                                   _mm256_fmadd_ps(a1, _mm256_permute_ps(b01, 0x55),
+                                                                   _mm256_fmadd_ps(a2, _mm256_permute_ps(b01, 0xAA),
+                                                                                   _mm256_mul_ps(a3, _mm256_permute_ps(b01, 0xFF)))));
+                __m256 product23 = _mm256_fmadd_ps(a0, _mm256_permute_ps(b23, 0x00),
+                                                   _mm256_fmadd_ps(a1, _mm256_permute_ps(b23, 0x55),
+                                                                   _mm256_fmadd_ps(a2, _mm256_permute_ps(b23, 0xAA),
+                                                                                   _mm256_mul_ps(a3, _mm256_permute_ps(b23, 0xFF)))));
+
+                _mm256_storeu_ps(dst[i].m, product01);
+                _mm256_storeu_ps(dst[i].m + 8, product23);
+            }
+        }
+
+        OUZEL_TARGET_AVX2 void transformBoxesAVX2(const Matrix4* matrices, const Box3* boxes, Box3* dst, size_t count)
+        {
+            const __m256 half = _mm256_set1_ps(0.5f);
+            const __m256 signMask = _mm256_set1_ps(-0.0f);
+
+            size_t i = 0;
+
+            for (; i + 1 < count; i += 2)
+            {
+                if (boxes[i].isEmpty() || boxes[i + 1].isEmpty())
+                {
+                    transformBoxSSE(matrices[i], boxes[i], dst[i]);
+                    transformBoxSSE(matrices[i + 1], boxes[i + 1], dst[i + 1]);
+                    continue;
+                }
+
+                __m256 min = loadPair(&boxes[i].min.x, &boxes[i + 1].min.x);
+                __m256 max = loadPair(&boxes[i].min.z, &boxes[i + 1].min.z);
+                max = _mm256_permute_ps(max, _MM_SHUFFLE(3, 3, 2, 1));
+
+                __m256 center = _mm256_mul_ps(_mm256_add_ps(min, max), half);
+                __m256 extent = _mm256_mul_ps(_mm256_sub_ps(max, min), half);
+
+                __m256 c0 = loadPair(matrices[i].m, matrices[i + 1].m);
+                __m256 c1 = loadPair(matrices[i].m + 4, matrices[i + 1].m + 4);
+                __m256 c2 = loadPair(matrices[i].m + 8, matrices[i + 1].m + 8);
+                __m256 c3 = loadPair(matrices[i].m + 12, matrices[i + 1].m + 12);
+
+                __m256 newCenter = _mm256_fmadd_ps(c0, _mm256_permute_ps(center, 0x00),
+                                                   _mm256_fmadd_ps(c1, _mm256_permute_ps(center, 0x55),
+                                                                   _mm256_fmadd_ps(c2, _mm256_permute_ps(center, 0xAA), c3)));
+                __m256 newExtent = _mm256_fmadd_ps(_mm256_andnot_ps(signMask, c0), _mm256_permute_ps(extent, 0x00),
+                                                   _mm256_fmadd_ps(_mm256_andnot_ps(signMask, c1), _mm256_permute_ps(extent, 0x55),
+                                                                   _mm256_mul_ps(_mm256_andnot_ps(signMask, c2), _mm256_permute_ps(extent, 0xAA))));
+
+                __m256 newMin = _mm256_sub_ps(newCenter, newExtent);
+                __m256 newMax = _mm256_add_ps(newCenter, newExtent);
+
+                storeVector3(dst[i].min, _mm256_castps256_ps128(newMin));
+                storeVector3(dst[i].max, _mm256_castps256_ps128(newMax));
+                storeVector3(dst[i + 1].min, _mm256_extractf128_ps(newMin, 1));
+                storeVector3(dst[i + 1].max, _mm256_extractf128_ps(newMax, 1));
+            }
+
+            for (; i < count; ++i)
+            {
+                transformBoxSSE(matrices[i], boxes[i], dst[i]);
+            }
+        }
+
+        OUZEL_TARGET_AVX2 inline __m256 crossAVX2(__m256 u, __m256 v)
+        {
+            return _mm256_fmsub_ps(_mm256_permute_ps(u, _MM_SHUFFLE(3, 0, 2, 1)), _mm256_permute_ps(v, _MM_SHUFFLE(3, 1, 0, 2)),
+                                   _mm256_mul_ps(_mm256_permute_ps(u, _MM_SHUFFLE(3, 1, 0, 2)), _mm256_permute_ps(v, _MM_SHUFFLE(3, 0, 2, 1))));
+        }
+
+        OUZEL_TARGET_AVX2 bool invertAffineMatricesAVX2(const Matrix4* matrices, Matrix4* dst, size_t count)
+        {
+            bool result = true;
+            size_t i = 0;
+
+            for (; i + 1 < count; i += 2)
+            {
+                __m256 c0 = loadPair(matrices[i].m, matrices[i + 1].m);
+                __m256 c1 = loadPair(matrices[i].m + 4, matrices[i + 1].m + 4);
+                __m256 c2 = loadPair(matrices[i].m + 8, matrices[i + 1].m + 8);
+                __m256 translation = loadPair(matrices[i].m + 12, matrices[i + 1].m + 12);
+
+                __m256 row0 = crossAVX2(c1, c2);
+                __m256 row1 = crossAVX2(c2, c0);
+                __m256 row2 = crossAVX2(c0, c1);
+
+                __m256 dot = _mm256_mul_ps(c0, row0);
+                __m256 det = _mm256_add_ps(_mm256_add_ps(dot, _mm256_permute_ps(dot, 0x55)), _mm256_permute_ps(dot, 0xAA));
+
+                if (fabsf(_mm_cvtss_f32(_mm256_castps256_ps128(det))) < TOLERANCE ||
+                    fabsf(_mm_cvtss_f32(_mm256_extractf128_ps(det, 1))) < TOLERANCE)
+                {
+                    if (!invertAffineMatrixSSE(matrices[i], dst[i])) result = false;
+                    if (!invertAffineMatrixSSE(matrices[i + 1], dst[i + 1])) result = false;
+                    continue;
+                }
+
+                __m256 invDet = _mm256_div_ps(_mm256_set1_ps(1.0f), _mm256_permute_ps(det, 0x00));
+                row0 = _mm256_mul_ps(row0, invDet);
+                row1 = _mm256_mul_ps(row1, invDet);
+                row2 = _mm256_mul_ps(row2, invDet);
+
+                // transpose the rows to columns in each lane, the fourth row is zero
+                __m256 zero = _mm256_setzero_ps();
+                __m256 t0 = _mm256_unpacklo_ps(row0, row1);
+                __m256 t1 = _mm256_unpackhi_ps(row0, row1);
+                __m256 t2 = _mm256_unpacklo_ps(row2, zero);
+                __m256 t3 = _mm256_unpackhi_ps(row2, zero);
+                __m256 column0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+                __m256 column1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+                __m256 column2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+
+                __m256 column3 = _mm256_sub_ps(_mm256_setr_ps(0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f),
+                                               _mm256_fmadd_ps(column0, _mm256_permute_ps(translation, 0x00),
+                                                               _mm256_fmadd_ps(column1, _mm256_permute_ps(translation, 0x55),
+                                                                               _mm256_mul_ps(column2, _mm256_permute_ps(translation, 0xAA)))));
+
+                dst[i].col[0] = _mm256_castps256_ps128(column0);
+                dst[i].col[1] = _mm256_castps256_ps128(column1);
+                dst[i].col[2] = _mm256_castps256_ps128(column2);
+                dst[i].col[3] = _mm256_castps256_ps128(column3);
+                dst[i + 1].col[0] = _mm256_extractf128_ps(column0, 1);
+                dst[i + 1].col[1] = _mm256_extractf128_ps(column1, 1);
+                dst[i + 1].col[2] = _mm256_extractf128_ps(column2, 1);
+                dst[i + 1].col[3] = _mm256_extractf128_ps(column3, 1);
+            }
+
+            for (; i < count; ++i)
+            {
+                if (!invertAffineMatrixSSE(matrices[i], dst[i])) result = false;
+            }
+
+            return result;
+        }
+
+        const Kernels avx2Kernels = {
+            MathISA::AVX2,
+            transformAVX2<true>,
+            transformAVX2<false>,
+            multiplyMatricesAVX2,
+            transformBoxesAVX2,
+            invertAffineMatricesAVX2
+        };
+#endif
+
+#if OUZEL_SUPPORTS_NEON || OUZEL_SUPPORTS_NEON64
+        // NEON
+
+        inline void storeVector3(Vector3& vector, float32x4_t value)
+        {
+            vst1_f32(&vector.x, vget_low_f32(value));
+            vector.z = vgetq_lane_f32(value, 2);
+        }
+
+        template<bool POINT>
+        void transformNEON(const Matrix4& matrix, const Vector3* src, Vector3* dst, size_t count)
+        {
+            float32x4_t c0 = vld1q_f32(matrix.m);
+            float32x4_t c1 = vld1q_f32(matrix.m + 4);
+            float32x4_t c2 = vld1q_f32(matrix.m + 8);
+            float32x4_t c3 = POINT ? vld1q_f32(matrix.m + 12) : vdupq_n_f32(0.0f);
+
+            for (size_t i = 0; i < count; ++i)
+            {
+                float32x4_t result = vmlaq_n_f32(vmlaq_n_f32(vmlaq_n_f32(c3, c0, src[i].x), c1, src[i].y), c2, src[i].z);
+                storeVector3(dst[i], result);
+            }
+        }
+
+        void multiplyMatricesNEON(const Matrix4* matrices1, const Matrix4* matrices2, Matrix4* dst, size_t count)
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                float32x4_t a0 = vld1q_f32(matrices1[i].m);
+                float32x4_t a1 = vld1q_f32(matrices1[i].m + 4);
+                float32x4_t a2 = vld1q_f32(matrices1[i].m + 8);
+                float32x4_t a3 = vld1q_f32(matrices1[i].m + 12);
+                float32x4_t product[4];
+
+                for (size_t column = 0; column < 4; ++column)
+                {
+                    float32x4_t b = vld1q_f32(matrices2[i].m + column * 4);
+                    product[column] = vmlaq_n_f32(vmlaq_n_f32(vmlaq_n_f32(vmulq_n_f32(a0, vgetq_lane_f32(b, 0)),
+                                                                          a1, vgetq_lane_f32(b, 1)),
+                                                              a2, vgetq_lane_f32(b, 2)),
+                                                  a3, vgetq_lane_f32(b, 3));
+                }
+
+                vst1q_f32(dst[i].m, product[0]);
+                vst1q_f32(dst[i].m + 4, product[1]);
+                vst1q_f32(dst[i].m + 8, product[2]);
+                vst1q_f32(dst[i].m + 12, product[3]);
+            }
+        }
+
+        void transformBoxesNEON(const Matrix4* matrices, const Box3* boxes, Box3* dst, size_t count)
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                const Box3& box = boxes[i];
+
+                if (box.isEmpty())
+                {
+                    dst[i].reset();
+                    continue;
+                }
+
+                // min.x min.y min.z max.x and max.x max.y max.z min.z
+                float32x4_t min = vld1q_f32(&box.min.x);
+                float32x4_t max = vld1q_f32(&box.min.z);
+                max = vextq_f32(max, max, 1);
+
+                float32x4_t center = vmulq_n_f32(vaddq_f32(min, max), 0.5f);
+                float32x4_t extent = vmulq_n_f32(vsubq_f32(max, min), 0.5f);
+
+                const float* m = matrices[i].m;
+                float32x4_t c0 = vld1q_f32(m);
+                float32x4_t c1 = vld1q_f32(m + 4);
+                float32x4_t c2 = vld1q_f32(m + 8);
+                float32x4_t c3 = vld1q_f32(m + 12);
+
+                float32x4_t newCenter = vmlaq_n_f32(vmlaq_n_f32(vmlaq_n_f32(c3, c0, vgetq_lane_f32(center, 0)),
+                                                                c1, vgetq_lane_f32(center, 1)),
+                                                    c2, vgetq_lane_f32(center, 2));
+                float32x4_t newExtent = vmlaq_n_f32(vmlaq_n_f32(vmulq_n_f32(vabsq_f32(c0), vgetq_lane_f32(extent, 0)),
+                                                                vabsq_f32(c1), vgetq_lane_f32(extent, 1)),
+                                                    vabsq_f32(c2), vgetq_lane_f32(extent, 2));
+
+                storeVector3(dst[i].min, vsubq_f32(newCenter, newExtent));
+                storeVector3(dst[i].max, vaddq_f32(newCenter, newExtent));
+            }
+        }
+
+        // the inverse needs shuffles that NEON doesn't have, so the scalar version is used
+        const Kernels neonKernels = {
+            MathISA::NEON,
+            transformNEON<true>,
+            transformNEON<false>,
+            multiplyMatricesNEON,
+            transformBoxesNEON,
+            invertAffineMatricesScalar
+        };
+#endif
+
+        const Kernels* getKernels(MathISA isa)
+        {
+            switch (isa)
+            {
+                case MathISA::SCALAR:
+                    return &scalarKernels;
+#if OUZEL_SUPPORTS_SSE
+                case MathISA::SSE:
+                    return &sseKernels;
+#endif
+#if OUZEL_SUPPORTS_AVX2
+                case MathISA::AVX2:
+                    return isAVX2Available() ? &avx2Kernels : nullptr;
+#endif
+#if OUZEL_SUPPORTS_NEON || OUZEL_SUPPORTS_NEON64
+                case MathISA::NEON:
+    #if OUZEL_SUPPORTS_NEON_CHECK
+                    return anrdoidNEONChecker.isNEONAvailable() ? &neonKernels : nullptr;
+    #else
+                    return &neonKernels;
+    #endif
+#endif
+                default:
+                    return nullptr;
+            }
+        }
+
+        const Kernels*& currentKernels()
+        {
+            static const Kernels* kernels = [] {
+                for (MathISA isa : {MathISA::AVX2, MathISA::SSE, MathISA::NEON})
+                {
+                    if (const Kernels* result = getKernels(isa)) return result;
+                }
+
+                return &scalarKernels;
+            }();
+
+            return kernels;
+        }
+    }
+
+    MathISA getMathISA()
+    {
+        return currentKernels()->isa;
+    }
+
+    bool isMathISASupported(MathISA isa)
+    {
+        return getKernels(isa) != nullptr;
+    }
+
+    bool setMathISA(MathISA isa)
+    {
+        const Kernels* kernels = getKernels(isa);
+        if (!kernels) return false;
+
+        currentKernels() = kernels;
+        return true;
+    }
+
+    void transformPoints(const Matrix4& matrix, const Vector3* points, Vector3* dst, size_t count)
+    {
+        currentKernels()->transformPoints(matrix, points, dst, count);
+    }
+
+    void transformVectors(const Matrix4& matrix, const Vector3* vectors, Vector3* dst, size_t count)
+    {
+        currentKernels()->transformVectors(matrix, vectors, dst, count);
+    }
+
+    void multiplyMatrices(const Matrix4* matrices1, const Matrix4* matrices2, Matrix4* dst, size_t count)
+    {
+        currentKernels()->multiplyMatrices(matrices1, matrices2, dst, count);
+    }
+
+    void transformBoxes(const Matrix4* matrices, const Box3* boxes, Box3* dst, size_t count)
+    {
+        currentKernels()->transformBoxes(matrices, boxes, dst, count);
+    }
+
+    bool invertAffineMatrices(const Matrix4* matrices, Matrix4* dst, size_t count)
+    {
+        return currentKernels()->invertAffineMatrices(matrices, dst, count);
+    }
+}
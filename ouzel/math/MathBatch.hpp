@@ -0,0 +1,36 @@
+// Copyright (C) 2018 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#pragma once
+
+#include <cstddef>
+#include "math/Box3.hpp"
+#include "math/Matrix4.hpp"
+#include "math/Vector3.hpp"
+
+namespace ouzel
+{
+    // instruction sets of the batch functions, the best supported one is selected at startup
+    enum class MathISA
+    {
+        SCALAR,
+        SSE,
+        AVX2,
+        NEON
+    };
+
+    MathISA getMathISA();
+    bool isMathISASupported(MathISA isa);
+    // not thread safe, meant for benchmarks and for comparing the results with the scalar versions
+    bool setMathISA(MathISA isa);
+
+    // dst can be the same array as the input in all of the functions
+    void transformPoints(const Matrix4& matrix, const Vector3* points, Vector3* dst, size_t count);
+    void transformVectors(const Matrix4& matrix, const Vector3* vectors, Vector3* dst, size_t count);
+    void multiplyMatrices(const Matrix4* matrices1, const Matrix4* matrices2, Matrix4* dst, size_t count);
+    // axis-aligned bounding boxes of the boxes transformed by the matrix with the same index, empty boxes stay empty
+    void transformBoxes(const Matrix4* matrices, const Box3* boxes, Box3* dst, size_t count);
+    // the last row of the matrices has to be (0, 0, 0, 1), returns false if any of the matrices could not be inverted
+    // (those are left unchanged in dst)
+    bool invertAffineMatrices(const Matrix4* matrices, Matrix4* dst, size_t count);
+}
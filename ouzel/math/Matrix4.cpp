@@ -949,6 +949,152 @@ namespace ouzel
 #endif
     }
 
+    void Matrix4::multiplyAffine(const Matrix4& m1, const Matrix4& m2, Matrix4& dst)
+    {
+        // the w component of the first three columns of m2 is 0 and of the last one is 1
+#if OUZEL_SUPPORTS_NEON
+    #if OUZEL_SUPPORTS_NEON_CHECK
+        if (anrdoidNEONChecker.isNEONAvailable())
+        {
+    #endif
+        asm volatile
+        (
+            "vld1.32 {d16 - d19}, [%1]! \n\t" // M1[m0-m7]
+            "vld1.32 {d20 - d23}, [%1]  \n\t" // M1[m8-m15]
+            "vld1.32 {d0 - d3}, [%2]!   \n\t" // M2[m0-m7]
+            "vld1.32 {d4 - d7}, [%2]    \n\t" // M2[m8-m15]
+
+            "vmul.f32 q12, q8, d0[0]    \n\t" // DST->M[m0-m3] = M1[m0-m3] * M2[m0]
+            "vmul.f32 q13, q8, d2[0]    \n\t" // DST->M[m4-m7] = M1[m0-m3] * M2[m4]
+            "vmul.f32 q14, q8, d4[0]    \n\t" // DST->M[m8-m11] = M1[m0-m3] * M2[m8]
+            "vmov q15, q11              \n\t" // DST->M[m12-m15] = M1[m12-m15]
+
+            "vmla.f32 q12, q9, d0[1]    \n\t" // DST->M[m0-m3] += M1[m4-m7] * M2[m1]
+            "vmla.f32 q13, q9, d2[1]    \n\t" // DST->M[m4-m7] += M1[m4-m7] * M2[m5]
+            "vmla.f32 q14, q9, d4[1]    \n\t" // DST->M[m8-m11] += M1[m4-m7] * M2[m9]
+            "vmla.f32 q15, q8, d6[0]    \n\t" // DST->M[m12-m15] += M1[m0-m3] * M2[m12]
+
+            "vmla.f32 q12, q10, d1[0]   \n\t" // DST->M[m0-m3] += M1[m8-m11] * M2[m2]
+            "vmla.f32 q13, q10, d3[0]   \n\t" // DST->M[m4-m7] += M1[m8-m11] * M2[m6]
+            "vmla.f32 q14, q10, d5[0]   \n\t" // DST->M[m8-m11] += M1[m8-m11] * M2[m10]
+            "vmla.f32 q15, q9, d6[1]    \n\t" // DST->M[m12-m15] += M1[m4-m7] * M2[m13]
+
+            "vmla.f32 q15, q10, d7[0]   \n\t" // DST->M[m12-m15] += M1[m8-m11] * M2[m14]
+
+            "vst1.32 {d24 - d27}, [%0]! \n\t" // DST->M[m0-m7]
+            "vst1.32 {d28 - d31}, [%0]  \n\t" // DST->M[m8-m15]
+
+            : // output
+            : "r"(dst.m), "r"(m1.m), "r"(m2.m) // input - note *value* of pointer doesn't change
+            : "memory", "q0", "q1", "q2", "q3", "q8", "q9", "q10", "q11", "q12", "q13", "q14", "q15"
+        );
+    #if OUZEL_SUPPORTS_NEON_CHECK
+        }
+    #endif
+#elif OUZEL_SUPPORTS_NEON64
+        asm volatile
+        (
+            "ld1 {v8.4s, v9.4s, v10.4s, v11.4s}, [%1]   \n\t" // M1[m0-m15]
+            "ld4 {v0.4s, v1.4s, v2.4s, v3.4s}, [%2]     \n\t" // M2[m0-m15]
+
+            "fmul v12.4s, v8.4s, v0.s[0]                \n\t" // DST->M[m0-m3] = M1[m0-m3] * M2[m0]
+            "fmul v13.4s, v8.4s, v0.s[1]                \n\t" // DST->M[m4-m7] = M1[m0-m3] * M2[m4]
+            "fmul v14.4s, v8.4s, v0.s[2]                \n\t" // DST->M[m8-m11] = M1[m0-m3] * M2[m8]
+            "mov v15.16b, v11.16b                       \n\t" // DST->M[m12-m15] = M1[m12-m15]
+
+            "fmla v12.4s, v9.4s, v1.s[0]                \n\t" // DST->M[m0-m3] += M1[m4-m7] * M2[m1]
+            "fmla v13.4s, v9.4s, v1.s[1]                \n\t" // DST->M[m4-m7] += M1[m4-m7] * M2[m5]
+            "fmla v14.4s, v9.4s, v1.s[2]                \n\t" // DST->M[m8-m11] += M1[m4-m7] * M2[m9]
+            "fmla v15.4s, v8.4s, v0.s[3]                \n\t" // DST->M[m12-m15] += M1[m0-m3] * M2[m12]
+
+            "fmla v12.4s, v10.4s, v2.s[0]               \n\t" // DST->M[m0-m3] += M1[m8-m11] * M2[m2]
+            "fmla v13.4s, v10.4s, v2.s[1]               \n\t" // DST->M[m4-m7] += M1[m8-m11] * M2[m6]
+            "fmla v14.4s, v10.4s, v2.s[2]               \n\t" // DST->M[m8-m11] += M1[m8-m11] * M2[m10]
+            "fmla v15.4s, v9.4s, v1.s[3]                \n\t" // DST->M[m12-m15] += M1[m4-m7] * M2[m13]
+
+            "fmla v15.4s, v10.4s, v2.s[3]               \n\t" // DST->M[m12-m15] += M1[m8-m11] * M2[m14]
+
+            "st1 {v12.4s, v13.4s, v14.4s, v15.4s}, [%0] \n\t" // DST->M[m0-m15]
+
+            : // output
+            : "r"(dst.m), "r"(m1.m), "r"(m2.m) // input - note *value* of pointer doesn't change
+            : "memory", "v0", "v1", "v2", "v3", "v8", "v9", "v10", "v11", "v12", "v13", "v14", "v15"
+        );
+#elif OUZEL_SUPPORTS_SSE
+        __m128 dst0, dst1, dst2, dst3;
+        {
+            __m128 e0 = _mm_shuffle_ps(m2.col[0], m2.col[0], _MM_SHUFFLE(0, 0, 0, 0));
+            __m128 e1 = _mm_shuffle_ps(m2.col[0], m2.col[0], _MM_SHUFFLE(1, 1, 1, 1));
+            __m128 e2 = _mm_shuffle_ps(m2.col[0], m2.col[0], _MM_SHUFFLE(2, 2, 2, 2));
+
+            dst0 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m1.col[0], e0), _mm_mul_ps(m1.col[1], e1)), _mm_mul_ps(m1.col[2], e2));
+        }
+
+        {
+            __m128 e0 = _mm_shuffle_ps(m2.col[1], m2.col[1], _MM_SHUFFLE(0, 0, 0, 0));
+            __m128 e1 = _mm_shuffle_ps(m2.col[1], m2.col[1], _MM_SHUFFLE(1, 1, 1, 1));
+            __m128 e2 = _mm_shuffle_ps(m2.col[1], m2.col[1], _MM_SHUFFLE(2, 2, 2, 2));
+
+            dst1 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m1.col[0], e0), _mm_mul_ps(m1.col[1], e1)), _mm_mul_ps(m1.col[2], e2));
+        }
+
+        {
+            __m128 e0 = _mm_shuffle_ps(m2.col[2], m2.col[2], _MM_SHUFFLE(0, 0, 0, 0));
+            __m128 e1 = _mm_shuffle_ps(m2.col[2], m2.col[2], _MM_SHUFFLE(1, 1, 1, 1));
+            __m128 e2 = _mm_shuffle_ps(m2.col[2], m2.col[2], _MM_SHUFFLE(2, 2, 2, 2));
+
+            dst2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m1.col[0], e0), _mm_mul_ps(m1.col[1], e1)), _mm_mul_ps(m1.col[2], e2));
+        }
+
+        {
+            __m128 e0 = _mm_shuffle_ps(m2.col[3], m2.col[3], _MM_SHUFFLE(0, 0, 0, 0));
+            __m128 e1 = _mm_shuffle_ps(m2.col[3], m2.col[3], _MM_SHUFFLE(1, 1, 1, 1));
+            __m128 e2 = _mm_shuffle_ps(m2.col[3], m2.col[3], _MM_SHUFFLE(2, 2, 2, 2));
+
+            dst3 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m1.col[0], e0), _mm_mul_ps(m1.col[1], e1)),
+                              _mm_add_ps(_mm_mul_ps(m1.col[2], e2), m1.col[3]));
+        }
+        dst.col[0] = dst0;
+        dst.col[1] = dst1;
+        dst.col[2] = dst2;
+        dst.col[3] = dst3;
+#endif
+
+#if (!OUZEL_SUPPORTS_NEON && !OUZEL_SUPPORTS_NEON64 && !OUZEL_SUPPORTS_SSE) || OUZEL_SUPPORTS_NEON_CHECK
+    #if OUZEL_SUPPORTS_NEON_CHECK
+        else
+        {
+    #endif
+        // Support the case where m1 or m2 is the same array as dst
+        float product[16];
+
+        product[0]  = m1.m[0] * m2.m[0]  + m1.m[4] * m2.m[1]  + m1.m[8]  * m2.m[2];
+        product[1]  = m1.m[1] * m2.m[0]  + m1.m[5] * m2.m[1]  + m1.m[9]  * m2.m[2];
+        product[2]  = m1.m[2] * m2.m[0]  + m1.m[6] * m2.m[1]  + m1.m[10] * m2.m[2];
+        product[3]  = 0.0f;
+
+        product[4]  = m1.m[0] * m2.m[4]  + m1.m[4] * m2.m[5]  + m1.m[8]  * m2.m[6];
+        product[5]  = m1.m[1] * m2.m[4]  + m1.m[5] * m2.m[5]  + m1.m[9]  * m2.m[6];
+        product[6]  = m1.m[2] * m2.m[4]  + m1.m[6] * m2.m[5]  + m1.m[10] * m2.m[6];
+        product[7]  = 0.0f;
+
+        product[8]  = m1.m[0] * m2.m[8]  + m1.m[4] * m2.m[9]  + m1.m[8]  * m2.m[10];
+        product[9]  = m1.m[1] * m2.m[8]  + m1.m[5] * m2.m[9]  + m1.m[9]  * m2.m[10];
+        product[10] = m1.m[2] * m2.m[8]  + m1.m[6] * m2.m[9]  + m1.m[10] * m2.m[10];
+        product[11] = 0.0f;
+
+        product[12] = m1.m[0] * m2.m[12] + m1.m[4] * m2.m[13] + m1.m[8]  * m2.m[14] + m1.m[12];
+        product[13] = m1.m[1] * m2.m[12] + m1.m[5] * m2.m[13] + m1.m[9]  * m2.m[14] + m1.m[13];
+        product[14] = m1.m[2] * m2.m[12] + m1.m[6] * m2.m[13] + m1.m[10] * m2.m[14] + m1.m[14];
+        product[15] = 1.0f;
+
+        std::copy(std::begin(product), std::end(product), dst.m);
+    #if OUZEL_SUPPORTS_NEON_CHECK
+        }
+    #endif
+#endif
+    }
+
     void Matrix4::negate()
     {
         negate(*this);
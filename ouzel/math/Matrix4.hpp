@@ -122,11 +122,19 @@ namespace ouzel
 
         bool isIdentity() const;
 
+        // the last row is (0, 0, 0, 1)
+        bool isAffine() const
+        {
+            return m[3] == 0.0f && m[7] == 0.0f && m[11] == 0.0f && m[15] == 1.0f;
+        }
+
         void multiply(float scalar);
         void multiply(float scalar, Matrix4& dst) const;
         static void multiply(const Matrix4& m, float scalar, Matrix4& dst);
         void multiply(const Matrix4& matrix);
         static void multiply(const Matrix4& m1, const Matrix4& m2, Matrix4& dst);
+        // faster version of multiply for two affine matrices
+        static void multiplyAffine(const Matrix4& m1, const Matrix4& m2, Matrix4& dst);
 
         void negate();
         void negate(Matrix4& dst) const;
@@ -0,0 +1,127 @@
+// Copyright (C) 2018 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace ouzel
+{
+    namespace network
+    {
+        // appends values of arbitrary bit width, least significant bit first
+        class BitWriter
+        {
+        public:
+            explicit BitWriter(std::vector<uint8_t>& initBuffer):
+                buffer(initBuffer)
+            {
+            }
+
+            ~BitWriter()
+            {
+                flush();
+            }
+
+            void write(uint32_t value, uint32_t bits)
+            {
+                if (bits < 32) value &= (1U << bits) - 1;
+
+                scratch |= static_cast<uint64_t>(value) << scratchBits;
+                scratchBits += bits;
+
+                while (scratchBits >= 8)
+                {
+                    buffer.push_back(static_cast<uint8_t>(scratch));
+                    scratch >>= 8;
+                    scratchBits -= 8;
+                }
+            }
+
+            void writeBool(bool value)
+            {
+                write(value ? 1 : 0, 1);
+            }
+
+            // small magnitudes take fewer bits: 6-bit length followed by the zigzag-encoded value
+            void writeVariable(int32_t value)
+            {
+                uint32_t zigzag = (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31);
+                uint32_t bits = 0;
+                while (bits < 32 && (zigzag >> bits) != 0) ++bits;
+
+                write(bits, 6);
+                if (bits) write(zigzag, bits);
+            }
+
+            void flush()
+            {
+                if (scratchBits > 0)
+                {
+                    buffer.push_back(static_cast<uint8_t>(scratch));
+                    scratch = 0;
+                    scratchBits = 0;
+                }
+            }
+
+        private:
+            std::vector<uint8_t>& buffer;
+            uint64_t scratch = 0;
+            uint32_t scratchBits = 0;
+        };
+
+        class BitReader
+        {
+        public:
+            BitReader(const uint8_t* initData, size_t initSize):
+                data(initData), size(initSize)
+            {
+            }
+
+            // returns false if the data ends before the value
+            bool read(uint32_t& value, uint32_t bits)
+            {
+                while (scratchBits < bits)
+                {
+                    if (offset >= size) return false;
+
+                    scratch |= static_cast<uint64_t>(data[offset++]) << scratchBits;
+                    scratchBits += 8;
+                }
+
+                value = (bits < 32) ? static_cast<uint32_t>(scratch & ((1ULL << bits) - 1)) : static_cast<uint32_t>(scratch);
+                scratch >>= bits;
+                scratchBits -= bits;
+
+                return true;
+            }
+
+            bool readBool(bool& value)
+            {
+                uint32_t bit;
+                if (!read(bit, 1)) return false;
+                value = (bit != 0);
+                return true;
+            }
+
+            bool readVariable(int32_t& value)
+            {
+                uint32_t bits;
+                uint32_t zigzag = 0;
+                if (!read(bits, 6) || bits > 32) return false;
+                if (bits && !read(zigzag, bits)) return false;
+
+                value = static_cast<int32_t>((zigzag >> 1) ^ (~(zigzag & 1) + 1));
+                return true;
+            }
+
+        private:
+            const uint8_t* data;
+            size_t size;
+            size_t offset = 0;
+            uint64_t scratch = 0;
+            uint32_t scratchBits = 0;
+        };
+    } // namespace network
+} // namespace ouzel
@@ -1,14 +1,87 @@
 // Copyright (C) 2018 Elviss Strazdins
 // This file is part of the Ouzel engine.
 
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <winsock2.h>
+#else
+#include <unistd.h>
+#endif
 #include "Client.hpp"
+#include "utils/Log.hpp"
 
 namespace ouzel
 {
     namespace network
     {
+        Client::Client(Network* initNetwork, Socket initSocket, uint32_t initId, uint32_t initAddress, uint16_t initPort):
+            network(initNetwork),
+            socket(initSocket),
+            id(initId),
+            address(initAddress),
+            port(initPort),
+            connected(false),
+            sendQueued(false),
+            closeRequested(false),
+            receiveBuffer(RECEIVE_BUFFER_SIZE)
+        {
+        }
+
+        Client::~Client()
+        {
+            if (socket != NULL_SOCKET)
+            {
+#ifdef _WIN32
+                closesocket(socket);
+#else
+                close(socket);
+#endif
+            }
+        }
+
+        bool Client::send(const void* data, uint32_t size)
+        {
+            if (!connected || closeRequested)
+            {
+                return false;
+            }
+
+            if (size > MAX_MESSAGE_SIZE)
+            {
+                Log(Log::Level::ERR) << "Message too big";
+                return false;
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(sendMutex);
+
+                // little-endian length prefix
+                pendingData.push_back(static_cast<uint8_t>(size));
+                pendingData.push_back(static_cast<uint8_t>(size >> 8));
+                pendingData.push_back(static_cast<uint8_t>(size >> 16));
+                pendingData.push_back(static_cast<uint8_t>(size >> 24));
+                pendingData.insert(pendingData.end(), static_cast<const uint8_t*>(data), static_cast<const uint8_t*>(data) + size);
+            }
+
+            sendQueued = true;
+            network->sendPending = true;
+
+            return true;
+        }
+
         bool Client::disconnect()
         {
+            if (closeRequested)
+            {
+                return false;
+            }
+
+            closeRequested = true;
+            sendQueued = true;
+            network->sendPending = true;
+
             return true;
         }
     } // namespace network
@@ -3,16 +3,65 @@
 
 #pragma once
 
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+#include "utils/Noncopyable.hpp"
+#include "network/Network.hpp"
+
 namespace ouzel
 {
     namespace network
     {
-        class Client
+        class Client: public Noncopyable
         {
+            friend Network;
         public:
-            ~Client() {}
+            // size of the preallocated receive ring buffer, messages have to fit in it with their length prefix
+            static const uint32_t RECEIVE_BUFFER_SIZE = 65536;
+            static const uint32_t MAX_MESSAGE_SIZE = RECEIVE_BUFFER_SIZE - sizeof(uint32_t);
+
+            ~Client();
+
+            uint32_t getId() const { return id; }
+            uint32_t getAddress() const { return address; }
+            uint16_t getPort() const { return port; }
+            bool isConnected() const { return connected; }
 
+            // queues a length-prefixed message, all the messages queued during an update are sent together
+            bool send(const void* data, uint32_t size);
+            bool send(const std::vector<uint8_t>& data) { return send(data.data(), static_cast<uint32_t>(data.size())); }
+
+            // closes the connection after the queued messages are sent
             bool disconnect();
+
+        protected:
+            Client(Network* initNetwork, Socket initSocket, uint32_t initId, uint32_t initAddress, uint16_t initPort);
+
+            Network* network;
+            Socket socket;
+            uint32_t id;
+            uint32_t address;
+            uint16_t port;
+
+            std::atomic<bool> connected;
+            std::atomic<bool> sendQueued;
+            std::atomic<bool> closeRequested;
+
+            // filled by the update thread, taken over by the network thread
+            std::mutex sendMutex;
+            std::vector<uint8_t> pendingData;
+
+            // network thread only
+            std::vector<uint8_t> sendBuffer;
+            uint32_t sendOffset = 0;
+            std::vector<uint8_t> receiveBuffer;
+            uint32_t readPosition = 0;
+            uint32_t writePosition = 0;
+            bool connecting = false;
+            bool readPaused = false;
+            bool writeInterest = false;
         };
     } // namespace network
 } // namespace ouzel
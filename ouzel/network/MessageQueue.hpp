@@ -0,0 +1,82 @@
+// Copyright (C) 2018 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+namespace ouzel
+{
+    namespace network
+    {
+        class Client;
+
+        // bounded lock-free queue with a single producer (the network thread) and a single consumer (the update thread),
+        // the slots are reused, so the message data buffers are allocated only until they reach their working size
+        class MessageQueue
+        {
+        public:
+            struct Message
+            {
+                enum class Type
+                {
+                    CONNECT,
+                    DISCONNECT,
+                    DATA
+                };
+
+                Type type = Type::DATA;
+                Client* client = nullptr;
+                std::vector<uint8_t> data;
+            };
+
+            explicit MessageQueue(uint32_t capacity):
+                head(0), tail(0)
+            {
+                uint32_t size = 1;
+                while (size < capacity) size <<= 1;
+
+                slots.resize(size);
+                mask = size - 1;
+            }
+
+            // producer, returns nullptr if the queue is full
+            Message* beginPush()
+            {
+                uint32_t currentTail = tail.load(std::memory_order_relaxed);
+                if (currentTail - head.load(std::memory_order_acquire) > mask) return nullptr;
+
+                return &slots[currentTail & mask];
+            }
+
+            void endPush()
+            {
+                tail.store(tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+            }
+
+            // consumer, returns nullptr if the queue is empty
+            Message* front()
+            {
+                uint32_t currentHead = head.load(std::memory_order_relaxed);
+                if (currentHead == tail.load(std::memory_order_acquire)) return nullptr;
+
+                return &slots[currentHead & mask];
+            }
+
+            void pop()
+            {
+                head.store(head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+            }
+
+        private:
+            std::vector<Message> slots;
+            uint32_t mask = 0;
+
+            // kept on separate cache lines, so that the threads don't invalidate each other's writes
+            alignas(64) std::atomic<uint32_t> head;
+            alignas(64) std::atomic<uint32_t> tail;
+        };
+    } // namespace network
+} // namespace ouzel
@@ -1,6 +1,10 @@
 // Copyright (C) 2018 Elviss Strazdins
 // This file is part of the Ouzel engine.
 
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <map>
 #ifdef _WIN32
 #ifndef NOMINMAX
 #define NOMINMAX
@@ -10,37 +14,322 @@
 #else
 #include <sys/socket.h>
 #include <netinet/in.h>
+#include <netinet/tcp.h>
 #include <poll.h>
 #include <netdb.h>
+#include <fcntl.h>
 #include <unistd.h>
 #endif
+#if defined(__linux__)
+#include <sys/epoll.h>
+#elif defined(__APPLE__) || defined(__FreeBSD__)
+#include <sys/types.h>
+#include <sys/event.h>
+#include <sys/time.h>
+#endif
 #include "Network.hpp"
+#include "Client.hpp"
+#include "core/Engine.hpp"
 #include "utils/Log.hpp"
 
 namespace ouzel
 {
     namespace network
     {
-        Network::Network()
+        // number of messages that can wait for the update thread
+        static const uint32_t MESSAGE_QUEUE_SIZE = 4096;
+        // how often the network thread retries delivering messages while the queue is full, in milliseconds
+        static const int BACKLOG_TIMEOUT = 1;
+        // how long the network thread waits before polling again after a failed poll, in milliseconds
+        static const int RETRY_TIMEOUT = 100;
+#ifdef _WIN32
+        // there is no wake socket on Windows, so the sends are flushed at least this often
+        static const int WAIT_TIMEOUT = 10;
+        static const int SEND_FLAGS = 0;
+#elif defined(__linux__)
+        static const int WAIT_TIMEOUT = -1;
+        static const int SEND_FLAGS = MSG_NOSIGNAL;
+#else
+        static const int WAIT_TIMEOUT = -1;
+        static const int SEND_FLAGS = 0;
+#endif
+
+        struct PollEvent
         {
-        }
+            void* data;
+            bool readable;
+            bool writable;
+            bool error;
+        };
 
-        Network::~Network()
+        // readiness notification: epoll on Linux, kqueue on Apple platforms and FreeBSD, poll elsewhere
+        class Poller
         {
-            if (endpoint != NULL_SOCKET)
+        public:
+            ~Poller()
             {
+#if defined(__linux__) || defined(__APPLE__) || defined(__FreeBSD__)
+                if (descriptor != -1) close(descriptor);
+#endif
+            }
+
+            bool init()
+            {
+#if defined(__linux__)
+                descriptor = epoll_create1(0);
+#elif defined(__APPLE__) || defined(__FreeBSD__)
+                descriptor = kqueue();
+#endif
+
+#if defined(__linux__) || defined(__APPLE__) || defined(__FreeBSD__)
+                if (descriptor == -1)
+                {
+                    int error = Network::getLastError();
+                    Log(Log::Level::ERR) << "Failed to create poller, error: " << error;
+                    return false;
+                }
+#endif
+
+                return true;
+            }
+
+            bool add(Socket socket, void* data, bool read, bool write)
+            {
+#if defined(__linux__)
+                epoll_event event;
+                event.events = static_cast<uint32_t>((read ? EPOLLIN : 0) | (write ? EPOLLOUT : 0));
+                event.data.ptr = data;
+
+                return epoll_ctl(descriptor, EPOLL_CTL_ADD, socket, &event) == 0;
+#elif defined(__APPLE__) || defined(__FreeBSD__)
+                struct kevent changes[2];
+                EV_SET(&changes[0], socket, EVFILT_READ, EV_ADD | (read ? EV_ENABLE : EV_DISABLE), 0, 0, data);
+                EV_SET(&changes[1], socket, EVFILT_WRITE, EV_ADD | (write ? EV_ENABLE : EV_DISABLE), 0, 0, data);
+
+                return kevent(descriptor, changes, 2, nullptr, 0, nullptr) == 0;
+#else
+                Entry entry;
+                entry.data = data;
+                entry.events = (read ? POLLIN : 0) | (write ? POLLOUT : 0);
+                entries[socket] = entry;
+
+                return true;
+#endif
+            }
+
+            bool modify(Socket socket, void* data, bool read, bool write)
+            {
+#if defined(__linux__)
+                epoll_event event;
+                event.events = static_cast<uint32_t>((read ? EPOLLIN : 0) | (write ? EPOLLOUT : 0));
+                event.data.ptr = data;
+
+                return epoll_ctl(descriptor, EPOLL_CTL_MOD, socket, &event) == 0;
+#elif defined(__APPLE__) || defined(__FreeBSD__)
+                struct kevent changes[2];
+                EV_SET(&changes[0], socket, EVFILT_READ, read ? EV_ENABLE : EV_DISABLE, 0, 0, data);
+                EV_SET(&changes[1], socket, EVFILT_WRITE, write ? EV_ENABLE : EV_DISABLE, 0, 0, data);
+
+                return kevent(descriptor, changes, 2, nullptr, 0, nullptr) == 0;
+#else
+                return add(socket, data, read, write);
+#endif
+            }
+
+            void remove(Socket socket)
+            {
+#if defined(__linux__)
+                epoll_event event;
+                epoll_ctl(descriptor, EPOLL_CTL_DEL, socket, &event);
+#elif defined(__APPLE__) || defined(__FreeBSD__)
+                // kqueue removes the filters of closed descriptors on its own
+                (void)socket;
+#else
+                entries.erase(socket);
+#endif
+            }
+
+            bool wait(int timeout, std::vector<PollEvent>& events)
+            {
+                events.clear();
+
+#if defined(__linux__)
+                epoll_event result[256];
+                int count = epoll_wait(descriptor, result, 256, timeout);
+
+                if (count == -1)
+                {
+                    return errno == EINTR;
+                }
+
+                for (int i = 0; i < count; ++i)
+                {
+                    PollEvent event;
+                    event.data = result[i].data.ptr;
+                    event.readable = (result[i].events & EPOLLIN) != 0;
+                    event.writable = (result[i].events & EPOLLOUT) != 0;
+                    event.error = (result[i].events & (EPOLLERR | EPOLLHUP)) != 0;
+                    events.push_back(event);
+                }
+#elif defined(__APPLE__) || defined(__FreeBSD__)
+                struct kevent result[256];
+                timespec time;
+                time.tv_sec = timeout / 1000;
+                time.tv_nsec = (timeout % 1000) * 1000000;
+                int count = kevent(descriptor, nullptr, 0, result, 256, timeout >= 0 ? &time : nullptr);
+
+                if (count == -1)
+                {
+                    return errno == EINTR;
+                }
+
+                for (int i = 0; i < count; ++i)
+                {
+                    PollEvent event;
+                    event.data = result[i].udata;
+                    event.readable = result[i].filter == EVFILT_READ;
+                    event.writable = result[i].filter == EVFILT_WRITE;
+                    event.error = (result[i].flags & EV_ERROR) != 0;
+                    events.push_back(event);
+                }
+#else
+                descriptors.clear();
+                for (const auto& entry : entries)
+                {
+                    pollfd descriptor;
+                    descriptor.fd = entry.first;
+                    descriptor.events = entry.second.events;
+                    descriptor.revents = 0;
+                    descriptors.push_back(descriptor);
+                }
+
 #ifdef _WIN32
-                int result = closesocket(endpoint);
+                // WSAPoll fails with no descriptors, which a client-only network has after its last connection closes
+                if (descriptors.empty())
+                {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(timeout));
+                    return true;
+                }
+
+                int count = WSAPoll(descriptors.data(), static_cast<ULONG>(descriptors.size()), timeout);
 #else
-                int result = close(endpoint);
+                int count = poll(descriptors.data(), static_cast<nfds_t>(descriptors.size()), timeout);
 #endif
 
-                if (result < 0)
+                if (count < 0)
                 {
-                    int error = getLastError();
-                    Log(Log::Level::ERR) << "Failed to close socket, error: " << error;
+#ifdef _WIN32
+                    return false;
+#else
+                    return errno == EINTR;
+#endif
+                }
+
+                for (const pollfd& descriptor : descriptors)
+                {
+                    if (descriptor.revents)
+                    {
+                        PollEvent event;
+                        event.data = entries[descriptor.fd].data;
+                        event.readable = (descriptor.revents & POLLIN) != 0;
+                        event.writable = (descriptor.revents & POLLOUT) != 0;
+                        event.error = (descriptor.revents & (POLLERR | POLLHUP)) != 0;
+                        events.push_back(event);
+                    }
                 }
+#endif
+
+                return true;
+            }
+
+        private:
+#if defined(__linux__) || defined(__APPLE__) || defined(__FreeBSD__)
+            int descriptor = -1;
+#else
+            struct Entry
+            {
+                void* data;
+                short events;
+            };
+
+            std::map<Socket, Entry> entries;
+            std::vector<pollfd> descriptors;
+#endif
+        };
+
+        static bool isWouldBlock(int error)
+        {
+#ifdef _WIN32
+            return error == WSAEWOULDBLOCK || error == WSAEINPROGRESS;
+#else
+            return error == EAGAIN || error == EWOULDBLOCK || error == EINPROGRESS;
+#endif
+        }
+
+        static void closeSocket(Socket socket)
+        {
+#ifdef _WIN32
+            int result = closesocket(socket);
+#else
+            int result = close(socket);
+#endif
+
+            if (result < 0)
+            {
+                int error = Network::getLastError();
+                Log(Log::Level::ERR) << "Failed to close socket, error: " << error;
             }
+        }
+
+        static bool setNonBlocking(Socket socket)
+        {
+#ifdef _WIN32
+            u_long mode = 1;
+            if (ioctlsocket(socket, FIONBIO, &mode) != 0)
+#else
+            int flags = fcntl(socket, F_GETFL, 0);
+            if (flags == -1 || fcntl(socket, F_SETFL, flags | O_NONBLOCK) == -1)
+#endif
+            {
+                int error = Network::getLastError();
+                Log(Log::Level::ERR) << "Failed to set socket to non-blocking mode, error: " << error;
+                return false;
+            }
+
+            return true;
+        }
+
+        static bool setupSocket(Socket socket)
+        {
+            if (!setNonBlocking(socket)) return false;
+
+            // messages are batched per update already, so Nagle's algorithm would only add latency
+            int value = 1;
+            if (setsockopt(socket, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&value), sizeof(value)) != 0)
+            {
+                int error = Network::getLastError();
+                Log(Log::Level::WARN) << "Failed to disable Nagle's algorithm, error: " << error;
+            }
+
+#ifdef SO_NOSIGPIPE
+            setsockopt(socket, SOL_SOCKET, SO_NOSIGPIPE, &value, sizeof(value));
+#endif
+
+            return true;
+        }
+
+        Network::Network():
+            running(false),
+            listenPending(false),
+            sendPending(false),
+            nextClientId(0),
+            messages(MESSAGE_QUEUE_SIZE)
+        {
+        }
+
+        Network::~Network()
+        {
+            disconnect();
 
 #ifdef _WIN32
             WSACleanup();
@@ -58,8 +347,12 @@ namespace ouzel
 
         bool Network::getAddress(const std::string& address, uint32_t& result)
         {
+            addrinfo hints;
+            memset(&hints, 0, sizeof(hints));
+            hints.ai_family = AF_INET;
+
             addrinfo* info;
-            int ret = getaddrinfo(address.c_str(), nullptr, nullptr, &info);
+            int ret = getaddrinfo(address.c_str(), nullptr, &hints, &info);
 
             if (ret != 0)
             {
@@ -101,17 +394,694 @@ namespace ouzel
 
         bool Network::listen(const std::string& address, uint16_t port)
         {
+            if (endpoint != NULL_SOCKET)
+            {
+                Log(Log::Level::ERR) << "Already listening";
+                return false;
+            }
+
+            uint32_t ip = ANY_ADDRESS;
+            if (!address.empty() && !getAddress(address, ip))
+            {
+                return false;
+            }
+
+            endpoint = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+
+            if (endpoint == NULL_SOCKET)
+            {
+                int error = getLastError();
+                Log(Log::Level::ERR) << "Failed to create socket, error: " << error;
+                return false;
+            }
+
+            int value = 1;
+            setsockopt(endpoint, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&value), sizeof(value));
+
+            sockaddr_in addr;
+            memset(&addr, 0, sizeof(addr));
+            addr.sin_family = AF_INET;
+            addr.sin_addr.s_addr = htonl(ip);
+            addr.sin_port = htons(port);
+
+            if (bind(endpoint, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+                ::listen(endpoint, SOMAXCONN) != 0 ||
+                !setNonBlocking(endpoint))
+            {
+                int error = getLastError();
+                Log(Log::Level::ERR) << "Failed to listen on port " << port << ", error: " << error;
+                closeSocket(endpoint);
+                endpoint = NULL_SOCKET;
+                return false;
+            }
+
+            listenPending = true;
+
+            if (!start()) return false;
+            wake();
+
             return true;
         }
 
         bool Network::connect(const std::string& address, uint16_t port)
         {
+            uint32_t ip;
+            if (!getAddress(address, ip))
+            {
+                return false;
+            }
+
+            Socket clientSocket = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+
+            if (clientSocket == NULL_SOCKET)
+            {
+                int error = getLastError();
+                Log(Log::Level::ERR) << "Failed to create socket, error: " << error;
+                return false;
+            }
+
+            if (!setupSocket(clientSocket))
+            {
+                closeSocket(clientSocket);
+                return false;
+            }
+
+            sockaddr_in addr;
+            memset(&addr, 0, sizeof(addr));
+            addr.sin_family = AF_INET;
+            addr.sin_addr.s_addr = htonl(ip);
+            addr.sin_port = htons(port);
+
+            // the connection completes on the network thread
+            if (::connect(clientSocket, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0)
+            {
+                int error = getLastError();
+                if (!isWouldBlock(error))
+                {
+                    Log(Log::Level::ERR) << "Failed to connect to " << address << ":" << port << ", error: " << error;
+                    closeSocket(clientSocket);
+                    return false;
+                }
+            }
+
+            std::unique_ptr<Client> client(new Client(this, clientSocket, ++nextClientId, ip, port));
+            client->connecting = true;
+
+            {
+                std::lock_guard<std::mutex> lock(clientMutex);
+                newClients.push_back(client.get());
+                clients.push_back(std::move(client));
+            }
+
+            if (!start()) return false;
+            wake();
+
             return true;
         }
 
         bool Network::disconnect()
         {
+            stop();
+
+            if (endpoint != NULL_SOCKET)
+            {
+                closeSocket(endpoint);
+                endpoint = NULL_SOCKET;
+            }
+
+            // the client destructors close their sockets
+            std::lock_guard<std::mutex> lock(clientMutex);
+            clients.clear();
+            newClients.clear();
+            activeClients.clear();
+            backloggedClients.clear();
+            closedClients.clear();
+            overflow.clear();
+            listenPending = false;
+
+            while (messages.front()) messages.pop();
+
+            return true;
+        }
+
+        void Network::update()
+        {
+            while (MessageQueue::Message* message = messages.front())
+            {
+                Client* client = message->client;
+
+                switch (message->type)
+                {
+                    case MessageQueue::Message::Type::CONNECT:
+                        if (connectHandler) connectHandler(client);
+                        break;
+                    case MessageQueue::Message::Type::DATA:
+                        if (messageHandler) messageHandler(client, message->data);
+                        break;
+                    case MessageQueue::Message::Type::DISCONNECT:
+                    {
+                        if (disconnectHandler) disconnectHandler(client);
+
+                        // the network thread doesn't reference the client after posting the disconnect
+                        std::lock_guard<std::mutex> lock(clientMutex);
+                        auto i = std::find_if(clients.begin(), clients.end(), [client](const std::unique_ptr<Client>& c) {
+                            return c.get() == client;
+                        });
+                        if (i != clients.end()) clients.erase(i);
+                        break;
+                    }
+                }
+
+                messages.pop();
+            }
+
+            // everything sent during this update goes out with one wake-up of the network thread
+            if (sendPending) wake();
+        }
+
+        bool Network::start()
+        {
+            if (running) return true;
+
+            poller.reset(new Poller());
+            if (!poller->init()) return false;
+
+#ifndef _WIN32
+            int pipeDescriptors[2];
+            if (pipe(pipeDescriptors) != 0)
+            {
+                int error = getLastError();
+                Log(Log::Level::ERR) << "Failed to create pipe, error: " << error;
+                return false;
+            }
+
+            wakeSockets[0] = pipeDescriptors[0];
+            wakeSockets[1] = pipeDescriptors[1];
+            setNonBlocking(wakeSockets[0]);
+            setNonBlocking(wakeSockets[1]);
+
+            // the wake pipe is the only registration without data
+            poller->add(wakeSockets[0], nullptr, true, false);
+#endif
+
+            running = true;
+            networkThread = std::thread(&Network::run, this);
+
+            return true;
+        }
+
+        void Network::stop()
+        {
+            if (!running) return;
+
+            running = false;
+            wake();
+            if (networkThread.joinable()) networkThread.join();
+
+            for (Socket& wakeSocket : wakeSockets)
+            {
+                if (wakeSocket != NULL_SOCKET)
+                {
+                    closeSocket(wakeSocket);
+                    wakeSocket = NULL_SOCKET;
+                }
+            }
+
+            poller.reset();
+        }
+
+        void Network::wake()
+        {
+#ifndef _WIN32
+            if (wakeSockets[1] != NULL_SOCKET)
+            {
+                uint8_t value = 1;
+                // a full pipe means the network thread is already going to wake up
+                if (write(wakeSockets[1], &value, sizeof(value)) == -1 && errno != EAGAIN)
+                {
+                    int error = getLastError();
+                    Log(Log::Level::ERR) << "Failed to wake network thread, error: " << error;
+                }
+            }
+#endif
+        }
+
+        void Network::run()
+        {
+            engine->setCurrentThreadName("Network");
+
+            std::vector<PollEvent> events;
+            bool pollFailed = false;
+
+            while (running)
+            {
+                adoptClients();
+
+                // retry delivering the messages that didn't fit in the queue
+                bool backlogged = !flushOverflow();
+
+                std::vector<Client*> retryClients;
+                retryClients.swap(backloggedClients);
+
+                for (Client* client : retryClients)
+                {
+                    // parsing puts the client back in the list if the queue is still full
+                    if (client->socket != NULL_SOCKET && !parseMessages(client)) closeClient(client);
+                }
+
+                if (!backloggedClients.empty()) backlogged = true;
+
+                if (!poller->wait(backlogged ? BACKLOG_TIMEOUT : WAIT_TIMEOUT, events))
+                {
+                    // keep the thread running, so that the sockets added later are still adopted
+                    if (!pollFailed)
+                    {
+                        int error = getLastError();
+                        Log(Log::Level::ERR) << "Failed to poll sockets, error: " << error;
+                        pollFailed = true;
+                    }
+
+                    std::this_thread::sleep_for(std::chrono::milliseconds(RETRY_TIMEOUT));
+                    continue;
+                }
+
+                pollFailed = false;
+
+                for (const PollEvent& event : events)
+                {
+                    if (!event.data)
+                    {
+#ifndef _WIN32
+                        uint8_t buffer[64];
+                        while (read(wakeSockets[0], buffer, sizeof(buffer)) > 0);
+#endif
+                        continue;
+                    }
+
+                    if (event.data == this)
+                    {
+                        acceptClients();
+                        continue;
+                    }
+
+                    Client* client = static_cast<Client*>(event.data);
+
+                    // closed by an earlier event in this batch
+                    if (client->socket == NULL_SOCKET) continue;
+
+                    if (client->connecting)
+                    {
+                        finishConnect(client);
+                        continue;
+                    }
+
+                    if ((event.readable || event.error) && !readClient(client))
+                    {
+                        closeClient(client);
+                        continue;
+                    }
+
+                    if (event.writable && !flushClient(client))
+                    {
+                        closeClient(client);
+                    }
+                }
+
+                if (sendPending.exchange(false))
+                {
+                    // copy, because closing the client removes it from the list
+                    std::vector<Client*> sendClients = activeClients;
+
+                    for (Client* client : sendClients)
+                    {
+                        if (client->sendQueued && !flushClient(client)) closeClient(client);
+                    }
+                }
+
+                // the update thread may delete the clients as soon as it receives the disconnects,
+                // so they are posted only after all the events referencing them have been handled
+                for (Client* client : closedClients)
+                {
+                    if (!pushMessage(MessageQueue::Message::Type::DISCONNECT, client))
+                    {
+                        overflow.push_back(std::make_pair(MessageQueue::Message::Type::DISCONNECT, client));
+                    }
+                }
+
+                closedClients.clear();
+            }
+        }
+
+        void Network::adoptClients()
+        {
+            if (listenPending.exchange(false))
+            {
+                poller->add(endpoint, this, true, false);
+            }
+
+            std::vector<Client*> clientsToAdopt;
+
+            {
+                std::lock_guard<std::mutex> lock(clientMutex);
+                clientsToAdopt.swap(newClients);
+            }
+
+            for (Client* client : clientsToAdopt)
+            {
+                if (!poller->add(client->socket, client, false, true))
+                {
+                    int error = getLastError();
+                    Log(Log::Level::ERR) << "Failed to register socket, error: " << error;
+                    closeClient(client);
+                    continue;
+                }
+
+                client->writeInterest = true;
+                activeClients.push_back(client);
+            }
+        }
+
+        void Network::acceptClients()
+        {
+            for (;;)
+            {
+                sockaddr_in addr;
+                socklen_t addressLength = sizeof(addr);
+                Socket clientSocket = accept(endpoint, reinterpret_cast<sockaddr*>(&addr), &addressLength);
+
+                if (clientSocket == NULL_SOCKET)
+                {
+                    int error = getLastError();
+                    if (!isWouldBlock(error))
+                    {
+                        Log(Log::Level::ERR) << "Failed to accept client, error: " << error;
+                    }
+                    break;
+                }
+
+                if (!setupSocket(clientSocket))
+                {
+                    closeSocket(clientSocket);
+                    continue;
+                }
+
+                std::unique_ptr<Client> client(new Client(this, clientSocket, ++nextClientId,
+                                                          ntohl(addr.sin_addr.s_addr), ntohs(addr.sin_port)));
+                Client* newClient = client.get();
+
+                if (!poller->add(clientSocket, newClient, true, false))
+                {
+                    int error = getLastError();
+                    Log(Log::Level::ERR) << "Failed to register socket, error: " << error;
+                    continue;
+                }
+
+                newClient->connected = true;
+
+                {
+                    std::lock_guard<std::mutex> lock(clientMutex);
+                    clients.push_back(std::move(client));
+                }
+
+                activeClients.push_back(newClient);
+
+                if (!pushMessage(MessageQueue::Message::Type::CONNECT, newClient))
+                {
+                    overflow.push_back(std::make_pair(MessageQueue::Message::Type::CONNECT, newClient));
+                }
+            }
+        }
+
+        void Network::finishConnect(Client* client)
+        {
+            int error = 0;
+            socklen_t length = sizeof(error);
+
+            if (getsockopt(client->socket, SOL_SOCKET, SO_ERROR, reinterpret_cast<char*>(&error), &length) != 0)
+            {
+                error = getLastError();
+            }
+
+            if (error != 0)
+            {
+                Log(Log::Level::ERR) << "Failed to connect, error: " << error;
+                closeClient(client);
+                return;
+            }
+
+            client->connecting = false;
+            client->connected = true;
+            client->writeInterest = false;
+            poller->modify(client->socket, client, true, false);
+
+            if (!pushMessage(MessageQueue::Message::Type::CONNECT, client))
+            {
+                overflow.push_back(std::make_pair(MessageQueue::Message::Type::CONNECT, client));
+            }
+
+            // a disconnect could have been requested while connecting
+            if (client->sendQueued && !flushClient(client)) closeClient(client);
+        }
+
+        bool Network::readClient(Client* client)
+        {
+            for (;;)
+            {
+                uint32_t freeSize = Client::RECEIVE_BUFFER_SIZE - (client->writePosition - client->readPosition);
+
+                if (freeSize == 0)
+                {
+                    // make room by handing the complete messages over to the update thread
+                    if (!parseMessages(client)) return false;
+
+                    freeSize = Client::RECEIVE_BUFFER_SIZE - (client->writePosition - client->readPosition);
+
+                    if (freeSize == 0)
+                    {
+                        // backpressure: stop reading until the update thread catches up
+                        if (!client->readPaused)
+                        {
+                            client->readPaused = true;
+                            poller->modify(client->socket, client, false, client->writeInterest);
+                        }
+
+                        return true;
+                    }
+                }
+
+                uint32_t offset = client->writePosition & (Client::RECEIVE_BUFFER_SIZE - 1);
+                uint32_t size = std::min(freeSize, Client::RECEIVE_BUFFER_SIZE - offset);
+
+                int result = static_cast<int>(recv(client->socket,
+                                                   reinterpret_cast<char*>(client->receiveBuffer.data() + offset),
+                                                   size, 0));
+
+                if (result > 0)
+                {
+                    client->writePosition += static_cast<uint32_t>(result);
+                    if (static_cast<uint32_t>(result) < size) break;
+                }
+                else if (result == 0)
+                {
+                    // closed by the peer
+                    return false;
+                }
+                else
+                {
+                    int error = getLastError();
+                    if (isWouldBlock(error)) break;
+#ifndef _WIN32
+                    if (error == EINTR) continue;
+#endif
+                    return false;
+                }
+            }
+
+            return parseMessages(client);
+        }
+
+        bool Network::parseMessages(Client* client)
+        {
+            const uint8_t* buffer = client->receiveBuffer.data();
+            const uint32_t mask = Client::RECEIVE_BUFFER_SIZE - 1;
+            bool backlogged = false;
+
+            while (client->writePosition - client->readPosition >= sizeof(uint32_t))
+            {
+                uint32_t position = client->readPosition;
+                uint32_t length = static_cast<uint32_t>(buffer[position & mask]) |
+                    static_cast<uint32_t>(buffer[(position + 1) & mask]) << 8 |
+                    static_cast<uint32_t>(buffer[(position + 2) & mask]) << 16 |
+                    static_cast<uint32_t>(buffer[(position + 3) & mask]) << 24;
+
+                if (length > Client::MAX_MESSAGE_SIZE)
+                {
+                    Log(Log::Level::ERR) << "Message too big";
+                    return false;
+                }
+
+                if (client->writePosition - client->readPosition < sizeof(uint32_t) + length) break;
+
+                // keep the connect and disconnect messages in order with the data
+                MessageQueue::Message* message = overflow.empty() ? messages.beginPush() : nullptr;
+
+                if (!message)
+                {
+                    backlogged = true;
+                    break;
+                }
+
+                message->type = MessageQueue::Message::Type::DATA;
+                message->client = client;
+                message->data.resize(length);
+
+                uint32_t offset = (position + sizeof(uint32_t)) & mask;
+                uint32_t first = std::min(length, Client::RECEIVE_BUFFER_SIZE - offset);
+                std::copy(buffer + offset, buffer + offset + first, message->data.begin());
+                std::copy(buffer, buffer + (length - first), message->data.begin() + first);
+
+                messages.endPush();
+                client->readPosition += sizeof(uint32_t) + length;
+            }
+
+            if (backlogged)
+            {
+                if (std::find(backloggedClients.begin(), backloggedClients.end(), client) == backloggedClients.end())
+                {
+                    backloggedClients.push_back(client);
+                }
+            }
+            else if (client->readPaused)
+            {
+                client->readPaused = false;
+                poller->modify(client->socket, client, true, client->writeInterest);
+
+                // data could have arrived while the reads were paused
+                return readClient(client);
+            }
+
+            return true;
+        }
+
+        bool Network::flushClient(Client* client)
+        {
+            if (client->sendQueued.exchange(false))
+            {
+                std::lock_guard<std::mutex> lock(client->sendMutex);
+
+                if (client->sendOffset == client->sendBuffer.size())
+                {
+                    client->sendBuffer.clear();
+                    client->sendOffset = 0;
+                    client->sendBuffer.swap(client->pendingData);
+                }
+                else
+                {
+                    client->sendBuffer.insert(client->sendBuffer.end(), client->pendingData.begin(), client->pendingData.end());
+                    client->pendingData.clear();
+                }
+            }
+
+            if (!writeClient(client)) return false;
+
+            // a requested disconnect happens once everything is sent
+            return !(client->closeRequested && client->sendOffset == client->sendBuffer.size());
+        }
+
+        bool Network::writeClient(Client* client)
+        {
+            while (client->sendOffset < client->sendBuffer.size())
+            {
+                int result = static_cast<int>(::send(client->socket,
+                                                     reinterpret_cast<const char*>(client->sendBuffer.data() + client->sendOffset),
+                                                     static_cast<int>(client->sendBuffer.size() - client->sendOffset),
+                                                     SEND_FLAGS));
+
+                if (result >= 0)
+                {
+                    client->sendOffset += static_cast<uint32_t>(result);
+                }
+                else
+                {
+                    int error = getLastError();
+
+#ifndef _WIN32
+                    if (error == EINTR) continue;
+#endif
+
+                    if (!isWouldBlock(error)) return false;
+
+                    // the socket buffer is full, continue when it becomes writable
+                    if (!client->writeInterest)
+                    {
+                        client->writeInterest = true;
+                        poller->modify(client->socket, client, !client->readPaused, true);
+                    }
+
+                    return true;
+                }
+            }
+
+            if (client->writeInterest)
+            {
+                client->writeInterest = false;
+                poller->modify(client->socket, client, !client->readPaused, false);
+            }
+
+            return true;
+        }
+
+        void Network::closeClient(Client* client)
+        {
+            if (client->socket == NULL_SOCKET) return;
+
+            poller->remove(client->socket);
+            closeSocket(client->socket);
+            client->socket = NULL_SOCKET;
+            client->connected = false;
+
+            auto i = std::find(activeClients.begin(), activeClients.end(), client);
+            if (i != activeClients.end()) activeClients.erase(i);
+
+            i = std::find(backloggedClients.begin(), backloggedClients.end(), client);
+            if (i != backloggedClients.end()) backloggedClients.erase(i);
+
+            closedClients.push_back(client);
+        }
+
+        bool Network::pushMessage(MessageQueue::Message::Type type, Client* client)
+        {
+            if (!overflow.empty()) return false;
+
+            MessageQueue::Message* message = messages.beginPush();
+            if (!message) return false;
+
+            message->type = type;
+            message->client = client;
+            message->data.clear();
+            messages.endPush();
+
             return true;
         }
+
+        bool Network::flushOverflow()
+        {
+            size_t count = 0;
+
+            for (; count < overflow.size(); ++count)
+            {
+                MessageQueue::Message* message = messages.beginPush();
+                if (!message) break;
+
+                message->type = overflow[count].first;
+                message->client = overflow[count].second;
+                message->data.clear();
+                messages.endPush();
+            }
+
+            overflow.erase(overflow.begin(), overflow.begin() + static_cast<std::ptrdiff_t>(count));
+
+            return overflow.empty();
+        }
     } // namespace network
 } // namespace ouzel
@@ -13,8 +13,15 @@ typedef int Socket;
 #define NULL_SOCKET -1
 #endif
 
+#include <atomic>
 #include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <vector>
+#include "network/MessageQueue.hpp"
 
 namespace ouzel
 {
@@ -23,8 +30,14 @@ namespace ouzel
         const uint32_t ANY_ADDRESS = 0;
         const uint16_t ANY_PORT = 0;
 
+        class Client;
+        class Poller;
+
+        // sockets are non-blocking and serviced by a network thread, received messages are delivered
+        // and queued sends are flushed on the update thread by update()
         class Network
         {
+            friend Client;
         public:
             Network();
             ~Network();
@@ -36,10 +49,56 @@ namespace ouzel
 
             bool listen(const std::string& address, uint16_t port);
             bool connect(const std::string& address, uint16_t port);
+            // closes the listening socket and all connections
             bool disconnect();
 
+            // calls the handlers for the received messages and wakes the network thread to send the queued ones
+            void update();
+
+            // the client is destroyed after the disconnect handler returns
+            std::function<void(Client*)> connectHandler;
+            std::function<void(Client*)> disconnectHandler;
+            std::function<void(Client*, const std::vector<uint8_t>&)> messageHandler;
+
         private:
+            bool start();
+            void stop();
+            void run();
+            void wake();
+
+            void adoptClients();
+            void acceptClients();
+            void finishConnect(Client* client);
+            bool readClient(Client* client);
+            bool parseMessages(Client* client);
+            bool flushClient(Client* client);
+            bool writeClient(Client* client);
+            void closeClient(Client* client);
+            bool pushMessage(MessageQueue::Message::Type type, Client* client);
+            bool flushOverflow();
+
             Socket endpoint = NULL_SOCKET;
+            Socket wakeSockets[2] = {NULL_SOCKET, NULL_SOCKET};
+            std::unique_ptr<Poller> poller;
+
+            std::thread networkThread;
+            std::atomic<bool> running;
+            std::atomic<bool> listenPending;
+            std::atomic<bool> sendPending;
+            std::atomic<uint32_t> nextClientId;
+
+            // guards the client list and the connections that the network thread hasn't registered yet
+            std::mutex clientMutex;
+            std::vector<std::unique_ptr<Client>> clients;
+            std::vector<Client*> newClients;
+
+            // network thread only
+            std::vector<Client*> activeClients;
+            std::vector<Client*> backloggedClients;
+            std::vector<Client*> closedClients;
+            std::vector<std::pair<MessageQueue::Message::Type, Client*>> overflow;
+
+            MessageQueue messages;
         };
     } // namespace network
 } // namespace ouzel
@@ -0,0 +1,523 @@
+// Copyright (C) 2018 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#include <algorithm>
+#include <cmath>
+#include "Replicator.hpp"
+#include "BitStream.hpp"
+#include "Client.hpp"
+#include "scene/Actor.hpp"
+#include "math/MathUtils.hpp"
+#include "utils/Log.hpp"
+
+namespace ouzel
+{
+    namespace network
+    {
+        // fixed-point precision of the positions (1/256 unit) and scales (1/1024)
+        static const float POSITION_PRECISION = 256.0f;
+        static const float SCALE_PRECISION = 1024.0f;
+        // bits per component of the smallest-three quaternion encoding
+        static const uint32_t ROTATION_BITS = 10;
+        static const uint32_t ROTATION_MAX = (1 << ROTATION_BITS) - 1;
+
+        enum ActorFlags
+        {
+            FLIP_X = 0x01,
+            FLIP_Y = 0x02,
+            HIDDEN = 0x04
+        };
+
+        static int32_t quantizeFloat(float value, float precision)
+        {
+            return static_cast<int32_t>(std::lround(value * precision));
+        }
+
+        // drops the largest component, it can be restored from the other three since the quaternion is normalized
+        static uint32_t quantizeRotation(Quaternion rotation)
+        {
+            rotation.normalize();
+
+            float components[4] = {rotation.x, rotation.y, rotation.z, rotation.w};
+            uint32_t largest = 0;
+
+            for (uint32_t i = 1; i < 4; ++i)
+            {
+                if (std::fabs(components[i]) > std::fabs(components[largest])) largest = i;
+            }
+
+            // q and -q are the same rotation
+            float sign = (components[largest] < 0.0f) ? -1.0f : 1.0f;
+            uint32_t result = largest;
+            uint32_t shift = 2;
+
+            for (uint32_t i = 0; i < 4; ++i)
+            {
+                if (i == largest) continue;
+
+                // the other components are in the range [-1/sqrt(2), 1/sqrt(2)]
+                float value = clamp(components[i] * sign * SQRT2 * 0.5f + 0.5f, 0.0f, 1.0f);
+                result |= static_cast<uint32_t>(std::lround(value * ROTATION_MAX)) << shift;
+                shift += ROTATION_BITS;
+            }
+
+            return result;
+        }
+
+        static Quaternion dequantizeRotation(uint32_t value)
+        {
+            float components[4];
+            uint32_t largest = value & 0x03;
+            uint32_t shift = 2;
+            float sum = 0.0f;
+
+            for (uint32_t i = 0; i < 4; ++i)
+            {
+                if (i == largest) continue;
+
+                float component = ((value >> shift) & ROTATION_MAX) / static_cast<float>(ROTATION_MAX);
+                components[i] = (component - 0.5f) * 2.0f / SQRT2;
+                sum += components[i] * components[i];
+                shift += ROTATION_BITS;
+            }
+
+            components[largest] = std::sqrt(std::max(0.0f, 1.0f - sum));
+
+            Quaternion rotation;
+            rotation.x = components[0];
+            rotation.y = components[1];
+            rotation.z = components[2];
+            rotation.w = components[3];
+            return rotation;
+        }
+
+        Replicator::Replicator():
+            history(HISTORY_SIZE)
+        {
+        }
+
+        bool Replicator::addActor(uint32_t id, scene::Actor* actor)
+        {
+            if (!actor || actors.find(id) != actors.end())
+            {
+                return false;
+            }
+
+            ActorRecord record;
+            record.actor = actor;
+            quantize(actor, record.state);
+            record.state.id = id;
+            actor->clearDirtyFields();
+
+            actors[id] = record;
+
+            return true;
+        }
+
+        bool Replicator::removeActor(uint32_t id)
+        {
+            return actors.erase(id) > 0;
+        }
+
+        scene::Actor* Replicator::getActor(uint32_t id) const
+        {
+            auto i = actors.find(id);
+
+            return (i == actors.end()) ? nullptr : i->second.actor;
+        }
+
+        void Replicator::addClient(Client* client)
+        {
+            // the first snapshot of a client contains the full state
+            clients.push_back({client, INVALID_TICK});
+        }
+
+        void Replicator::removeClient(Client* client)
+        {
+            clients.erase(std::remove_if(clients.begin(), clients.end(), [client](const ClientRecord& record) {
+                return record.client == client;
+            }), clients.end());
+        }
+
+        void Replicator::update()
+        {
+            ++tick;
+            if (tick == INVALID_TICK) tick = 0;
+
+            Snapshot& snapshot = history[tick % HISTORY_SIZE];
+            snapshot.tick = tick;
+            snapshot.states.clear();
+            snapshot.states.reserve(actors.size());
+
+            for (auto& i : actors)
+            {
+                ActorRecord& record = i.second;
+
+                // only the actors that were changed since the last tick are quantized again
+                if (record.actor->getDirtyFields())
+                {
+                    quantize(record.actor, record.state);
+                    record.actor->clearDirtyFields();
+                }
+
+                snapshot.states.push_back(record.state);
+            }
+
+            lastTickBytes = 0;
+
+            // clients that acknowledged the same snapshot get the same payload
+            std::map<uint32_t, std::vector<uint8_t>> payloads;
+
+            for (ClientRecord& record : clients)
+            {
+                uint32_t baselineTick = record.ackedTick;
+
+                if (baselineTick == INVALID_TICK ||
+                    tick - baselineTick >= HISTORY_SIZE ||
+                    history[baselineTick % HISTORY_SIZE].tick != baselineTick)
+                {
+                    baselineTick = INVALID_TICK;
+                }
+
+                auto i = payloads.find(baselineTick);
+
+                if (i == payloads.end())
+                {
+                    std::vector<uint8_t>& payload = payloads[baselineTick];
+                    payload.push_back(SNAPSHOT_MESSAGE);
+
+                    BitWriter writer(payload);
+                    writer.write(tick, 32);
+                    writer.write(baselineTick, 32);
+
+                    static const std::vector<State> EMPTY;
+                    encode((baselineTick == INVALID_TICK) ? EMPTY : history[baselineTick % HISTORY_SIZE].states,
+                           snapshot.states, writer);
+                    writer.flush();
+
+                    i = payloads.find(baselineTick);
+                }
+
+                if (baselineTick == INVALID_TICK) ++fullSnapshotCount;
+
+                if (record.client->send(i->second))
+                {
+                    lastTickBytes += i->second.size();
+                }
+            }
+
+            totalBytes += lastTickBytes;
+        }
+
+        bool Replicator::handleMessage(Client* client, const std::vector<uint8_t>& data)
+        {
+            if (data.empty()) return false;
+
+            switch (data[0])
+            {
+                case SNAPSHOT_MESSAGE:
+                    if (!receiveSnapshot(client, data))
+                    {
+                        Log(Log::Level::ERR) << "Invalid snapshot";
+                    }
+                    return true;
+                case ACK_MESSAGE:
+                    receiveAck(client, data);
+                    return true;
+                default:
+                    return false;
+            }
+        }
+
+        void Replicator::quantize(scene::Actor* actor, State& state)
+        {
+            const Vector3& position = actor->getPosition();
+            state.position[0] = quantizeFloat(position.x, POSITION_PRECISION);
+            state.position[1] = quantizeFloat(position.y, POSITION_PRECISION);
+            state.position[2] = quantizeFloat(position.z, POSITION_PRECISION);
+
+            state.rotation = quantizeRotation(actor->getRotation());
+
+            const Vector3& scale = actor->getScale();
+            state.scale[0] = quantizeFloat(scale.x, SCALE_PRECISION);
+            state.scale[1] = quantizeFloat(scale.y, SCALE_PRECISION);
+            state.scale[2] = quantizeFloat(scale.z, SCALE_PRECISION);
+
+            state.opacity = static_cast<uint32_t>(std::lround(actor->getOpacity() * 255.0f));
+
+            state.flags = (actor->getFlipX() ? FLIP_X : 0) |
+                (actor->getFlipY() ? FLIP_Y : 0) |
+                (actor->isHidden() ? HIDDEN : 0);
+        }
+
+        void Replicator::apply(const State& state, uint32_t fields, scene::Actor* actor)
+        {
+            if (fields & scene::Actor::DIRTY_POSITION)
+            {
+                actor->setPosition(Vector3(state.position[0] / POSITION_PRECISION,
+                                           state.position[1] / POSITION_PRECISION,
+                                           state.position[2] / POSITION_PRECISION));
+            }
+
+            if (fields & scene::Actor::DIRTY_ROTATION)
+            {
+                actor->setRotation(dequantizeRotation(state.rotation));
+            }
+
+            if (fields & scene::Actor::DIRTY_SCALE)
+            {
+                actor->setScale(Vector3(state.scale[0] / SCALE_PRECISION,
+                                        state.scale[1] / SCALE_PRECISION,
+                                        state.scale[2] / SCALE_PRECISION));
+            }
+
+            if (fields & scene::Actor::DIRTY_OPACITY)
+            {
+                actor->setOpacity(state.opacity / 255.0f);
+            }
+
+            if (fields & scene::Actor::DIRTY_FLAGS)
+            {
+                actor->setFlipX((state.flags & FLIP_X) != 0);
+                actor->setFlipY((state.flags & FLIP_Y) != 0);
+                actor->setHidden((state.flags & HIDDEN) != 0);
+            }
+        }
+
+        uint32_t Replicator::compare(const State& a, const State& b)
+        {
+            uint32_t fields = 0;
+
+            if (a.position[0] != b.position[0] ||
+                a.position[1] != b.position[1] ||
+                a.position[2] != b.position[2]) fields |= scene::Actor::DIRTY_POSITION;
+            if (a.rotation != b.rotation) fields |= scene::Actor::DIRTY_ROTATION;
+            if (a.scale[0] != b.scale[0] ||
+                a.scale[1] != b.scale[1] ||
+                a.scale[2] != b.scale[2]) fields |= scene::Actor::DIRTY_SCALE;
+            if (a.opacity != b.opacity) fields |= scene::Actor::DIRTY_OPACITY;
+            if (a.flags != b.flags) fields |= scene::Actor::DIRTY_FLAGS;
+
+            return fields;
+        }
+
+        // both state lists are sorted by id, each changed actor is written as the id difference from the previous one,
+        // the field mask and the changed fields, positions and scales as differences from the baseline
+        void Replicator::encode(const std::vector<State>& baseline, const std::vector<State>& current, BitWriter& writer)
+        {
+            static const State EMPTY;
+            uint32_t previousId = 0;
+            auto baselineState = baseline.begin();
+            auto currentState = current.begin();
+
+            while (baselineState != baseline.end() || currentState != current.end())
+            {
+                const State* base = &EMPTY;
+                const State* state = nullptr;
+                uint32_t fields;
+
+                if (currentState == current.end() ||
+                    (baselineState != baseline.end() && baselineState->id < currentState->id))
+                {
+                    // removed since the baseline
+                    base = &*baselineState++;
+                    fields = FIELD_REMOVED;
+                }
+                else if (baselineState == baseline.end() || currentState->id < baselineState->id)
+                {
+                    // added since the baseline
+                    state = &*currentState++;
+                    fields = scene::Actor::DIRTY_ALL;
+                }
+                else
+                {
+                    base = &*baselineState++;
+                    state = &*currentState++;
+                    fields = compare(*base, *state);
+                    if (!fields) continue;
+                }
+
+                uint32_t id = state ? state->id : base->id;
+
+                writer.writeBool(true);
+                writer.writeVariable(static_cast<int32_t>(id - previousId));
+                writer.write(fields, FIELD_BITS);
+                previousId = id;
+
+                if (fields & scene::Actor::DIRTY_POSITION)
+                {
+                    for (uint32_t i = 0; i < 3; ++i)
+                        writer.writeVariable(state->position[i] - base->position[i]);
+                }
+
+                if (fields & scene::Actor::DIRTY_ROTATION) writer.write(state->rotation, 2 + 3 * ROTATION_BITS);
+
+                if (fields & scene::Actor::DIRTY_SCALE)
+                {
+                    for (uint32_t i = 0; i < 3; ++i)
+                        writer.writeVariable(state->scale[i] - base->scale[i]);
+                }
+
+                if (fields & scene::Actor::DIRTY_OPACITY) writer.write(state->opacity, 8);
+                if (fields & scene::Actor::DIRTY_FLAGS) writer.write(state->flags, 3);
+            }
+
+            writer.writeBool(false);
+        }
+
+        bool Replicator::receiveSnapshot(Client* client, const std::vector<uint8_t>& data)
+        {
+            BitReader reader(data.data() + 1, data.size() - 1);
+
+            uint32_t snapshotTick;
+            uint32_t baselineTick;
+            if (!reader.read(snapshotTick, 32) || !reader.read(baselineTick, 32)) return false;
+
+            // stale snapshot
+            if (lastReceivedTick != INVALID_TICK &&
+                static_cast<int32_t>(snapshotTick - lastReceivedTick) <= 0) return true;
+
+            static const std::vector<State> EMPTY;
+            const std::vector<State>* baseline = &EMPTY;
+
+            if (baselineTick != INVALID_TICK)
+            {
+                const Snapshot& baselineSnapshot = history[baselineTick % HISTORY_SIZE];
+                if (baselineSnapshot.tick != baselineTick) return false;
+                baseline = &baselineSnapshot.states;
+            }
+
+            std::vector<State> states;
+            states.reserve(baseline->size());
+            auto baselineState = baseline->begin();
+            uint32_t id = 0;
+
+            for (;;)
+            {
+                bool more;
+                if (!reader.readBool(more)) return false;
+                if (!more) break;
+
+                int32_t idDelta;
+                uint32_t fields;
+                if (!reader.readVariable(idDelta) || !reader.read(fields, FIELD_BITS)) return false;
+                id += static_cast<uint32_t>(idDelta);
+
+                // unchanged actors are the same as in the baseline
+                while (baselineState != baseline->end() && baselineState->id < id)
+                    states.push_back(*baselineState++);
+
+                State state;
+                if (baselineState != baseline->end() && baselineState->id == id) state = *baselineState++;
+                state.id = id;
+
+                if (fields & FIELD_REMOVED) continue;
+
+                if (fields & scene::Actor::DIRTY_POSITION)
+                {
+                    for (uint32_t i = 0; i < 3; ++i)
+                    {
+                        int32_t delta;
+                        if (!reader.readVariable(delta)) return false;
+                        state.position[i] += delta;
+                    }
+                }
+
+                if ((fields & scene::Actor::DIRTY_ROTATION) && !reader.read(state.rotation, 2 + 3 * ROTATION_BITS)) return false;
+
+                if (fields & scene::Actor::DIRTY_SCALE)
+                {
+                    for (uint32_t i = 0; i < 3; ++i)
+                    {
+                        int32_t delta;
+                        if (!reader.readVariable(delta)) return false;
+                        state.scale[i] += delta;
+                    }
+                }
+
+                if ((fields & scene::Actor::DIRTY_OPACITY) && !reader.read(state.opacity, 8)) return false;
+                if ((fields & scene::Actor::DIRTY_FLAGS) && !reader.read(state.flags, 3)) return false;
+
+                states.push_back(state);
+            }
+
+            states.insert(states.end(), baselineState, baseline->end());
+
+            // apply the differences from the last applied snapshot, which can be newer than the baseline
+            const std::vector<State>* previous = &EMPTY;
+            if (lastReceivedTick != INVALID_TICK && history[lastReceivedTick % HISTORY_SIZE].tick == lastReceivedTick)
+                previous = &history[lastReceivedTick % HISTORY_SIZE].states;
+
+            auto previousState = previous->begin();
+
+            for (const State& state : states)
+            {
+                while (previousState != previous->end() && previousState->id < state.id)
+                {
+                    uint32_t removedId = (previousState++)->id;
+                    scene::Actor* actor = getActor(removedId);
+                    actors.erase(removedId);
+                    if (removeHandler) removeHandler(removedId, actor);
+                }
+
+                uint32_t fields = scene::Actor::DIRTY_ALL;
+                if (previousState != previous->end() && previousState->id == state.id)
+                    fields = compare(*previousState++, state);
+
+                if (!fields) continue;
+
+                auto i = actors.find(state.id);
+                scene::Actor* actor = (i == actors.end()) ? nullptr : i->second.actor;
+
+                if (!actor && createHandler && (actor = createHandler(state.id)))
+                {
+                    actors[state.id] = {actor, state};
+                    fields = scene::Actor::DIRTY_ALL;
+                }
+
+                if (actor) apply(state, fields, actor);
+            }
+
+            for (; previousState != previous->end(); ++previousState)
+            {
+                scene::Actor* actor = getActor(previousState->id);
+                actors.erase(previousState->id);
+                if (removeHandler) removeHandler(previousState->id, actor);
+            }
+
+            Snapshot& snapshot = history[snapshotTick % HISTORY_SIZE];
+            snapshot.tick = snapshotTick;
+            snapshot.states.swap(states);
+            lastReceivedTick = snapshotTick;
+
+            ack.resize(5);
+            ack[0] = ACK_MESSAGE;
+            ack[1] = static_cast<uint8_t>(snapshotTick);
+            ack[2] = static_cast<uint8_t>(snapshotTick >> 8);
+            ack[3] = static_cast<uint8_t>(snapshotTick >> 16);
+            ack[4] = static_cast<uint8_t>(snapshotTick >> 24);
+            client->send(ack);
+
+            return true;
+        }
+
+        void Replicator::receiveAck(Client* client, const std::vector<uint8_t>& data)
+        {
+            if (data.size() < 5) return;
+
+            uint32_t ackedTick = static_cast<uint32_t>(data[1]) |
+                static_cast<uint32_t>(data[2]) << 8 |
+                static_cast<uint32_t>(data[3]) << 16 |
+                static_cast<uint32_t>(data[4]) << 24;
+
+            for (ClientRecord& record : clients)
+            {
+                if (record.client == client &&
+                    (record.ackedTick == INVALID_TICK || static_cast<int32_t>(ackedTick - record.ackedTick) > 0))
+                {
+                    record.ackedTick = ackedTick;
+                }
+            }
+        }
+    } // namespace network
+} // namespace ouzel
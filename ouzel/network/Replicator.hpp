@@ -0,0 +1,116 @@
+// Copyright (C) 2018 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <vector>
+#include "utils/Noncopyable.hpp"
+
+namespace ouzel
+{
+    namespace scene
+    {
+        class Actor;
+    }
+
+    namespace network
+    {
+        class BitWriter;
+        class Client;
+
+        // replicates the position, rotation, scale, opacity and flags of actors, the sender quantizes the actors
+        // that are dirty and sends every client a bit-packed delta against the last snapshot the client acknowledged
+        class Replicator: public Noncopyable
+        {
+        public:
+            // first bytes of the replication messages, the application's own messages must not start with them
+            static const uint8_t SNAPSHOT_MESSAGE = 0xFE;
+            static const uint8_t ACK_MESSAGE = 0xFF;
+            // number of sent snapshots that can serve as a baseline
+            static const uint32_t HISTORY_SIZE = 32;
+
+            Replicator();
+
+            // the same id has to be used on both ends
+            bool addActor(uint32_t id, scene::Actor* actor);
+            bool removeActor(uint32_t id);
+            scene::Actor* getActor(uint32_t id) const;
+
+            void addClient(Client* client);
+            void removeClient(Client* client);
+
+            // sender, called once per network tick
+            void update();
+
+            // returns true if the message was a replication message
+            bool handleMessage(Client* client, const std::vector<uint8_t>& data);
+
+            // receiver, called for actors that are not registered and actors that were removed by the sender
+            std::function<scene::Actor*(uint32_t)> createHandler;
+            std::function<void(uint32_t, scene::Actor*)> removeHandler;
+
+            uint32_t getTick() const { return tick; }
+            uint64_t getLastTickBytes() const { return lastTickBytes; }
+            uint64_t getTotalBytes() const { return totalBytes; }
+            uint32_t getFullSnapshotCount() const { return fullSnapshotCount; }
+
+        private:
+            // the fields are sent as Actor::DirtyFields, with an extra bit for removed actors
+            static const uint32_t FIELD_REMOVED = 0x20;
+            static const uint32_t FIELD_BITS = 6;
+            static const uint32_t INVALID_TICK = 0xFFFFFFFF;
+
+            struct State
+            {
+                uint32_t id = 0;
+                int32_t position[3] = {0, 0, 0};
+                uint32_t rotation = 0;
+                int32_t scale[3] = {0, 0, 0};
+                uint32_t opacity = 0;
+                uint32_t flags = 0;
+            };
+
+            struct Snapshot
+            {
+                uint32_t tick = INVALID_TICK;
+                std::vector<State> states;
+            };
+
+            struct ActorRecord
+            {
+                scene::Actor* actor;
+                State state;
+            };
+
+            struct ClientRecord
+            {
+                Client* client;
+                uint32_t ackedTick;
+            };
+
+            static void quantize(scene::Actor* actor, State& state);
+            static void apply(const State& state, uint32_t fields, scene::Actor* actor);
+            static uint32_t compare(const State& a, const State& b);
+            static void encode(const std::vector<State>& baseline, const std::vector<State>& current, BitWriter& writer);
+
+            bool receiveSnapshot(Client* client, const std::vector<uint8_t>& data);
+            void receiveAck(Client* client, const std::vector<uint8_t>& data);
+
+            std::map<uint32_t, ActorRecord> actors;
+            std::vector<ClientRecord> clients;
+
+            // snapshots sent by the sender or received by the receiver, indexed by the tick
+            std::vector<Snapshot> history;
+            uint32_t tick = 0;
+            uint32_t lastReceivedTick = INVALID_TICK;
+
+            std::vector<uint8_t> ack;
+            uint64_t lastTickBytes = 0;
+            uint64_t totalBytes = 0;
+            uint32_t fullSnapshotCount = 0;
+        };
+    } // namespace network
+} // namespace ouzel
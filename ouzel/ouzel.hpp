@@ -25,9 +25,11 @@
 #include "assets/LoaderTTF.hpp"
 #include "assets/LoaderVorbis.hpp"
 #include "assets/LoaderWave.hpp"
+#include "assets/TextureAtlas.hpp"
 #include "audio/Audio.hpp"
 #include "audio/Listener.hpp"
 #include "audio/Mixer.hpp"
+#include "audio/Resampler.hpp"
 #include "audio/Sound.hpp"
 #include "audio/SoundData.hpp"
 #include "audio/SoundDataVorbis.hpp"
@@ -43,6 +45,7 @@
 #include "events/EventDispatcher.hpp"
 #include "events/EventHandler.hpp"
 #include "files/FileSystem.hpp"
+#include "files/MappedFile.hpp"
 #include "graphics/BlendState.hpp"
 #include "graphics/BlendStateResource.hpp"
 #include "graphics/ImageData.hpp"
@@ -66,12 +69,14 @@
 #include "gui/ComboBox.hpp"
 #include "gui/EditBox.hpp"
 #include "gui/Label.hpp"
+#include "gui/ListView.hpp"
 #include "gui/Menu.hpp"
 #include "gui/RadioButton.hpp"
 #include "gui/RadioButtonGroup.hpp"
 #include "gui/ScrollBar.hpp"
 #include "gui/SlideBar.hpp"
 #include "gui/Widget.hpp"
+#include "gui/WidgetBatch.hpp"
 #include "input/Cursor.hpp"
 #include "input/CursorResource.hpp"
 #include "input/Gamepad.hpp"
@@ -81,6 +86,7 @@
 #include "math/Box3.hpp"
 #include "math/Color.hpp"
 #include "math/ConvexVolume.hpp"
+#include "math/MathBatch.hpp"
 #include "math/MathUtils.hpp"
 #include "math/Matrix3.hpp"
 #include "math/Matrix4.hpp"
@@ -93,12 +99,18 @@
 #include "math/Vector3.hpp"
 #include "math/Vector4.hpp"
 #include "network/Network.hpp"
+#include "network/Client.hpp"
+#include "network/MessageQueue.hpp"
+#include "network/BitStream.hpp"
+#include "network/Replicator.hpp"
 #include "scene/Actor.hpp"
 #include "scene/ActorContainer.hpp"
 #include "scene/Camera.hpp"
 #include "scene/Component.hpp"
+#include "scene/DebugRenderer.hpp"
 #include "scene/Layer.hpp"
 #include "scene/Light.hpp"
+#include "scene/LightGrid.hpp"
 #include "scene/ModelData.hpp"
 #include "scene/ModelRenderer.hpp"
 #include "scene/ParticleSystemData.hpp"
@@ -111,7 +123,13 @@
 #include "scene/TextRenderer.hpp"
 #include "utils/INI.hpp"
 #include "utils/JSON.hpp"
+#include "utils/JSONDocument.hpp"
+#include "utils/JSONReader.hpp"
+#include "utils/LatencyHistogram.hpp"
 #include "utils/Log.hpp"
 #include "utils/OBF.hpp"
+#include "utils/OBFView.hpp"
+#include "utils/StringView.hpp"
 #include "utils/Utils.hpp"
 #include "utils/XML.hpp"
+#include "utils/XMLReader.hpp"
@@ -85,7 +85,7 @@ namespace ouzel
                     component->draw(transform,
                                     opacity,
                                     camera->getRenderViewProjection(),
-                                    camera->getRenderTarget(),
+                                    camera->getDrawTarget(),
                                     camera->getRenderViewport(),
                                     camera->getDepthWrite(),
                                     camera->getDepthTest(),
@@ -106,26 +106,32 @@ namespace ouzel
             }
         }
 
+        void Actor::setOrder(int32_t newOrder)
+        {
+            order = newOrder;
+            if (layer) layer->invalidateCache();
+        }
+
         void Actor::setPosition(const Vector2& newPosition)
         {
             position.x = newPosition.x;
             position.y = newPosition.y;
 
-            updateLocalTransform();
+            updateLocalTransform(DIRTY_POSITION);
         }
 
         void Actor::setPosition(const Vector3& newPosition)
         {
             position = newPosition;
 
-            updateLocalTransform();
+            updateLocalTransform(DIRTY_POSITION);
         }
 
         void Actor::setRotation(const Quaternion& newRotation)
         {
             rotation = newRotation;
 
-            updateLocalTransform();
+            updateLocalTransform(DIRTY_ROTATION);
         }
 
         void Actor::setRotation(const Vector3& newRotation)
@@ -135,7 +141,7 @@ namespace ouzel
 
             rotation = roationQuaternion;
 
-            updateLocalTransform();
+            updateLocalTransform(DIRTY_ROTATION);
         }
 
         void Actor::setRotation(float newRotation)
@@ -145,7 +151,7 @@ namespace ouzel
 
             rotation = roationQuaternion;
 
-            updateLocalTransform();
+            updateLocalTransform(DIRTY_ROTATION);
         }
 
         void Actor::setScale(const Vector2& newScale)
@@ -153,38 +159,48 @@ namespace ouzel
             scale.x = newScale.x;
             scale.y = newScale.y;
 
-            updateLocalTransform();
+            updateLocalTransform(DIRTY_SCALE);
         }
 
         void Actor::setScale(const Vector3& newScale)
         {
             scale = newScale;
 
-            updateLocalTransform();
+            updateLocalTransform(DIRTY_SCALE);
         }
 
         void Actor::setOpacity(float newOpacity)
         {
             opacity = clamp(newOpacity, 0.0f, 1.0f);
+            dirtyFields |= DIRTY_OPACITY;
+            if (layer) layer->invalidateCache();
         }
 
         void Actor::setFlipX(bool newFlipX)
         {
             flipX = newFlipX;
 
-            updateLocalTransform();
+            updateLocalTransform(DIRTY_FLAGS);
         }
 
         void Actor::setFlipY(bool newFlipY)
         {
             flipY = newFlipY;
 
-            updateLocalTransform();
+            updateLocalTransform(DIRTY_FLAGS);
         }
 
         void Actor::setHidden(bool newHidden)
         {
             hidden = newHidden;
+            dirtyFields |= DIRTY_FLAGS;
+            if (layer) layer->invalidateCache();
+        }
+
+        void Actor::setCullDisabled(bool newCullDisabled)
+        {
+            cullDisabled = newCullDisabled;
+            if (layer) layer->invalidateCache();
         }
 
         bool Actor::pointOn(const Vector2& worldPosition) const
@@ -228,9 +244,11 @@ namespace ouzel
             return false;
         }
 
-        void Actor::updateLocalTransform()
+        void Actor::updateLocalTransform(uint32_t fields)
         {
             localTransformDirty = transformDirty = inverseTransformDirty = true;
+            dirtyFields |= fields;
+            if (layer) layer->invalidateCache();
             for (Component* component : components)
             {
                 component->updateTransform();
@@ -249,10 +267,10 @@ namespace ouzel
 
         Vector3 Actor::getWorldPosition() const
         {
-            Vector3 result = position;
+            Vector3 result;
             getTransform().transformPoint(result);
 
-            return position;
+            return result;
         }
 
         Vector3 Actor::convertWorldToLocal(const Vector3& worldPosition) const
@@ -277,22 +295,58 @@ namespace ouzel
 
         void Actor::calculateLocalTransform() const
         {
-            localTransform.setIdentity();
-            localTransform.translate(position);
-            localTransform *= rotation.getMatrix();
-
-            Vector3 realScale = Vector3(scale.x * (flipX ? -1.0f : 1.0f),
-                                        scale.y * (flipY ? -1.0f : 1.0f),
-                                        scale.z);
-
-            localTransform.scale(realScale);
+            // translation * rotation * scale written out directly, the columns of the rotation matrix are scaled
+            float scaleX = scale.x * (flipX ? -1.0f : 1.0f);
+            float scaleY = scale.y * (flipY ? -1.0f : 1.0f);
+            float scaleZ = scale.z;
+
+            float wx = rotation.w * rotation.x;
+            float wy = rotation.w * rotation.y;
+            float wz = rotation.w * rotation.z;
+            float xx = rotation.x * rotation.x;
+            float xy = rotation.x * rotation.y;
+            float xz = rotation.x * rotation.z;
+            float yy = rotation.y * rotation.y;
+            float yz = rotation.y * rotation.z;
+            float zz = rotation.z * rotation.z;
+
+            localTransform.m[0] = (1.0f - 2.0f * (yy + zz)) * scaleX;
+            localTransform.m[1] = 2.0f * (xy + wz) * scaleX;
+            localTransform.m[2] = 2.0f * (xz - wy) * scaleX;
+            localTransform.m[3] = 0.0f;
+
+            localTransform.m[4] = 2.0f * (xy - wz) * scaleY;
+            localTransform.m[5] = (1.0f - 2.0f * (xx + zz)) * scaleY;
+            localTransform.m[6] = 2.0f * (yz + wx) * scaleY;
+            localTransform.m[7] = 0.0f;
+
+            localTransform.m[8] = 2.0f * (xz + wy) * scaleZ;
+            localTransform.m[9] = 2.0f * (yz - wx) * scaleZ;
+            localTransform.m[10] = (1.0f - 2.0f * (xx + yy)) * scaleZ;
+            localTransform.m[11] = 0.0f;
+
+            localTransform.m[12] = position.x;
+            localTransform.m[13] = position.y;
+            localTransform.m[14] = position.z;
+            localTransform.m[15] = 1.0f;
 
             localTransformDirty = false;
         }
 
         void Actor::calculateTransform() const
         {
-            transform = parentTransform * getLocalTransform();
+            const Matrix4& currentLocalTransform = getLocalTransform();
+
+            // the local transform is always affine
+            if (parentTransform.isAffine())
+            {
+                Matrix4::multiplyAffine(parentTransform, currentLocalTransform, transform);
+            }
+            else
+            {
+                Matrix4::multiply(parentTransform, currentLocalTransform, transform);
+            }
+
             transformDirty = false;
 
             updateChildrenTransform = true;
@@ -319,6 +373,7 @@ namespace ouzel
 
             component->setActor(this);
             components.push_back(component);
+            if (layer) layer->invalidateCache();
         }
 
         bool Actor::removeChildComponent(Component* component)
@@ -331,6 +386,7 @@ namespace ouzel
             {
                 component->setActor(nullptr);
                 components.erase(componentIterator);
+                if (layer) layer->invalidateCache();
                 result = true;
             }
 
@@ -348,6 +404,7 @@ namespace ouzel
 
         void Actor::removeAllComponents()
         {
+            if (layer) layer->invalidateCache();
             components.clear();
             ownedComponents.clear();
         }
@@ -27,6 +27,17 @@ namespace ouzel
             friend ActorContainer;
             friend Layer;
         public:
+            // fields that have changed since the last clearDirtyFields call, used by the replication
+            enum DirtyFields
+            {
+                DIRTY_POSITION = 0x01,
+                DIRTY_ROTATION = 0x02,
+                DIRTY_SCALE = 0x04,
+                DIRTY_OPACITY = 0x08,
+                DIRTY_FLAGS = 0x10,
+                DIRTY_ALL = 0x1F
+            };
+
             Actor();
             virtual ~Actor();
 
@@ -42,7 +53,7 @@ namespace ouzel
             virtual void setPosition(const Vector3& newPosition);
             virtual const Vector3& getPosition() const { return position; }
 
-            void setOrder(int32_t newOrder) { order = newOrder; }
+            void setOrder(int32_t newOrder);
             int32_t getOrder() const { return order; }
 
             virtual void setRotation(const Quaternion& newRotation);
@@ -67,7 +78,7 @@ namespace ouzel
             virtual bool isPickable() const { return pickable; }
 
             virtual bool isCullDisabled() const { return cullDisabled; }
-            virtual void setCullDisabled(bool newCullDisabled) { cullDisabled = newCullDisabled; }
+            virtual void setCullDisabled(bool newCullDisabled);
 
             virtual void setHidden(bool newHidden);
             virtual bool isHidden() const { return hidden; }
@@ -147,6 +158,9 @@ namespace ouzel
 
             Box3 getBoundingBox() const;
 
+            uint32_t getDirtyFields() const { return dirtyFields; }
+            void clearDirtyFields() { dirtyFields = 0; }
+
         protected:
             virtual void addChildActor(Actor* actor) override;
             void addChildComponent(Component* component);
@@ -154,7 +168,7 @@ namespace ouzel
 
             virtual void setLayer(Layer* newLayer) override;
 
-            void updateLocalTransform();
+            void updateLocalTransform(uint32_t fields);
             void updateTransform(const Matrix4& newParentTransform);
 
             virtual void calculateLocalTransform() const;
@@ -171,6 +185,7 @@ namespace ouzel
             mutable bool inverseTransformDirty = true;
             mutable bool localTransformDirty = true;
             mutable bool updateChildrenTransform = true;
+            uint32_t dirtyFields = DIRTY_ALL;
 
             bool flipX = false;
             bool flipY = false;
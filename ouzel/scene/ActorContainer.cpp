@@ -4,6 +4,7 @@
 #include <algorithm>
 #include "ActorContainer.hpp"
 #include "Actor.hpp"
+#include "Layer.hpp"
 
 namespace ouzel
 {
@@ -36,6 +37,7 @@ namespace ouzel
                 actor->setLayer(layer);
                 if (entered) actor->enter();
                 children.push_back(actor);
+                if (layer) layer->invalidateCache();
             }
         }
 
@@ -47,6 +49,7 @@ namespace ouzel
 
             if (childIterator != children.end())
             {
+                if (layer) layer->invalidateCache();
                 if (entered) actor->leave();
                 actor->parent = nullptr;
                 actor->setLayer(nullptr);
@@ -74,6 +77,7 @@ namespace ouzel
             if (i != children.end())
             {
                 std::rotate(children.begin(), i, i + 1);
+                if (layer) layer->invalidateCache();
 
                 return true;
             }
@@ -88,6 +92,7 @@ namespace ouzel
             if (i != children.end())
             {
                 std::rotate(i, i + 1, children.end());
+                if (layer) layer->invalidateCache();
 
                 return true;
             }
@@ -97,6 +102,8 @@ namespace ouzel
 
         void ActorContainer::removeAllChildren()
         {
+            if (layer) layer->invalidateCache();
+
             for (auto& actor : children)
             {
                 if (entered) actor->leave();
@@ -8,8 +8,11 @@
 #include "graphics/Renderer.hpp"
 #include "graphics/RenderDevice.hpp"
 #include "Layer.hpp"
+#include "assets/Cache.hpp"
 #include "graphics/TextureResource.hpp"
 #include "math/Matrix4.hpp"
+#include "utils/Log.hpp"
+#include "utils/Utils.hpp"
 
 namespace ouzel
 {
@@ -65,6 +68,7 @@ namespace ouzel
             Component::updateTransform();
 
             viewProjectionDirty = inverseViewProjectionDirty = true;
+            cacheValid = false;
         }
 
         void Camera::recalculateProjection()
@@ -134,6 +138,7 @@ namespace ouzel
             }
 
             viewProjectionDirty = inverseViewProjectionDirty = true;
+            cacheValid = false;
         }
 
         const Matrix4& Camera::getViewProjection() const
@@ -177,7 +182,7 @@ namespace ouzel
 
                 renderViewProjection = viewProjection;
 
-                renderViewProjection = engine->getRenderer()->getDevice()->getProjectionTransform(renderTarget != nullptr) * renderViewProjection;
+                renderViewProjection = engine->getRenderer()->getDevice()->getProjectionTransform(getDrawTarget() != nullptr) * renderViewProjection;
 
                 viewProjectionDirty = false;
             }
@@ -287,7 +292,115 @@ namespace ouzel
         void Camera::setRenderTarget(const std::shared_ptr<graphics::Texture>& newRenderTarget)
         {
             renderTarget = newRenderTarget;
+            if (renderTarget) cacheTexture.reset();
             recalculateProjection();
         }
+
+        void Camera::setCacheEnabled(bool newCacheEnabled)
+        {
+            cacheEnabled = newCacheEnabled;
+            cacheValid = false;
+
+            if (!cacheEnabled)
+            {
+                cacheTexture.reset();
+                cacheMeshBuffer.reset();
+                viewProjectionDirty = true;
+            }
+        }
+
+        bool Camera::createCache()
+        {
+            // a render target keeps its content in the frames nothing is drawn to it
+            if (renderTarget) return true;
+
+            Size2 size = engine->getRenderer()->getSize();
+            uint32_t flags = graphics::Texture::RENDER_TARGET |
+                ((depthWrite || depthTest) ? graphics::Texture::DEPTH_BUFFER : 0);
+
+            if (!cacheTexture || cacheTexture->getSize() != size || cacheTexture->getFlags() != flags)
+            {
+                cacheTexture = std::make_shared<graphics::Texture>();
+                if (!cacheTexture->init(size, flags, 1))
+                {
+                    Log(Log::Level::ERR) << "Failed to create camera cache texture";
+                    cacheTexture.reset();
+                    viewProjectionDirty = true;
+                    return false;
+                }
+
+                cacheTexture->setFilter(graphics::Texture::Filter::POINT);
+                // alpha blending into a transparent texture leaves premultiplied colors, drawCache composites them as such
+                cacheTexture->setClearColor(Color(0, 0, 0, 0));
+                cacheMeshBuffer.reset();
+                viewProjectionDirty = true;
+            }
+
+            if (!cacheMeshBuffer || cacheViewport != renderViewport)
+            {
+                cacheViewport = renderViewport;
+
+                // the quad covers the viewport, the texture coordinates select the same area of the cache texture
+                float left = renderViewport.position.x / size.width;
+                float right = (renderViewport.position.x + renderViewport.size.width) / size.width;
+                float top = renderViewport.position.y / size.height;
+                float bottom = (renderViewport.position.y + renderViewport.size.height) / size.height;
+
+                const uint16_t indices[] = {0, 1, 2, 1, 3, 2};
+                const graphics::Vertex vertices[] = {
+                    graphics::Vertex(Vector3(-1.0f, -1.0f, 0.0f), Color::WHITE, Vector2(left, bottom), Vector3(0.0f, 0.0f, -1.0f)),
+                    graphics::Vertex(Vector3(1.0f, -1.0f, 0.0f), Color::WHITE, Vector2(right, bottom), Vector3(0.0f, 0.0f, -1.0f)),
+                    graphics::Vertex(Vector3(-1.0f, 1.0f, 0.0f), Color::WHITE, Vector2(left, top), Vector3(0.0f, 0.0f, -1.0f)),
+                    graphics::Vertex(Vector3(1.0f, 1.0f, 0.0f), Color::WHITE, Vector2(right, top), Vector3(0.0f, 0.0f, -1.0f))
+                };
+
+                std::shared_ptr<graphics::Buffer> indexBuffer = std::make_shared<graphics::Buffer>();
+                std::shared_ptr<graphics::Buffer> vertexBuffer = std::make_shared<graphics::Buffer>();
+                cacheMeshBuffer = std::make_shared<graphics::MeshBuffer>();
+
+                if (!indexBuffer->init(graphics::Buffer::Usage::INDEX, indices, sizeof(indices)) ||
+                    !vertexBuffer->init(graphics::Buffer::Usage::VERTEX, vertices, sizeof(vertices)) ||
+                    !cacheMeshBuffer->init(sizeof(uint16_t), indexBuffer, vertexBuffer))
+                {
+                    Log(Log::Level::ERR) << "Failed to create camera cache mesh buffer";
+                    cacheMeshBuffer.reset();
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        void Camera::drawCache()
+        {
+            if (!cacheTexture || !cacheMeshBuffer) return;
+
+            Matrix4 modelViewProj = engine->getRenderer()->getDevice()->getProjectionTransform(false);
+            float colorVector[] = {1.0f, 1.0f, 1.0f, 1.0f};
+
+            std::vector<std::vector<float>> pixelShaderConstants(1);
+            pixelShaderConstants[0] = {std::begin(colorVector), std::end(colorVector)};
+
+            std::vector<std::vector<float>> vertexShaderConstants(1);
+            vertexShaderConstants[0] = {std::begin(modelViewProj.m), std::end(modelViewProj.m)};
+
+            engine->getRenderer()->addDrawCommand({cacheTexture},
+                                                  engine->getCache()->getShader(graphics::SHADER_TEXTURE),
+                                                  pixelShaderConstants,
+                                                  vertexShaderConstants,
+                                                  engine->getCache()->getBlendState(graphics::BLEND_PREMULTIPLIED_ALPHA),
+                                                  cacheMeshBuffer,
+                                                  6,
+                                                  graphics::Renderer::DrawMode::TRIANGLE_LIST,
+                                                  0,
+                                                  nullptr,
+                                                  renderViewport,
+                                                  false,
+                                                  false,
+                                                  false,
+                                                  false,
+                                                  Rectangle(),
+                                                  graphics::Renderer::CullMode::NONE);
+        }
     } // namespace scene
 } // namespace ouzel
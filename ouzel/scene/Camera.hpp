@@ -5,8 +5,10 @@
 
 #include <memory>
 #include "scene/Component.hpp"
+#include "scene/LightGrid.hpp"
 #include "math/MathUtils.hpp"
 #include "math/Rectangle.hpp"
+#include "graphics/MeshBuffer.hpp"
 #include "graphics/Texture.hpp"
 
 namespace ouzel
@@ -83,12 +85,27 @@ namespace ouzel
             const std::shared_ptr<graphics::Texture>& getRenderTarget() const { return renderTarget; }
 
             bool getDepthWrite() const { return depthWrite; }
-            void setDepthWrite(bool newDepthWrite) { depthWrite = newDepthWrite; }
+            void setDepthWrite(bool newDepthWrite) { depthWrite = newDepthWrite; cacheValid = false; }
             bool getDepthTest() const { return depthTest; }
-            void setDepthTest(bool newDepthTest) { depthTest = newDepthTest; }
+            void setDepthTest(bool newDepthTest) { depthTest = newDepthTest; cacheValid = false; }
 
             bool getWireframe() const { return wireframe; }
-            void setWireframe(bool newWireframe) { wireframe = newWireframe; }
+            void setWireframe(bool newWireframe) { wireframe = newWireframe; cacheValid = false; }
+
+            // lights of the layer culled against the tiles of this camera, rebuilt every frame
+            const LightGrid& getLightGrid() const { return lightGrid; }
+
+            // keeps the rendered layer and redraws the actors only after something in the layer has changed,
+            // a camera without a render target renders into its own texture and draws it as a single quad
+            bool isCacheEnabled() const { return cacheEnabled; }
+            void setCacheEnabled(bool newCacheEnabled);
+            void invalidateCache() { cacheValid = false; }
+
+            uint32_t getCacheSkippedFrames() const { return cacheSkippedFrames; }
+            uint32_t getCacheInvalidations() const { return cacheInvalidations; }
+
+            // texture the actors are rendered into, the cache texture if it is used or the render target otherwise
+            const std::shared_ptr<graphics::Texture>& getDrawTarget() const { return cacheTexture ? cacheTexture : renderTarget; }
 
         protected:
             virtual void setActor(Actor* newActor) override;
@@ -97,6 +114,9 @@ namespace ouzel
             virtual void updateTransform() override;
             void calculateViewProjection() const;
 
+            bool createCache();
+            void drawCache();
+
             Type type;
             float fov = TAU / 6.0f;
             float nearPlane = 1.0f;
@@ -125,6 +145,17 @@ namespace ouzel
             mutable Matrix4 inverseViewProjection;
 
             std::shared_ptr<graphics::Texture> renderTarget;
+
+            LightGrid lightGrid;
+
+            bool cacheEnabled = false;
+            bool cacheValid = false;
+            uint32_t cacheChangeCount = 0;
+            uint32_t cacheSkippedFrames = 0;
+            uint32_t cacheInvalidations = 0;
+            std::shared_ptr<graphics::Texture> cacheTexture;
+            std::shared_ptr<graphics::MeshBuffer> cacheMeshBuffer;
+            Rectangle cacheViewport;
         };
     } // namespace scene
 } // namespace ouzel
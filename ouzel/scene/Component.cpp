@@ -3,6 +3,7 @@
 
 #include "Component.hpp"
 #include "Actor.hpp"
+#include "Layer.hpp"
 #include "math/MathUtils.hpp"
 
 namespace ouzel
@@ -97,6 +98,18 @@ namespace ouzel
             return true;
         }
 
+        void Component::setHidden(bool newHidden)
+        {
+            hidden = newHidden;
+            contentChanged();
+        }
+
+        void Component::contentChanged()
+        {
+            ++changeCount;
+            if (layer) layer->invalidateCache();
+        }
+
         void Component::removeFromActor()
         {
             if (actor) actor->removeComponent(this);
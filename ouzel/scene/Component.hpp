@@ -36,7 +36,8 @@ namespace ouzel
                 SOUND = 7,
                 SPRITE = 8,
                 TEXT_RENDERER = 9,
-                LIGHT = 10
+                LIGHT = 10,
+                DEBUG_RENDERER = 11
             };
 
             Component(uint32_t initType);
@@ -62,12 +63,18 @@ namespace ouzel
             virtual bool shapeOverlaps(const std::vector<Vector2>& edges) const;
 
             bool isHidden() const { return hidden; }
-            void setHidden(bool newHidden) { hidden = newHidden; }
+            void setHidden(bool newHidden);
 
             Actor* getActor() const { return actor; }
             void removeFromActor();
 
+            // incremented every time the drawn content of the component changes
+            uint32_t getChangeCount() const { return changeCount; }
+
         protected:
+            // bumps the change count and invalidates the cache of the layer
+            void contentChanged();
+
             virtual void setActor(Actor* newActor);
             virtual void setLayer(Layer* newLayer);
             virtual void updateTransform();
@@ -76,6 +83,7 @@ namespace ouzel
 
             Box3 boundingBox;
             bool hidden = false;
+            uint32_t changeCount = 0;
 
             Layer* layer = nullptr;
             Actor* actor = nullptr;
@@ -0,0 +1,320 @@
+// Copyright (C) 2018 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#include <cmath>
+#include "DebugRenderer.hpp"
+#include "core/Engine.hpp"
+#include "assets/Cache.hpp"
+#include "math/MathUtils.hpp"
+#include "utils/Log.hpp"
+#include "utils/Utils.hpp"
+
+namespace ouzel
+{
+    namespace scene
+    {
+        DebugRenderer::DebugRenderer():
+            Component(TYPE),
+            updateCallback(UpdateCallback::PRIORITY_MAX + 1)
+        {
+            shader = engine->getCache()->getShader(graphics::SHADER_COLOR);
+            blendState = engine->getCache()->getBlendState(graphics::BLEND_ALPHA);
+
+            updateCallback.callback = std::bind(&DebugRenderer::update, this, std::placeholders::_1);
+            engine->scheduleUpdate(&updateCallback);
+        }
+
+        void DebugRenderer::draw(const Matrix4& transformMatrix,
+                                 float opacity,
+                                 const Matrix4& renderViewProjection,
+                                 const std::shared_ptr<graphics::Texture>& renderTarget,
+                                 const Rectangle& renderViewport,
+                                 bool depthWrite,
+                                 bool depthTest,
+                                 bool wireframe,
+                                 bool scissorTest,
+                                 const Rectangle& scissorRectangle)
+        {
+            Component::draw(transformMatrix,
+                            opacity,
+                            renderViewProjection,
+                            renderTarget,
+                            renderViewport,
+                            depthWrite,
+                            depthTest,
+                            wireframe,
+                            scissorTest,
+                            scissorRectangle);
+
+            Matrix4 modelViewProj = renderViewProjection * transformMatrix;
+            Matrix4 screenProjection;
+            Matrix4::createOrthographicOffCenter(0.0f, renderViewport.size.width, 0.0f, renderViewport.size.height,
+                                                 -1.0f, 1.0f, screenProjection);
+
+            std::vector<std::vector<float>> pixelShaderConstants(1);
+            pixelShaderConstants[0] = {1.0f, 1.0f, 1.0f, opacity};
+
+            for (uint32_t i = 0; i < BATCH_COUNT; ++i)
+            {
+                Batch& batch = batches[i];
+                if (batch.indices.empty()) continue;
+
+                if (!batch.meshBuffer)
+                {
+                    batch.indexBuffer = std::make_shared<graphics::Buffer>();
+                    batch.indexBuffer->init(graphics::Buffer::Usage::INDEX, graphics::Buffer::DYNAMIC);
+
+                    batch.vertexBuffer = std::make_shared<graphics::Buffer>();
+                    batch.vertexBuffer->init(graphics::Buffer::Usage::VERTEX, graphics::Buffer::DYNAMIC);
+
+                    batch.meshBuffer = std::make_shared<graphics::MeshBuffer>();
+                    batch.meshBuffer->init(sizeof(uint32_t), batch.indexBuffer, batch.vertexBuffer);
+                }
+
+                // uploaded once per frame, even if there are several cameras
+                if (batch.dirty)
+                {
+                    batch.indexBuffer->setData(batch.indices.data(), static_cast<uint32_t>(getVectorSize(batch.indices)));
+                    batch.vertexBuffer->setData(batch.vertices.data(), static_cast<uint32_t>(getVectorSize(batch.vertices)));
+                    batch.dirty = false;
+                }
+
+                bool triangles = (i & 0x01) != 0;
+                uint32_t flags = i >> 1;
+                const Matrix4& matrix = (flags & SCREEN_SPACE) ? screenProjection : modelViewProj;
+
+                std::vector<std::vector<float>> vertexShaderConstants(1);
+                vertexShaderConstants[0] = {std::begin(matrix.m), std::end(matrix.m)};
+
+                engine->getRenderer()->addDrawCommand(std::vector<std::shared_ptr<graphics::Texture>>(),
+                                                      shader,
+                                                      pixelShaderConstants,
+                                                      vertexShaderConstants,
+                                                      blendState,
+                                                      batch.meshBuffer,
+                                                      static_cast<uint32_t>(batch.indices.size()),
+                                                      triangles ? graphics::Renderer::DrawMode::TRIANGLE_LIST : graphics::Renderer::DrawMode::LINE_LIST,
+                                                      0,
+                                                      renderTarget,
+                                                      renderViewport,
+                                                      false,
+                                                      (flags & DEPTH_TEST) != 0,
+                                                      wireframe,
+                                                      scissorTest,
+                                                      scissorRectangle,
+                                                      graphics::Renderer::CullMode::NONE);
+            }
+        }
+
+        void DebugRenderer::clear()
+        {
+            bool changed = false;
+
+            // keeps the capacity of the vectors for the next frame
+            for (Batch& batch : batches)
+            {
+                if (batch.indices.empty()) continue;
+
+                batch.indices.clear();
+                batch.vertices.clear();
+                batch.dirty = true;
+                changed = true;
+            }
+
+            if (changed) contentChanged();
+        }
+
+        void DebugRenderer::line(const Vector3& start, const Vector3& finish, const Color& color, uint32_t flags)
+        {
+            Batch& batch = getBatch(false, flags);
+            uint32_t startVertex = static_cast<uint32_t>(batch.vertices.size());
+
+            batch.vertices.push_back(graphics::Vertex(start, color, Vector2(), Vector3(0.0f, 0.0f, -1.0f)));
+            batch.vertices.push_back(graphics::Vertex(finish, color, Vector2(), Vector3(0.0f, 0.0f, -1.0f)));
+            batch.indices.push_back(startVertex);
+            batch.indices.push_back(startVertex + 1);
+        }
+
+        void DebugRenderer::lines(const Vector3* points, uint32_t count, const Color& color, uint32_t flags)
+        {
+            count &= ~1U;
+            if (count == 0) return;
+
+            Batch& batch = getBatch(false, flags);
+            uint32_t startVertex = static_cast<uint32_t>(batch.vertices.size());
+
+            batch.vertices.reserve(batch.vertices.size() + count);
+            batch.indices.reserve(batch.indices.size() + count);
+
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                batch.vertices.push_back(graphics::Vertex(points[i], color, Vector2(), Vector3(0.0f, 0.0f, -1.0f)));
+                batch.indices.push_back(startVertex + i);
+            }
+        }
+
+        void DebugRenderer::circle(const Vector3& position, float radius, const Color& color,
+                                   bool fill, uint32_t segments, uint32_t flags)
+        {
+            if (radius < 0.0f || segments < 3) return;
+
+            const std::vector<Vector2>& unitCircle = getUnitCircle(segments);
+            segments = static_cast<uint32_t>(unitCircle.size());
+
+            Batch& batch = getBatch(fill, flags);
+            uint32_t startVertex = static_cast<uint32_t>(batch.vertices.size());
+
+            if (fill)
+            {
+                batch.vertices.push_back(graphics::Vertex(position, color, Vector2(), Vector3(0.0f, 0.0f, -1.0f)));
+                ++startVertex;
+            }
+
+            for (const Vector2& point : unitCircle)
+            {
+                batch.vertices.push_back(graphics::Vertex(Vector3(position.x + radius * point.x,
+                                                                  position.y + radius * point.y,
+                                                                  position.z),
+                                                          color, Vector2(), Vector3(0.0f, 0.0f, -1.0f)));
+            }
+
+            for (uint32_t i = 0; i < segments; ++i)
+            {
+                if (fill) batch.indices.push_back(startVertex - 1); // center
+                batch.indices.push_back(startVertex + i);
+                batch.indices.push_back(startVertex + (i + 1) % segments);
+            }
+        }
+
+        void DebugRenderer::rectangle(const Rectangle& rectangle, const Color& color, bool fill, uint32_t flags)
+        {
+            polygon({Vector2(rectangle.left(), rectangle.bottom()),
+                     Vector2(rectangle.right(), rectangle.bottom()),
+                     Vector2(rectangle.right(), rectangle.top()),
+                     Vector2(rectangle.left(), rectangle.top())}, color, fill, flags);
+        }
+
+        void DebugRenderer::polygon(const std::vector<Vector2>& edges, const Color& color, bool fill, uint32_t flags)
+        {
+            if (edges.size() < 3) return;
+
+            Batch& batch = getBatch(fill, flags);
+            uint32_t startVertex = static_cast<uint32_t>(batch.vertices.size());
+            uint32_t count = static_cast<uint32_t>(edges.size());
+
+            for (const Vector2& edge : edges)
+            {
+                batch.vertices.push_back(graphics::Vertex(edge, color, Vector2(), Vector3(0.0f, 0.0f, -1.0f)));
+            }
+
+            if (fill)
+            {
+                // triangle fan, the polygon has to be convex
+                for (uint32_t i = 1; i < count - 1; ++i)
+                {
+                    batch.indices.push_back(startVertex);
+                    batch.indices.push_back(startVertex + i);
+                    batch.indices.push_back(startVertex + i + 1);
+                }
+            }
+            else
+            {
+                for (uint32_t i = 0; i < count; ++i)
+                {
+                    batch.indices.push_back(startVertex + i);
+                    batch.indices.push_back(startVertex + (i + 1) % count);
+                }
+            }
+        }
+
+        void DebugRenderer::box(const Box3& box, const Color& color, uint32_t flags)
+        {
+            Batch& batch = getBatch(false, flags);
+            uint32_t startVertex = static_cast<uint32_t>(batch.vertices.size());
+
+            // bit 0 of the corner selects the x, bit 1 the y and bit 2 the z of the max corner
+            for (uint32_t corner = 0; corner < 8; ++corner)
+            {
+                batch.vertices.push_back(graphics::Vertex(Vector3((corner & 1) ? box.max.x : box.min.x,
+                                                                  (corner & 2) ? box.max.y : box.min.y,
+                                                                  (corner & 4) ? box.max.z : box.min.z),
+                                                          color, Vector2(), Vector3(0.0f, 0.0f, -1.0f)));
+            }
+
+            // the edges connect the corners that differ in one bit
+            for (uint32_t corner = 0; corner < 8; ++corner)
+            {
+                for (uint32_t bit = 1; bit < 8; bit <<= 1)
+                {
+                    if (corner & bit) continue;
+
+                    batch.indices.push_back(startVertex + corner);
+                    batch.indices.push_back(startVertex + (corner | bit));
+                }
+            }
+        }
+
+        uint32_t DebugRenderer::getLineCount() const
+        {
+            uint32_t count = 0;
+
+            for (uint32_t i = 0; i < BATCH_COUNT; i += 2)
+            {
+                count += static_cast<uint32_t>(batches[i].indices.size() / 2);
+            }
+
+            return count;
+        }
+
+        uint32_t DebugRenderer::getTriangleCount() const
+        {
+            uint32_t count = 0;
+
+            for (uint32_t i = 1; i < BATCH_COUNT; i += 2)
+            {
+                count += static_cast<uint32_t>(batches[i].indices.size() / 3);
+            }
+
+            return count;
+        }
+
+        DebugRenderer::Batch& DebugRenderer::getBatch(bool triangles, uint32_t flags)
+        {
+            Batch& batch = batches[((flags & (DEPTH_TEST | SCREEN_SPACE)) << 1) | (triangles ? 1 : 0)];
+
+            if (!batch.dirty)
+            {
+                batch.dirty = true;
+                contentChanged();
+            }
+
+            return batch;
+        }
+
+        const std::vector<Vector2>& DebugRenderer::getUnitCircle(uint32_t segments)
+        {
+            if (segments > MAX_SEGMENTS) segments = MAX_SEGMENTS;
+            if (unitCircles.size() <= segments) unitCircles.resize(segments + 1);
+
+            std::vector<Vector2>& unitCircle = unitCircles[segments];
+
+            if (unitCircle.empty())
+            {
+                unitCircle.reserve(segments);
+
+                for (uint32_t i = 0; i < segments; ++i)
+                {
+                    float angle = i * TAU / static_cast<float>(segments);
+                    unitCircle.push_back(Vector2(cosf(angle), sinf(angle)));
+                }
+            }
+
+            return unitCircle;
+        }
+
+        void DebugRenderer::update(float)
+        {
+            clear();
+        }
+    } // namespace scene
+} // namespace ouzel
@@ -0,0 +1,108 @@
+// Copyright (C) 2018 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "scene/Component.hpp"
+#include "core/UpdateCallback.hpp"
+#include "graphics/BlendState.hpp"
+#include "graphics/Buffer.hpp"
+#include "graphics/MeshBuffer.hpp"
+#include "graphics/Renderer.hpp"
+#include "graphics/Shader.hpp"
+#include "graphics/Vertex.hpp"
+#include "math/Box3.hpp"
+#include "math/Color.hpp"
+#include "math/Rectangle.hpp"
+#include "math/Vector2.hpp"
+#include "math/Vector3.hpp"
+
+namespace ouzel
+{
+    namespace scene
+    {
+        // immediate mode lines and shapes for debug overlays, the primitives are only drawn in the frame
+        // they were added in (they are cleared before the other update callbacks run), so they have to be
+        // added every frame from an update callback
+        // all the primitives with the same type and flags go into one draw call, the memory is reused
+        // between the frames
+        // there is no bounding box, the actor of the renderer should have culling disabled
+        class DebugRenderer: public Component
+        {
+        public:
+            static const uint32_t TYPE = Component::DEBUG_RENDERER;
+            static const uint32_t MAX_SEGMENTS = 256;
+
+            enum Flags
+            {
+                // tested against the depth buffer, otherwise drawn on top
+                DEPTH_TEST = 0x01,
+                // positions are in render target pixels from the bottom left corner of the viewport
+                SCREEN_SPACE = 0x02
+            };
+
+            DebugRenderer();
+
+            virtual void draw(const Matrix4& transformMatrix,
+                              float opacity,
+                              const Matrix4& renderViewProjection,
+                              const std::shared_ptr<graphics::Texture>& renderTarget,
+                              const Rectangle& renderViewport,
+                              bool depthWrite,
+                              bool depthTest,
+                              bool wireframe,
+                              bool scissorTest,
+                              const Rectangle& scissorRectangle) override;
+
+            void clear();
+
+            void line(const Vector3& start, const Vector3& finish, const Color& color, uint32_t flags = 0);
+            // pairs of points
+            void lines(const Vector3* points, uint32_t count, const Color& color, uint32_t flags = 0);
+            void circle(const Vector3& position, float radius, const Color& color,
+                        bool fill = false, uint32_t segments = 16, uint32_t flags = 0);
+            void rectangle(const Rectangle& rectangle, const Color& color, bool fill = false, uint32_t flags = 0);
+            void polygon(const std::vector<Vector2>& edges, const Color& color, bool fill = false, uint32_t flags = 0);
+            void box(const Box3& box, const Color& color, uint32_t flags = 0);
+
+            virtual const std::shared_ptr<graphics::Shader>& getShader() const { return shader; }
+            virtual void setShader(const std::shared_ptr<graphics::Shader>& newShader) { shader = newShader; }
+
+            virtual const std::shared_ptr<graphics::BlendState>& getBlendState() const { return blendState; }
+            virtual void setBlendState(const std::shared_ptr<graphics::BlendState>& newBlendState) { blendState = newBlendState; }
+
+            uint32_t getLineCount() const;
+            uint32_t getTriangleCount() const;
+
+        protected:
+            // lines or triangles with a combination of the flags
+            static const uint32_t BATCH_COUNT = 8;
+
+            struct Batch
+            {
+                std::vector<uint32_t> indices;
+                std::vector<graphics::Vertex> vertices;
+                std::shared_ptr<graphics::Buffer> indexBuffer;
+                std::shared_ptr<graphics::Buffer> vertexBuffer;
+                std::shared_ptr<graphics::MeshBuffer> meshBuffer;
+                bool dirty = false;
+            };
+
+            Batch& getBatch(bool triangles, uint32_t flags);
+            const std::vector<Vector2>& getUnitCircle(uint32_t segments);
+
+            void update(float delta);
+
+            std::shared_ptr<graphics::Shader> shader;
+            std::shared_ptr<graphics::BlendState> blendState;
+
+            Batch batches[BATCH_COUNT];
+            // cos and sin of the segment angles, by the number of segments
+            std::vector<std::vector<Vector2>> unitCircles;
+
+            UpdateCallback updateCallback;
+        };
+    } // namespace scene
+} // namespace ouzel
@@ -34,8 +34,29 @@ namespace ouzel
         {
             for (Camera* camera : cameras)
             {
+                engine->getRenderer()->setPassTag(camera, this);
+
+                if (camera->cacheEnabled)
+                {
+                    // nothing has changed since the last draw, reuse the cached content
+                    if (camera->cacheValid && camera->cacheChangeCount == changeCount)
+                    {
+                        ++camera->cacheSkippedFrames;
+                        camera->drawCache();
+                        continue;
+                    }
+
+                    if (camera->cacheValid) ++camera->cacheInvalidations;
+
+                    if (!camera->createCache()) camera->setCacheEnabled(false);
+                }
+
                 std::vector<Actor*> drawQueue;
 
+                // one light list per camera, the lit materials loop only over the lights of their tile
+                camera->lightGrid.update(lights, camera, ambientColor);
+                lightGrid = &camera->lightGrid;
+
                 for (Actor* actor : children)
                 {
                     actor->visit(drawQueue, Matrix4::IDENTITY, false, camera, 0, false);
@@ -50,7 +71,18 @@ namespace ouzel
                         actor->draw(camera, true);
                     }
                 }
+
+                if (camera->cacheEnabled)
+                {
+                    camera->cacheChangeCount = changeCount;
+                    camera->cacheValid = true;
+                    camera->drawCache();
+                }
             }
+
+            lightGrid = nullptr;
+
+            engine->getRenderer()->setPassTag(nullptr, nullptr);
         }
 
         void Layer::addChildActor(Actor* actor)
@@ -6,6 +6,7 @@
 #include <cstdint>
 #include <vector>
 #include "scene/ActorContainer.hpp"
+#include "math/Color.hpp"
 #include "math/Vector2.hpp"
 
 namespace ouzel
@@ -15,6 +16,7 @@ namespace ouzel
         class Scene;
         class Camera;
         class Light;
+        class LightGrid;
 
         class Layer: public ActorContainer
         {
@@ -39,6 +41,19 @@ namespace ouzel
             Scene* getScene() const { return scene; }
             void removeFromScene();
 
+            const std::vector<Light*>& getLights() const { return lights; }
+
+            const Color& getAmbientColor() const { return ambientColor; }
+            void setAmbientColor(const Color& newAmbientColor) { ambientColor = newAmbientColor; invalidateCache(); }
+
+            // light grid of the camera that is being drawn
+            const LightGrid* getLightGrid() const { return lightGrid; }
+
+            // marks the content cached by the cameras of the layer as stale, called by the actors and components
+            // on every visible change, changes that bypass them (e.g. editing a shared material) have to call it too
+            void invalidateCache() { ++changeCount; }
+            uint32_t getChangeCount() const { return changeCount; }
+
         protected:
             virtual void addChildActor(Actor* actor) override;
 
@@ -55,8 +70,11 @@ namespace ouzel
 
             std::vector<Camera*> cameras;
             std::vector<Light*> lights;
+            Color ambientColor = Color::BLACK;
+            const LightGrid* lightGrid = nullptr;
 
             int32_t order = 0;
+            uint32_t changeCount = 0;
         };
     } // namespace scene
 } // namespace ouzel
@@ -19,13 +19,39 @@ namespace ouzel
             if (layer) layer->removeLight(this);
         }
 
+        void Light::setColor(const Color& newColor)
+        {
+            color = newColor;
+            if (layer) layer->invalidateCache();
+        }
+
+        void Light::setIntensity(float newIntensity)
+        {
+            intensity = newIntensity;
+            if (layer) layer->invalidateCache();
+        }
+
+        void Light::setRange(float newRange)
+        {
+            range = newRange;
+            if (layer) layer->invalidateCache();
+        }
+
         void Light::setLayer(Layer* newLayer)
         {
-            if (layer) layer->addLight(this);
+            if (layer)
+            {
+                layer->removeLight(this);
+                layer->invalidateCache();
+            }
 
             Component::setLayer(newLayer);
 
-            if (layer) layer->removeLight(this);
+            if (layer)
+            {
+                layer->addLight(this);
+                layer->invalidateCache();
+            }
         }
     } // namespace scene
 } // namespace ouzel
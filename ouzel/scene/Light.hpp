@@ -4,11 +4,13 @@
 #pragma once
 
 #include "scene/Component.hpp"
+#include "math/Color.hpp"
 
 namespace ouzel
 {
     namespace scene
     {
+        // point light at the position of its actor, lights the materials that have lighting enabled
         class Light: public Component
         {
         public:
@@ -17,8 +19,22 @@ namespace ouzel
             Light();
             virtual ~Light();
 
+            const Color& getColor() const { return color; }
+            void setColor(const Color& newColor);
+
+            float getIntensity() const { return intensity; }
+            void setIntensity(float newIntensity);
+
+            // distance at which the light fades out completely
+            float getRange() const { return range; }
+            void setRange(float newRange);
+
         protected:
             virtual void setLayer(Layer* newLayer) override;
+
+            Color color = Color::WHITE;
+            float intensity = 1.0f;
+            float range = 100.0f;
         };
     } // namespace scene
 } // namespace ouzel
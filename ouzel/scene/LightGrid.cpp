@@ -0,0 +1,213 @@
+// Copyright (C) 2018 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#include <algorithm>
+#include <cmath>
+#include "LightGrid.hpp"
+#include "Actor.hpp"
+#include "Camera.hpp"
+#include "Light.hpp"
+#include "core/Engine.hpp"
+#include "assets/Cache.hpp"
+#include "graphics/Renderer.hpp"
+#include "utils/Log.hpp"
+
+namespace ouzel
+{
+    namespace scene
+    {
+        void LightGrid::update(const std::vector<Light*>& lights, const Camera* camera, const Color& newAmbientColor)
+        {
+            ambientColor = newAmbientColor;
+
+            const Rectangle& viewport = camera->getRenderViewport();
+            uint32_t newTileCountX = std::max(1U, static_cast<uint32_t>(std::ceil(viewport.size.width / TILE_SIZE)));
+            uint32_t newTileCountY = std::max(1U, static_cast<uint32_t>(std::ceil(viewport.size.height / TILE_SIZE)));
+            uint32_t tileCount = newTileCountX * newTileCountY;
+
+            // nothing to upload if there were no lights in the previous frame either
+            if (lights.empty() && empty && texture &&
+                newTileCountX == tileCountX && newTileCountY == tileCountY)
+            {
+                return;
+            }
+
+            tileCountX = newTileCountX;
+            tileCountY = newTileCountY;
+
+            const Matrix4& viewProjection = camera->getRenderViewProjection();
+            ranges.clear();
+            data.clear();
+            lightCount = 0;
+
+            // light data and the tile range each light covers
+            for (Light* light : lights)
+            {
+                Actor* actor = light->getActor();
+                if (!actor || light->isHidden() || actor->isWorldHidden() || light->getRange() <= 0.0f) continue;
+
+                Vector3 position = actor->getWorldPosition();
+                float range = light->getRange();
+
+                // project the corners of the light's bounding box
+                float minX = 1.0f, minY = 1.0f, maxX = -1.0f, maxY = -1.0f;
+                bool behind = false;
+                uint32_t outside[6] = {0, 0, 0, 0, 0, 0};
+
+                for (uint32_t corner = 0; corner < 8; ++corner)
+                {
+                    Vector4 clip;
+                    viewProjection.transformVector(Vector4(position.x + ((corner & 1) ? range : -range),
+                                                           position.y + ((corner & 2) ? range : -range),
+                                                           position.z + ((corner & 4) ? range : -range),
+                                                           1.0f), clip);
+
+                    if (clip.x < -clip.w) ++outside[0];
+                    if (clip.x > clip.w) ++outside[1];
+                    if (clip.y < -clip.w) ++outside[2];
+                    if (clip.y > clip.w) ++outside[3];
+                    if (clip.z < -clip.w) ++outside[4];
+                    if (clip.z > clip.w) ++outside[5];
+
+                    if (clip.w <= 0.0f)
+                    {
+                        behind = true;
+                        continue;
+                    }
+
+                    minX = std::min(minX, clip.x / clip.w);
+                    minY = std::min(minY, clip.y / clip.w);
+                    maxX = std::max(maxX, clip.x / clip.w);
+                    maxY = std::max(maxY, clip.y / clip.w);
+                }
+
+                // all corners outside of the same frustum plane
+                if (std::find(std::begin(outside), std::end(outside), 8U) != std::end(outside)) continue;
+
+                // a box crossing the camera plane can cover any part of the screen
+                if (behind)
+                {
+                    minX = minY = -1.0f;
+                    maxX = maxY = 1.0f;
+                }
+
+                TileRange tileRange;
+                tileRange.light = lightCount;
+                tileRange.minX = static_cast<uint32_t>(clamp((minX * 0.5f + 0.5f) * tileCountX, 0.0f, static_cast<float>(tileCountX - 1)));
+                tileRange.minY = static_cast<uint32_t>(clamp((minY * 0.5f + 0.5f) * tileCountY, 0.0f, static_cast<float>(tileCountY - 1)));
+                tileRange.maxX = static_cast<uint32_t>(clamp((maxX * 0.5f + 0.5f) * tileCountX, 0.0f, static_cast<float>(tileCountX - 1)));
+                tileRange.maxY = static_cast<uint32_t>(clamp((maxY * 0.5f + 0.5f) * tileCountY, 0.0f, static_cast<float>(tileCountY - 1)));
+                ranges.push_back(tileRange);
+
+                const Color& color = light->getColor();
+                float intensity = light->getIntensity();
+                data.insert(data.end(), {position.x, position.y, position.z, range,
+                    color.normR() * intensity, color.normG() * intensity, color.normB() * intensity, 0.0f});
+
+                ++lightCount;
+            }
+
+            // count the lights per tile, then place them, so that the indices of a tile are contiguous
+            tileLightCounts.assign(tileCount, 0);
+
+            for (const TileRange& tileRange : ranges)
+            {
+                for (uint32_t y = tileRange.minY; y <= tileRange.maxY; ++y)
+                    for (uint32_t x = tileRange.minX; x <= tileRange.maxX; ++x)
+                        ++tileLightCounts[y * tileCountX + x];
+            }
+
+            tileStart = lightCount * 2;
+            tileOffsets.resize(tileCount);
+            maxTileLightCount = 0;
+            uint32_t indexCount = 0;
+
+            for (uint32_t tile = 0; tile < tileCount; ++tile)
+            {
+                uint32_t count = std::min(tileLightCounts[tile], MAX_TILE_LIGHTS);
+                maxTileLightCount = std::max(maxTileLightCount, tileLightCounts[tile]);
+                tileOffsets[tile] = indexCount;
+                data.insert(data.end(), {static_cast<float>(indexCount), static_cast<float>(count), 0.0f, 0.0f});
+                indexCount += count;
+            }
+
+            indexStart = tileStart + tileCount;
+            size_t indexData = data.size();
+            data.resize(data.size() + ((indexCount + 3) / 4) * 4, 0.0f);
+
+            for (const TileRange& tileRange : ranges)
+            {
+                for (uint32_t y = tileRange.minY; y <= tileRange.maxY; ++y)
+                {
+                    for (uint32_t x = tileRange.minX; x <= tileRange.maxX; ++x)
+                    {
+                        uint32_t tile = y * tileCountX + x;
+                        uint32_t end = static_cast<uint32_t>(data[(tileStart + tile) * 4]) + std::min(tileLightCounts[tile], MAX_TILE_LIGHTS);
+
+                        if (tileOffsets[tile] < end)
+                        {
+                            data[indexData + tileOffsets[tile]] = static_cast<float>(tileRange.light);
+                            ++tileOffsets[tile];
+                        }
+                    }
+                }
+            }
+
+            uint32_t texelCount = static_cast<uint32_t>(data.size() / 4);
+            uint32_t height = std::max(1U, (texelCount + TEXTURE_WIDTH - 1) / TEXTURE_WIDTH);
+
+            // the texture only grows, so that it isn't recreated every time the number of lights changes
+            if (!texture || height > textureHeight)
+            {
+                textureHeight = 1;
+                while (textureHeight < height) textureHeight <<= 1;
+
+                texture = std::make_shared<graphics::Texture>();
+                if (!texture->init(Size2(static_cast<float>(TEXTURE_WIDTH), static_cast<float>(textureHeight)),
+                                   graphics::Texture::DYNAMIC, 1, 1, graphics::PixelFormat::RGBA32_FLOAT))
+                {
+                    Log(Log::Level::ERR) << "Failed to create light grid texture";
+                    texture.reset();
+                    return;
+                }
+
+                texture->setFilter(graphics::Texture::Filter::POINT);
+            }
+
+            data.resize(static_cast<size_t>(TEXTURE_WIDTH) * textureHeight * 4, 0.0f);
+
+            const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data.data());
+            texture->setData(std::vector<uint8_t>(bytes, bytes + data.size() * sizeof(float)),
+                             Size2(static_cast<float>(TEXTURE_WIDTH), static_cast<float>(textureHeight)));
+
+            empty = lights.empty();
+        }
+
+        bool LightGrid::setupDraw(const Matrix4& transformMatrix,
+                                  std::shared_ptr<graphics::Shader>& shader,
+                                  std::vector<std::shared_ptr<graphics::Texture>>& textures,
+                                  std::vector<std::vector<float>>& pixelShaderConstants,
+                                  std::vector<std::vector<float>>& vertexShaderConstants) const
+        {
+            const std::shared_ptr<graphics::Shader>& lightingShader = engine->getCache()->getShader(graphics::SHADER_LIGHTING);
+
+            if (!lightingShader || !texture)
+            {
+                return false;
+            }
+
+            shader = lightingShader;
+
+            if (textures.size() < 2) textures.resize(2);
+            textures[1] = texture;
+
+            pixelShaderConstants.push_back({ambientColor.normR(), ambientColor.normG(), ambientColor.normB(), ambientColor.normA()});
+            pixelShaderConstants.push_back({static_cast<float>(tileCountX), static_cast<float>(tileCountY),
+                static_cast<float>(tileStart), static_cast<float>(indexStart)});
+
+            vertexShaderConstants.push_back({std::begin(transformMatrix.m), std::end(transformMatrix.m)});
+
+            return true;
+        }
+    } // namespace scene
+} // namespace ouzel
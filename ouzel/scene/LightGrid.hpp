@@ -0,0 +1,76 @@
+// Copyright (C) 2018 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "utils/Noncopyable.hpp"
+#include "graphics/Shader.hpp"
+#include "graphics/Texture.hpp"
+#include "math/Color.hpp"
+#include "math/Matrix4.hpp"
+
+namespace ouzel
+{
+    namespace scene
+    {
+        class Camera;
+        class Light;
+
+        // per-camera list of the lights that touch each screen tile, packed into a float texture:
+        // two texels per light (position and range, color), a texel per tile (first index and count)
+        // and the light indices four per texel
+        class LightGrid: public Noncopyable
+        {
+        public:
+            static const uint32_t TILE_SIZE = 32;
+            static const uint32_t MAX_TILE_LIGHTS = 32;
+            static const uint32_t TEXTURE_WIDTH = 256;
+
+            // culls the lights against the tiles of the camera and uploads the result
+            void update(const std::vector<Light*>& lights, const Camera* camera, const Color& newAmbientColor);
+
+            // switches the draw to the lighting shader, returns false if the lighting shader is not available
+            bool setupDraw(const Matrix4& transformMatrix,
+                           std::shared_ptr<graphics::Shader>& shader,
+                           std::vector<std::shared_ptr<graphics::Texture>>& textures,
+                           std::vector<std::vector<float>>& pixelShaderConstants,
+                           std::vector<std::vector<float>>& vertexShaderConstants) const;
+
+            uint32_t getTileCountX() const { return tileCountX; }
+            uint32_t getTileCountY() const { return tileCountY; }
+            uint32_t getLightCount() const { return lightCount; }
+
+            // number of lights that touch each tile before the MAX_TILE_LIGHTS limit, row by row from the bottom
+            const std::vector<uint32_t>& getTileLightCounts() const { return tileLightCounts; }
+            uint32_t getMaxTileLightCount() const { return maxTileLightCount; }
+
+            const std::shared_ptr<graphics::Texture>& getTexture() const { return texture; }
+
+        private:
+            uint32_t tileCountX = 0;
+            uint32_t tileCountY = 0;
+            uint32_t lightCount = 0;
+            uint32_t maxTileLightCount = 0;
+            uint32_t tileStart = 0;
+            uint32_t indexStart = 0;
+            Color ambientColor;
+
+            struct TileRange
+            {
+                uint32_t light;
+                uint32_t minX, minY, maxX, maxY;
+            };
+
+            std::vector<TileRange> ranges;
+            std::vector<uint32_t> tileLightCounts;
+            std::vector<uint32_t> tileOffsets;
+            std::vector<float> data;
+            std::shared_ptr<graphics::Texture> texture;
+            uint32_t textureHeight = 0;
+            bool empty = false;
+        };
+    } // namespace scene
+} // namespace ouzel
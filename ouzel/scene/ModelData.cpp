@@ -13,14 +13,25 @@ namespace ouzel
                              const std::vector<uint32_t> indices,
                              const std::vector<graphics::Vertex>& vertices,
                              const std::shared_ptr<graphics::Material>& newMaterial)
+        {
+            return init(newBoundingBox,
+                        indices.data(), static_cast<uint32_t>(indices.size()),
+                        vertices.data(), static_cast<uint32_t>(vertices.size()),
+                        newMaterial);
+        }
+
+        bool ModelData::init(Box3 newBoundingBox,
+                             const uint32_t* indices, uint32_t indexCount,
+                             const graphics::Vertex* vertices, uint32_t vertexCount,
+                             const std::shared_ptr<graphics::Material>& newMaterial)
         {
             boundingBox = newBoundingBox;
 
             indexBuffer = std::make_shared<graphics::Buffer>();
-            indexBuffer->init(graphics::Buffer::Usage::INDEX, indices.data(), static_cast<uint32_t>(getVectorSize(indices)));
+            indexBuffer->init(graphics::Buffer::Usage::INDEX, indices, static_cast<uint32_t>(sizeof(uint32_t) * indexCount));
 
             vertexBuffer = std::make_shared<graphics::Buffer>();
-            vertexBuffer->init(graphics::Buffer::Usage::VERTEX, vertices.data(), static_cast<uint32_t>(getVectorSize(vertices)));
+            vertexBuffer->init(graphics::Buffer::Usage::VERTEX, vertices, static_cast<uint32_t>(sizeof(graphics::Vertex) * vertexCount));
 
             meshBuffer = std::make_shared<graphics::MeshBuffer>();
             meshBuffer->init(sizeof(uint32_t), indexBuffer, vertexBuffer);
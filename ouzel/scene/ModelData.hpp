@@ -20,6 +20,11 @@ namespace ouzel
                       const std::vector<uint32_t> indices,
                       const std::vector<graphics::Vertex>& vertices,
                       const std::shared_ptr<graphics::Material>& newMaterial);
+            // the data is copied into the buffers, so it may point into a mapped file
+            bool init(Box3 newBoundingBox,
+                      const uint32_t* indices, uint32_t indexCount,
+                      const graphics::Vertex* vertices, uint32_t vertexCount,
+                      const std::shared_ptr<graphics::Material>& newMaterial);
 
             Box3 boundingBox;
             std::shared_ptr<graphics::Material> material;
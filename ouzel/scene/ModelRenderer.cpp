@@ -3,6 +3,8 @@
 
 #include "ModelRenderer.hpp"
 #include "core/Engine.hpp"
+#include "Layer.hpp"
+#include "LightGrid.hpp"
 
 namespace ouzel
 {
@@ -80,8 +82,15 @@ namespace ouzel
             if (wireframe) textures.push_back(whitePixelTexture);
             else textures.assign(std::begin(material->textures), std::end(material->textures));
 
+            std::shared_ptr<graphics::Shader> shader = material->shader;
+            if (material->lighting && !wireframe && layer && layer->getLightGrid())
+            {
+                layer->getLightGrid()->setupDraw(transformMatrix, shader, textures,
+                                                 pixelShaderConstants, vertexShaderConstants);
+            }
+
             engine->getRenderer()->addDrawCommand(textures,
-                                                        material->shader,
+                                                        shader,
                                                         pixelShaderConstants,
                                                         vertexShaderConstants,
                                                         material->blendState,
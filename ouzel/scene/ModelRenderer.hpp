@@ -34,7 +34,7 @@ namespace ouzel
                               const Rectangle& scissorRectangle) override;
 
             virtual const std::shared_ptr<graphics::Material>& getMaterial() const { return material; }
-            virtual void setMaterial(const std::shared_ptr<graphics::Material>& newMaterial) { material = newMaterial; }
+            virtual void setMaterial(const std::shared_ptr<graphics::Material>& newMaterial) { material = newMaterial; contentChanged(); }
 
         protected:
             std::shared_ptr<graphics::Material> material;
@@ -223,6 +223,7 @@ namespace ouzel
                     }
 
                     needsMeshUpdate = true;
+                    contentChanged();
                     needsBoundingBoxUpdate = true;
                 }
             }
@@ -326,6 +327,7 @@ namespace ouzel
             timeSinceUpdate = 0.0f;
             particleCount = 0;
             finished = false;
+            contentChanged();
         }
 
         bool ParticleSystem::createParticleMesh()
@@ -7,6 +7,7 @@
 #include "graphics/MeshBufferResource.hpp"
 #include "graphics/BufferResource.hpp"
 #include "Camera.hpp"
+#include "Layer.hpp"
 #include "utils/Utils.hpp"
 
 namespace ouzel
@@ -89,6 +90,25 @@ namespace ouzel
             }
         }
 
+        void ShapeRenderer::appendDrawCommand(const DrawCommand& command)
+        {
+            if (!drawCommands.empty() &&
+                (command.mode == graphics::Renderer::DrawMode::LINE_LIST ||
+                 command.mode == graphics::Renderer::DrawMode::TRIANGLE_LIST))
+            {
+                DrawCommand& previous = drawCommands.back();
+
+                if (previous.mode == command.mode &&
+                    previous.startIndex + previous.indexCount == command.startIndex)
+                {
+                    previous.indexCount += command.indexCount;
+                    return;
+                }
+            }
+
+            drawCommands.push_back(command);
+        }
+
         void ShapeRenderer::clear()
         {
             boundingBox.reset();
@@ -98,6 +118,7 @@ namespace ouzel
             vertices.clear();
 
             dirty = true;
+            contentChanged();
         }
 
         bool ShapeRenderer::line(const Vector2& start, const Vector2& finish, const Color& color, float thickness)
@@ -158,9 +179,10 @@ namespace ouzel
                 boundingBox.insertPoint(vertices[startVertex + 3].position);
             }
 
-            drawCommands.push_back(command);
+            appendDrawCommand(command);
 
             dirty = true;
+            contentChanged();
             return true;
         }
 
@@ -281,9 +303,10 @@ namespace ouzel
                 }
             }
 
-            drawCommands.push_back(command);
+            appendDrawCommand(command);
 
             dirty = true;
+            contentChanged();
             return true;
         }
 
@@ -429,9 +452,10 @@ namespace ouzel
                 }
             }
 
-            drawCommands.push_back(command);
+            appendDrawCommand(command);
 
             dirty = true;
+            contentChanged();
             return true;
         }
 
@@ -503,9 +527,10 @@ namespace ouzel
                 }
             }
 
-            drawCommands.push_back(command);
+            appendDrawCommand(command);
 
             dirty = true;
+            contentChanged();
             return true;
         }
 
@@ -577,9 +602,10 @@ namespace ouzel
                 return false;
             }
 
-            drawCommands.push_back(command);
+            appendDrawCommand(command);
 
             dirty = true;
+            contentChanged();
             return true;
         }
     } // namespace scene
@@ -77,6 +77,9 @@ namespace ouzel
                 uint32_t startIndex;
             };
 
+            // merges list commands that follow each other into one
+            void appendDrawCommand(const DrawCommand& command);
+
             std::shared_ptr<graphics::Shader> shader;
             std::shared_ptr<graphics::BlendState> blendState;
             std::shared_ptr<graphics::MeshBuffer> meshBuffer;
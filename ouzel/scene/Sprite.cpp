@@ -55,6 +55,12 @@ namespace ouzel
 
             frames = spriteData.frames;
 
+            // frames that were constructed by hand don't have a mesh buffer yet
+            if (!SpriteFrame::createMeshBuffer(frames))
+            {
+                return false;
+            }
+
             updateBoundingBox();
 
             return true;
@@ -106,6 +112,11 @@ namespace ouzel
                 }
             }
 
+            if (!SpriteFrame::createMeshBuffer(frames))
+            {
+                return false;
+            }
+
             updateBoundingBox();
 
             return true;
@@ -115,6 +126,7 @@ namespace ouzel
         {
             if (playing)
             {
+                uint32_t previousFrame = currentFrame;
                 timeSinceLastFrame += delta;
 
                 while (timeSinceLastFrame > fabsf(frameInterval))
@@ -179,7 +191,7 @@ namespace ouzel
                     }
                 }
 
-                updateBoundingBox();
+                if (currentFrame != previousFrame) updateBoundingBox();
             }
         }
 
@@ -205,7 +217,7 @@ namespace ouzel
                             scissorTest,
                             scissorRectangle);
 
-            if (currentFrame < frames.size() && material)
+            if (currentFrame < frames.size() && frames[currentFrame].getIndexCount() > 0 && material)
             {
                 Matrix4 modelViewProj = renderViewProjection * transformMatrix * offsetMatrix;
                 float colorVector[] = {material->diffuseColor.normR(), material->diffuseColor.normG(), material->diffuseColor.normB(), material->diffuseColor.normA() * opacity * material->opacity};
@@ -220,15 +232,22 @@ namespace ouzel
                 if (wireframe) textures.push_back(whitePixelTexture);
                 else textures.assign(std::begin(material->textures), std::end(material->textures));
 
+                std::shared_ptr<graphics::Shader> shader = material->shader;
+                if (material->lighting && !wireframe && layer && layer->getLightGrid())
+                {
+                    layer->getLightGrid()->setupDraw(transformMatrix * offsetMatrix, shader, textures,
+                                                     pixelShaderConstants, vertexShaderConstants);
+                }
+
                 engine->getRenderer()->addDrawCommand(textures,
-                                                            material->shader,
+                                                            shader,
                                                             pixelShaderConstants,
                                                             vertexShaderConstants,
                                                             material->blendState,
                                                             frames[currentFrame].getMeshBuffer(),
-                                                            0,
+                                                            frames[currentFrame].getIndexCount(),
                                                             graphics::Renderer::DrawMode::TRIANGLE_LIST,
-                                                            0,
+                                                            frames[currentFrame].getStartIndex(),
                                                             renderTarget,
                                                             renderViewport,
                                                             depthWrite,
@@ -344,6 +363,8 @@ namespace ouzel
                 size.width = size.height = 0.0f;
                 boundingBox.reset();
             }
+
+            contentChanged();
         }
     } // namespace scene
 } // namespace ouzel
@@ -52,12 +52,13 @@ namespace ouzel
                               const Rectangle& scissorRectangle) override;
 
             virtual const std::shared_ptr<graphics::Material>& getMaterial() const { return material; }
-            virtual void setMaterial(const std::shared_ptr<graphics::Material>& newMaterial) { material = newMaterial; }
+            virtual void setMaterial(const std::shared_ptr<graphics::Material>& newMaterial) { material = newMaterial; contentChanged(); }
 
             virtual const Size2& getSize() const { return size; }
 
             const Vector2& getOffset() const { return offset; }
             void setOffset(const Vector2& newOffset);
+            const Matrix4& getOffsetMatrix() const { return offsetMatrix; }
 
             virtual void play(bool repeat = true, float newFrameInterval = 0.1f);
             virtual void stop(bool resetAnimation = true);
@@ -66,6 +67,7 @@ namespace ouzel
 
             const std::vector<SpriteFrame>& getFrames() const { return frames; }
             virtual void setCurrentFrame(uint32_t frame);
+            uint32_t getCurrentFrame() const { return currentFrame; }
 
         protected:
             void updateBoundingBox();
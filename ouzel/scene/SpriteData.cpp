@@ -4,7 +4,7 @@
 #include <algorithm>
 #include "SpriteData.hpp"
 #include "core/Engine.hpp"
-#include "utils/JSON.hpp"
+#include "utils/JSONReader.hpp"
 
 namespace ouzel
 {
@@ -21,114 +21,295 @@ namespace ouzel
             return init(data, mipmaps);
         }
 
-        bool SpriteData::init(const std::vector<uint8_t>& data, bool mipmaps)
+        struct FrameRectangle
         {
-            json::Data document;
+            float x = 0.0f;
+            float y = 0.0f;
+            float w = 0.0f;
+            float h = 0.0f;
+        };
 
-            if (!document.init(data))
-            {
-                return false;
-            }
+        struct FrameDescription
+        {
+            std::string name;
+            FrameRectangle frame;
+            FrameRectangle sourceSize;
+            FrameRectangle spriteSourceSize;
+            FrameRectangle pivot;
+            bool rotated = false;
+            bool hasVertices = false;
+            bool hasVerticesUV = false;
+            bool hasTriangles = false;
+            std::vector<uint16_t> indices;
+            std::vector<Vector2> vertices;
+            std::vector<Vector2> verticesUV;
+        };
+
+        static bool readRectangle(json::Reader& reader, FrameRectangle& rectangle)
+        {
+            if (reader.next() != json::Reader::Event::OBJECT_START) return false;
 
-            if (!document.hasMember("meta") ||
-                !document.hasMember("frames"))
+            while (reader.next() == json::Reader::Event::KEY)
             {
-                return false;
+                StringView key = reader.getString();
+                float* value = nullptr;
+
+                if (key == "x") value = &rectangle.x;
+                else if (key == "y") value = &rectangle.y;
+                else if (key == "w") value = &rectangle.w;
+                else if (key == "h") value = &rectangle.h;
+
+                if (value)
+                {
+                    if (reader.next() != json::Reader::Event::NUMBER) return false;
+                    *value = static_cast<float>(reader.getNumber());
+                }
+                else if (!reader.skipValue())
+                {
+                    return false;
+                }
             }
 
-            const json::Value& metaObject = document["meta"];
+            return reader.getEvent() == json::Reader::Event::OBJECT_END;
+        }
 
-            texture = engine->getCache()->getTexture(metaObject["image"].asString(), mipmaps);
+        static bool readPoints(json::Reader& reader, std::vector<Vector2>& points)
+        {
+            if (reader.next() != json::Reader::Event::ARRAY_START) return false;
 
-            if (!texture)
+            while (reader.next() == json::Reader::Event::ARRAY_START)
             {
-                return false;
+                Vector2 point;
+
+                if (reader.next() != json::Reader::Event::NUMBER) return false;
+                point.x = static_cast<float>(static_cast<int32_t>(reader.getNumber()));
+
+                if (reader.next() != json::Reader::Event::NUMBER) return false;
+                point.y = static_cast<float>(static_cast<int32_t>(reader.getNumber()));
+
+                if (!reader.skipContainer()) return false;
+
+                points.push_back(point);
             }
 
-            const json::Value& framesArray = document["frames"];
+            return reader.getEvent() == json::Reader::Event::ARRAY_END;
+        }
 
-            frames.reserve(framesArray.getSize());
+        static bool readIndices(json::Reader& reader, std::vector<uint16_t>& indices)
+        {
+            if (reader.next() != json::Reader::Event::ARRAY_START) return false;
 
-            for (const json::Value& frameObject : framesArray.asArray())
+            while (reader.next() == json::Reader::Event::ARRAY_START)
             {
-                std::string name = frameObject["filename"].asString();
+                while (reader.next() == json::Reader::Event::NUMBER)
+                {
+                    indices.push_back(static_cast<uint16_t>(reader.getNumber()));
+                }
 
-                const json::Value& frameRectangleObject = frameObject["frame"];
+                if (reader.getEvent() != json::Reader::Event::ARRAY_END) return false;
+            }
 
-                Rectangle frameRectangle(static_cast<float>(frameRectangleObject["x"].asInt32()),
-                                         static_cast<float>(frameRectangleObject["y"].asInt32()),
-                                         static_cast<float>(frameRectangleObject["w"].asInt32()),
-                                         static_cast<float>(frameRectangleObject["h"].asInt32()));
+            return reader.getEvent() == json::Reader::Event::ARRAY_END;
+        }
 
-                const json::Value& sourceSizeObject = frameObject["sourceSize"];
+        static bool readFrame(json::Reader& reader, FrameDescription& frame)
+        {
+            while (reader.next() == json::Reader::Event::KEY)
+            {
+                StringView key = reader.getString();
 
-                Size2 sourceSize(static_cast<float>(sourceSizeObject["w"].asInt32()),
-                                 static_cast<float>(sourceSizeObject["h"].asInt32()));
+                if (key == "filename")
+                {
+                    if (reader.next() != json::Reader::Event::STRING) return false;
+                    frame.name = reader.getString().str();
+                }
+                else if (key == "frame")
+                {
+                    if (!readRectangle(reader, frame.frame)) return false;
+                }
+                else if (key == "sourceSize")
+                {
+                    if (!readRectangle(reader, frame.sourceSize)) return false;
+                }
+                else if (key == "spriteSourceSize")
+                {
+                    if (!readRectangle(reader, frame.spriteSourceSize)) return false;
+                }
+                else if (key == "pivot")
+                {
+                    if (!readRectangle(reader, frame.pivot)) return false;
+                }
+                else if (key == "rotated")
+                {
+                    if (reader.next() != json::Reader::Event::BOOLEAN) return false;
+                    frame.rotated = reader.getBoolean();
+                }
+                else if (key == "triangles")
+                {
+                    if (!readIndices(reader, frame.indices)) return false;
+                    frame.hasTriangles = true;
+                }
+                else if (key == "vertices")
+                {
+                    if (!readPoints(reader, frame.vertices)) return false;
+                    frame.hasVertices = true;
+                }
+                else if (key == "verticesUV")
+                {
+                    if (!readPoints(reader, frame.verticesUV)) return false;
+                    frame.hasVerticesUV = true;
+                }
+                else if (!reader.skipValue())
+                {
+                    return false;
+                }
+            }
 
-                const json::Value& spriteSourceSizeObject = frameObject["spriteSourceSize"];
+            return reader.getEvent() == json::Reader::Event::OBJECT_END;
+        }
+
+        bool SpriteData::init(const std::vector<uint8_t>& data, bool mipmaps)
+        {
+            // the reader decodes strings in-situ, so it needs its own copy of the data
+            std::vector<uint8_t> buffer = data;
+            json::Reader reader(buffer.data(), buffer.data() + buffer.size());
 
-                Vector2 sourceOffset(static_cast<float>(spriteSourceSizeObject["x"].asInt32()),
-                                     static_cast<float>(spriteSourceSizeObject["y"].asInt32()));
+            if (reader.next() != json::Reader::Event::OBJECT_START)
+            {
+                return false;
+            }
 
-                const json::Value& pivotObject = frameObject["pivot"];
+            // "frames" usually precede "meta", so frame descriptions are kept until the texture is known
+            std::vector<FrameDescription> frameDescriptions;
+            std::string image;
+            bool hasFrames = false;
+            bool hasMeta = false;
 
-                Vector2 pivot(pivotObject["x"].asFloat(),
-                              pivotObject["y"].asFloat());
+            while (reader.next() == json::Reader::Event::KEY)
+            {
+                StringView key = reader.getString();
 
-                if (frameObject.hasMember("vertices") &&
-                    frameObject.hasMember("verticesUV") &&
-                    frameObject.hasMember("triangles"))
+                if (key == "frames")
                 {
-                    std::vector<uint16_t> indices;
+                    if (reader.next() != json::Reader::Event::ARRAY_START) return false;
+
+                    while (reader.next() == json::Reader::Event::OBJECT_START)
+                    {
+                        frameDescriptions.push_back(FrameDescription());
+                        if (!readFrame(reader, frameDescriptions.back())) return false;
+                    }
+
+                    if (reader.getEvent() != json::Reader::Event::ARRAY_END) return false;
 
-                    const json::Value& trianglesObject = frameObject["triangles"];
+                    hasFrames = true;
+                }
+                else if (key == "meta")
+                {
+                    if (reader.next() != json::Reader::Event::OBJECT_START) return false;
 
-                    for (const json::Value& triangleObject : trianglesObject.asArray())
+                    while (reader.next() == json::Reader::Event::KEY)
                     {
-                        for (const json::Value& indexObject : triangleObject.asArray())
+                        if (reader.getString() == "image")
+                        {
+                            if (reader.next() != json::Reader::Event::STRING) return false;
+                            image = reader.getString().str();
+                        }
+                        else if (!reader.skipValue())
                         {
-                            indices.push_back(static_cast<uint16_t>(indexObject.asUInt32()));
+                            return false;
                         }
                     }
 
+                    if (reader.getEvent() != json::Reader::Event::OBJECT_END) return false;
+
+                    hasMeta = true;
+                }
+                else if (!reader.skipValue())
+                {
+                    return false;
+                }
+            }
+
+            if (reader.getEvent() != json::Reader::Event::OBJECT_END ||
+                reader.next() != json::Reader::Event::END)
+            {
+                return false;
+            }
+
+            if (!hasMeta || !hasFrames)
+            {
+                return false;
+            }
+
+            assets::TextureAtlas::Region region;
+
+            if (!engine->getCache()->getTextureRegion(image, mipmaps, region))
+            {
+                return false;
+            }
+
+            texture = region.texture;
+
+            // frame rectangles are relative to the image, which can be placed anywhere in an atlas page
+            const Size2& textureSize = texture->getSize();
+            const Vector2& imageOffset = region.rectangle.position;
+
+            frames.reserve(frameDescriptions.size());
+
+            for (FrameDescription& frameDescription : frameDescriptions)
+            {
+                Rectangle frameRectangle(static_cast<float>(static_cast<int32_t>(frameDescription.frame.x)) + imageOffset.x,
+                                         static_cast<float>(static_cast<int32_t>(frameDescription.frame.y)) + imageOffset.y,
+                                         static_cast<float>(static_cast<int32_t>(frameDescription.frame.w)),
+                                         static_cast<float>(static_cast<int32_t>(frameDescription.frame.h)));
+
+                Size2 sourceSize(static_cast<float>(static_cast<int32_t>(frameDescription.sourceSize.w)),
+                                 static_cast<float>(static_cast<int32_t>(frameDescription.sourceSize.h)));
+
+                Vector2 sourceOffset(static_cast<float>(static_cast<int32_t>(frameDescription.spriteSourceSize.x)),
+                                     static_cast<float>(static_cast<int32_t>(frameDescription.spriteSourceSize.y)));
+
+                Vector2 pivot(frameDescription.pivot.x,
+                              frameDescription.pivot.y);
+
+                if (frameDescription.hasVertices &&
+                    frameDescription.hasVerticesUV &&
+                    frameDescription.hasTriangles)
+                {
+                    std::vector<uint16_t>& indices = frameDescription.indices;
+
                     // reverse the vertices, so that they are counterclockwise
                     std::reverse(indices.begin(), indices.end());
 
                     std::vector<graphics::Vertex> vertices;
-
-                    const json::Value& verticesObject = frameObject["vertices"];
-                    const json::Value& verticesUVObject = frameObject["verticesUV"];
-
-                    const Size2& textureSize = texture->getSize();
+                    vertices.reserve(frameDescription.vertices.size());
 
                     Vector2 finalOffset(-sourceSize.width * pivot.x + sourceOffset.x,
                                         -sourceSize.height * pivot.y + (sourceSize.height - frameRectangle.size.height - sourceOffset.y));
 
-                    for (size_t vertexIndex = 0; vertexIndex < verticesObject.getSize(); ++vertexIndex)
+                    for (size_t vertexIndex = 0; vertexIndex < frameDescription.vertices.size(); ++vertexIndex)
                     {
-                        const json::Value& vertexObject = verticesObject[vertexIndex];
-                        const json::Value& vertexUVObject = verticesUVObject[vertexIndex];
+                        const Vector2& vertex = frameDescription.vertices[vertexIndex];
+                        Vector2 vertexUV = (vertexIndex < frameDescription.verticesUV.size()) ? frameDescription.verticesUV[vertexIndex] : Vector2();
 
-                        vertices.push_back(graphics::Vertex(Vector3(static_cast<float>(vertexObject[0].asInt32()) + finalOffset.x,
-                                                                    -static_cast<float>(vertexObject[1].asInt32()) - finalOffset.y,
+                        vertices.push_back(graphics::Vertex(Vector3(vertex.x + finalOffset.x,
+                                                                    -vertex.y - finalOffset.y,
                                                                     0.0f),
                                                             Color::WHITE,
-                                                            Vector2(static_cast<float>(vertexUVObject[0].asInt32()) / textureSize.width,
-                                                                    static_cast<float>(vertexUVObject[1].asInt32()) / textureSize.height),
+                                                            Vector2((vertexUV.x + imageOffset.x) / textureSize.width,
+                                                                    (vertexUV.y + imageOffset.y) / textureSize.height),
                                                             Vector3(0.0f, 0.0f, -1.0f)));
                     }
 
-                    frames.push_back(SpriteFrame(name, indices, vertices, frameRectangle, sourceSize, sourceOffset, pivot));
+                    frames.push_back(SpriteFrame(frameDescription.name, indices, vertices, frameRectangle, sourceSize, sourceOffset, pivot));
                 }
                 else
                 {
-                    bool rotated = frameObject["rotated"].asBool();
-
-                    frames.push_back(SpriteFrame(name, texture->getSize(), frameRectangle, rotated, sourceSize, sourceOffset, pivot));
+                    frames.push_back(SpriteFrame(frameDescription.name, textureSize, frameRectangle, frameDescription.rotated, sourceSize, sourceOffset, pivot));
                 }
             }
 
-            return true;
+            return SpriteFrame::createMeshBuffer(frames);
         }
     } // namespace scene
 } // namespace ouzel
@@ -22,7 +22,8 @@ namespace ouzel
                                  const Vector2& pivot):
             name(frameName)
         {
-            std::vector<uint16_t> indices = {0, 1, 2, 1, 3, 2};
+            std::shared_ptr<Geometry> newGeometry = std::make_shared<Geometry>();
+            newGeometry->indices = {0, 1, 2, 1, 3, 2};
 
             Vector2 textCoords[4];
             Vector2 finalOffset(-sourceSize.width * pivot.x + sourceOffset.x,
@@ -55,7 +56,7 @@ namespace ouzel
                 textCoords[3] = Vector2(rightBottom.x, rightBottom.y);
             }
 
-            std::vector<graphics::Vertex> vertices = {
+            newGeometry->vertices = {
                 graphics::Vertex(Vector3(finalOffset.x, finalOffset.y, 0.0f), Color::WHITE,
                                  textCoords[0], Vector3(0.0f, 0.0f, -1.0f)),
                 graphics::Vertex(Vector3(finalOffset.x + frameRectangle.size.width, finalOffset.y, 0.0f), Color::WHITE,
@@ -71,26 +72,24 @@ namespace ouzel
             rectangle = Rectangle(finalOffset.x, finalOffset.y,
                                   sourceSize.width, sourceSize.height);
 
-            indexBuffer = std::make_shared<graphics::Buffer>();
-            indexBuffer->init(graphics::Buffer::Usage::INDEX, indices.data(), static_cast<uint32_t>(getVectorSize(indices)), 0);
-
-            vertexBuffer = std::make_shared<graphics::Buffer>();
-            vertexBuffer->init(graphics::Buffer::Usage::VERTEX, vertices.data(), static_cast<uint32_t>(getVectorSize(vertices)), 0);
-
-            meshBuffer = std::make_shared<graphics::MeshBuffer>();
-            meshBuffer->init(sizeof(uint16_t), indexBuffer, vertexBuffer);
+            indexCount = static_cast<uint32_t>(newGeometry->indices.size());
+            geometry = newGeometry;
         }
 
         SpriteFrame::SpriteFrame(const std::string& frameName,
-                                 const std::vector<uint16_t>& indices,
-                                 const std::vector<graphics::Vertex>& vertices,
+                                 const std::vector<uint16_t>& frameIndices,
+                                 const std::vector<graphics::Vertex>& frameVertices,
                                  const Rectangle& frameRectangle,
                                  const Size2& sourceSize,
                                  const Vector2& sourceOffset,
                                  const Vector2& pivot):
             name(frameName)
         {
-            for (const graphics::Vertex& vertex : vertices)
+            std::shared_ptr<Geometry> newGeometry = std::make_shared<Geometry>();
+            newGeometry->indices = frameIndices;
+            newGeometry->vertices = frameVertices;
+
+            for (const graphics::Vertex& vertex : frameVertices)
             {
                 boundingBox.insertPoint(vertex.position);
             }
@@ -101,15 +100,86 @@ namespace ouzel
             rectangle = Rectangle(finalOffset.x, finalOffset.y,
                                   sourceSize.width, sourceSize.height);
 
-            indexBuffer = std::make_shared<graphics::Buffer>();
-            indexBuffer->init(graphics::Buffer::Usage::INDEX, indices.data(), static_cast<uint32_t>(getVectorSize(indices)), 0);
+            indexCount = static_cast<uint32_t>(frameIndices.size());
+            geometry = newGeometry;
+        }
+
+        bool SpriteFrame::createMeshBuffer(std::vector<SpriteFrame>& frames)
+        {
+            uint32_t totalIndexCount = 0;
+            uint32_t totalVertexCount = 0;
 
-            vertexBuffer = std::make_shared<graphics::Buffer>();
-            vertexBuffer->init(graphics::Buffer::Usage::VERTEX, vertices.data(), static_cast<uint32_t>(getVectorSize(vertices)), 0);
+            // frames that already have a mesh buffer (copied from the sprite data) are not uploaded again
+            for (const SpriteFrame& frame : frames)
+            {
+                if (frame.meshBuffer) continue;
 
-            meshBuffer = std::make_shared<graphics::MeshBuffer>();
-            meshBuffer->init(sizeof(uint16_t), indexBuffer, vertexBuffer);
-        }
+                totalIndexCount += static_cast<uint32_t>(frame.geometry->indices.size());
+                totalVertexCount += static_cast<uint32_t>(frame.geometry->vertices.size());
+            }
+
+            if (totalIndexCount == 0)
+            {
+                return true;
+            }
 
+            // frame indices are rebased onto the shared vertex buffer, so they might not fit in 16 bits anymore
+            uint32_t indexSize = (totalVertexCount > 65536) ? sizeof(uint32_t) : sizeof(uint16_t);
+
+            std::vector<uint8_t> indexData(totalIndexCount * indexSize);
+            std::vector<graphics::Vertex> vertexData;
+            vertexData.reserve(totalVertexCount);
+
+            uint32_t currentIndex = 0;
+
+            for (SpriteFrame& frame : frames)
+            {
+                if (frame.meshBuffer) continue;
+
+                uint32_t baseVertex = static_cast<uint32_t>(vertexData.size());
+
+                for (uint16_t index : frame.geometry->indices)
+                {
+                    if (indexSize == sizeof(uint16_t))
+                    {
+                        reinterpret_cast<uint16_t*>(indexData.data())[currentIndex++] = static_cast<uint16_t>(baseVertex + index);
+                    }
+                    else
+                    {
+                        reinterpret_cast<uint32_t*>(indexData.data())[currentIndex++] = baseVertex + index;
+                    }
+                }
+
+                vertexData.insert(vertexData.end(), frame.geometry->vertices.begin(), frame.geometry->vertices.end());
+
+                frame.startIndex = currentIndex - static_cast<uint32_t>(frame.geometry->indices.size());
+                frame.indexCount = static_cast<uint32_t>(frame.geometry->indices.size());
+            }
+
+            std::shared_ptr<graphics::Buffer> indexBuffer = std::make_shared<graphics::Buffer>();
+            if (!indexBuffer->init(graphics::Buffer::Usage::INDEX, indexData.data(), static_cast<uint32_t>(indexData.size()), 0))
+            {
+                return false;
+            }
+
+            std::shared_ptr<graphics::Buffer> vertexBuffer = std::make_shared<graphics::Buffer>();
+            if (!vertexBuffer->init(graphics::Buffer::Usage::VERTEX, vertexData.data(), static_cast<uint32_t>(getVectorSize(vertexData)), 0))
+            {
+                return false;
+            }
+
+            std::shared_ptr<graphics::MeshBuffer> meshBuffer = std::make_shared<graphics::MeshBuffer>();
+            if (!meshBuffer->init(indexSize, indexBuffer, vertexBuffer))
+            {
+                return false;
+            }
+
+            for (SpriteFrame& frame : frames)
+            {
+                if (!frame.meshBuffer) frame.meshBuffer = meshBuffer;
+            }
+
+            return true;
+        }
     } // scene
 } // ouzel
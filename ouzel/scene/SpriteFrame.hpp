@@ -34,19 +34,38 @@ namespace ouzel
                         const Vector2& sourceOffset,
                         const Vector2& pivot);
 
+            // puts the geometry of all the frames into one shared vertex and index buffer,
+            // each frame is then drawn as a range of indices in it
+            static bool createMeshBuffer(std::vector<SpriteFrame>& frames);
+
             const std::string& getName() const { return name; }
             const Rectangle& getRectangle() const { return rectangle; }
 
             const Box2& getBoundingBox() const { return boundingBox; }
             const std::shared_ptr<graphics::MeshBuffer>& getMeshBuffer() const { return meshBuffer; }
+            uint32_t getStartIndex() const { return startIndex; }
+            uint32_t getIndexCount() const { return indexCount; }
+
+            // geometry of the frame, kept after the upload so that it can be batched with other frames
+            const std::vector<uint16_t>& getIndices() const { return geometry->indices; }
+            const std::vector<graphics::Vertex>& getVertices() const { return geometry->vertices; }
 
         protected:
+            struct Geometry
+            {
+                std::vector<uint16_t> indices;
+                std::vector<graphics::Vertex> vertices;
+            };
+
             std::string name;
             Rectangle rectangle;
             Box2 boundingBox;
             std::shared_ptr<graphics::MeshBuffer> meshBuffer;
-            std::shared_ptr<graphics::Buffer> indexBuffer;
-            std::shared_ptr<graphics::Buffer> vertexBuffer;
+            uint32_t startIndex = 0;
+            uint32_t indexCount = 0;
+
+            // shared by the copies of the frame, so that the sprites don't each hold their own copy
+            std::shared_ptr<const Geometry> geometry;
         };
     } // scene
 } // ouzel
@@ -5,6 +5,7 @@
 #include "core/Engine.hpp"
 #include "graphics/Renderer.hpp"
 #include "scene/Camera.hpp"
+#include "scene/Layer.hpp"
 #include "assets/Cache.hpp"
 #include "utils/Utils.hpp"
 
@@ -132,12 +133,14 @@ namespace ouzel
         void TextRenderer::setColor(const Color& newColor)
         {
             color = newColor;
+            contentChanged();
         }
 
         void TextRenderer::updateText()
         {
             font->getVertices(text, Color::WHITE, fontSize, textAnchor, indices, vertices, texture);
             needsMeshUpdate = true;
+            contentChanged();
 
             boundingBox.reset();
 
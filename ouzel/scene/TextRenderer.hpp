@@ -55,10 +55,15 @@ namespace ouzel
             virtual void setColor(const Color& newColor);
 
             virtual const std::shared_ptr<graphics::Shader>& getShader() const { return shader; }
-            virtual void setShader(const std::shared_ptr<graphics::Shader>& newShader) { shader = newShader; }
+            virtual void setShader(const std::shared_ptr<graphics::Shader>& newShader) { shader = newShader; contentChanged(); }
 
             virtual const std::shared_ptr<graphics::BlendState>& getBlendState() const { return blendState; }
-            virtual void setBlendState(const std::shared_ptr<graphics::BlendState>& newBlendState)  { blendState = newBlendState; }
+            virtual void setBlendState(const std::shared_ptr<graphics::BlendState>& newBlendState)  { blendState = newBlendState; contentChanged(); }
+
+            // geometry of the text in the local space of the actor, with white vertex colors
+            const std::vector<uint16_t>& getIndices() const { return indices; }
+            const std::vector<graphics::Vertex>& getVertices() const { return vertices; }
+            const std::shared_ptr<graphics::Texture>& getTexture() const { return texture; }
 
         protected:
             void updateText();
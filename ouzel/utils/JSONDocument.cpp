@@ -0,0 +1,191 @@
+// Copyright (C) 2018 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#include <algorithm>
+#include "JSONDocument.hpp"
+#include "core/Engine.hpp"
+#include "Log.hpp"
+
+namespace ouzel
+{
+    namespace json
+    {
+        static const Node NULL_NODE;
+        static const uint32_t MIN_BLOCK_SIZE = 1024;
+
+        const Node& Node::operator[](uint32_t index) const
+        {
+            if (type != Type::ARRAY || index >= length) return NULL_NODE;
+            return children[index];
+        }
+
+        const Node& Node::operator[](const char* key) const
+        {
+            if (type == Type::OBJECT)
+            {
+                for (uint32_t i = 0; i < length; ++i)
+                {
+                    const Node& name = children[i * 2];
+                    if (name.asString() == key) return children[i * 2 + 1];
+                }
+            }
+
+            return NULL_NODE;
+        }
+
+        bool Node::hasMember(const char* key) const
+        {
+            if (type == Type::OBJECT)
+            {
+                for (uint32_t i = 0; i < length; ++i)
+                {
+                    if (children[i * 2].asString() == key) return true;
+                }
+            }
+
+            return false;
+        }
+
+        const Node& Node::getMemberName(uint32_t index) const
+        {
+            if (type != Type::OBJECT || index >= length) return NULL_NODE;
+            return children[index * 2];
+        }
+
+        const Node& Node::getMemberValue(uint32_t index) const
+        {
+            if (type != Type::OBJECT || index >= length) return NULL_NODE;
+            return children[index * 2 + 1];
+        }
+
+        Document::Document()
+        {
+        }
+
+        Document::Document(const std::string& filename)
+        {
+            init(filename);
+        }
+
+        Document::Document(const std::vector<uint8_t>& data)
+        {
+            init(data);
+        }
+
+        bool Document::init(const std::string& filename)
+        {
+            std::vector<uint8_t> data;
+
+            if (!engine->getFileSystem()->readFile(filename, data))
+            {
+                return false;
+            }
+
+            return init(std::move(data));
+        }
+
+        bool Document::init(const std::vector<uint8_t>& data)
+        {
+            buffer = data;
+            return parse();
+        }
+
+        bool Document::init(std::vector<uint8_t>&& data)
+        {
+            buffer = std::move(data);
+            return parse();
+        }
+
+        const Node* Document::allocate(const Node* nodes, uint32_t count)
+        {
+            if (count == 0) return nullptr;
+
+            if (blocks.empty() || blockUsed + count > blockSize)
+            {
+                blockSize = std::max(count, MIN_BLOCK_SIZE);
+                blocks.push_back(std::unique_ptr<Node[]>(new Node[blockSize]));
+                blockUsed = 0;
+            }
+
+            Node* result = blocks.back().get() + blockUsed;
+            std::copy(nodes, nodes + count, result);
+            blockUsed += count;
+
+            return result;
+        }
+
+        bool Document::parse()
+        {
+            blocks.clear();
+            blockSize = 0;
+            blockUsed = 0;
+            root = Node();
+
+            Reader reader(buffer.data(), buffer.data() + buffer.size());
+            bom = reader.hasBOM();
+
+            // nodes of the containers that are still open, moved to the arena once the container is closed
+            std::vector<Node> stack;
+            std::vector<size_t> starts;
+
+            for (;;)
+            {
+                Node node;
+
+                switch (reader.next())
+                {
+                    case Reader::Event::OBJECT_START:
+                    case Reader::Event::ARRAY_START:
+                        starts.push_back(stack.size());
+                        continue;
+                    case Reader::Event::OBJECT_END:
+                    case Reader::Event::ARRAY_END:
+                    {
+                        size_t start = starts.back();
+                        starts.pop_back();
+
+                        uint32_t count = static_cast<uint32_t>(stack.size() - start);
+                        node.children = allocate(stack.data() + start, count);
+                        stack.resize(start);
+
+                        if (reader.getEvent() == Reader::Event::OBJECT_END)
+                        {
+                            node.type = Node::Type::OBJECT;
+                            node.length = count / 2;
+                        }
+                        else
+                        {
+                            node.type = Node::Type::ARRAY;
+                            node.length = count;
+                        }
+                        break;
+                    }
+                    case Reader::Event::KEY:
+                    case Reader::Event::STRING:
+                        node.type = Node::Type::STRING;
+                        node.length = reader.getString().getLength();
+                        node.stringValue = reader.getString().getData();
+                        break;
+                    case Reader::Event::NUMBER:
+                        node.type = Node::Type::NUMBER;
+                        node.numberValue = reader.getNumber();
+                        break;
+                    case Reader::Event::BOOLEAN:
+                        node.type = Node::Type::BOOLEAN;
+                        node.booleanValue = reader.getBoolean();
+                        break;
+                    case Reader::Event::NULL_VALUE:
+                        break;
+                    case Reader::Event::END:
+                        if (!stack.empty()) root = stack.front();
+                        return true;
+                    default:
+                        blocks.clear();
+                        return false;
+                }
+
+                stack.push_back(node);
+            }
+        }
+    } // namespace json
+} // namespace ouzel
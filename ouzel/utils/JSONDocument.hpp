@@ -0,0 +1,109 @@
+// Copyright (C) 2018 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "utils/JSONReader.hpp"
+
+namespace ouzel
+{
+    namespace json
+    {
+        // compact read-only DOM node, all nodes of a document live in its arena
+        class Node
+        {
+            friend class Document;
+        public:
+            enum class Type: uint8_t
+            {
+                NULL_VALUE,
+                OBJECT,
+                ARRAY,
+                STRING,
+                NUMBER,
+                BOOLEAN
+            };
+
+            Node(): numberValue(0.0) {}
+
+            Type getType() const { return type; }
+            bool isNull() const { return type == Type::NULL_VALUE; }
+            bool isObject() const { return type == Type::OBJECT; }
+            bool isArray() const { return type == Type::ARRAY; }
+            bool isString() const { return type == Type::STRING; }
+            bool isNumber() const { return type == Type::NUMBER; }
+            bool isBoolean() const { return type == Type::BOOLEAN; }
+
+            double asDouble() const { return (type == Type::NUMBER) ? numberValue : 0.0; }
+            float asFloat() const { return static_cast<float>(asDouble()); }
+            int32_t asInt32() const { return static_cast<int32_t>(asDouble()); }
+            uint32_t asUInt32() const { return static_cast<uint32_t>(asDouble()); }
+            bool asBool() const { return (type == Type::BOOLEAN) ? booleanValue : false; }
+            StringView asString() const { return (type == Type::STRING) ? StringView(stringValue, length) : StringView(); }
+
+            // number of array elements or object members
+            uint32_t getSize() const { return (type == Type::OBJECT || type == Type::ARRAY) ? length : 0; }
+
+            // array element, null node if out of range
+            const Node& operator[](uint32_t index) const;
+
+            // object member, null node if missing
+            const Node& operator[](const char* key) const;
+            bool hasMember(const char* key) const;
+
+            const Node& getMemberName(uint32_t index) const;
+            const Node& getMemberValue(uint32_t index) const;
+
+            const Node* begin() const { return (type == Type::ARRAY) ? children : nullptr; }
+            const Node* end() const { return (type == Type::ARRAY) ? children + length : nullptr; }
+
+        private:
+            Type type = Type::NULL_VALUE;
+            uint32_t length = 0;
+            union
+            {
+                double numberValue;
+                bool booleanValue;
+                const char* stringValue;
+                const Node* children; // objects store name and value nodes interleaved
+            };
+        };
+
+        class Document
+        {
+        public:
+            Document();
+            Document(const std::string& filename);
+            Document(const std::vector<uint8_t>& data);
+
+            Document(const Document&) = delete;
+            Document& operator=(const Document&) = delete;
+
+            bool init(const std::string& filename);
+            bool init(const std::vector<uint8_t>& data);
+            bool init(std::vector<uint8_t>&& data);
+
+            const Node& getRoot() const { return root; }
+            const Node& operator[](const char* key) const { return root[key]; }
+            bool hasMember(const char* key) const { return root.hasMember(key); }
+
+            bool hasBOM() const { return bom; }
+
+        private:
+            bool parse();
+            const Node* allocate(const Node* nodes, uint32_t count);
+
+            std::vector<uint8_t> buffer;
+            std::vector<std::unique_ptr<Node[]>> blocks;
+            uint32_t blockSize = 0;
+            uint32_t blockUsed = 0;
+
+            Node root;
+            bool bom = false;
+        };
+    } // namespace json
+} // namespace ouzel
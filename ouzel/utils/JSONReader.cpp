@@ -0,0 +1,347 @@
+// Copyright (C) 2018 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#include "JSONReader.hpp"
+#include "Log.hpp"
+#include "Utils.hpp"
+
+namespace ouzel
+{
+    namespace json
+    {
+        static inline bool isDigit(uint8_t c)
+        {
+            return c >= '0' && c <= '9';
+        }
+
+        static bool parseHex(const uint8_t* current, const uint8_t* end, uint32_t& result)
+        {
+            if (end - current < 4) return false;
+
+            result = 0;
+
+            for (uint32_t i = 0; i < 4; ++i)
+            {
+                uint8_t c = current[i];
+                result <<= 4;
+
+                if (c >= '0' && c <= '9') result |= static_cast<uint32_t>(c - '0');
+                else if (c >= 'a' && c <= 'f') result |= static_cast<uint32_t>(c - 'a' + 10);
+                else if (c >= 'A' && c <= 'F') result |= static_cast<uint32_t>(c - 'A' + 10);
+                else return false;
+            }
+
+            return true;
+        }
+
+        static uint8_t* encodeUtf8(uint32_t c, uint8_t* result)
+        {
+            if (c <= 0x7F)
+            {
+                *result++ = static_cast<uint8_t>(c);
+            }
+            else if (c <= 0x7FF)
+            {
+                *result++ = static_cast<uint8_t>(0xC0 | ((c >> 6) & 0x1F));
+                *result++ = static_cast<uint8_t>(0x80 | (c & 0x3F));
+            }
+            else if (c <= 0xFFFF)
+            {
+                *result++ = static_cast<uint8_t>(0xE0 | ((c >> 12) & 0x0F));
+                *result++ = static_cast<uint8_t>(0x80 | ((c >> 6) & 0x3F));
+                *result++ = static_cast<uint8_t>(0x80 | (c & 0x3F));
+            }
+            else
+            {
+                *result++ = static_cast<uint8_t>(0xF0 | ((c >> 18) & 0x07));
+                *result++ = static_cast<uint8_t>(0x80 | ((c >> 12) & 0x3F));
+                *result++ = static_cast<uint8_t>(0x80 | ((c >> 6) & 0x3F));
+                *result++ = static_cast<uint8_t>(0x80 | (c & 0x3F));
+            }
+
+            return result;
+        }
+
+        Reader::Reader(uint8_t* begin, uint8_t* initEnd):
+            current(begin), end(initEnd)
+        {
+            // BOM
+            if (end - current >= 3 &&
+                current[0] == 0xEF &&
+                current[1] == 0xBB &&
+                current[2] == 0xBF)
+            {
+                bom = true;
+                current += 3;
+            }
+        }
+
+        Reader::Event Reader::error(const char* message)
+        {
+            Log(Log::Level::ERR) << message;
+            return event = Event::ERROR;
+        }
+
+        void Reader::skipWhitespaces()
+        {
+            while (current != end &&
+                   (*current == ' ' || *current == '\t' || *current == '\r' || *current == '\n'))
+            {
+                ++current;
+            }
+        }
+
+        Reader::Event Reader::next()
+        {
+            if (event == Event::ERROR || event == Event::END) return event;
+
+            skipWhitespaces();
+
+            if (containers.empty())
+            {
+                if (rootParsed)
+                {
+                    if (current != end) return error("Unexpected data after the root value");
+                    return event = Event::END;
+                }
+
+                rootParsed = true;
+                return parseValue();
+            }
+
+            if (current == end) return error("Unexpected end of data");
+
+            if (containers.back() == '{')
+            {
+                if (afterKey)
+                {
+                    if (*current != ':') return error("Expected a colon");
+                    ++current;
+                    afterKey = false;
+
+                    skipWhitespaces();
+                    return parseValue();
+                }
+
+                if (*current == '}')
+                {
+                    ++current;
+                    containers.pop_back();
+                    first = false;
+                    return event = Event::OBJECT_END;
+                }
+
+                if (!first)
+                {
+                    if (*current != ',') return error("Expected a comma");
+                    ++current;
+                    skipWhitespaces();
+                }
+
+                if (current == end || *current != '"') return error("Expected a key");
+                if (!parseString()) return event = Event::ERROR;
+
+                afterKey = true;
+                return event = Event::KEY;
+            }
+            else
+            {
+                if (*current == ']')
+                {
+                    ++current;
+                    containers.pop_back();
+                    first = false;
+                    return event = Event::ARRAY_END;
+                }
+
+                if (!first)
+                {
+                    if (*current != ',') return error("Expected a comma");
+                    ++current;
+                    skipWhitespaces();
+                }
+
+                return parseValue();
+            }
+        }
+
+        bool Reader::skipValue()
+        {
+            Event valueEvent = next();
+
+            if (valueEvent == Event::OBJECT_START || valueEvent == Event::ARRAY_START)
+            {
+                return skipContainer();
+            }
+
+            return valueEvent != Event::ERROR && valueEvent != Event::END;
+        }
+
+        bool Reader::skipContainer()
+        {
+            size_t depth = containers.size();
+
+            while (containers.size() >= depth)
+            {
+                Event containerEvent = next();
+                if (containerEvent == Event::ERROR || containerEvent == Event::END) return false;
+            }
+
+            return true;
+        }
+
+        Reader::Event Reader::parseValue()
+        {
+            if (current == end) return error("Unexpected end of data");
+
+            first = false;
+
+            switch (*current)
+            {
+                case '{':
+                    ++current;
+                    containers.push_back('{');
+                    first = true;
+                    return event = Event::OBJECT_START;
+                case '[':
+                    ++current;
+                    containers.push_back('[');
+                    first = true;
+                    return event = Event::ARRAY_START;
+                case '"':
+                    if (!parseString()) return event = Event::ERROR;
+                    return event = Event::STRING;
+                case 't':
+                    if (end - current < 4 || memcmp(current, "true", 4) != 0) return error("Invalid keyword");
+                    current += 4;
+                    booleanValue = true;
+                    return event = Event::BOOLEAN;
+                case 'f':
+                    if (end - current < 5 || memcmp(current, "false", 5) != 0) return error("Invalid keyword");
+                    current += 5;
+                    booleanValue = false;
+                    return event = Event::BOOLEAN;
+                case 'n':
+                    if (end - current < 4 || memcmp(current, "null", 4) != 0) return error("Invalid keyword");
+                    current += 4;
+                    return event = Event::NULL_VALUE;
+                default:
+                    if (*current == '-' || isDigit(*current))
+                    {
+                        if (!parseNumber()) return event = Event::ERROR;
+                        return event = Event::NUMBER;
+                    }
+
+                    return error("Expected a value");
+            }
+        }
+
+        bool Reader::parseString()
+        {
+            ++current; // opening quote
+
+            uint8_t* start = current;
+            uint8_t* output = current;
+
+            for (;;)
+            {
+                if (current == end)
+                {
+                    Log(Log::Level::ERR) << "Unterminated string";
+                    return false;
+                }
+
+                uint8_t c = *current;
+
+                if (c == '"')
+                {
+                    break;
+                }
+                else if (c == '\\')
+                {
+                    if (++current == end)
+                    {
+                        Log(Log::Level::ERR) << "Unterminated string";
+                        return false;
+                    }
+
+                    switch (*current)
+                    {
+                        case '"': *output++ = '"'; break;
+                        case '\\': *output++ = '\\'; break;
+                        case '/': *output++ = '/'; break;
+                        case 'b': *output++ = '\b'; break;
+                        case 'f': *output++ = '\f'; break;
+                        case 'n': *output++ = '\n'; break;
+                        case 'r': *output++ = '\r'; break;
+                        case 't': *output++ = '\t'; break;
+                        case 'u':
+                        {
+                            uint32_t codePoint;
+                            if (!parseHex(current + 1, end, codePoint))
+                            {
+                                Log(Log::Level::ERR) << "Invalid unicode escape sequence";
+                                return false;
+                            }
+                            current += 4;
+
+                            // surrogate pair
+                            if (codePoint >= 0xD800 && codePoint <= 0xDBFF)
+                            {
+                                uint32_t lowSurrogate;
+                                if (end - current < 3 || current[1] != '\\' || current[2] != 'u' ||
+                                    !parseHex(current + 3, end, lowSurrogate) ||
+                                    lowSurrogate < 0xDC00 || lowSurrogate > 0xDFFF)
+                                {
+                                    Log(Log::Level::ERR) << "Invalid surrogate pair";
+                                    return false;
+                                }
+                                current += 6;
+
+                                codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (lowSurrogate - 0xDC00);
+                            }
+
+                            // the encoded character is never longer than its escape sequence
+                            output = encodeUtf8(codePoint, output);
+                            break;
+                        }
+                        default:
+                            Log(Log::Level::ERR) << "Invalid escape sequence";
+                            return false;
+                    }
+
+                    ++current;
+                }
+                else if (c < 0x20)
+                {
+                    Log(Log::Level::ERR) << "Unexpected control character";
+                    return false;
+                }
+                else
+                {
+                    *output++ = c;
+                    ++current;
+                }
+            }
+
+            // terminate the string in place of the closing quote (or earlier if escapes were decoded)
+            *output = '\0';
+            ++current;
+
+            stringValue = StringView(reinterpret_cast<const char*>(start), static_cast<uint32_t>(output - start));
+
+            return true;
+        }
+
+        bool Reader::parseNumber()
+        {
+            if (!parseDecimal(current, end, numberValue, true))
+            {
+                Log(Log::Level::ERR) << "Expected a digit";
+                return false;
+            }
+
+            return true;
+        }
+    } // namespace json
+} // namespace ouzel
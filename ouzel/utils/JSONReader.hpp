@@ -0,0 +1,77 @@
+// Copyright (C) 2018 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "utils/StringView.hpp"
+
+namespace ouzel
+{
+    namespace json
+    {
+        // single-pass pull parser that works directly on UTF-8 bytes
+        // escape sequences are decoded in-situ, so the buffer is modified while parsing
+        class Reader
+        {
+        public:
+            enum class Event
+            {
+                NONE,
+                OBJECT_START,
+                OBJECT_END,
+                ARRAY_START,
+                ARRAY_END,
+                KEY,
+                STRING,
+                NUMBER,
+                BOOLEAN,
+                NULL_VALUE,
+                END,
+                ERROR
+            };
+
+            Reader(uint8_t* begin, uint8_t* end);
+
+            Event next();
+
+            // skips the next value, including all of its children
+            bool skipValue();
+            // skips the remaining children of the object or array that was just started
+            bool skipContainer();
+
+            Event getEvent() const { return event; }
+            size_t getDepth() const { return containers.size(); }
+
+            // valid after KEY and STRING events
+            const StringView& getString() const { return stringValue; }
+            // valid after NUMBER events
+            double getNumber() const { return numberValue; }
+            // valid after BOOLEAN events
+            bool getBoolean() const { return booleanValue; }
+
+            bool hasBOM() const { return bom; }
+
+        private:
+            Event error(const char* message);
+            void skipWhitespaces();
+            Event parseValue();
+            bool parseString();
+            bool parseNumber();
+
+            uint8_t* current;
+            uint8_t* end;
+            std::vector<uint8_t> containers;
+            bool first = true;
+            bool afterKey = false;
+            bool rootParsed = false;
+            bool bom = false;
+
+            Event event = Event::NONE;
+            StringView stringValue;
+            double numberValue = 0.0;
+            bool booleanValue = false;
+        };
+    } // namespace json
+} // namespace ouzel
@@ -0,0 +1,61 @@
+// Copyright (C) 2018 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#include <algorithm>
+#include "LatencyHistogram.hpp"
+
+namespace ouzel
+{
+    LatencyHistogram::LatencyHistogram()
+    {
+        reset();
+    }
+
+    void LatencyHistogram::add(std::chrono::steady_clock::duration latency)
+    {
+        int64_t microseconds = std::chrono::duration_cast<std::chrono::microseconds>(latency).count();
+        uint64_t value = (microseconds > 0) ? static_cast<uint64_t>(microseconds) : 0;
+        uint32_t bucket = static_cast<uint32_t>(std::min(value / BUCKET_WIDTH, static_cast<uint64_t>(BUCKET_COUNT - 1)));
+
+        buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+        total.fetch_add(value, std::memory_order_relaxed);
+        if (value > max.load(std::memory_order_relaxed)) max.store(value, std::memory_order_relaxed);
+        count.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void LatencyHistogram::reset()
+    {
+        for (std::atomic<uint32_t>& bucket : buckets)
+            bucket.store(0, std::memory_order_relaxed);
+
+        count.store(0, std::memory_order_relaxed);
+        total.store(0, std::memory_order_relaxed);
+        max.store(0, std::memory_order_relaxed);
+    }
+
+    std::chrono::microseconds LatencyHistogram::getMean() const
+    {
+        uint64_t currentCount = count;
+        return std::chrono::microseconds(currentCount ? total / currentCount : 0);
+    }
+
+    std::chrono::microseconds LatencyHistogram::getPercentile(float fraction) const
+    {
+        uint64_t currentCount = 0;
+        for (const std::atomic<uint32_t>& bucket : buckets)
+            currentCount += bucket.load(std::memory_order_relaxed);
+
+        if (!currentCount) return std::chrono::microseconds(0);
+
+        uint64_t target = static_cast<uint64_t>(std::max(0.0f, std::min(fraction, 1.0f)) * currentCount);
+        uint64_t sum = 0;
+
+        for (uint32_t i = 0; i < BUCKET_COUNT; ++i)
+        {
+            sum += buckets[i].load(std::memory_order_relaxed);
+            if (sum >= target && sum > 0) return std::chrono::microseconds((i + 1) * BUCKET_WIDTH);
+        }
+
+        return std::chrono::microseconds(BUCKET_COUNT * BUCKET_WIDTH);
+    }
+}
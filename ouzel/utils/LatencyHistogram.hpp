@@ -0,0 +1,40 @@
+// Copyright (C) 2018 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include "utils/Noncopyable.hpp"
+
+namespace ouzel
+{
+    // counts of durations in fixed-width buckets, written by one thread and readable from any thread
+    class LatencyHistogram: public Noncopyable
+    {
+    public:
+        static const uint32_t BUCKET_COUNT = 256;
+        // in microseconds, the last bucket also holds all of the longer durations
+        static const uint32_t BUCKET_WIDTH = 250;
+
+        LatencyHistogram();
+
+        void add(std::chrono::steady_clock::duration latency);
+        void reset();
+
+        uint64_t getCount() const { return count; }
+        uint32_t getBucket(uint32_t index) const { return buckets[index]; }
+
+        std::chrono::microseconds getMean() const;
+        std::chrono::microseconds getMax() const { return std::chrono::microseconds(max); }
+        // upper bound of the bucket below which the given fraction (0-1) of the durations are
+        std::chrono::microseconds getPercentile(float fraction) const;
+
+    private:
+        std::atomic<uint32_t> buckets[BUCKET_COUNT];
+        std::atomic<uint64_t> count;
+        std::atomic<uint64_t> total;
+        std::atomic<uint64_t> max;
+    };
+}
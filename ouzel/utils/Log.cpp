@@ -2,8 +2,20 @@
 // This file is part of the Ouzel engine.
 
 #include "core/Setup.h"
-#include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
+
+#if OUZEL_MULTITHREADED
+#include <condition_variable>
+#include <thread>
+#endif
 
 #if OUZEL_PLATFORM_IOS || OUZEL_PLATFORM_TVOS
 #include <sys/syslog.h>
@@ -33,20 +45,133 @@ namespace ouzel
 
 #endif
 
-    Log::~Log()
+    namespace
     {
-        if (!s.empty())
+        enum Tag: uint8_t
+        {
+            TAG_STRING,
+            TAG_SIGNED,
+            TAG_UNSIGNED,
+            TAG_DOUBLE,
+            TAG_FLOAT,
+            TAG_CHAR
+        };
+
+        // level and category
+        const uint32_t HEADER_SIZE = 2;
+
+        struct RateLimit
+        {
+            std::atomic<uint32_t> limit{0};
+            std::atomic<uint32_t> second{0};
+            std::atomic<uint32_t> count{0};
+        };
+
+        RateLimit rateLimits[Log::MAX_CATEGORIES];
+        std::atomic<uint64_t> droppedCount{0};
+        std::atomic<uint64_t> rateLimitedCount{0};
+
+        bool checkRateLimit(uint32_t category)
+        {
+            if (category >= Log::MAX_CATEGORIES) return true;
+
+            RateLimit& rateLimit = rateLimits[category];
+            uint32_t limit = rateLimit.limit.load(std::memory_order_relaxed);
+            if (!limit) return true;
+
+            uint32_t second = static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+
+            // records of the other threads around the start of a new second may be counted in the old one
+            if (rateLimit.second.exchange(second, std::memory_order_relaxed) != second)
+                rateLimit.count.store(0, std::memory_order_relaxed);
+
+            if (rateLimit.count.fetch_add(1, std::memory_order_relaxed) >= limit)
+            {
+                rateLimitedCount.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+
+            return true;
+        }
+
+        template<typename T> T readValue(const uint8_t* data)
+        {
+            T result;
+            memcpy(&result, data, sizeof(T));
+            return result;
+        }
+
+        std::string formatRecord(const uint8_t* data, uint32_t size)
+        {
+            std::string result;
+            uint32_t offset = 0;
+
+            while (offset < size)
+            {
+                switch (data[offset++])
+                {
+                    case TAG_STRING:
+                    {
+                        uint32_t length = readValue<uint32_t>(data + offset);
+                        offset += sizeof(length);
+                        result.append(reinterpret_cast<const char*>(data + offset), length);
+                        offset += length;
+                        break;
+                    }
+                    case TAG_SIGNED:
+                        result += std::to_string(readValue<int64_t>(data + offset));
+                        offset += sizeof(int64_t);
+                        break;
+                    case TAG_UNSIGNED:
+                        result += std::to_string(readValue<uint64_t>(data + offset));
+                        offset += sizeof(uint64_t);
+                        break;
+                    case TAG_DOUBLE:
+                        result += std::to_string(readValue<double>(data + offset));
+                        offset += sizeof(double);
+                        break;
+                    case TAG_FLOAT:
+                        result += std::to_string(readValue<float>(data + offset));
+                        offset += sizeof(float);
+                        break;
+                    case TAG_CHAR:
+                        result += static_cast<char>(data[offset++]);
+                        break;
+                    default:
+                        return result;
+                }
+            }
+
+            return result;
+        }
+
+        const char* getLevelName(Log::Level level)
+        {
+            switch (level)
+            {
+                case Log::Level::ERR: return "ERR";
+                case Log::Level::WARN: return "WARN";
+                case Log::Level::INFO: return "INFO";
+                case Log::Level::ALL: return "ALL";
+                default: return "";
+            }
+        }
+
+        // the desktop consoles are flushed by flushConsole, once per batch of records
+        void writeToConsole(Log::Level level, const std::string& s)
         {
 #if OUZEL_PLATFORM_MACOS || OUZEL_PLATFORM_LINUX || OUZEL_PLATFORM_RASPBIAN
             switch (level)
             {
-                case Level::ERR:
-                case Level::WARN:
-                    std::cerr << s << std::endl;
+                case Log::Level::ERR:
+                case Log::Level::WARN:
+                    fwrite(s.data(), 1, s.length(), stderr);
+                    fputc('\n', stderr);
                     break;
-                case Level::INFO:
-                case Level::ALL:
-                    std::cout << s << std::endl;
+                case Log::Level::INFO:
+                case Log::Level::ALL:
+                    fwrite(s.data(), 1, s.length(), stdout);
+                    fputc('\n', stdout);
                     break;
                 default: break;
             }
@@ -54,10 +179,10 @@ namespace ouzel
             int priority = 0;
             switch (level)
             {
-                case Level::ERR: priority = LOG_ERR; break;
-                case Level::WARN: priority = LOG_WARNING; break;
-                case Level::INFO: priority = LOG_INFO; break;
-                case Level::ALL: priority = LOG_DEBUG; break;
+                case Log::Level::ERR: priority = LOG_ERR; break;
+                case Log::Level::WARN: priority = LOG_WARNING; break;
+                case Log::Level::INFO: priority = LOG_INFO; break;
+                case Log::Level::ALL: priority = LOG_DEBUG; break;
                 default: break;
             }
             syslog(priority, "%s", s.c_str());
@@ -75,12 +200,12 @@ namespace ouzel
             HANDLE handle = 0;
             switch (level)
             {
-            case Level::ERR:
-            case Level::WARN:
+            case Log::Level::ERR:
+            case Log::Level::WARN:
                 handle = GetStdHandle(STD_ERROR_HANDLE);
                 break;
-            case Level::INFO:
-            case Level::ALL:
+            case Log::Level::INFO:
+            case Log::Level::ALL:
                 handle = GetStdHandle(STD_OUTPUT_HANDLE);
                 break;
             default: break;
@@ -97,20 +222,491 @@ namespace ouzel
             int priority = 0;
             switch (level)
             {
-                case Level::ERR: priority = ANDROID_LOG_ERROR; break;
-                case Level::WARN: priority = ANDROID_LOG_WARN; break;
-                case Level::INFO: priority = ANDROID_LOG_INFO; break;
-                case Level::ALL: priority = ANDROID_LOG_DEBUG; break;
+                case Log::Level::ERR: priority = ANDROID_LOG_ERROR; break;
+                case Log::Level::WARN: priority = ANDROID_LOG_WARN; break;
+                case Log::Level::INFO: priority = ANDROID_LOG_INFO; break;
+                case Log::Level::ALL: priority = ANDROID_LOG_DEBUG; break;
                 default: break;
             }
             __android_log_print(priority, "Ouzel", "%s", s.c_str());
 #elif OUZEL_PLATFORM_EMSCRIPTEN
             int flags = EM_LOG_CONSOLE;
-            if (level == Level::ERR) flags |= EM_LOG_ERROR;
-            else if (level == Level::WARN) flags |= EM_LOG_WARN;
+            if (level == Log::Level::ERR) flags |= EM_LOG_ERROR;
+            else if (level == Log::Level::WARN) flags |= EM_LOG_WARN;
             emscripten_log(flags, "%s", s.c_str());
 #endif
-            s.clear();
+        }
+
+        void flushConsole()
+        {
+#if OUZEL_PLATFORM_MACOS || OUZEL_PLATFORM_LINUX || OUZEL_PLATFORM_RASPBIAN
+            fflush(stdout);
+            fflush(stderr);
+#endif
+        }
+
+#if OUZEL_MULTITHREADED
+        // single producer, single consumer ring of records prefixed with their size
+        class LogRing
+        {
+        public:
+            static const uint32_t SIZE = 65536;
+
+            // called only by the thread that owns the ring
+            bool push(const uint8_t* header, const uint8_t* data, uint32_t size)
+            {
+                uint32_t recordSize = HEADER_SIZE + size;
+                uint32_t currentHead = head.load(std::memory_order_relaxed);
+
+                if (SIZE - (currentHead - tail.load(std::memory_order_acquire)) < sizeof(recordSize) + recordSize)
+                    return false;
+
+                write(currentHead, reinterpret_cast<const uint8_t*>(&recordSize), sizeof(recordSize));
+                write(currentHead + sizeof(recordSize), header, HEADER_SIZE);
+                write(currentHead + sizeof(recordSize) + HEADER_SIZE, data, size);
+
+                head.store(currentHead + sizeof(recordSize) + recordSize, std::memory_order_release);
+
+                return true;
+            }
+
+            // called only by the writer thread
+            bool pop(std::vector<uint8_t>& record)
+            {
+                uint32_t currentTail = tail.load(std::memory_order_relaxed);
+                if (currentTail == head.load(std::memory_order_acquire)) return false;
+
+                uint32_t recordSize;
+                read(currentTail, reinterpret_cast<uint8_t*>(&recordSize), sizeof(recordSize));
+                record.resize(recordSize);
+                read(currentTail + sizeof(recordSize), record.data(), recordSize);
+
+                tail.store(currentTail + sizeof(recordSize) + recordSize, std::memory_order_release);
+
+                return true;
+            }
+
+            uint32_t getUsedSize() const
+            {
+                return head.load(std::memory_order_relaxed) - tail.load(std::memory_order_relaxed);
+            }
+
+            bool isEmpty() const
+            {
+                return head.load(std::memory_order_acquire) == tail.load(std::memory_order_relaxed);
+            }
+
+            // set when the owning thread exits, the writer removes the ring after draining it
+            std::atomic<bool> closed{false};
+
+        private:
+            void write(uint32_t position, const uint8_t* src, uint32_t count)
+            {
+                uint32_t offset = position & (SIZE - 1);
+                uint32_t first = std::min(count, SIZE - offset);
+                memcpy(data + offset, src, first);
+                memcpy(data, src + first, count - first);
+            }
+
+            void read(uint32_t position, uint8_t* dst, uint32_t count) const
+            {
+                uint32_t offset = position & (SIZE - 1);
+                uint32_t first = std::min(count, SIZE - offset);
+                memcpy(dst, data + offset, first);
+                memcpy(dst + first, data, count - first);
+            }
+
+            // positions only grow and wrap around at 2^32, which is a multiple of SIZE
+            alignas(64) std::atomic<uint32_t> head{0};
+            alignas(64) std::atomic<uint32_t> tail{0};
+            alignas(64) uint8_t data[SIZE];
+        };
+
+        static_assert(Log::MAX_RECORD_SIZE * 4 <= LogRing::SIZE, "Log ring must fit several records of the maximum size");
+
+        struct RingHolder
+        {
+            ~RingHolder()
+            {
+                if (ring) ring->closed = true;
+            }
+
+            std::shared_ptr<LogRing> ring;
+        };
+
+        thread_local RingHolder ringHolder;
+#endif
+
+        // set when the logger is destroyed at exit, the records are then written synchronously
+        std::atomic<bool> loggerDestroyed{false};
+
+        class Logger
+        {
+        public:
+            Logger()
+            {
+#if OUZEL_MULTITHREADED
+                writerThread = std::thread(&Logger::run, this);
+#endif
+            }
+
+            ~Logger()
+            {
+                loggerDestroyed = true;
+
+#if OUZEL_MULTITHREADED
+                {
+                    std::unique_lock<std::mutex> lock(wakeMutex);
+                    running = false;
+                }
+                wakeCondition.notify_all();
+
+                if (writerThread.joinable()) writerThread.join();
+#endif
+
+                for (FILE* file : fileSinks)
+                    fclose(file);
+            }
+
+            void log(const uint8_t* header, const uint8_t* data, uint32_t size)
+            {
+#if OUZEL_MULTITHREADED
+                if (!ringHolder.ring)
+                {
+                    ringHolder.ring = std::make_shared<LogRing>();
+
+                    std::unique_lock<std::mutex> lock(ringMutex);
+                    rings.push_back(ringHolder.ring);
+                }
+
+                if (!ringHolder.ring->push(header, data, size))
+                {
+                    droppedCount.fetch_add(1, std::memory_order_relaxed);
+                    wake();
+                }
+                else if (static_cast<Log::Level>(header[0]) == Log::Level::ERR ||
+                         ringHolder.ring->getUsedSize() > LogRing::SIZE / 2)
+                    wake();
+#else
+                write(static_cast<Log::Level>(header[0]), formatRecord(data, size));
+                flushOutputs();
+#endif
+            }
+
+            void flush()
+            {
+#if OUZEL_MULTITHREADED
+                std::unique_lock<std::mutex> lock(wakeMutex);
+                uint64_t request = ++flushRequest;
+                wakeCondition.notify_all();
+                flushCondition.wait(lock, [this, request]() { return flushDone >= request || !running; });
+#endif
+            }
+
+            bool addFileSink(const std::string& filename)
+            {
+                FILE* file = fopen(filename.c_str(), "a");
+                if (!file) return false;
+
+                std::unique_lock<std::mutex> lock(sinkMutex);
+                fileSinks.push_back(file);
+
+                return true;
+            }
+
+            void removeFileSinks()
+            {
+                std::unique_lock<std::mutex> lock(sinkMutex);
+
+                for (FILE* file : fileSinks)
+                    fclose(file);
+
+                fileSinks.clear();
+            }
+
+        private:
+            void write(Log::Level level, const std::string& s)
+            {
+                writeToConsole(level, s);
+
+                std::unique_lock<std::mutex> lock(sinkMutex);
+
+                for (FILE* file : fileSinks)
+                    fprintf(file, "[%s] %s\n", getLevelName(level), s.c_str());
+            }
+
+            void flushOutputs()
+            {
+                flushConsole();
+
+                std::unique_lock<std::mutex> lock(sinkMutex);
+
+                for (FILE* file : fileSinks)
+                    fflush(file);
+            }
+
+#if OUZEL_MULTITHREADED
+            void wake()
+            {
+                // the writer wakes up periodically anyway, so a missed notification only delays the output
+                if (!wakeRequested.exchange(true, std::memory_order_relaxed))
+                    wakeCondition.notify_one();
+            }
+
+            void run()
+            {
+                std::vector<uint8_t> record;
+                std::vector<std::shared_ptr<LogRing>> currentRings;
+                uint64_t reportedDropped = 0;
+
+                for (;;)
+                {
+                    bool stop;
+                    uint64_t request;
+
+                    {
+                        std::unique_lock<std::mutex> lock(wakeMutex);
+                        wakeCondition.wait_for(lock, std::chrono::milliseconds(10), [this]() {
+                            return wakeRequested.load(std::memory_order_relaxed) || flushRequest != flushDone || !running;
+                        });
+                        wakeRequested.store(false, std::memory_order_relaxed);
+                        stop = !running;
+                        request = flushRequest;
+                    }
+
+                    {
+                        std::unique_lock<std::mutex> lock(ringMutex);
+                        currentRings = rings;
+                    }
+
+                    bool written = false;
+
+                    for (const std::shared_ptr<LogRing>& ring : currentRings)
+                    {
+                        while (ring->pop(record))
+                        {
+                            write(static_cast<Log::Level>(record[0]), formatRecord(record.data() + HEADER_SIZE,
+                                                                                   static_cast<uint32_t>(record.size()) - HEADER_SIZE));
+                            written = true;
+                        }
+                    }
+
+                    uint64_t dropped = droppedCount.load(std::memory_order_relaxed);
+                    if (dropped != reportedDropped)
+                    {
+                        write(Log::Level::WARN, std::to_string(dropped - reportedDropped) + " log records dropped");
+                        reportedDropped = dropped;
+                        written = true;
+                    }
+
+                    if (written) flushOutputs();
+
+                    {
+                        std::unique_lock<std::mutex> lock(ringMutex);
+
+                        // rings of the threads that have exited are removed once they have been drained
+                        rings.erase(std::remove_if(rings.begin(), rings.end(), [](const std::shared_ptr<LogRing>& ring) {
+                            return ring->closed && ring->isEmpty();
+                        }), rings.end());
+                    }
+
+                    currentRings.clear();
+
+                    {
+                        std::unique_lock<std::mutex> lock(wakeMutex);
+                        flushDone = request;
+                    }
+                    flushCondition.notify_all();
+
+                    if (stop) break;
+                }
+            }
+
+            std::mutex ringMutex;
+            std::vector<std::shared_ptr<LogRing>> rings;
+
+            std::mutex wakeMutex;
+            std::condition_variable wakeCondition;
+            std::condition_variable flushCondition;
+            std::atomic<bool> wakeRequested{false};
+            uint64_t flushRequest = 0;
+            uint64_t flushDone = 0;
+            bool running = true;
+            std::thread writerThread;
+#endif
+
+            std::mutex sinkMutex;
+            std::vector<FILE*> fileSinks;
+        };
+
+        Logger& getLogger()
+        {
+            static Logger logger;
+            return logger;
+        }
+    }
+
+    bool Log::setRateLimit(uint32_t category, uint32_t recordsPerSecond)
+    {
+        if (category >= MAX_CATEGORIES)
+        {
+            Log(Log::Level::ERR) << "Invalid log category " << category;
+            return false;
+        }
+
+        rateLimits[category].limit = recordsPerSecond;
+
+        return true;
+    }
+
+    bool Log::addFileSink(const std::string& filename)
+    {
+        if (!getLogger().addFileSink(filename))
+        {
+            Log(Log::Level::ERR) << "Failed to open log file " << filename;
+            return false;
+        }
+
+        return true;
+    }
+
+    void Log::removeFileSinks()
+    {
+        getLogger().removeFileSinks();
+    }
+
+    uint64_t Log::getDroppedCount()
+    {
+        return droppedCount;
+    }
+
+    uint64_t Log::getRateLimitedCount()
+    {
+        return rateLimitedCount;
+    }
+
+    void Log::flush()
+    {
+        if (!loggerDestroyed) getLogger().flush();
+    }
+
+    Log::~Log()
+    {
+        if (size)
+        {
+            if (!checkRateLimit(category)) return;
+
+            const uint8_t* data = heapData.empty() ? inlineData : heapData.data();
+            const uint8_t header[HEADER_SIZE] = {static_cast<uint8_t>(level), static_cast<uint8_t>(category)};
+
+            if (loggerDestroyed)
+            {
+                writeToConsole(level, formatRecord(data, size));
+                flushConsole();
+            }
+            else
+                getLogger().log(header, data, size);
+        }
+    }
+
+    void Log::copy(const Log& other)
+    {
+        if (&other == this) return;
+
+        level = other.level;
+        category = other.category;
+        size = other.size;
+        heapData = other.heapData;
+        if (heapData.empty()) memcpy(inlineData, other.inlineData, size);
+    }
+
+    uint8_t* Log::reserve(uint32_t count)
+    {
+        if (size + count > MAX_RECORD_SIZE) return nullptr;
+
+        uint8_t* result;
+
+        if (heapData.empty() && size + count <= sizeof(inlineData))
+            result = inlineData + size;
+        else
+        {
+            if (heapData.empty()) heapData.assign(inlineData, inlineData + size);
+            heapData.resize(size + count);
+            result = heapData.data() + size;
+        }
+
+        size += count;
+
+        return result;
+    }
+
+    void Log::writeSigned(int64_t val)
+    {
+        if (uint8_t* data = reserve(1 + sizeof(val)))
+        {
+            data[0] = TAG_SIGNED;
+            memcpy(data + 1, &val, sizeof(val));
+        }
+    }
+
+    void Log::writeUnsigned(uint64_t val)
+    {
+        if (uint8_t* data = reserve(1 + sizeof(val)))
+        {
+            data[0] = TAG_UNSIGNED;
+            memcpy(data + 1, &val, sizeof(val));
+        }
+    }
+
+    void Log::writeDouble(double val)
+    {
+        if (uint8_t* data = reserve(1 + sizeof(val)))
+        {
+            data[0] = TAG_DOUBLE;
+            memcpy(data + 1, &val, sizeof(val));
+        }
+    }
+
+    void Log::writeString(const char* val)
+    {
+        writeString(val, strlen(val));
+    }
+
+    void Log::writeString(const char* val, size_t length)
+    {
+        if (!length) return;
+
+        // strings that don't fit are truncated
+        uint32_t header = 1 + sizeof(uint32_t);
+        if (size + header >= MAX_RECORD_SIZE) return;
+        uint32_t count = static_cast<uint32_t>(std::min(length, static_cast<size_t>(MAX_RECORD_SIZE - size - header)));
+
+        if (uint8_t* data = reserve(header + count))
+        {
+            data[0] = TAG_STRING;
+            memcpy(data + 1, &count, sizeof(count));
+            memcpy(data + header, val, count);
+        }
+    }
+
+    void Log::writeFloats(const float* val, uint32_t count, uint32_t rowLength)
+    {
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            if (i > 0)
+            {
+                if (uint8_t* data = reserve(2))
+                {
+                    data[0] = TAG_CHAR;
+                    data[1] = (rowLength && i % rowLength == 0) ? '\n' : ',';
+                }
+            }
+
+            if (uint8_t* data = reserve(1 + sizeof(float)))
+            {
+                data[0] = TAG_FLOAT;
+                memcpy(data + 1, &val[i], sizeof(float));
+            }
         }
     }
 }
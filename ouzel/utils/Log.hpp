@@ -3,7 +3,10 @@
 
 #pragma once
 
+#include <cstdint>
 #include <string>
+#include <type_traits>
+#include <vector>
 #include "math/Matrix3.hpp"
 #include "math/Matrix4.hpp"
 #include "math/Quaternion.hpp"
@@ -15,6 +18,8 @@
 
 namespace ouzel
 {
+    // the arguments are stored in a binary record that is pushed into a ring of the calling thread when the Log is
+    // destroyed, a background thread formats the records and writes them to the console and the file sinks
     class Log
     {
     public:
@@ -29,47 +34,78 @@ namespace ouzel
 
         static Level threshold;
 
-        Log(Level initLevel = Level::INFO): level(initLevel)
+        static const uint32_t MAX_CATEGORIES = 32;
+        // longer records are truncated
+        static const uint32_t MAX_RECORD_SIZE = 16384;
+
+        // 0 means no limit, records over the limit are discarded
+        static bool setRateLimit(uint32_t category, uint32_t recordsPerSecond);
+        // the records are appended to the file with the level as a prefix
+        static bool addFileSink(const std::string& filename);
+        static void removeFileSinks();
+        // records that did not fit into the ring of their thread
+        static uint64_t getDroppedCount();
+        static uint64_t getRateLimitedCount();
+        // blocks until the records logged before the call are written
+        static void flush();
+
+        Log(Level initLevel = Level::INFO, uint32_t initCategory = 0):
+            level(initLevel), category(initCategory)
         {
         }
 
         Log(const Log& other)
         {
-            level = other.level;
-            s = other.s;
+            copy(other);
         }
 
         Log(Log&& other)
         {
-            level = other.level;
+            copy(other);
             other.level = Level::INFO;
-            s = std::move(other.s);
+            other.size = 0;
+            other.heapData.clear();
         }
 
         Log& operator=(const Log& other)
         {
-            level = other.level;
-            s = other.s;
+            copy(other);
 
             return *this;
         }
 
         Log& operator=(Log&& other)
         {
-            level = other.level;
+            copy(other);
             other.level = Level::INFO;
-            s = std::move(other.s);
+            other.size = 0;
+            other.heapData.clear();
 
             return *this;
         }
 
         ~Log();
 
-        template<typename T> Log& operator<<(T val)
+        template<typename T, typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value>::type* = nullptr>
+        Log& operator<<(T val)
         {
             if (level <= threshold)
             {
-                s += std::to_string(val);
+                if (std::is_unsigned<T>::value)
+                    writeUnsigned(static_cast<uint64_t>(val));
+                else
+                    writeSigned(static_cast<int64_t>(val));
+            }
+
+            return *this;
+        }
+
+        template<typename T, typename std::enable_if<std::is_floating_point<T>::value>::type* = nullptr>
+        Log& operator<<(T val)
+        {
+            if (level <= threshold)
+            {
+                writeDouble(static_cast<double>(val));
             }
 
             return *this;
@@ -79,7 +115,7 @@ namespace ouzel
         {
             if (level <= threshold)
             {
-                s += val;
+                writeString(val.data(), val.length());
             }
 
             return *this;
@@ -89,7 +125,7 @@ namespace ouzel
         {
             if (level <= threshold)
             {
-                s += val;
+                writeString(val);
             }
 
             return *this;
@@ -99,7 +135,7 @@ namespace ouzel
         {
             if (level <= threshold)
             {
-                s += val;
+                writeString(val);
             }
 
             return *this;
@@ -107,19 +143,20 @@ namespace ouzel
 
         Log& operator<<(const Matrix3& val)
         {
-            s += std::to_string(val.m[0]) + "," + std::to_string(val.m[1]) + "," + std::to_string(val.m[2]) + "\n" +
-                std::to_string(val.m[3]) + "," + std::to_string(val.m[4]) + "," + std::to_string(val.m[5]) + "\n" +
-                std::to_string(val.m[6]) + "," + std::to_string(val.m[7]) + "," + std::to_string(val.m[8]);
+            if (level <= threshold)
+            {
+                writeFloats(val.m, 9, 3);
+            }
 
             return *this;
         }
 
         Log& operator<<(const Matrix4& val)
         {
-            s += std::to_string(val.m[0]) + "," + std::to_string(val.m[1]) + "," + std::to_string(val.m[2]) + "," + std::to_string(val.m[3]) + "\n" +
-                std::to_string(val.m[4]) + "," + std::to_string(val.m[5]) + "," + std::to_string(val.m[6]) + "," + std::to_string(val.m[7]) + "\n" +
-                std::to_string(val.m[8]) + "," + std::to_string(val.m[9]) + "," + std::to_string(val.m[10]) + "," + std::to_string(val.m[11]) + "\n" +
-                std::to_string(val.m[12]) + "," + std::to_string(val.m[13]) + "," + std::to_string(val.m[14]) + "," + std::to_string(val.m[15]);
+            if (level <= threshold)
+            {
+                writeFloats(val.m, 16, 4);
+            }
 
             return *this;
         }
@@ -128,8 +165,8 @@ namespace ouzel
         {
             if (level <= threshold)
             {
-                s += std::to_string(val.x) + "," + std::to_string(val.y) + "," +
-                    std::to_string(val.z) + "," + std::to_string(val.w);
+                const float values[] = {val.x, val.y, val.z, val.w};
+                writeFloats(values, 4);
             }
 
             return *this;
@@ -139,7 +176,8 @@ namespace ouzel
         {
             if (level <= threshold)
             {
-                s += std::to_string(val.width) + "," + std::to_string(val.height);
+                const float values[] = {val.width, val.height};
+                writeFloats(values, 2);
             }
 
             return *this;
@@ -149,8 +187,8 @@ namespace ouzel
         {
             if (level <= threshold)
             {
-                s += std::to_string(val.width) + "," + std::to_string(val.height) + "," +
-                    std::to_string(val.depth);
+                const float values[] = {val.width, val.height, val.depth};
+                writeFloats(values, 3);
             }
 
             return *this;
@@ -160,7 +198,8 @@ namespace ouzel
         {
             if (level <= threshold)
             {
-                s += std::to_string(val.x) + "," + std::to_string(val.y);
+                const float values[] = {val.x, val.y};
+                writeFloats(values, 2);
             }
 
             return *this;
@@ -170,8 +209,8 @@ namespace ouzel
         {
             if (level <= threshold)
             {
-                s += std::to_string(val.x) + "," + std::to_string(val.y) + "," +
-                    std::to_string(val.z);
+                const float values[] = {val.x, val.y, val.z};
+                writeFloats(values, 3);
             }
 
             return *this;
@@ -181,15 +220,29 @@ namespace ouzel
         {
             if (level <= threshold)
             {
-                s += std::to_string(val.x) + "," + std::to_string(val.y) + "," +
-                    std::to_string(val.z) + "," + std::to_string(val.w);
+                const float values[] = {val.x, val.y, val.z, val.w};
+                writeFloats(values, 4);
             }
 
             return *this;
         }
 
     private:
+        void copy(const Log& other);
+        uint8_t* reserve(uint32_t count);
+        void writeSigned(int64_t val);
+        void writeUnsigned(uint64_t val);
+        void writeDouble(double val);
+        void writeString(const char* val);
+        void writeString(const char* val, size_t length);
+        // values separated by commas, with a newline after every rowLength values
+        void writeFloats(const float* val, uint32_t count, uint32_t rowLength = 0);
+
         Level level = Level::INFO;
-        std::string s;
+        uint32_t category = 0;
+        uint32_t size = 0;
+        // the record is moved to heapData when it doesn't fit into inlineData
+        uint8_t inlineData[256];
+        std::vector<uint8_t> heapData;
     };
 }
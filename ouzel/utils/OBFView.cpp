@@ -0,0 +1,552 @@
+// Copyright (C) 2018 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#include <cstring>
+#include <iterator>
+#include "OBFView.hpp"
+#include "Log.hpp"
+#include "Utils.hpp"
+
+namespace ouzel
+{
+    namespace obf
+    {
+        static const uint32_t MAX_DEPTH = 256;
+
+        // returns the encoded size of the value or 0 if it is invalid
+        static uint32_t validate(const uint8_t* data, uint32_t size, uint32_t depth)
+        {
+            if (size < 1 || depth > MAX_DEPTH) return 0;
+
+            Value::Marker marker = static_cast<Value::Marker>(data[0]);
+            uint32_t offset = 1;
+
+            switch (marker)
+            {
+                case Value::Marker::NONE: return offset;
+                case Value::Marker::INT8: return (size - offset >= 1) ? offset + 1 : 0;
+                case Value::Marker::INT16: return (size - offset >= 2) ? offset + 2 : 0;
+                case Value::Marker::INT32: return (size - offset >= 4) ? offset + 4 : 0;
+                case Value::Marker::INT64: return (size - offset >= 8) ? offset + 8 : 0;
+                case Value::Marker::FLOAT: return (size - offset >= sizeof(float)) ? offset + sizeof(float) : 0;
+                case Value::Marker::DOUBLE: return (size - offset >= sizeof(double)) ? offset + sizeof(double) : 0;
+                case Value::Marker::STRING:
+                {
+                    if (size - offset < sizeof(uint16_t)) return 0;
+                    uint32_t length = decodeUInt16Big(data + offset);
+                    offset += sizeof(uint16_t);
+                    return (size - offset >= length) ? offset + length : 0;
+                }
+                case Value::Marker::LONG_STRING:
+                case Value::Marker::BYTE_ARRAY:
+                {
+                    if (size - offset < sizeof(uint32_t)) return 0;
+                    uint32_t length = decodeUInt32Big(data + offset);
+                    offset += sizeof(uint32_t);
+                    return (size - offset >= length) ? offset + length : 0;
+                }
+                case Value::Marker::OBJECT:
+                case Value::Marker::ARRAY:
+                case Value::Marker::DICTIONARY:
+                {
+                    if (size - offset < sizeof(uint32_t)) return 0;
+                    uint32_t count = decodeUInt32Big(data + offset);
+                    offset += sizeof(uint32_t);
+
+                    for (uint32_t i = 0; i < count; ++i)
+                    {
+                        if (marker == Value::Marker::OBJECT)
+                        {
+                            if (size - offset < sizeof(uint32_t)) return 0;
+                            offset += sizeof(uint32_t);
+                        }
+                        else if (marker == Value::Marker::DICTIONARY)
+                        {
+                            if (size - offset < sizeof(uint16_t)) return 0;
+                            uint32_t length = decodeUInt16Big(data + offset);
+                            offset += sizeof(uint16_t);
+                            if (size - offset < length) return 0;
+                            offset += length;
+                        }
+
+                        uint32_t ret = validate(data + offset, size - offset, depth + 1);
+                        if (ret == 0) return 0;
+                        offset += ret;
+                    }
+
+                    return offset;
+                }
+                default:
+                    return 0;
+            }
+        }
+
+        // returns the encoded size of an already validated value
+        static uint32_t getValueSize(const uint8_t* data)
+        {
+            Value::Marker marker = static_cast<Value::Marker>(data[0]);
+
+            switch (marker)
+            {
+                case Value::Marker::NONE: return 1;
+                case Value::Marker::INT8: return 1 + 1;
+                case Value::Marker::INT16: return 1 + 2;
+                case Value::Marker::INT32: return 1 + 4;
+                case Value::Marker::INT64: return 1 + 8;
+                case Value::Marker::FLOAT: return 1 + sizeof(float);
+                case Value::Marker::DOUBLE: return 1 + sizeof(double);
+                case Value::Marker::STRING: return 1 + sizeof(uint16_t) + decodeUInt16Big(data + 1);
+                case Value::Marker::LONG_STRING:
+                case Value::Marker::BYTE_ARRAY: return 1 + sizeof(uint32_t) + decodeUInt32Big(data + 1);
+                case Value::Marker::OBJECT:
+                case Value::Marker::ARRAY:
+                case Value::Marker::DICTIONARY:
+                {
+                    uint32_t count = decodeUInt32Big(data + 1);
+                    uint32_t offset = 1 + sizeof(uint32_t);
+
+                    for (uint32_t i = 0; i < count; ++i)
+                    {
+                        if (marker == Value::Marker::OBJECT)
+                            offset += sizeof(uint32_t);
+                        else if (marker == Value::Marker::DICTIONARY)
+                            offset += sizeof(uint16_t) + decodeUInt16Big(data + offset);
+
+                        offset += getValueSize(data + offset);
+                    }
+
+                    return offset;
+                }
+                default:
+                    return 0;
+            }
+        }
+
+        View::Iterator::Iterator(Value::Marker initContainerMarker, const uint8_t* initCurrent, uint32_t initRemaining):
+            containerMarker(initContainerMarker), current(initCurrent), remaining(initRemaining)
+        {
+            if (remaining) readElement();
+        }
+
+        View::Iterator& View::Iterator::operator++()
+        {
+            current = value.data + value.size;
+            if (--remaining) readElement();
+
+            return *this;
+        }
+
+        void View::Iterator::readElement()
+        {
+            const uint8_t* element = current;
+
+            if (containerMarker == Value::Marker::OBJECT)
+            {
+                key = decodeUInt32Big(element);
+                element += sizeof(uint32_t);
+            }
+            else if (containerMarker == Value::Marker::DICTIONARY)
+            {
+                uint16_t length = decodeUInt16Big(element);
+                element += sizeof(uint16_t);
+                name = StringView(reinterpret_cast<const char*>(element), length);
+                element += length;
+            }
+
+            value = View(element, getValueSize(element));
+        }
+
+        bool View::init(const uint8_t* buffer, uint32_t bufferSize)
+        {
+            uint32_t encodedSize = validate(buffer, bufferSize, 0);
+
+            if (encodedSize == 0)
+            {
+                data = nullptr;
+                size = 0;
+                return false;
+            }
+
+            data = buffer;
+            size = encodedSize;
+
+            return true;
+        }
+
+        bool View::init(const std::vector<uint8_t>& buffer, uint32_t offset)
+        {
+            if (offset > buffer.size())
+            {
+                data = nullptr;
+                size = 0;
+                return false;
+            }
+
+            return init(buffer.data() + offset, static_cast<uint32_t>(buffer.size() - offset));
+        }
+
+        Value::Type View::getType() const
+        {
+            switch (getMarker())
+            {
+                case Value::Marker::INT8:
+                case Value::Marker::INT16:
+                case Value::Marker::INT32:
+                case Value::Marker::INT64: return Value::Type::INT;
+                case Value::Marker::FLOAT: return Value::Type::FLOAT;
+                case Value::Marker::DOUBLE: return Value::Type::DOUBLE;
+                case Value::Marker::STRING:
+                case Value::Marker::LONG_STRING: return Value::Type::STRING;
+                case Value::Marker::BYTE_ARRAY: return Value::Type::BYTE_ARRAY;
+                case Value::Marker::OBJECT: return Value::Type::OBJECT;
+                case Value::Marker::ARRAY: return Value::Type::ARRAY;
+                case Value::Marker::DICTIONARY: return Value::Type::DICTIONARY;
+                default: return Value::Type::NONE;
+            }
+        }
+
+        uint64_t View::asUInt64() const
+        {
+            switch (getMarker())
+            {
+                case Value::Marker::INT8: return data[1];
+                case Value::Marker::INT16: return decodeUInt16Big(data + 1);
+                case Value::Marker::INT32: return decodeUInt32Big(data + 1);
+                case Value::Marker::INT64: return decodeUInt64Big(data + 1);
+                default: return 0;
+            }
+        }
+
+        double View::asDouble() const
+        {
+            switch (getMarker())
+            {
+                case Value::Marker::FLOAT:
+                {
+                    float result;
+                    memcpy(&result, data + 1, sizeof(result));
+                    return result;
+                }
+                case Value::Marker::DOUBLE:
+                {
+                    double result;
+                    memcpy(&result, data + 1, sizeof(result));
+                    return result;
+                }
+                default: return 0.0;
+            }
+        }
+
+        StringView View::asString() const
+        {
+            switch (getMarker())
+            {
+                case Value::Marker::STRING:
+                    return StringView(reinterpret_cast<const char*>(data + 1 + sizeof(uint16_t)), decodeUInt16Big(data + 1));
+                case Value::Marker::LONG_STRING:
+                    return StringView(reinterpret_cast<const char*>(data + 1 + sizeof(uint32_t)), decodeUInt32Big(data + 1));
+                default:
+                    return StringView();
+            }
+        }
+
+        const uint8_t* View::getByteArrayData() const
+        {
+            return (getMarker() == Value::Marker::BYTE_ARRAY) ? data + 1 + sizeof(uint32_t) : nullptr;
+        }
+
+        uint32_t View::getByteArraySize() const
+        {
+            return (getMarker() == Value::Marker::BYTE_ARRAY) ? decodeUInt32Big(data + 1) : 0;
+        }
+
+        uint32_t View::getSize() const
+        {
+            switch (getMarker())
+            {
+                case Value::Marker::OBJECT:
+                case Value::Marker::ARRAY:
+                case Value::Marker::DICTIONARY:
+                    return decodeUInt32Big(data + 1);
+                default:
+                    return 0;
+            }
+        }
+
+        View::Iterator View::begin() const
+        {
+            return Iterator(getMarker(), data ? data + 1 + sizeof(uint32_t) : nullptr, getSize());
+        }
+
+        View::Iterator View::end() const
+        {
+            return Iterator(getMarker(), nullptr, 0);
+        }
+
+        View View::operator[](uint32_t key) const
+        {
+            Value::Marker marker = getMarker();
+
+            if (marker == Value::Marker::ARRAY)
+            {
+                if (key >= getSize()) return View();
+
+                const uint8_t* element = data + 1 + sizeof(uint32_t);
+                for (uint32_t i = 0; i < key; ++i) element += getValueSize(element);
+
+                return View(element, getValueSize(element));
+            }
+            else if (marker == Value::Marker::OBJECT)
+            {
+                for (Iterator i = begin(); i != end(); ++i)
+                {
+                    if (i.getKey() == key) return *i;
+                }
+            }
+
+            return View();
+        }
+
+        View View::operator[](const char* key) const
+        {
+            if (getMarker() == Value::Marker::DICTIONARY)
+            {
+                for (Iterator i = begin(); i != end(); ++i)
+                {
+                    if (i.getName() == key) return *i;
+                }
+            }
+
+            return View();
+        }
+
+        bool View::decode(Value& result) const
+        {
+            if (!data) return false;
+
+            switch (getType())
+            {
+                case Value::Type::NONE:
+                    result = Value::Type::NONE;
+                    break;
+                case Value::Type::INT:
+                    result = asUInt64();
+                    break;
+                case Value::Type::FLOAT:
+                    result = asFloat();
+                    break;
+                case Value::Type::DOUBLE:
+                    result = asDouble();
+                    break;
+                case Value::Type::STRING:
+                    result = asString().str();
+                    break;
+                case Value::Type::BYTE_ARRAY:
+                    result = std::vector<uint8_t>(getByteArrayData(), getByteArrayData() + getByteArraySize());
+                    break;
+                case Value::Type::OBJECT:
+                    result = Value::Type::OBJECT;
+                    for (Iterator i = begin(); i != end(); ++i)
+                    {
+                        if (!i->decode(result[i.getKey()])) return false;
+                    }
+                    break;
+                case Value::Type::ARRAY:
+                    result = Value::Type::ARRAY;
+                    for (const View& element : *this)
+                    {
+                        Value value;
+                        if (!element.decode(value)) return false;
+                        result.append(value);
+                    }
+                    break;
+                case Value::Type::DICTIONARY:
+                    result = Value::Type::DICTIONARY;
+                    for (Iterator i = begin(); i != end(); ++i)
+                    {
+                        if (!i->decode(result[i.getName().str()])) return false;
+                    }
+                    break;
+            }
+
+            return true;
+        }
+
+        Writer::Writer(std::vector<uint8_t>& initBuffer):
+            buffer(initBuffer)
+        {
+        }
+
+        void Writer::writeUInt16(uint16_t value)
+        {
+            uint8_t data[sizeof(value)];
+            encodeUInt16Big(data, value);
+            buffer.insert(buffer.end(), std::begin(data), std::end(data));
+        }
+
+        void Writer::writeUInt32(uint32_t value)
+        {
+            uint8_t data[sizeof(value)];
+            encodeUInt32Big(data, value);
+            buffer.insert(buffer.end(), std::begin(data), std::end(data));
+        }
+
+        void Writer::beginValue()
+        {
+            // object and dictionary members are counted by their keys
+            if (!containers.empty() && containers.back().marker == Value::Marker::ARRAY)
+                ++containers.back().count;
+        }
+
+        void Writer::writeNull()
+        {
+            beginValue();
+            buffer.push_back(static_cast<uint8_t>(Value::Marker::NONE));
+        }
+
+        void Writer::writeInt(uint64_t value)
+        {
+            beginValue();
+
+            if (value > std::numeric_limits<uint32_t>::max())
+            {
+                uint8_t data[1 + sizeof(uint64_t)];
+                data[0] = static_cast<uint8_t>(Value::Marker::INT64);
+                encodeUInt64Big(data + 1, value);
+                buffer.insert(buffer.end(), std::begin(data), std::end(data));
+            }
+            else if (value > std::numeric_limits<uint16_t>::max())
+            {
+                buffer.push_back(static_cast<uint8_t>(Value::Marker::INT32));
+                writeUInt32(static_cast<uint32_t>(value));
+            }
+            else if (value > std::numeric_limits<uint8_t>::max())
+            {
+                buffer.push_back(static_cast<uint8_t>(Value::Marker::INT16));
+                writeUInt16(static_cast<uint16_t>(value));
+            }
+            else
+            {
+                buffer.push_back(static_cast<uint8_t>(Value::Marker::INT8));
+                buffer.push_back(static_cast<uint8_t>(value));
+            }
+        }
+
+        void Writer::writeFloat(float value)
+        {
+            beginValue();
+            buffer.push_back(static_cast<uint8_t>(Value::Marker::FLOAT));
+            buffer.insert(buffer.end(),
+                          reinterpret_cast<const uint8_t*>(&value),
+                          reinterpret_cast<const uint8_t*>(&value) + sizeof(value));
+        }
+
+        void Writer::writeDouble(double value)
+        {
+            beginValue();
+            buffer.push_back(static_cast<uint8_t>(Value::Marker::DOUBLE));
+            buffer.insert(buffer.end(),
+                          reinterpret_cast<const uint8_t*>(&value),
+                          reinterpret_cast<const uint8_t*>(&value) + sizeof(value));
+        }
+
+        void Writer::writeString(const std::string& value)
+        {
+            writeString(StringView(value.data(), static_cast<uint32_t>(value.length())));
+        }
+
+        void Writer::writeString(const StringView& value)
+        {
+            beginValue();
+
+            if (value.getLength() > std::numeric_limits<uint16_t>::max())
+            {
+                buffer.push_back(static_cast<uint8_t>(Value::Marker::LONG_STRING));
+                writeUInt32(value.getLength());
+            }
+            else
+            {
+                buffer.push_back(static_cast<uint8_t>(Value::Marker::STRING));
+                writeUInt16(static_cast<uint16_t>(value.getLength()));
+            }
+
+            buffer.insert(buffer.end(), value.begin(), value.end());
+        }
+
+        void Writer::writeByteArray(const uint8_t* value, uint32_t valueSize)
+        {
+            beginValue();
+            buffer.push_back(static_cast<uint8_t>(Value::Marker::BYTE_ARRAY));
+            writeUInt32(valueSize);
+            buffer.insert(buffer.end(), value, value + valueSize);
+        }
+
+        void Writer::writeByteArray(const std::vector<uint8_t>& value)
+        {
+            writeByteArray(value.data(), static_cast<uint32_t>(value.size()));
+        }
+
+        void Writer::writeValue(const Value& value)
+        {
+            beginValue();
+            value.encode(buffer);
+        }
+
+        void Writer::writeKey(uint32_t key)
+        {
+            if (!containers.empty()) ++containers.back().count;
+            writeUInt32(key);
+        }
+
+        bool Writer::writeKey(const std::string& key)
+        {
+            if (key.length() > std::numeric_limits<uint16_t>::max())
+            {
+                Log(Log::Level::ERR) << "Key \"" << key.substr(0, 32) << "...\" is too long";
+                failed = true;
+                return false;
+            }
+
+            if (!containers.empty()) ++containers.back().count;
+            writeUInt16(static_cast<uint16_t>(key.length()));
+            buffer.insert(buffer.end(), key.begin(), key.end());
+
+            return true;
+        }
+
+        void Writer::beginContainer(Value::Marker marker)
+        {
+            beginValue();
+            buffer.push_back(static_cast<uint8_t>(marker));
+
+            // the element count is patched when the container is closed
+            containers.push_back({marker, buffer.size(), 0});
+            writeUInt32(0);
+        }
+
+        void Writer::beginObject()
+        {
+            beginContainer(Value::Marker::OBJECT);
+        }
+
+        void Writer::beginArray()
+        {
+            beginContainer(Value::Marker::ARRAY);
+        }
+
+        void Writer::beginDictionary()
+        {
+            beginContainer(Value::Marker::DICTIONARY);
+        }
+
+        bool Writer::endContainer(Value::Marker marker)
+        {
+            if (failed || containers.empty() || containers.back().marker != marker) return false;
+
+            encodeUInt32Big(buffer.data() + containers.back().countOffset, containers.back().count);
+            containers.pop_back();
+
+            return true;
+        }
+    } // namespace obf
+} // namespace ouzel
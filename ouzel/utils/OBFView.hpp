@@ -0,0 +1,162 @@
+// Copyright (C) 2018 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "utils/OBF.hpp"
+#include "utils/StringView.hpp"
+
+namespace ouzel
+{
+    namespace obf
+    {
+        // read-only view of an encoded value, the buffer is validated once by init
+        // and walked lazily afterwards, strings and byte arrays are never copied
+        class View
+        {
+        public:
+            class Iterator;
+
+            View() {}
+
+            // returns false if the buffer does not start with a valid encoded value
+            bool init(const uint8_t* buffer, uint32_t bufferSize);
+            bool init(const std::vector<uint8_t>& buffer, uint32_t offset = 0);
+
+            bool isValid() const { return data != nullptr; }
+
+            // number of bytes that the value occupies in the buffer
+            uint32_t getEncodedSize() const { return size; }
+
+            Value::Marker getMarker() const { return data ? static_cast<Value::Marker>(*data) : Value::Marker::NONE; }
+            Value::Type getType() const;
+            bool isIntType() const { return getType() == Value::Type::INT; }
+            bool isFloatType() const { return getType() == Value::Type::FLOAT || getType() == Value::Type::DOUBLE; }
+            bool isStringType() const { return getType() == Value::Type::STRING; }
+
+            uint64_t asUInt64() const;
+            int64_t asInt64() const { return static_cast<int64_t>(asUInt64()); }
+            uint32_t asUInt32() const { return static_cast<uint32_t>(asUInt64()); }
+            int32_t asInt32() const { return static_cast<int32_t>(asUInt64()); }
+            uint16_t asUInt16() const { return static_cast<uint16_t>(asUInt64()); }
+            int16_t asInt16() const { return static_cast<int16_t>(asUInt64()); }
+            uint8_t asUInt8() const { return static_cast<uint8_t>(asUInt64()); }
+            int8_t asInt8() const { return static_cast<int8_t>(asUInt64()); }
+
+            double asDouble() const;
+            float asFloat() const { return static_cast<float>(asDouble()); }
+
+            StringView asString() const;
+
+            const uint8_t* getByteArrayData() const;
+            uint32_t getByteArraySize() const;
+
+            // number of elements of an object, array or dictionary
+            uint32_t getSize() const;
+
+            // object member by key or array element by index, invalid view if missing
+            View operator[](uint32_t key) const;
+            // dictionary member, invalid view if missing
+            View operator[](const char* key) const;
+            View operator[](const std::string& key) const { return (*this)[key.c_str()]; }
+
+            bool hasElement(uint32_t key) const { return (*this)[key].isValid(); }
+            bool hasElement(const std::string& key) const { return (*this)[key].isValid(); }
+
+            Iterator begin() const;
+            Iterator end() const;
+
+            // converts the view to a value tree
+            bool decode(Value& result) const;
+
+        private:
+            View(const uint8_t* initData, uint32_t initSize): data(initData), size(initSize) {}
+
+            const uint8_t* data = nullptr;
+            uint32_t size = 0;
+        };
+
+        class View::Iterator
+        {
+            friend View;
+        public:
+            const View& operator*() const { return value; }
+            const View* operator->() const { return &value; }
+
+            Iterator& operator++();
+            bool operator==(const Iterator& other) const { return remaining == other.remaining; }
+            bool operator!=(const Iterator& other) const { return remaining != other.remaining; }
+
+            // key of the current object member
+            uint32_t getKey() const { return key; }
+            // name of the current dictionary member
+            const StringView& getName() const { return name; }
+
+        private:
+            Iterator(Value::Marker initContainerMarker, const uint8_t* initCurrent, uint32_t initRemaining);
+            void readElement();
+
+            Value::Marker containerMarker = Value::Marker::NONE;
+            const uint8_t* current = nullptr;
+            uint32_t remaining = 0;
+
+            uint32_t key = 0;
+            StringView name;
+            View value;
+        };
+
+        // encodes values directly into a buffer without building a value tree
+        class Writer
+        {
+        public:
+            explicit Writer(std::vector<uint8_t>& initBuffer);
+
+            void writeNull();
+            void writeInt(uint64_t value);
+            void writeFloat(float value);
+            void writeDouble(double value);
+            void writeString(const std::string& value);
+            void writeString(const StringView& value);
+            void writeByteArray(const uint8_t* value, uint32_t valueSize);
+            void writeByteArray(const std::vector<uint8_t>& value);
+            void writeValue(const Value& value);
+
+            // object members and dictionary members have to be preceded by a key
+            void writeKey(uint32_t key);
+            // fails the write if the key does not fit in 16 bits
+            bool writeKey(const std::string& key);
+
+            void beginObject();
+            void beginArray();
+            void beginDictionary();
+            // closes the innermost container, returns false if it was not started or a key was rejected
+            bool endObject() { return endContainer(Value::Marker::OBJECT); }
+            bool endArray() { return endContainer(Value::Marker::ARRAY); }
+            bool endDictionary() { return endContainer(Value::Marker::DICTIONARY); }
+
+            // true if all containers have been closed
+            bool isComplete() const { return !failed && containers.empty(); }
+
+        private:
+            struct Container
+            {
+                Value::Marker marker;
+                size_t countOffset;
+                uint32_t count;
+            };
+
+            void beginValue();
+            void beginContainer(Value::Marker marker);
+            bool endContainer(Value::Marker marker);
+            void writeUInt16(uint16_t value);
+            void writeUInt32(uint32_t value);
+
+            std::vector<uint8_t>& buffer;
+            std::vector<Container> containers;
+            bool failed = false;
+        };
+    } // namespace obf
+} // namespace ouzel
@@ -0,0 +1,62 @@
+// Copyright (C) 2018 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+namespace ouzel
+{
+    // non-owning reference to a UTF-8 string inside of a parsed buffer
+    class StringView
+    {
+    public:
+        StringView() {}
+        StringView(const char* initData, uint32_t initLength): data(initData), length(initLength) {}
+
+        const char* getData() const { return data; }
+        uint32_t getLength() const { return length; }
+        bool isEmpty() const { return length == 0; }
+
+        const char* begin() const { return data; }
+        const char* end() const { return data + length; }
+
+        std::string str() const { return std::string(data, length); }
+
+        bool operator==(const char* other) const
+        {
+            return strlen(other) == length && memcmp(data, other, length) == 0;
+        }
+
+        bool operator!=(const char* other) const
+        {
+            return !(*this == other);
+        }
+
+        bool operator==(const std::string& other) const
+        {
+            return length == other.length() && memcmp(data, other.data(), length) == 0;
+        }
+
+        bool operator!=(const std::string& other) const
+        {
+            return !(*this == other);
+        }
+
+        bool operator==(const StringView& other) const
+        {
+            return length == other.length && memcmp(data, other.data, length) == 0;
+        }
+
+        bool operator!=(const StringView& other) const
+        {
+            return !(*this == other);
+        }
+
+    private:
+        const char* data = "";
+        uint32_t length = 0;
+    };
+} // namespace ouzel
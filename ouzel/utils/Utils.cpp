@@ -12,4 +12,26 @@ namespace ouzel
 #endif
 
     std::mt19937 randomEngine(std::random_device{}());
+
+    static const double POWERS_OF_10[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+
+    double scaleDecimal(uint64_t mantissa, int32_t exponent)
+    {
+        double result = static_cast<double>(mantissa);
+
+        // exact for the usual asset values, the powers up to 10^22 are representable
+        if (mantissa != 0)
+        {
+            for (; exponent > 22; exponent -= 22) result *= POWERS_OF_10[22];
+            for (; exponent < -22; exponent += 22) result /= POWERS_OF_10[22];
+
+            if (exponent > 0) result *= POWERS_OF_10[exponent];
+            else if (exponent < 0) result /= POWERS_OF_10[-exponent];
+        }
+
+        return result;
+    }
 }
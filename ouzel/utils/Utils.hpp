@@ -373,6 +373,84 @@ namespace ouzel
         return result;
     }
 
+    // mantissa * 10^exponent, computed without depending on the current locale
+    double scaleDecimal(uint64_t mantissa, int32_t exponent);
+
+    // locale independent parsing of a decimal number with an optional sign, fraction and exponent,
+    // strict follows the JSON grammar (no plus sign, no leading zeros and digits after the point and the exponent)
+    template<typename Iterator>
+    bool parseDecimal(Iterator& current, Iterator end, double& result, bool strict = false)
+    {
+        bool negative = false;
+        if (current != end && (*current == '-' || (!strict && *current == '+'))) negative = (*current++ == '-');
+
+        uint64_t mantissa = 0;
+        int32_t exponent = 0;
+        uint32_t digits = 0;
+        bool hasDigits = false;
+
+        if (strict && current != end && *current == '0')
+        {
+            hasDigits = true;
+            ++current;
+        }
+        else
+        {
+            for (; current != end && *current >= '0' && *current <= '9'; ++current)
+            {
+                hasDigits = true;
+                if (digits < 19)
+                {
+                    if (mantissa != 0 || *current != '0') ++digits;
+                    mantissa = mantissa * 10 + static_cast<uint64_t>(*current - '0');
+                }
+                else ++exponent; // drop digits that do not fit in the mantissa
+            }
+        }
+
+        if (strict && !hasDigits) return false;
+
+        if (current != end && *current == '.')
+        {
+            ++current;
+            if (strict && (current == end || *current < '0' || *current > '9')) return false;
+
+            for (; current != end && *current >= '0' && *current <= '9'; ++current)
+            {
+                hasDigits = true;
+                if (digits < 19)
+                {
+                    if (mantissa != 0 || *current != '0') ++digits;
+                    mantissa = mantissa * 10 + static_cast<uint64_t>(*current - '0');
+                    --exponent;
+                }
+            }
+        }
+
+        if (!hasDigits) return false;
+
+        if (current != end && (*current == 'e' || *current == 'E'))
+        {
+            bool negativeExponent = false;
+            if (++current != end && (*current == '+' || *current == '-')) negativeExponent = (*current++ == '-');
+
+            if (strict && (current == end || *current < '0' || *current > '9')) return false;
+
+            int32_t explicitExponent = 0;
+            for (; current != end && *current >= '0' && *current <= '9'; ++current)
+            {
+                if (explicitExponent < 10000) explicitExponent = explicitExponent * 10 + (*current - '0');
+            }
+
+            exponent += negativeExponent ? -explicitExponent : explicitExponent;
+        }
+
+        double value = scaleDecimal(mantissa, exponent);
+        result = negative ? -value : value;
+
+        return true;
+    }
+
     template<typename T> std::string hexToString(T n, size_t len = 0)
     {
         static const char* digits = "0123456789ABCDEF";
@@ -384,4 +462,30 @@ namespace ouzel
 
         return result;
     }
+
+    static const uint32_t FNV1A_OFFSET_32 = 0x811C9DC5U;
+    static const uint32_t FNV1A_PRIME_32 = 0x01000193U;
+    static const uint64_t FNV1A_OFFSET_64 = 0xCBF29CE484222325ULL;
+    static const uint64_t FNV1A_PRIME_64 = 0x00000100000001B3ULL;
+
+    // Fowler / Noll / Vo (FNV-1a) hash of the bytes, the result of an earlier call can be passed as the hash to continue it
+    template<typename T> T fnv1aHash(const void* data, size_t size, T hash, T prime)
+    {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+
+        for (size_t i = 0; i < size; ++i)
+            hash = (hash ^ bytes[i]) * prime;
+
+        return hash;
+    }
+
+    inline uint32_t fnv1aHash32(const void* data, size_t size, uint32_t hash = FNV1A_OFFSET_32)
+    {
+        return fnv1aHash(data, size, hash, FNV1A_PRIME_32);
+    }
+
+    inline uint64_t fnv1aHash64(const void* data, size_t size, uint64_t hash = FNV1A_OFFSET_64)
+    {
+        return fnv1aHash(data, size, hash, FNV1A_PRIME_64);
+    }
 }
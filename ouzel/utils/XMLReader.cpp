@@ -0,0 +1,448 @@
+// Copyright (C) 2018 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#include "XMLReader.hpp"
+#include "Log.hpp"
+#include "Utils.hpp"
+
+namespace ouzel
+{
+    namespace xml
+    {
+        static inline bool isWhitespace(uint8_t c)
+        {
+            return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+        }
+
+        // all non-ASCII bytes are accepted, so multi-byte UTF-8 names pass without decoding
+        static inline bool isNameStartChar(uint8_t c)
+        {
+            return (c >= 'a' && c <= 'z') ||
+                (c >= 'A' && c <= 'Z') ||
+                c == ':' || c == '_' ||
+                c >= 0x80;
+        }
+
+        static inline bool isNameChar(uint8_t c)
+        {
+            return isNameStartChar(c) ||
+                c == '-' || c == '.' ||
+                (c >= '0' && c <= '9');
+        }
+
+        static inline bool startsWith(const uint8_t* current, const uint8_t* end, const char* prefix)
+        {
+            for (; *prefix; ++prefix, ++current)
+            {
+                if (current == end || *current != static_cast<uint8_t>(*prefix)) return false;
+            }
+
+            return true;
+        }
+
+        Reader::Reader(const uint8_t* begin, const uint8_t* initEnd,
+                       bool initPreserveWhitespaces,
+                       bool initPreserveComments,
+                       bool initPreserveProcessingInstructions):
+            current(begin), end(initEnd),
+            preserveWhitespaces(initPreserveWhitespaces),
+            preserveComments(initPreserveComments),
+            preserveProcessingInstructions(initPreserveProcessingInstructions)
+        {
+            // BOM
+            if (end - current >= 3 &&
+                current[0] == 0xEF &&
+                current[1] == 0xBB &&
+                current[2] == 0xBF)
+            {
+                bom = true;
+                current += 3;
+            }
+        }
+
+        Reader::Event Reader::error(const char* message)
+        {
+            Log(Log::Level::ERR) << message;
+            return event = Event::ERROR;
+        }
+
+        Reader::Event Reader::next()
+        {
+            if (event == Event::ERROR || event == Event::END) return event;
+
+            if (pendingEnd)
+            {
+                // end of a self-closing element
+                pendingEnd = false;
+                name = elements.back();
+                elements.pop_back();
+                attributes.clear();
+                return event = Event::END_ELEMENT;
+            }
+
+            for (;;)
+            {
+                if (!preserveWhitespaces)
+                {
+                    while (current != end && isWhitespace(*current)) ++current;
+                }
+
+                if (current == end)
+                {
+                    if (!elements.empty()) return error("Unexpected end of data");
+                    return event = Event::END;
+                }
+
+                if (*current == '<')
+                {
+                    Event markupEvent = parseMarkup();
+                    if (markupEvent != Event::NONE) return markupEvent;
+                    // skipped a comment, processing instruction or type declaration
+                }
+                else
+                {
+                    const uint8_t* start = current;
+                    while (current != end && *current != '<') ++current;
+
+                    text = StringView(reinterpret_cast<const char*>(start), static_cast<uint32_t>(current - start));
+                    attributes.clear();
+                    return event = Event::TEXT;
+                }
+            }
+        }
+
+        bool Reader::skipElement()
+        {
+            size_t depth = elements.size();
+
+            for (;;)
+            {
+                Event elementEvent = next();
+                if (elementEvent == Event::ERROR || elementEvent == Event::END) return false;
+                if (elementEvent == Event::END_ELEMENT && elements.size() < depth) return true;
+            }
+        }
+
+        bool Reader::parseName(StringView& result)
+        {
+            if (current == end)
+            {
+                Log(Log::Level::ERR) << "Unexpected end of data";
+                return false;
+            }
+
+            if (!isNameStartChar(*current))
+            {
+                Log(Log::Level::ERR) << "Invalid name start";
+                return false;
+            }
+
+            const uint8_t* start = current;
+            while (current != end && isNameChar(*current)) ++current;
+
+            result = StringView(reinterpret_cast<const char*>(start), static_cast<uint32_t>(current - start));
+
+            return true;
+        }
+
+        bool Reader::parseAttributes(char terminator)
+        {
+            attributes.clear();
+
+            for (;;)
+            {
+                while (current != end && isWhitespace(*current)) ++current;
+
+                if (current == end)
+                {
+                    Log(Log::Level::ERR) << "Unexpected end of data";
+                    return false;
+                }
+
+                if (*current == '>' || *current == static_cast<uint8_t>(terminator)) return true;
+
+                Attribute attribute;
+                if (!parseName(attribute.name)) return false;
+
+                while (current != end && isWhitespace(*current)) ++current;
+
+                if (current == end || *current != '=')
+                {
+                    Log(Log::Level::ERR) << "Expected an equal sign";
+                    return false;
+                }
+
+                ++current;
+
+                while (current != end && isWhitespace(*current)) ++current;
+
+                if (current == end || (*current != '"' && *current != '\''))
+                {
+                    Log(Log::Level::ERR) << "Expected quotes";
+                    return false;
+                }
+
+                uint8_t quotes = *current++;
+                const uint8_t* start = current;
+
+                while (current != end && *current != quotes) ++current;
+
+                if (current == end)
+                {
+                    Log(Log::Level::ERR) << "Unexpected end of data";
+                    return false;
+                }
+
+                attribute.value = StringView(reinterpret_cast<const char*>(start), static_cast<uint32_t>(current - start));
+                ++current;
+
+                attributes.push_back(attribute);
+            }
+        }
+
+        Reader::Event Reader::parseMarkup()
+        {
+            ++current; // <
+
+            if (current == end) return error("Unexpected end of data");
+
+            if (*current == '!') // <!
+            {
+                if (startsWith(current, end, "!--"))
+                {
+                    current += 3;
+                    const uint8_t* start = current;
+
+                    for (;;)
+                    {
+                        if (end - current < 3) return error("Unexpected end of data");
+
+                        if (current[0] == '-' && current[1] == '-')
+                        {
+                            if (current[2] != '>') return error("Unexpected double-hyphen inside comment");
+                            break;
+                        }
+
+                        ++current;
+                    }
+
+                    text = StringView(reinterpret_cast<const char*>(start), static_cast<uint32_t>(current - start));
+                    current += 3;
+
+                    if (!preserveComments) return Event::NONE;
+
+                    attributes.clear();
+                    return event = Event::COMMENT;
+                }
+                else if (startsWith(current, end, "![CDATA["))
+                {
+                    current += 8;
+                    const uint8_t* start = current;
+
+                    for (;;)
+                    {
+                        if (end - current < 3) return error("Unexpected end of data");
+                        if (current[0] == ']' && current[1] == ']' && current[2] == '>') break;
+                        ++current;
+                    }
+
+                    text = StringView(reinterpret_cast<const char*>(start), static_cast<uint32_t>(current - start));
+                    current += 3;
+
+                    attributes.clear();
+                    return event = Event::CDATA;
+                }
+                else if (startsWith(current, end, "!DOCTYPE"))
+                {
+                    // type declarations are skipped, including the internal subset
+                    uint32_t brackets = 0;
+
+                    for (;;)
+                    {
+                        if (++current == end) return error("Unexpected end of data");
+
+                        if (*current == '[') ++brackets;
+                        else if (*current == ']' && brackets > 0) --brackets;
+                        else if (*current == '>' && brackets == 0) break;
+                    }
+
+                    ++current;
+                    return Event::NONE;
+                }
+
+                return error("Expected a comment, CDATA or a type declaration");
+            }
+            else if (*current == '?') // <?
+            {
+                ++current;
+                if (!parseName(name)) return event = Event::ERROR;
+                if (!parseAttributes('?')) return event = Event::ERROR;
+
+                if (!startsWith(current, end, "?>")) return error("Expected a right angle bracket");
+                current += 2;
+
+                if (!preserveProcessingInstructions) return Event::NONE;
+
+                return event = Event::PROCESSING_INSTRUCTION;
+            }
+            else if (*current == '/') // </
+            {
+                ++current;
+
+                StringView tag;
+                if (!parseName(tag)) return event = Event::ERROR;
+
+                if (elements.empty() || elements.back() != tag) return error("Tag not closed properly");
+
+                while (current != end && isWhitespace(*current)) ++current;
+
+                if (current == end || *current != '>') return error("Expected a right angle bracket");
+                ++current;
+
+                name = tag;
+                elements.pop_back();
+                attributes.clear();
+
+                return event = Event::END_ELEMENT;
+            }
+            else // <
+            {
+                if (!parseName(name)) return event = Event::ERROR;
+                if (!parseAttributes('/')) return event = Event::ERROR;
+
+                if (*current == '/')
+                {
+                    if (++current == end || *current != '>') return error("Expected a right angle bracket");
+                    pendingEnd = true;
+                }
+
+                ++current;
+
+                elements.push_back(name);
+
+                return event = Event::START_ELEMENT;
+            }
+        }
+
+        bool Reader::getText(std::string& result) const
+        {
+            if (event == Event::CDATA)
+            {
+                result.assign(text.getData(), text.getLength());
+                return true;
+            }
+
+            return decode(text, result);
+        }
+
+        bool Reader::hasAttribute(const char* attributeName) const
+        {
+            for (const Attribute& attribute : attributes)
+            {
+                if (attribute.name == attributeName) return true;
+            }
+
+            return false;
+        }
+
+        StringView Reader::getAttribute(const char* attributeName) const
+        {
+            for (const Attribute& attribute : attributes)
+            {
+                if (attribute.name == attributeName) return attribute.value;
+            }
+
+            return StringView();
+        }
+
+        bool Reader::getAttribute(const char* attributeName, std::string& result) const
+        {
+            for (const Attribute& attribute : attributes)
+            {
+                if (attribute.name == attributeName) return decode(attribute.value, result);
+            }
+
+            result.clear();
+            return false;
+        }
+
+        bool Reader::decode(const StringView& value, std::string& result)
+        {
+            result.clear();
+            result.reserve(value.getLength());
+
+            for (const char* i = value.begin(); i != value.end(); ++i)
+            {
+                if (*i != '&')
+                {
+                    result.push_back(*i);
+                    continue;
+                }
+
+                const char* start = i + 1;
+                const char* semicolon = start;
+                while (semicolon != value.end() && *semicolon != ';') ++semicolon;
+
+                if (semicolon == value.end() || semicolon == start)
+                {
+                    Log(Log::Level::ERR) << "Invalid entity";
+                    return false;
+                }
+
+                StringView entity(start, static_cast<uint32_t>(semicolon - start));
+
+                if (entity == "quot") result.push_back('"');
+                else if (entity == "amp") result.push_back('&');
+                else if (entity == "apos") result.push_back('\'');
+                else if (entity == "lt") result.push_back('<');
+                else if (entity == "gt") result.push_back('>');
+                else if (entity.getData()[0] == '#' && entity.getLength() >= 2)
+                {
+                    bool hex = (entity.getData()[1] == 'x');
+                    const char* digit = entity.getData() + (hex ? 2 : 1);
+
+                    if (digit == entity.end())
+                    {
+                        Log(Log::Level::ERR) << "Invalid entity";
+                        return false;
+                    }
+
+                    uint32_t c = 0;
+
+                    for (; digit != entity.end(); ++digit)
+                    {
+                        uint32_t code;
+
+                        if (*digit >= '0' && *digit <= '9') code = static_cast<uint32_t>(*digit - '0');
+                        else if (hex && *digit >= 'a' && *digit <= 'f') code = static_cast<uint32_t>(*digit - 'a' + 10);
+                        else if (hex && *digit >= 'A' && *digit <= 'F') code = static_cast<uint32_t>(*digit - 'A' + 10);
+                        else
+                        {
+                            Log(Log::Level::ERR) << "Invalid character code";
+                            return false;
+                        }
+
+                        c = hex ? ((c << 4) | code) : (c * 10 + code);
+
+                        if (c > 0x10FFFF)
+                        {
+                            Log(Log::Level::ERR) << "Invalid character code";
+                            return false;
+                        }
+                    }
+
+                    result += utf32ToUtf8(c);
+                }
+                else
+                {
+                    Log(Log::Level::ERR) << "Invalid entity";
+                    return false;
+                }
+
+                i = semicolon;
+            }
+
+            return true;
+        }
+    } // namespace xml
+} // namespace ouzel
@@ -0,0 +1,93 @@
+// Copyright (C) 2018 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "utils/StringView.hpp"
+
+namespace ouzel
+{
+    namespace xml
+    {
+        // streaming pull parser that works directly on UTF-8 bytes
+        // names, attribute values and text are returned as views into the source buffer,
+        // entities are decoded only when asked for
+        class Reader
+        {
+        public:
+            enum class Event
+            {
+                NONE,
+                START_ELEMENT,
+                END_ELEMENT,
+                TEXT,
+                CDATA,
+                COMMENT,
+                PROCESSING_INSTRUCTION,
+                END,
+                ERROR
+            };
+
+            struct Attribute
+            {
+                StringView name;
+                StringView value; // raw value, entities are not decoded
+            };
+
+            Reader(const uint8_t* begin, const uint8_t* end,
+                   bool initPreserveWhitespaces = false,
+                   bool initPreserveComments = false,
+                   bool initPreserveProcessingInstructions = false);
+
+            Event next();
+
+            // skips the children of the element that was just started, including its end tag
+            bool skipElement();
+
+            Event getEvent() const { return event; }
+            size_t getDepth() const { return elements.size(); }
+
+            // element or processing instruction name
+            const StringView& getName() const { return name; }
+
+            // raw content of text, CDATA and comment nodes
+            const StringView& getText() const { return text; }
+            // decoded content of text and CDATA nodes
+            bool getText(std::string& result) const;
+
+            // attributes of the current element or processing instruction
+            const std::vector<Attribute>& getAttributes() const { return attributes; }
+            bool hasAttribute(const char* attributeName) const;
+            StringView getAttribute(const char* attributeName) const;
+            bool getAttribute(const char* attributeName, std::string& result) const;
+
+            bool hasBOM() const { return bom; }
+
+            static bool decode(const StringView& value, std::string& result);
+
+        private:
+            Event error(const char* message);
+            bool parseName(StringView& result);
+            bool parseAttributes(char terminator);
+            Event parseMarkup();
+
+            const uint8_t* current;
+            const uint8_t* end;
+            bool preserveWhitespaces;
+            bool preserveComments;
+            bool preserveProcessingInstructions;
+            bool bom = false;
+            bool pendingEnd = false;
+
+            std::vector<StringView> elements;
+
+            Event event = Event::NONE;
+            StringView name;
+            StringView text;
+            std::vector<Attribute> attributes;
+        };
+    } // namespace xml
+} // namespace ouzel
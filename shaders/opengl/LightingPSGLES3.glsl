@@ -0,0 +1,39 @@
+#version 300 es
+precision highp float;
+precision highp int;
+uniform lowp vec4 color;
+uniform vec4 ambientColor;
+uniform vec4 lightGrid;
+uniform lowp sampler2D texture0;
+uniform highp sampler2D texture1;
+in vec4 exColor;
+in vec2 exTexCoord;
+in vec3 exWorldPosition;
+in vec4 exClipPosition;
+out vec4 outColor;
+vec4 fetchLightData(int index)
+{
+    return texelFetch(texture1, ivec2(index % 256, index / 256), 0);
+}
+void main()
+{
+    vec2 tileCount = lightGrid.xy;
+    vec2 normalized = exClipPosition.xy / exClipPosition.w * 0.5 + 0.5;
+    ivec2 tile = clamp(ivec2(normalized * tileCount), ivec2(0, 0), ivec2(tileCount) - 1);
+    vec4 tileData = fetchLightData(int(lightGrid.z) + tile.y * int(tileCount.x) + tile.x);
+    int offset = int(tileData.x);
+    int count = int(tileData.y);
+    vec3 light = ambientColor.rgb;
+    for (int i = 0; i < count; ++i)
+    {
+        int slot = offset + i;
+        vec4 indices = fetchLightData(int(lightGrid.w) + slot / 4);
+        int lightIndex = int(indices[slot % 4]);
+        vec4 positionRange = fetchLightData(lightIndex * 2);
+        vec4 lightColor = fetchLightData(lightIndex * 2 + 1);
+        float attenuation = max(0.0, 1.0 - distance(exWorldPosition, positionRange.xyz) / positionRange.w);
+        light += lightColor.rgb * attenuation * attenuation;
+    }
+    vec4 baseColor = texture(texture0, exTexCoord) * exColor * color;
+    outColor = vec4(baseColor.rgb * light, baseColor.a);
+}
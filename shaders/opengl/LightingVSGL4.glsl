@@ -0,0 +1,18 @@
+#version 400
+in vec3 position0;
+in vec4 color0;
+in vec2 texCoord0;
+uniform mat4 modelViewProj;
+uniform mat4 modelMatrix;
+out vec4 exColor;
+out vec2 exTexCoord;
+out vec3 exWorldPosition;
+out vec4 exClipPosition;
+void main()
+{
+    gl_Position = modelViewProj * vec4(position0, 1.0);
+    exClipPosition = gl_Position;
+    exWorldPosition = (modelMatrix * vec4(position0, 1.0)).xyz;
+    exColor = color0;
+    exTexCoord = texCoord0;
+}
@@ -9,12 +9,16 @@ xxd -i ColorPSGL3.glsl ../../ouzel/graphics/opengl/ColorPSGL3.h
 xxd -i ColorVSGL3.glsl ../../ouzel/graphics/opengl/ColorVSGL3.h
 xxd -i TexturePSGL3.glsl ../../ouzel/graphics/opengl/TexturePSGL3.h
 xxd -i TextureVSGL3.glsl ../../ouzel/graphics/opengl/TextureVSGL3.h
+xxd -i LightingPSGL3.glsl ../../ouzel/graphics/opengl/LightingPSGL3.h
+xxd -i LightingVSGL3.glsl ../../ouzel/graphics/opengl/LightingVSGL3.h
 
 # OpenGL 4
 xxd -i ColorPSGL4.glsl ../../ouzel/graphics/opengl/ColorPSGL4.h
 xxd -i ColorVSGL4.glsl ../../ouzel/graphics/opengl/ColorVSGL4.h
 xxd -i TexturePSGL4.glsl ../../ouzel/graphics/opengl/TexturePSGL4.h
 xxd -i TextureVSGL4.glsl ../../ouzel/graphics/opengl/TextureVSGL4.h
+xxd -i LightingPSGL4.glsl ../../ouzel/graphics/opengl/LightingPSGL4.h
+xxd -i LightingVSGL4.glsl ../../ouzel/graphics/opengl/LightingVSGL4.h
 
 # OpenGL ES 2
 xxd -i ColorPSGLES2.glsl ../../ouzel/graphics/opengl/ColorPSGLES2.h
@@ -26,4 +30,6 @@ xxd -i TextureVSGLES2.glsl ../../ouzel/graphics/opengl/TextureVSGLES2.h
 xxd -i ColorPSGLES3.glsl ../../ouzel/graphics/opengl/ColorPSGLES3.h
 xxd -i ColorVSGLES3.glsl ../../ouzel/graphics/opengl/ColorVSGLES3.h
 xxd -i TexturePSGLES3.glsl ../../ouzel/graphics/opengl/TexturePSGLES3.h
-xxd -i TextureVSGLES3.glsl ../../ouzel/graphics/opengl/TextureVSGLES3.h
\ No newline at end of file
+xxd -i TextureVSGLES3.glsl ../../ouzel/graphics/opengl/TextureVSGLES3.h
+xxd -i LightingPSGLES3.glsl ../../ouzel/graphics/opengl/LightingPSGLES3.h
+xxd -i LightingVSGLES3.glsl ../../ouzel/graphics/opengl/LightingVSGLES3.h
\ No newline at end of file